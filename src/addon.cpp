@@ -21,12 +21,15 @@
 //---------------------------------------------------------------------------
 
 #include "addon.h"
+#include "capturedevice.h"
 #include "dabstream.h"
 #include "dbtypes.h"
+#include "dsp_fm/fft.h"
 #include "filedevice.h"
 #include "fmstream.h"
 #include "hdstream.h"
 #include "tcpdevice.h"
+#include "timeshiftstream.h"
 #ifdef USB_DEVICE_SUPPORT
 #include "usbdevice.h"
 #endif
@@ -37,6 +40,7 @@
 #include "gui/channelsettings.h"
 #include "utils/value_size_defines.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <kodi/Filesystem.h>
 #include <kodi/General.h>
@@ -550,7 +554,8 @@ std::unique_ptr<rtldevice> addon::create_device(struct settings const& settings)
     {
 
       auto const& item = files[selected];
-      return filedevice::create(item.first.c_str(), item.second);
+      return filedevice::create(item.first.c_str(), item.second,
+                                static_cast<uint32_t>(std::max(settings.device_rawfile_speed, 0)));
     }
   }
 
@@ -569,6 +574,32 @@ std::unique_ptr<rtldevice> addon::create_device(struct settings const& settings)
   throw string_exception("invalid device_connection type specified");
 }
 
+//---------------------------------------------------------------------------
+// addon::create_stream_device (private)
+//
+// Creates the RTL-SDR device instance for a live stream
+//
+// Arguments:
+//
+//	settings		- Current addon settings structure
+
+std::unique_ptr<rtldevice> addon::create_stream_device(struct settings const& settings) const
+{
+  std::unique_ptr<rtldevice> device = create_device(settings);
+
+  // Wrap the device to capture the raw I/Q samples to disk if the option has been enabled
+  if ((settings.device_capture_enable) && (!settings.device_capture_folder.empty()))
+  {
+
+    std::string folder = kodi::vfs::TranslateSpecialProtocol(settings.device_capture_folder);
+    log_info(__func__, ": capturing raw I/Q samples to folder ", folder.c_str());
+
+    device = capturedevice::create(std::move(device), folder.c_str());
+  }
+
+  return device;
+}
+
 //---------------------------------------------------------------------------
 // addon::downsample_quality_to_string (private, static)
 //
@@ -617,6 +648,79 @@ std::string addon::device_connection_to_string(enum device_connection connection
   return "Unknown";
 }
 
+//---------------------------------------------------------------------------
+// addon::get_streaming_profile (private, static)
+//
+// Sets the device transfer buffer count and length for a streaming profile; the
+// balanced profile leaves both at zero to use the device and stream defaults
+//
+// Arguments:
+//
+//	profile			- Streaming profile
+//	modulation		- Modulation of the stream
+//	tunerprops		- Tuner properties to receive the buffer count and length
+
+void addon::get_streaming_profile(enum streaming_profile profile,
+                                  enum modulation modulation,
+                                  struct tunerprops& tunerprops)
+{
+  tunerprops.buffercount = 0;
+  tunerprops.bufferlength = 0;
+
+  // Low latency: ~5ms buffers; FM and WX are limited to one ~10ms demodulator block
+  if (profile == streaming_profile::lowlatency)
+  {
+
+    tunerprops.buffercount = 8;
+    if (modulation == modulation::hd)
+      tunerprops.bufferlength = 16 KiB;
+    else if (modulation == modulation::dab)
+      tunerprops.bufferlength = 20 KiB;
+  }
+
+  // Robust: ~40ms buffers, with enough of them to cover over a second of data
+  else if (profile == streaming_profile::robust)
+  {
+
+    tunerprops.buffercount = 32;
+    if (modulation == modulation::dab)
+      tunerprops.bufferlength = 160 KiB;
+    else
+      tunerprops.bufferlength = 128 KiB;
+  }
+}
+
+//---------------------------------------------------------------------------
+// addon::get_streamcache_key (private, static)
+//
+// Generates the stream cache key for a channel
+//
+// Arguments:
+//
+//	settings		- Current addon settings structure
+//	channelprops	- Channel properties
+
+struct streamcache::key addon::get_streamcache_key(struct settings const& settings,
+                                                   struct channelprops const& channelprops)
+{
+  struct streamcache::key key = {};
+
+  // The device is identified by the connection settings that were used to open it
+  if (settings.device_connection == device_connection::usb)
+    key.device = "usb:" + std::to_string(settings.device_connection_usb_index);
+  else
+    key.device = "tcp:" + settings.device_connection_tcp_host + ":" +
+                 std::to_string(settings.device_connection_tcp_port);
+
+  key.frequency = channelprops.frequency;
+  key.modulation = channelprops.modulation;
+
+  // A DAB ensemble decodes the audio or passes it through undecoded for all of its subscribers
+  key.passthrough = (channelprops.modulation == modulation::dab) && settings.dabradio_passthrough;
+
+  return key;
+}
+
 //---------------------------------------------------------------------------
 // addon::is_region_northamerica (private)
 //
@@ -1029,6 +1133,31 @@ std::string addon::regioncode_to_string(enum regioncode code)
   return "Unknown";
 }
 
+//---------------------------------------------------------------------------
+// addon::streaming_profile_to_string (private, static)
+//
+// Converts a streaming_profile enumeration value into a string
+//
+// Arguments:
+//
+//	profile		- Streaming profile to convert into a string
+
+std::string addon::streaming_profile_to_string(enum streaming_profile profile)
+{
+  switch (profile)
+  {
+
+    case streaming_profile::lowlatency:
+      return kodi::addon::GetLocalizedString(30226);
+    case streaming_profile::balanced:
+      return kodi::addon::GetLocalizedString(30227);
+    case streaming_profile::robust:
+      return kodi::addon::GetLocalizedString(30228);
+  }
+
+  return "Unknown";
+}
+
 //---------------------------------------------------------------------------
 // addon::update_regioncode (private)
 //
@@ -1168,6 +1297,14 @@ ADDON_STATUS addon::Create(void)
           kodi::addon::GetSettingInt("device_connection_tcp_port", 1234);
       m_settings.device_frequency_correction =
           kodi::addon::GetSettingInt("device_frequency_correction", 0);
+      m_settings.device_streaming_profile =
+          kodi::addon::GetSettingEnum("device_streaming_profile", streaming_profile::balanced);
+      m_settings.device_stream_cache_period =
+          kodi::addon::GetSettingInt("device_stream_cache_period", 10);
+      m_settings.device_capture_enable =
+          kodi::addon::GetSettingBoolean("device_capture_enable", false);
+      m_settings.device_capture_folder = kodi::addon::GetSettingString("device_capture_folder");
+      m_settings.device_rawfile_speed = kodi::addon::GetSettingInt("device_rawfile_speed", 1);
 
       // Load the region settings
       m_settings.region_regioncode =
@@ -1179,41 +1316,77 @@ ADDON_STATUS addon::Create(void)
           kodi::addon::GetSettingBoolean("fmradio_prepend_channel_numbers", false);
       m_settings.fmradio_sample_rate =
           kodi::addon::GetSettingInt("fmradio_sample_rate", (1600 KHz));
+      m_settings.fmradio_frontend_decimation =
+          kodi::addon::GetSettingBoolean("fmradio_frontend_decimation", false);
       m_settings.fmradio_downsample_quality =
           kodi::addon::GetSettingEnum("fmradio_downsample_quality", downsample_quality::standard);
       m_settings.fmradio_output_samplerate =
           kodi::addon::GetSettingInt("fmradio_output_samplerate", 48000);
       m_settings.fmradio_output_gain = kodi::addon::GetSettingFloat("fmradio_output_gain", -3.0f);
+      m_settings.fmradio_output_latency =
+          kodi::addon::GetSettingInt("fmradio_output_latency", 1000);
+      m_settings.fmradio_adaptive_latency =
+          kodi::addon::GetSettingBoolean("fmradio_adaptive_latency", true);
 
       // Load the HD Radio settings
       m_settings.hdradio_enable = kodi::addon::GetSettingBoolean("hdradio_enable", false);
       m_settings.hdradio_prepend_channel_numbers =
           kodi::addon::GetSettingBoolean("hdradio_prepend_channel_numbers", false);
       m_settings.hdradio_output_gain = kodi::addon::GetSettingFloat("hdradio_output_gain", -3.0f);
+      m_settings.hdradio_output_latency =
+          kodi::addon::GetSettingInt("hdradio_output_latency", 1000);
+      m_settings.hdradio_adaptive_latency =
+          kodi::addon::GetSettingBoolean("hdradio_adaptive_latency", true);
 
       // Load the DAB settings
       m_settings.dabradio_enable = kodi::addon::GetSettingBoolean("dabradio_enable", false);
       m_settings.dabradio_output_gain = kodi::addon::GetSettingFloat("dabradio_output_gain", -3.0f);
       m_settings.dabradio_coarse_corrector = kodi::addon::GetSettingBoolean("dabradio_coarse_corrector", true);
       m_settings.dabradio_coarse_corrector_type = kodi::addon::GetSettingInt("dabradio_coarse_corrector_type", 1);
+      m_settings.dabradio_passthrough = kodi::addon::GetSettingBoolean("dabradio_passthrough", false);
+      m_settings.dabradio_output_latency =
+          kodi::addon::GetSettingInt("dabradio_output_latency", 1000);
+      m_settings.dabradio_adaptive_latency =
+          kodi::addon::GetSettingBoolean("dabradio_adaptive_latency", true);
 
       // Load the Weather Radio settings
       m_settings.wxradio_enable = kodi::addon::GetSettingBoolean("wxradio_enable", false);
       m_settings.wxradio_sample_rate =
           kodi::addon::GetSettingInt("wxradio_sample_rate", (1600 KHz));
+      m_settings.wxradio_frontend_decimation =
+          kodi::addon::GetSettingBoolean("wxradio_frontend_decimation", false);
       m_settings.wxradio_output_samplerate =
           kodi::addon::GetSettingInt("wxradio_output_samplerate", 48000);
       m_settings.wxradio_output_gain = kodi::addon::GetSettingFloat("wxradio_output_gain", -3.0f);
+      m_settings.wxradio_output_latency =
+          kodi::addon::GetSettingInt("wxradio_output_latency", 1000);
+      m_settings.wxradio_adaptive_latency =
+          kodi::addon::GetSettingBoolean("wxradio_adaptive_latency", true);
+
+      // Load the timeshift settings
+      m_settings.timeshift_enable = kodi::addon::GetSettingBoolean("timeshift_enable", false);
+      m_settings.timeshift_folder = kodi::addon::GetSettingString("timeshift_folder");
+      m_settings.timeshift_buffer_size = kodi::addon::GetSettingInt("timeshift_buffer_size", 256);
 
       // Log the setting values
+      log_info(__func__, ": m_settings.dabradio_adaptive_latency         = ",
+               m_settings.dabradio_adaptive_latency);
       log_info(__func__,
                ": m_settings.dabradio_enable                   = ", m_settings.dabradio_enable);
       log_info(__func__, ": m_settings.dabradio_output_gain              = ",
                m_settings.dabradio_output_gain);
+      log_info(__func__, ": m_settings.dabradio_output_latency           = ",
+               m_settings.dabradio_output_latency, " ms");
       log_info(__func__, ": m_settings.dabradio_coarse_corrector         = ",
                m_settings.dabradio_coarse_corrector);
       log_info(__func__, ": m_settings.dabradio_coarse_corrector_type    = ",
                m_settings.dabradio_coarse_corrector_type);
+      log_info(__func__, ": m_settings.dabradio_passthrough              = ",
+               m_settings.dabradio_passthrough);
+      log_info(__func__, ": m_settings.device_capture_enable             = ",
+               m_settings.device_capture_enable);
+      log_info(__func__, ": m_settings.device_capture_folder             = ",
+               m_settings.device_capture_folder);
       log_info(__func__, ": m_settings.device_connection                 = ",
                device_connection_to_string(m_settings.device_connection));
       log_info(__func__, ": m_settings.device_connection_tcp_host        = ",
@@ -1224,30 +1397,58 @@ ADDON_STATUS addon::Create(void)
                m_settings.device_connection_usb_index);
       log_info(__func__, ": m_settings.device_frequency_correction       = ",
                m_settings.device_frequency_correction);
+      log_info(__func__, ": m_settings.device_rawfile_speed              = ",
+               m_settings.device_rawfile_speed);
+      log_info(__func__, ": m_settings.device_stream_cache_period        = ",
+               m_settings.device_stream_cache_period, " seconds");
+      log_info(__func__, ": m_settings.device_streaming_profile          = ",
+               streaming_profile_to_string(m_settings.device_streaming_profile));
+      log_info(__func__, ": m_settings.fmradio_adaptive_latency          = ",
+               m_settings.fmradio_adaptive_latency);
       log_info(__func__, ": m_settings.fmradio_downsample_quality        = ",
                downsample_quality_to_string(m_settings.fmradio_downsample_quality));
       log_info(__func__,
                ": m_settings.fmradio_enable_rds                = ", m_settings.fmradio_enable_rds);
+      log_info(__func__, ": m_settings.fmradio_frontend_decimation       = ",
+               m_settings.fmradio_frontend_decimation);
       log_info(__func__, ": m_settings.fmradio_prepend_channel_numbers   = ",
                m_settings.fmradio_prepend_channel_numbers);
       log_info(__func__,
                ": m_settings.fmradio_output_gain               = ", m_settings.fmradio_output_gain);
+      log_info(__func__, ": m_settings.fmradio_output_latency            = ",
+               m_settings.fmradio_output_latency, " ms");
       log_info(__func__, ": m_settings.fmradio_output_samplerate         = ",
                m_settings.fmradio_output_samplerate);
       log_info(__func__,
                ": m_settings.fmradio_sample_rate               = ", m_settings.fmradio_sample_rate);
+      log_info(__func__, ": m_settings.hdradio_adaptive_latency          = ",
+               m_settings.hdradio_adaptive_latency);
       log_info(__func__,
                ": m_settings.hdradio_enable                    = ", m_settings.hdradio_enable);
       log_info(__func__,
                ": m_settings.hdradio_output_gain               = ", m_settings.hdradio_output_gain);
+      log_info(__func__, ": m_settings.hdradio_output_latency            = ",
+               m_settings.hdradio_output_latency, " ms");
       log_info(__func__, ": m_settings.hdradio_prepend_channel_numbers   = ",
                m_settings.hdradio_prepend_channel_numbers);
       log_info(__func__, ": m_settings.region_regioncode                 = ",
                regioncode_to_string(m_settings.region_regioncode));
+      log_info(__func__, ": m_settings.timeshift_buffer_size             = ",
+               m_settings.timeshift_buffer_size, " MiB");
+      log_info(__func__,
+               ": m_settings.timeshift_enable                  = ", m_settings.timeshift_enable);
+      log_info(__func__,
+               ": m_settings.timeshift_folder                  = ", m_settings.timeshift_folder);
+      log_info(__func__, ": m_settings.wxradio_adaptive_latency          = ",
+               m_settings.wxradio_adaptive_latency);
       log_info(__func__,
                ": m_settings.wxradio_enable                    = ", m_settings.wxradio_enable);
+      log_info(__func__, ": m_settings.wxradio_frontend_decimation       = ",
+               m_settings.wxradio_frontend_decimation);
       log_info(__func__,
                ": m_settings.wxradio_output_gain               = ", m_settings.wxradio_output_gain);
+      log_info(__func__, ": m_settings.wxradio_output_latency            = ",
+               m_settings.wxradio_output_latency, " ms");
       log_info(__func__, ": m_settings.wxradio_output_samplerate         = ",
                m_settings.wxradio_output_samplerate);
       log_info(__func__,
@@ -1280,6 +1481,11 @@ ADDON_STATUS addon::Create(void)
         throw;
       }
 
+      // Load the FFTW planner wisdom saved by a previous session, if present
+      std::string wisdomfile = UserPath() + "/fftw.wisdom";
+      if (kodi::vfs::FileExists(wisdomfile, false) && !CFft<>::ImportWisdom(wisdomfile.c_str()))
+        log_warning(__func__, ": unable to import FFTW wisdom from ", wisdomfile);
+
       // If the user has not specified a region code, attempt to get them to do it during startup
       if (m_settings.region_regioncode == regioncode::notset)
       {
@@ -1359,6 +1565,12 @@ void addon::Destroy(void) noexcept
     log_info(__func__, ": ", VERSION_PRODUCTNAME_ANSI, " v", VERSION_VERSION3_ANSI, " unloading");
 
     m_pvrstream.reset(); // Destroy any active stream instance
+    m_streamcache.clear(); // Release any cached stream pipeline
+
+    // Save the FFTW planner wisdom so the FFT plans don't have to be measured again
+    std::string wisdomfile = UserPath() + "/fftw.wisdom";
+    if (!CFft<>::ExportWisdom(wisdomfile.c_str()))
+      log_warning(__func__, ": unable to export FFTW wisdom to ", wisdomfile);
 
     // Check for more than just the global connection pool reference during shutdown
     long poolrefs = m_connpool.use_count();
@@ -1483,6 +1695,77 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName,
     }
   }
 
+  // device_streaming_profile
+  //
+  else if (settingName == "device_streaming_profile")
+  {
+
+    enum streaming_profile value = settingValue.GetEnum<enum streaming_profile>();
+    if (value != m_settings.device_streaming_profile)
+    {
+
+      m_settings.device_streaming_profile = value;
+      log_info(__func__, ": setting device_streaming_profile changed to ",
+               streaming_profile_to_string(value).c_str());
+    }
+  }
+
+  // device_stream_cache_period
+  //
+  else if (settingName == "device_stream_cache_period")
+  {
+
+    int nvalue = settingValue.GetInt();
+    if (nvalue != m_settings.device_stream_cache_period)
+    {
+
+      m_settings.device_stream_cache_period = nvalue;
+      log_info(__func__, ": setting device_stream_cache_period changed to ", nvalue, " seconds");
+    }
+  }
+
+  // device_capture_enable
+  //
+  else if (settingName == "device_capture_enable")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.device_capture_enable)
+    {
+
+      m_settings.device_capture_enable = bvalue;
+      log_info(__func__, ": setting device_capture_enable changed to ", bvalue);
+    }
+  }
+
+  // device_capture_folder
+  //
+  else if (settingName == "device_capture_folder")
+  {
+
+    std::string strvalue = settingValue.GetString();
+    if (strvalue != m_settings.device_capture_folder)
+    {
+
+      m_settings.device_capture_folder = strvalue;
+      log_info(__func__, ": setting device_capture_folder changed to ", strvalue.c_str());
+    }
+  }
+
+  // device_rawfile_speed
+  //
+  else if (settingName == "device_rawfile_speed")
+  {
+
+    int nvalue = settingValue.GetInt();
+    if (nvalue != m_settings.device_rawfile_speed)
+    {
+
+      m_settings.device_rawfile_speed = nvalue;
+      log_info(__func__, ": setting device_rawfile_speed changed to ", nvalue);
+    }
+  }
+
   // fmradio_enable_rds
   //
   else if (settingName == "fmradio_enable_rds")
@@ -1529,6 +1812,20 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName,
     }
   }
 
+  // fmradio_frontend_decimation
+  //
+  else if (settingName == "fmradio_frontend_decimation")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.fmradio_frontend_decimation)
+    {
+
+      m_settings.fmradio_frontend_decimation = bvalue;
+      log_info(__func__, ": setting fmradio_frontend_decimation changed to ", bvalue);
+    }
+  }
+
   // fmradio_downsample_quality
   //
   else if (settingName == "fmradio_downsample_quality")
@@ -1572,6 +1869,34 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName,
     }
   }
 
+  // fmradio_output_latency
+  //
+  else if (settingName == "fmradio_output_latency")
+  {
+
+    int nvalue = settingValue.GetInt();
+    if (nvalue != m_settings.fmradio_output_latency)
+    {
+
+      m_settings.fmradio_output_latency = nvalue;
+      log_info(__func__, ": setting fmradio_output_latency changed to ", nvalue, "ms");
+    }
+  }
+
+  // fmradio_adaptive_latency
+  //
+  else if (settingName == "fmradio_adaptive_latency")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.fmradio_adaptive_latency)
+    {
+
+      m_settings.fmradio_adaptive_latency = bvalue;
+      log_info(__func__, ": setting fmradio_adaptive_latency changed to ", bvalue);
+    }
+  }
+
   // hdradio_enable
   //
   else if (settingName == "hdradio_enable")
@@ -1620,6 +1945,34 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName,
     }
   }
 
+  // hdradio_output_latency
+  //
+  else if (settingName == "hdradio_output_latency")
+  {
+
+    int nvalue = settingValue.GetInt();
+    if (nvalue != m_settings.hdradio_output_latency)
+    {
+
+      m_settings.hdradio_output_latency = nvalue;
+      log_info(__func__, ": setting hdradio_output_latency changed to ", nvalue, "ms");
+    }
+  }
+
+  // hdradio_adaptive_latency
+  //
+  else if (settingName == "hdradio_adaptive_latency")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.hdradio_adaptive_latency)
+    {
+
+      m_settings.hdradio_adaptive_latency = bvalue;
+      log_info(__func__, ": setting hdradio_adaptive_latency changed to ", bvalue);
+    }
+  }
+
   // dabradio_enable
   //
   else if (settingName == "dabradio_enable")
@@ -1679,6 +2032,48 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName,
     }
   }
 
+  // dabradio_passthrough
+  //
+  else if (settingName == "dabradio_passthrough")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.dabradio_passthrough)
+    {
+
+      m_settings.dabradio_passthrough = bvalue;
+      log_info(__func__, ": setting dabradio_passthrough changed to ", bvalue);
+    }
+  }
+
+  // dabradio_output_latency
+  //
+  else if (settingName == "dabradio_output_latency")
+  {
+
+    int nvalue = settingValue.GetInt();
+    if (nvalue != m_settings.dabradio_output_latency)
+    {
+
+      m_settings.dabradio_output_latency = nvalue;
+      log_info(__func__, ": setting dabradio_output_latency changed to ", nvalue, "ms");
+    }
+  }
+
+  // dabradio_adaptive_latency
+  //
+  else if (settingName == "dabradio_adaptive_latency")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.dabradio_adaptive_latency)
+    {
+
+      m_settings.dabradio_adaptive_latency = bvalue;
+      log_info(__func__, ": setting dabradio_adaptive_latency changed to ", bvalue);
+    }
+  }
+
   // region_regioncode
   //
   if (settingName == "region_regioncode")
@@ -1729,6 +2124,20 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName,
     }
   }
 
+  // wxradio_frontend_decimation
+  //
+  else if (settingName == "wxradio_frontend_decimation")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.wxradio_frontend_decimation)
+    {
+
+      m_settings.wxradio_frontend_decimation = bvalue;
+      log_info(__func__, ": setting wxradio_frontend_decimation changed to ", bvalue);
+    }
+  }
+
   // wxradio_output_samplerate
   //
   else if (settingName == "wxradio_output_samplerate")
@@ -1757,6 +2166,76 @@ ADDON_STATUS addon::SetSetting(std::string const& settingName,
     }
   }
 
+  // wxradio_output_latency
+  //
+  else if (settingName == "wxradio_output_latency")
+  {
+
+    int nvalue = settingValue.GetInt();
+    if (nvalue != m_settings.wxradio_output_latency)
+    {
+
+      m_settings.wxradio_output_latency = nvalue;
+      log_info(__func__, ": setting wxradio_output_latency changed to ", nvalue, "ms");
+    }
+  }
+
+  // wxradio_adaptive_latency
+  //
+  else if (settingName == "wxradio_adaptive_latency")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.wxradio_adaptive_latency)
+    {
+
+      m_settings.wxradio_adaptive_latency = bvalue;
+      log_info(__func__, ": setting wxradio_adaptive_latency changed to ", bvalue);
+    }
+  }
+
+  // timeshift_enable
+  //
+  else if (settingName == "timeshift_enable")
+  {
+
+    bool bvalue = settingValue.GetBoolean();
+    if (bvalue != m_settings.timeshift_enable)
+    {
+
+      m_settings.timeshift_enable = bvalue;
+      log_info(__func__, ": setting timeshift_enable changed to ", bvalue);
+    }
+  }
+
+  // timeshift_folder
+  //
+  else if (settingName == "timeshift_folder")
+  {
+
+    std::string strvalue = settingValue.GetString();
+    if (strvalue != m_settings.timeshift_folder)
+    {
+
+      m_settings.timeshift_folder = strvalue;
+      log_info(__func__, ": setting timeshift_folder changed to ", strvalue.c_str());
+    }
+  }
+
+  // timeshift_buffer_size
+  //
+  else if (settingName == "timeshift_buffer_size")
+  {
+
+    int nvalue = settingValue.GetInt();
+    if (nvalue != m_settings.timeshift_buffer_size)
+    {
+
+      m_settings.timeshift_buffer_size = nvalue;
+      log_info(__func__, ": setting timeshift_buffer_size changed to ", nvalue, "MiB");
+    }
+  }
+
   return ADDON_STATUS::ADDON_STATUS_OK;
 }
 
@@ -1799,6 +2278,31 @@ PVR_ERROR addon::CallSettingsMenuHook(kodi::addon::PVRMenuhook const& menuhook)
   return PVR_ERROR::PVR_ERROR_NO_ERROR;
 }
 
+//-----------------------------------------------------------------------------
+// addon::CanPauseStream (CInstancePVRClient)
+//
+// Check if the backend supports pausing the currently playing stream
+//
+// Arguments:
+//
+//	NONE
+
+bool addon::CanPauseStream(void)
+{
+  try
+  {
+    return (m_pvrstream) ? m_pvrstream->canpause() : false;
+  }
+  catch (std::exception& ex)
+  {
+    return handle_stdexception(__func__, ex, false);
+  }
+  catch (...)
+  {
+    return handle_generalexception(__func__, false);
+  }
+}
+
 //-----------------------------------------------------------------------------
 // addon::CanSeekStream (CInstancePVRClient)
 //
@@ -1840,7 +2344,41 @@ void addon::CloseLiveStream(void)
 
   try
   {
+    if (m_pvrstream)
+    {
+
+      // Report the data transfer statistics for the device
+      struct rtldevice::device_statistics stats = {};
+      m_pvrstream->devicestatistics(stats);
+      log_info(__func__, ": device transferred ", stats.bytes, " bytes (", stats.bytespersecond,
+               " bytes/sec), stall time ", stats.stalltime, "ms, longest gap ", stats.longestgap,
+               "ms");
+      log_info(__func__, ": device completed ", stats.transfers, " transfers, mean jitter ",
+               stats.jitter, "us");
+
+      // Report if the device was not able to deliver all of the data
+      if (stats.droppedtransfers > 0)
+        log_warning(__func__, ": device data was lost for an estimated ", stats.droppedtransfers,
+                    " transfer(s); consider a more robust streaming profile");
+
+      // Report on the raw I/Q sample capture, if it was enabled
+      if ((stats.capturedbytes > 0) || (stats.capturedropped > 0))
+        log_info(__func__, ": captured ", stats.capturedbytes, " bytes to disk, ",
+                 stats.capturedropped, " bytes were dropped");
+
+      // Report if the stream was not able to keep up with the incoming data
+      if (m_pvrstream->overruns() > 0)
+        log_warning(__func__, ": stream data was dropped ", m_pvrstream->overruns(),
+                    " time(s) due to queue overruns");
+    }
+
     m_pvrstream.reset();
+
+    // Keep the stream pipeline running for the grace period so that the next stream opened
+    // against the same device, frequency and modulation can reuse it without resynchronizing
+    int const graceperiod = std::max(copy_settings().device_stream_cache_period, 0);
+    if (m_streamcache.detach(static_cast<uint32_t>(graceperiod) * 1000))
+      log_info(__func__, ": keeping stream pipeline for ", graceperiod, " seconds");
   }
   catch (std::exception& ex)
   {
@@ -1988,6 +2526,7 @@ DEMUX_PACKET* addon::DemuxRead(void)
                                      ex.what());
 
     m_pvrstream.reset(); // Close the stream
+    m_streamcache.clear(); // Release the stream pipeline
     return nullptr; // Return a null demultiplexer packet
   }
 
@@ -2440,6 +2979,45 @@ PVR_ERROR addon::GetStreamProperties(std::vector<kodi::addon::PVRStreamPropertie
   return PVR_ERROR::PVR_ERROR_NO_ERROR;
 }
 
+//-----------------------------------------------------------------------------
+// addon::GetStreamTimes (CInstancePVRClient)
+//
+// Get the stream times of the stream that's currently being read
+//
+// Arguments:
+//
+//	times			- Stream times to be set
+
+PVR_ERROR addon::GetStreamTimes(kodi::addon::PVRStreamTimes& times)
+{
+  // Prevent race condition with functions that modify m_pvrstream
+  std::unique_lock<std::mutex> lock(m_pvrstream_lock);
+
+  try
+  {
+
+    struct streamtimes streamtimes = {};
+    if ((!m_pvrstream) || (!m_pvrstream->streamtimes(streamtimes)))
+      return PVR_ERROR::PVR_ERROR_NOT_IMPLEMENTED;
+
+    times.SetStartTime(0);
+    times.SetPTSStart(static_cast<int64_t>(streamtimes.ptsstart));
+    times.SetPTSBegin(static_cast<int64_t>(streamtimes.ptsbegin));
+    times.SetPTSEnd(static_cast<int64_t>(streamtimes.ptsend));
+  }
+
+  catch (std::exception& ex)
+  {
+    return handle_stdexception(__func__, ex, PVR_ERROR::PVR_ERROR_FAILED);
+  }
+  catch (...)
+  {
+    return handle_generalexception(__func__, PVR_ERROR::PVR_ERROR_FAILED);
+  }
+
+  return PVR_ERROR::PVR_ERROR_NO_ERROR;
+}
+
 //-----------------------------------------------------------------------------
 // addon::GetConnectionString (CInstancePVRClient)
 //
@@ -2590,6 +3168,9 @@ PVR_ERROR addon::OpenDialogChannelAdd(kodi::addon::PVRChannel const& /*channel*/
     return PVR_ERROR::PVR_ERROR_NO_ERROR;
   }
 
+  // Release any cached live stream pipeline, it may be holding the device open
+  m_streamcache.clear();
+
   try
   {
 
@@ -2670,6 +3251,9 @@ PVR_ERROR addon::OpenDialogChannelSettings(kodi::addon::PVRChannel const& channe
     return PVR_ERROR::PVR_ERROR_NO_ERROR;
   }
 
+  // Release any cached live stream pipeline, it may be holding the device open
+  m_streamcache.clear();
+
   // Create a copy of the current addon settings structure
   struct settings settings = copy_settings();
 
@@ -2755,6 +3339,21 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
       throw string_exception("channel ", channel.GetUniqueId(), " (",
                              channel.GetChannelName().c_str(), ") was not found in the database");
 
+    // Set up the device transfer buffers for the modulation
+    get_streaming_profile(settings.device_streaming_profile, channelprops.modulation, tunerprops);
+
+    // Pipelines are not cached when raw files have been registered; the file is selected when
+    // the device is created and the cache key can't tell one file from another
+    bool const cacheable = !has_rawfiles(connectionpool::handle(m_connpool));
+
+    // Reclaim the cached stream pipeline if it matches this device, frequency and modulation,
+    // otherwise it has to be released here so that the device can be opened again
+    struct streamcache::key const cachekey = get_streamcache_key(settings, channelprops);
+    if (!cacheable)
+      m_streamcache.clear();
+    else if (m_streamcache.acquire(cachekey))
+      log_info(__func__, ": Reclaiming cached stream pipeline");
+
     // FM Radio
     //
     if (channelprops.modulation == modulation::fm)
@@ -2763,16 +3362,23 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
       // Set up the FM digital signal processor properties
       struct fmprops fmprops = {};
       fmprops.decoderds = settings.fmradio_enable_rds;
+      fmprops.decimate = settings.fmradio_frontend_decimation;
       fmprops.isnorthamerica = is_region_northamerica(settings);
       fmprops.samplerate = settings.fmradio_sample_rate;
       fmprops.downsamplequality = static_cast<int>(settings.fmradio_downsample_quality);
       fmprops.outputrate = settings.fmradio_output_samplerate;
       fmprops.outputgain = settings.fmradio_output_gain;
+      fmprops.outputlatency = static_cast<uint32_t>(settings.fmradio_output_latency);
+      fmprops.adaptivelatency = settings.fmradio_adaptive_latency;
+      fmprops.freerun = settings.timeshift_enable;
 
       // Log information about the stream for diagnostic purposes
       log_info(__func__, ": Creating fmstream for channel \"", channelprops.name, "\"");
       log_info(__func__, ": tunerprops.freqcorrection = ", tunerprops.freqcorrection, " PPM");
+      log_info(__func__, ": tunerprops.buffercount = ", tunerprops.buffercount);
+      log_info(__func__, ": tunerprops.bufferlength = ", tunerprops.bufferlength, " bytes");
       log_info(__func__, ": fmprops.decoderds = ", (fmprops.decoderds) ? "true" : "false");
+      log_info(__func__, ": fmprops.decimate = ", (fmprops.decimate) ? "true" : "false");
       log_info(__func__,
                ": fmprops.isnorthamerica = ", (fmprops.isnorthamerica) ? "true" : "false");
       log_info(__func__, ": fmrops.samplerate = ", fmprops.samplerate, " Hz");
@@ -2780,6 +3386,10 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
                downsample_quality_to_string(
                    static_cast<enum downsample_quality>(fmprops.downsamplequality)));
       log_info(__func__, ": fmprops.outputgain = ", fmprops.outputgain, " dB");
+      log_info(__func__, ": fmprops.outputlatency = ", fmprops.outputlatency, " ms");
+      log_info(__func__, ": fmprops.adaptivelatency = ",
+               (fmprops.adaptivelatency) ? "true" : "false");
+      log_info(__func__, ": fmprops.freerun = ", (fmprops.freerun) ? "true" : "false");
       log_info(__func__, ": fmprops.outputrate = ", fmprops.outputrate, " Hz");
       log_info(__func__, ": channelprops.frequency = ", channelprops.frequency, " Hz");
       log_info(__func__, ": channelprops.autogain = ", (channelprops.autogain) ? "true" : "false");
@@ -2787,7 +3397,8 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
       log_info(__func__, ": channelprops.freqcorrection = ", channelprops.freqcorrection, " PPM");
 
       // Create the FM Radio stream
-      m_pvrstream = fmstream::create(create_device(settings), tunerprops, channelprops, fmprops);
+      m_pvrstream =
+          fmstream::create(create_stream_device(settings), tunerprops, channelprops, fmprops);
     }
 
     // HD Radio
@@ -2798,20 +3409,48 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
       // Set up the HD Radio digital signal processor properties
       struct hdprops hdprops = {};
       hdprops.outputgain = settings.hdradio_output_gain;
+      hdprops.outputlatency = static_cast<uint32_t>(settings.hdradio_output_latency);
+      hdprops.adaptivelatency = settings.hdradio_adaptive_latency;
+      hdprops.freerun = settings.timeshift_enable;
 
       // Log information about the stream for diagnostic purposes
       log_info(__func__, ": Creating hdstream for channel \"", channelprops.name, "\"");
       log_info(__func__, ": subchannel = ", channelid.subchannel());
       log_info(__func__, ": tunerprops.freqcorrection = ", tunerprops.freqcorrection, " PPM");
+      log_info(__func__, ": tunerprops.buffercount = ", tunerprops.buffercount);
+      log_info(__func__, ": tunerprops.bufferlength = ", tunerprops.bufferlength, " bytes");
       log_info(__func__, ": hdprops.outputgain = ", hdprops.outputgain, " dB");
+      log_info(__func__, ": hdprops.outputlatency = ", hdprops.outputlatency, " ms");
+      log_info(__func__, ": hdprops.adaptivelatency = ",
+               (hdprops.adaptivelatency) ? "true" : "false");
+      log_info(__func__, ": hdprops.freerun = ", (hdprops.freerun) ? "true" : "false");
       log_info(__func__, ": channelprops.frequency = ", channelprops.frequency, " Hz");
       log_info(__func__, ": channelprops.autogain = ", (channelprops.autogain) ? "true" : "false");
       log_info(__func__, ": channelprops.manualgain = ", channelprops.manualgain / 10, " dB");
       log_info(__func__, ": channelprops.freqcorrection = ", channelprops.freqcorrection, " PPM");
 
-      // Create the HD Radio stream
-      m_pvrstream = hdstream::create(create_device(settings), tunerprops, channelprops, hdprops,
-                                     channelid.subchannel());
+      // HD Radio streams subscribe to a shared station; if there is already an active station
+      // tuned to the same frequency it will be reused rather than creating a new one
+      std::shared_ptr<hdstation> station = m_hdstation.lock();
+      if ((!station) || (station->stopped()) || (station->frequency() != channelprops.frequency))
+      {
+
+        // Drop the reference to a stopped station before the device is opened again, along
+        // with the cached pipeline, otherwise the stopped station still holds the device
+        station.reset();
+        m_streamcache.clear();
+
+        station = hdstation::create(create_stream_device(settings), tunerprops, channelprops);
+        m_hdstation = station;
+      }
+      else
+        log_info(__func__, ": Sharing active HD Radio station (", station->subscribers(),
+                 " subscriber(s))");
+
+      // Create the HD Radio stream and attach the station to the stream cache
+      m_pvrstream = hdstream::create(station, hdprops, channelid.subchannel());
+      if (cacheable)
+        m_streamcache.attach(cachekey, station);
     }
 
     // DAB
@@ -2824,22 +3463,56 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
       dabprops.outputgain = settings.dabradio_output_gain;
       dabprops.coarse_corrector = settings.dabradio_coarse_corrector;
       dabprops.coarse_corrector_type = settings.dabradio_coarse_corrector_type;
+      dabprops.passthrough = settings.dabradio_passthrough;
+      dabprops.outputlatency = static_cast<uint32_t>(settings.dabradio_output_latency);
+      dabprops.adaptivelatency = settings.dabradio_adaptive_latency;
+      dabprops.freerun = settings.timeshift_enable;
 
       // Log information about the stream for diagnostic purposes
       log_info(__func__, ": Creating dabstream for channel \"", channelprops.name, "\"");
       log_info(__func__, ": subchannel = ", channelid.subchannel());
       log_info(__func__, ": tunerprops.freqcorrection = ", tunerprops.freqcorrection, " PPM");
+      log_info(__func__, ": tunerprops.buffercount = ", tunerprops.buffercount);
+      log_info(__func__, ": tunerprops.bufferlength = ", tunerprops.bufferlength, " bytes");
       log_info(__func__, ": dabrops.outputgain = ", dabprops.outputgain, " dB");
       log_info(__func__, ": dabrops.coarse_corrector = ", dabprops.coarse_corrector);
       log_info(__func__, ": dabrops.coarse_corrector_type = ", dabprops.coarse_corrector_type);
+      log_info(__func__, ": dabrops.passthrough = ", dabprops.passthrough);
+      log_info(__func__, ": dabrops.outputlatency = ", dabprops.outputlatency, " ms");
+      log_info(__func__, ": dabrops.adaptivelatency = ",
+               (dabprops.adaptivelatency) ? "true" : "false");
+      log_info(__func__, ": dabprops.freerun = ", (dabprops.freerun) ? "true" : "false");
       log_info(__func__, ": channelprops.frequency = ", channelprops.frequency, " Hz");
       log_info(__func__, ": channelprops.autogain = ", (channelprops.autogain) ? "true" : "false");
       log_info(__func__, ": channelprops.manualgain = ", channelprops.manualgain / 10, " dB");
       log_info(__func__, ": channelprops.freqcorrection = ", channelprops.freqcorrection, " PPM");
 
-      // Create the DAB stream
-      m_pvrstream = dabstream::create(create_device(settings), tunerprops, channelprops, dabprops,
-                                      channelid.subchannel());
+      // DAB streams subscribe to a shared ensemble; if there is already an active ensemble
+      // tuned to the same frequency with the same audio output it will be reused rather
+      // than creating a new one
+      std::shared_ptr<dabensemble> ensemble = m_dabensemble.lock();
+      if ((!ensemble) || (ensemble->stopped()) ||
+          (ensemble->frequency() != channelprops.frequency) ||
+          (ensemble->passthrough() != dabprops.passthrough))
+      {
+
+        // Drop the reference to a stopped or mismatched ensemble before the device is opened
+        // again, along with the cached pipeline, otherwise that ensemble still holds the device
+        ensemble.reset();
+        m_streamcache.clear();
+
+        ensemble = dabensemble::create(create_stream_device(settings), tunerprops, channelprops,
+                                       dabprops);
+        m_dabensemble = ensemble;
+      }
+      else
+        log_info(__func__, ": Sharing active DAB ensemble (", ensemble->subscribers(),
+                 " subscriber(s))");
+
+      // Create the DAB stream and attach the ensemble to the stream cache
+      m_pvrstream = dabstream::create(ensemble, dabprops, channelid.subchannel());
+      if (cacheable)
+        m_streamcache.attach(cachekey, ensemble);
     }
 
     // Weather Radio
@@ -2849,15 +3522,26 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
 
       // Set up the FM digital signal processor properties
       struct wxprops wxprops = {};
+      wxprops.decimate = settings.wxradio_frontend_decimation;
       wxprops.samplerate = settings.wxradio_sample_rate;
       wxprops.outputrate = settings.wxradio_output_samplerate;
       wxprops.outputgain = settings.wxradio_output_gain;
+      wxprops.outputlatency = static_cast<uint32_t>(settings.wxradio_output_latency);
+      wxprops.adaptivelatency = settings.wxradio_adaptive_latency;
+      wxprops.freerun = settings.timeshift_enable;
 
       // Log information about the stream for diagnostic purposes
       log_info(__func__, ": Creating wxstream for channel \"", channelprops.name, "\"");
       log_info(__func__, ": tunerprops.freqcorrection = ", tunerprops.freqcorrection, " PPM");
+      log_info(__func__, ": tunerprops.buffercount = ", tunerprops.buffercount);
+      log_info(__func__, ": tunerprops.bufferlength = ", tunerprops.bufferlength, " bytes");
+      log_info(__func__, ": wxprops.decimate = ", (wxprops.decimate) ? "true" : "false");
       log_info(__func__, ": wxprops.samplerate = ", wxprops.samplerate, " Hz");
       log_info(__func__, ": wxprops.outputgain = ", wxprops.outputgain, " dB");
+      log_info(__func__, ": wxprops.outputlatency = ", wxprops.outputlatency, " ms");
+      log_info(__func__, ": wxprops.adaptivelatency = ",
+               (wxprops.adaptivelatency) ? "true" : "false");
+      log_info(__func__, ": wxprops.freerun = ", (wxprops.freerun) ? "true" : "false");
       log_info(__func__, ": wxprops.outputrate = ", wxprops.outputrate, " Hz");
       log_info(__func__, ": channelprops.frequency = ", channelprops.frequency, " Hz");
       log_info(__func__, ": channelprops.autogain = ", (channelprops.autogain) ? "true" : "false");
@@ -2865,18 +3549,35 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
       log_info(__func__, ": channelprops.freqcorrection = ", channelprops.freqcorrection, " PPM");
 
       // Create the Weather Radio stream
-      m_pvrstream = wxstream::create(create_device(settings), tunerprops, channelprops, wxprops);
+      m_pvrstream =
+          wxstream::create(create_stream_device(settings), tunerprops, channelprops, wxprops);
     }
 
     else
       throw string_exception("channel ", channel.GetUniqueId(), " (",
                              channel.GetChannelName().c_str(), ") has an unknown modulation type");
+
+    // Wrap the stream in a timeshift buffer if the option has been enabled; the buffer file
+    // is created in the temporary folder unless a different folder has been specified
+    if (settings.timeshift_enable)
+    {
+
+      std::string folder = kodi::vfs::TranslateSpecialProtocol(
+          (settings.timeshift_folder.empty()) ? "special://temp/" : settings.timeshift_folder);
+      uint64_t capacity = static_cast<uint64_t>(std::max(settings.timeshift_buffer_size, 16)) MiB;
+
+      log_info(__func__, ": Creating timeshift buffer (", capacity, " bytes) in folder ",
+               folder.c_str());
+
+      m_pvrstream = timeshiftstream::create(std::move(m_pvrstream), folder.c_str(), capacity);
+    }
   }
 
   // Queue a notification for the user when a live stream cannot be opened, don't just silently log it
   catch (std::exception& ex)
   {
 
+    m_streamcache.clear(); // Release the stream pipeline
     kodi::QueueFormattedNotification(QueueMsg::QUEUE_ERROR, "Live Stream creation failed (%s).",
                                      ex.what());
     return handle_stdexception(__func__, ex, false);
@@ -2884,6 +3585,7 @@ bool addon::OpenLiveStream(kodi::addon::PVRChannel const& channel)
 
   catch (...)
   {
+    m_streamcache.clear(); // Release the stream pipeline
     return handle_generalexception(__func__, false);
   }
 
@@ -2961,6 +3663,36 @@ int64_t addon::SeekLiveStream(int64_t position, int whence)
   }
 }
 
+//-----------------------------------------------------------------------------
+// addon::SeekTime (CInstancePVRClient)
+//
+// Seek to a specific time in a stream on a backend that supports timeshifting
+//
+// Arguments:
+//
+//	time		- Time to seek to, in milliseconds
+//	backwards	- Flag indicating a backwards seek
+//	startpts	- On success, receives the PTS of the first packet after the seek
+
+bool addon::SeekTime(double time, bool backwards, double& startpts)
+{
+  // Prevent race condition with functions that modify m_pvrstream
+  std::unique_lock<std::mutex> lock(m_pvrstream_lock);
+
+  try
+  {
+    return (m_pvrstream) ? m_pvrstream->seektime(time, backwards, startpts) : false;
+  }
+  catch (std::exception& ex)
+  {
+    return handle_stdexception(__func__, ex, false);
+  }
+  catch (...)
+  {
+    return handle_generalexception(__func__, false);
+  }
+}
+
 //---------------------------------------------------------------------------
 
 #pragma warning(pop)
@@ -24,11 +24,14 @@
 #define __ADDON_H_
 #pragma once
 
+#include "dabensemble.h"
 #include "database.h"
+#include "hdstation.h"
 #include "props.h"
 #include "pvrstream.h"
 #include "pvrtypes.h"
 #include "rtldevice.h"
+#include "streamcache.h"
 
 #include <kodi/addon-instance/PVR.h>
 #include <memory>
@@ -76,6 +79,11 @@ public:
   // Call one of the settings related menu hooks
   PVR_ERROR CallSettingsMenuHook(kodi::addon::PVRMenuhook const& menuhook) override;
 
+  // CanPauseStream
+  //
+  // Check if the backend supports pausing the currently playing stream
+  bool CanPauseStream(void) override;
+
   // CanSeekStream
   //
   // Check if the backend supports seeking for the currently playing stream
@@ -177,6 +185,11 @@ public:
   // Get the stream properties of the stream that's currently being read
   PVR_ERROR GetStreamProperties(std::vector<kodi::addon::PVRStreamProperties>& properties) override;
 
+  // GetStreamTimes
+  //
+  // Get the stream times of the stream that's currently being read
+  PVR_ERROR GetStreamTimes(kodi::addon::PVRStreamTimes& times) override;
+
   // GetConnectionString
   //
   // Gets the connection string reported by the backend
@@ -227,6 +240,11 @@ public:
   // Seek in a live stream on a backend that supports timeshifting
   int64_t SeekLiveStream(int64_t position, int whence) override;
 
+  // SeekTime
+  //
+  // Seek to a specific time in a stream on a backend that supports timeshifting
+  bool SeekTime(double time, bool backwards, double& startpts) override;
+
 private:
   addon(addon const&) = delete;
   addon& operator=(addon const&) = delete;
@@ -249,6 +267,9 @@ private:
   // Device Helpers
   //
   std::unique_ptr<rtldevice> create_device(struct settings const& settings) const;
+  std::unique_ptr<rtldevice> create_stream_device(struct settings const& settings) const;
+  static struct streamcache::key get_streamcache_key(struct settings const& settings,
+                                                     struct channelprops const& channelprops);
 
   // Exception Helpers
   //
@@ -288,16 +309,23 @@ private:
   struct settings copy_settings(void) const;
   static std::string device_connection_to_string(enum device_connection connection);
   static std::string downsample_quality_to_string(enum downsample_quality quality);
+  static void get_streaming_profile(enum streaming_profile profile,
+                                    enum modulation modulation,
+                                    struct tunerprops& tunerprops);
   static std::string regioncode_to_string(enum regioncode code);
+  static std::string streaming_profile_to_string(enum streaming_profile profile);
 
   //-------------------------------------------------------------------------
   // Member Variables
 
   std::shared_ptr<connectionpool> m_connpool; // Database connection pool
+  std::weak_ptr<dabensemble> m_dabensemble; // Active DAB ensemble instance
+  std::weak_ptr<hdstation> m_hdstation; // Active HD Radio station instance
   std::unique_ptr<pvrstream> m_pvrstream; // Active PVR stream instance
   mutable std::mutex m_pvrstream_lock; // Synchronization object
   struct settings m_settings; // Custom addon settings
   mutable std::recursive_mutex m_settings_lock; // Synchronization object
+  mutable streamcache m_streamcache; // Cached live stream pipeline
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,577 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+
+#include "capturedevice.h"
+
+#include "exception_control/string_exception.h"
+#include "utils/align.h"
+#include "utils/value_size_defines.h"
+
+#include <algorithm>
+#include <string.h>
+#include <thread>
+#include <time.h>
+#include <type_traits>
+
+#ifdef _WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#pragma warning(push, 4)
+
+// capturedevice::BLOCK_ALIGNMENT (static)
+//
+// Alignment of the capture blocks in memory and in the file
+size_t const capturedevice::BLOCK_ALIGNMENT = 4 KiB;
+
+// capturedevice::BLOCK_COUNT (static)
+//
+// Number of capture blocks
+size_t const capturedevice::BLOCK_COUNT = 32;
+
+// capturedevice::BLOCK_SIZE (static)
+//
+// Size of each capture block
+size_t const capturedevice::BLOCK_SIZE = 1 MiB;
+
+//---------------------------------------------------------------------------
+// capturedevice Constructor (private)
+//
+// Arguments:
+//
+//	device		- Device instance to be wrapped
+//	folder		- Folder in which to create the capture files
+
+capturedevice::capturedevice(std::unique_ptr<rtldevice> device, char const* folder)
+  : m_device(std::move(device)), m_folder((folder != nullptr) ? folder : "")
+{
+  if (!m_device)
+    throw std::invalid_argument("device");
+  if (m_folder.empty())
+    throw std::invalid_argument("folder");
+
+  // Verify that the capture folder exists before any streaming takes place
+#ifdef _WINDOWS
+  DWORD attributes = GetFileAttributesA(m_folder.c_str());
+  if ((attributes == INVALID_FILE_ATTRIBUTES) || ((attributes & FILE_ATTRIBUTE_DIRECTORY) == 0))
+#else
+  struct stat folderstat = {};
+  if ((stat(m_folder.c_str(), &folderstat) != 0) || (!S_ISDIR(folderstat.st_mode)))
+#endif
+    throw string_exception(__func__, ": capture folder ", m_folder.c_str(), " does not exist");
+
+  // Allocate all of the capture blocks in one shot; BLOCK_ALIGNMENT additional bytes allow
+  // for the base address to be aligned up to meet the requirements of unbuffered file I/O
+  m_storage.reset(new uint8_t[(BLOCK_COUNT * BLOCK_SIZE) + BLOCK_ALIGNMENT]);
+  m_blocks = align::up(m_storage.get(), static_cast<unsigned int>(BLOCK_ALIGNMENT));
+}
+
+//---------------------------------------------------------------------------
+// capturedevice Destructor
+
+capturedevice::~capturedevice()
+{
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::begin_stream
+//
+// Starts streaming data from the device
+//
+// Arguments:
+//
+//	NONE
+
+void capturedevice::begin_stream(void) const
+{
+  m_device->begin_stream();
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::cancel_async
+//
+// Cancels any pending asynchronous read operations from the device
+//
+// Arguments:
+//
+//	NONE
+
+void capturedevice::cancel_async(void) const
+{
+  m_device->cancel_async();
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::close_file (private)
+//
+// Closes the capture file, truncating it to the specified length
+//
+// Arguments:
+//
+//	file		- Capture file handle
+//	length		- Actual length of the captured data
+
+bool capturedevice::close_file(file_t file, uint64_t length) const
+{
+  bool result = false; // Result from the truncation
+
+  // The final block was padded out to the alignment when it was written; cut the
+  // file back to the length of the data that was actually captured
+#ifdef _WINDOWS
+  LARGE_INTEGER position = {};
+  position.QuadPart = static_cast<LONGLONG>(length);
+  if (SetFilePointerEx(file, position, nullptr, FILE_BEGIN))
+    result = (SetEndOfFile(file) != FALSE);
+
+  CloseHandle(file);
+#else
+  result = (ftruncate(file, static_cast<off_t>(length)) == 0);
+  close(file);
+#endif
+
+  return result;
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::create (static)
+//
+// Factory method, creates a new capturedevice instance
+//
+// Arguments:
+//
+//	device		- Device instance to be wrapped
+//	folder		- Folder in which to create the capture files
+
+std::unique_ptr<capturedevice> capturedevice::create(std::unique_ptr<rtldevice> device,
+                                                     char const* folder)
+{
+  return std::unique_ptr<capturedevice>(new capturedevice(std::move(device), folder));
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::get_device_name
+//
+// Gets the name of the device
+//
+// Arguments:
+//
+//	NONE
+
+char const* capturedevice::get_device_name(void) const
+{
+  return m_device->get_device_name();
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::get_valid_gains
+//
+// Gets the valid tuner gain values for the device
+//
+// Arguments:
+//
+//	dbs			- vector<> to retrieve the valid gain values
+
+void capturedevice::get_valid_gains(std::vector<int>& dbs) const
+{
+  m_device->get_valid_gains(dbs);
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::get_statistics
+//
+// Gets the data transfer statistics for the device
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void capturedevice::get_statistics(struct device_statistics& stats) const
+{
+  m_device->get_statistics(stats);
+
+  stats.capturedbytes = m_capturedbytes.load(std::memory_order_relaxed);
+  stats.capturedropped = m_droppedbytes.load(std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::open_file (private)
+//
+// Creates a new capture file in the capture folder
+//
+// Arguments:
+//
+//	NONE
+
+capturedevice::file_t capturedevice::open_file(void) const
+{
+  time_t now = time(nullptr);
+  struct tm local = {};
+  char timestamp[32] = {'\0'};
+
+#ifdef _WINDOWS
+  localtime_s(&local, &now);
+#else
+  localtime_r(&now, &local);
+#endif
+  strftime(timestamp, std::extent<decltype(timestamp)>::value, "%Y%m%d-%H%M%S", &local);
+
+  // The file name carries the tuned frequency and the sample rate, which are needed
+  // to make sense of the raw samples when the file is played back later
+  std::string filename(m_folder);
+  if ((filename.back() != '/') && (filename.back() != '\\'))
+    filename.push_back('/');
+  filename.append("rtlradio-")
+      .append(timestamp)
+      .append("-")
+      .append(std::to_string(m_frequency))
+      .append("hz-")
+      .append(std::to_string(m_samplerate))
+      .append("sps.u8");
+
+#ifdef _WINDOWS
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_NEW,
+                            FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    throw string_exception(__func__, ": CreateFile() failed for ", filename.c_str());
+#else
+  int file = open(filename.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+  if (file == -1)
+    throw string_exception(__func__, ": open() failed for ", filename.c_str());
+
+  // Bypass the page cache if the file system supports it; the capture blocks are
+  // never read back and would otherwise push more useful data out of the cache
+#if defined(O_DIRECT)
+  int flags = fcntl(file, F_GETFL);
+  if (flags != -1)
+    fcntl(file, F_SETFL, flags | O_DIRECT);
+#elif defined(F_NOCACHE)
+  fcntl(file, F_NOCACHE, 1);
+#endif
+#endif
+
+  return file;
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::is_unpaced
+//
+// Determines if the device delivers data as fast as it can be consumed
+//
+// Arguments:
+//
+//	NONE
+
+bool capturedevice::is_unpaced(void) const
+{
+  return m_device->is_unpaced();
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::read
+//
+// Reads data from the device; synchronous reads are not captured
+//
+// Arguments:
+//
+//	buffer		- Buffer to receive the data
+//	count		- Size of the destination buffer, specified in bytes
+
+size_t capturedevice::read(uint8_t* buffer, size_t count) const
+{
+  return m_device->read(buffer, count);
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::read_async
+//
+// Asynchronously reads data from the device
+//
+// Arguments:
+//
+//	callback		- Asynchronous read callback function
+//	bufferlength	- Output buffer length in bytes
+//	buffercount		- Number of output buffers
+
+void capturedevice::read_async(rtldevice::asynccallback const& callback,
+                               uint32_t bufferlength,
+                               uint32_t buffercount) const
+{
+  // Reset the capture blocks; the writer thread isn't running so both ends of the queues
+  // can be safely manipulated from this thread
+  m_freeblocks.clear();
+  m_fullblocks.clear();
+  for (size_t index = 0; index < BLOCK_COUNT; index++)
+    m_freeblocks.push(m_blocks + (index * BLOCK_SIZE));
+
+  m_capturedbytes.store(0);
+  m_droppedbytes.store(0);
+  m_stopwriter.store(false);
+
+  // Create the capture file and start the writer thread
+  file_t file = open_file();
+  std::thread writerthread(&capturedevice::writer, this, file);
+
+  block_t current = {}; // Capture block being filled
+
+  // capturecallback (local)
+  //
+  // Copies the data into the capture blocks ahead of invoking the caller's callback
+  asynccallback capturecallback = [&](uint8_t const* buffer, size_t count) -> void
+  {
+    size_t offset = 0;
+    while (offset < count)
+    {
+
+      // If there are no free blocks the disk has fallen behind; rather than waiting for
+      // the writer thread the remaining data is left out of the file and counted
+      if ((current.data == nullptr) && (!m_freeblocks.try_pop(current.data)))
+      {
+
+        m_droppedbytes.fetch_add(count - offset, std::memory_order_relaxed);
+        break;
+      }
+
+      size_t const length = std::min(count - offset, BLOCK_SIZE - current.length);
+      memcpy(&current.data[current.length], &buffer[offset], length);
+      current.length += length;
+      offset += length;
+
+      // Hand a full block off to the writer thread; the queue can hold every block
+      if (current.length == BLOCK_SIZE)
+      {
+
+        m_fullblocks.push(std::move(current));
+        current = {};
+      }
+    }
+
+    callback(buffer, count);
+  };
+
+  // finish (local)
+  //
+  // Queues the final partial block and waits for the writer thread to finish
+  auto finish = [&]() -> void
+  {
+    if (current.length > 0)
+      m_fullblocks.push(std::move(current));
+
+    m_stopwriter.store(true);
+    m_fullblocks.notify();
+    writerthread.join();
+  };
+
+  try
+  {
+    m_device->read_async(capturecallback, bufferlength, buffercount);
+  }
+  catch (...)
+  {
+    finish();
+    throw;
+  }
+
+  finish();
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::set_automatic_gain_control
+//
+// Enables/disables the automatic gain control mode of the device
+//
+// Arguments:
+//
+//	enable		- Flag to enable/disable the automatic gain control
+
+void capturedevice::set_automatic_gain_control(bool enable) const
+{
+  m_device->set_automatic_gain_control(enable);
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::set_center_frequency
+//
+// Sets the center frequency of the device
+//
+// Arguments:
+//
+//	hz		- Frequency to set, specified in hertz
+
+uint32_t capturedevice::set_center_frequency(uint32_t hz) const
+{
+  m_frequency = m_device->set_center_frequency(hz);
+  return m_frequency;
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::set_frequency_correction
+//
+// Sets the frequency correction of the device
+//
+// Arguments:
+//
+//	ppm		- Frequency correction to set, specified in parts per million
+
+int capturedevice::set_frequency_correction(int ppm) const
+{
+  return m_device->set_frequency_correction(ppm);
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::set_gain
+//
+// Sets the gain value of the device
+//
+// Arguments:
+//
+//	db			- Gain to set, specified in tenths of a decibel
+
+int capturedevice::set_gain(int db) const
+{
+  return m_device->set_gain(db);
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::set_sample_rate
+//
+// Sets the sample rate of the device
+//
+// Arguments:
+//
+//	hz			- Sample rate to set, specified in hertz
+
+uint32_t capturedevice::set_sample_rate(uint32_t hz) const
+{
+  m_samplerate = m_device->set_sample_rate(hz);
+  return m_samplerate;
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::set_test_mode
+//
+// Enables/disables the test mode of the device
+//
+// Arguments:
+//
+//	enable		- Flag to enable/disable the test mode
+
+void capturedevice::set_test_mode(bool enable) const
+{
+  m_device->set_test_mode(enable);
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::write_file (private)
+//
+// Writes an aligned block of data to the capture file
+//
+// Arguments:
+//
+//	file		- Capture file handle
+//	data		- Block data to be written
+//	length		- Length of the block data
+
+bool capturedevice::write_file(file_t file, uint8_t const* data, size_t length) const
+{
+  while (length > 0)
+  {
+
+#ifdef _WINDOWS
+    DWORD written = 0;
+    if (!WriteFile(file, data, static_cast<DWORD>(length), &written, nullptr) || (written == 0))
+      return false;
+#else
+    ssize_t written = write(file, data, length);
+    if (written <= 0)
+      return false;
+#endif
+
+    data += written;
+    length -= static_cast<size_t>(written);
+  }
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// capturedevice::writer (private)
+//
+// Capture file writer thread procedure
+//
+// Arguments:
+//
+//	file		- Capture file handle
+
+void capturedevice::writer(file_t file) const
+{
+  uint64_t written = 0; // Length of the data written to the file
+  bool failed = false; // Flag indicating that a write has failed
+
+  while (true)
+  {
+
+    // Wait for a full block to be queued or for the stop flag to be set; the stop flag is set
+    // after the final block has been queued so the queue is drained before the thread exits
+    block_t block = {};
+    m_fullblocks.wait([&]() -> bool { return m_stopwriter.load(); });
+    if (!m_fullblocks.try_pop(block))
+    {
+
+      if (m_stopwriter.load())
+        break;
+      continue;
+    }
+
+    // Only the final block can be partial; unbuffered writes must be a multiple of the
+    // alignment so it is padded out with zeros and the file is truncated when closed
+    size_t const length = align::up(block.length, static_cast<unsigned int>(BLOCK_ALIGNMENT));
+    memset(&block.data[block.length], 0, length - block.length);
+
+    // Once a write has failed (disk full, for example) nothing more is written to the
+    // file, but the blocks continue to be recycled so that streaming is not affected
+    if (!failed)
+      failed = !write_file(file, block.data, length);
+
+    if (failed)
+      m_droppedbytes.fetch_add(block.length, std::memory_order_relaxed);
+    else
+    {
+
+      written += block.length;
+      m_capturedbytes.fetch_add(block.length, std::memory_order_relaxed);
+    }
+
+    m_freeblocks.push(std::move(block.data));
+  }
+
+  // If the file could not be truncated the padding is left at the end, which is harmless
+  close_file(file, written);
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
@@ -0,0 +1,229 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+
+#ifndef __CAPTUREDEVICE_H_
+#define __CAPTUREDEVICE_H_
+#pragma once
+
+#include "rtldevice.h"
+#include "utils/spsc_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class capturedevice
+//
+// Implements a device that wraps another device and writes a copy of the raw
+// I/Q samples delivered by read_async() to a file.  The samples are copied
+// into a fixed set of large aligned blocks that are written by a background
+// thread; if the disk falls behind and no free block is available, samples
+// are left out of the file rather than holding up the caller
+
+class capturedevice : public rtldevice
+{
+public:
+  // Destructor
+  //
+  virtual ~capturedevice();
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // begin_stream
+  //
+  // Starts streaming data from the device
+  void begin_stream(void) const override;
+
+  // cancel_async
+  //
+  // Cancels any pending asynchronous read operations from the device
+  void cancel_async(void) const override;
+
+  // create (static)
+  //
+  // Factory method, creates a new capturedevice instance
+  static std::unique_ptr<capturedevice> create(std::unique_ptr<rtldevice> device,
+                                               char const* folder);
+
+  // get_device_name
+  //
+  // Gets the name of the device
+  char const* get_device_name(void) const override;
+
+  // get_valid_gains
+  //
+  // Gets the valid tuner gain values for the device
+  void get_valid_gains(std::vector<int>& dbs) const override;
+
+  // get_statistics
+  //
+  // Gets the data transfer statistics for the device
+  void get_statistics(struct device_statistics& stats) const override;
+
+  // is_unpaced
+  //
+  // Determines if the device delivers data as fast as it can be consumed
+  bool is_unpaced(void) const override;
+
+  // read
+  //
+  // Reads data from the device
+  size_t read(uint8_t* buffer, size_t count) const override;
+
+  // read_async
+  //
+  // Asynchronously reads data from the device
+  void read_async(rtldevice::asynccallback const& callback,
+                  uint32_t bufferlength,
+                  uint32_t buffercount) const override;
+
+  // set_automatic_gain_control
+  //
+  // Enables/disables the automatic gain control of the device
+  void set_automatic_gain_control(bool enable) const override;
+
+  // set_center_frequency
+  //
+  // Sets the center frequency of the device
+  uint32_t set_center_frequency(uint32_t hz) const override;
+
+  // set_frequency_correction
+  //
+  // Sets the frequency correction of the device
+  int set_frequency_correction(int ppm) const override;
+
+  // set_gain
+  //
+  // Sets the gain value of the device
+  int set_gain(int db) const override;
+
+  // set_sample_rate
+  //
+  // Sets the sample rate of the device
+  uint32_t set_sample_rate(uint32_t hz) const override;
+
+  // set_test_mode
+  //
+  // Enables/disables the test mode of the device
+  void set_test_mode(bool enable) const override;
+
+private:
+  capturedevice(capturedevice const&) = delete;
+  capturedevice& operator=(capturedevice const&) = delete;
+
+  // BLOCK_ALIGNMENT
+  //
+  // Alignment of the capture blocks in memory and in the file
+  static size_t const BLOCK_ALIGNMENT;
+
+  // BLOCK_COUNT
+  //
+  // Number of capture blocks
+  static size_t const BLOCK_COUNT;
+
+  // BLOCK_SIZE
+  //
+  // Size of each capture block
+  static size_t const BLOCK_SIZE;
+
+  // Instance Constructor
+  //
+  capturedevice(std::unique_ptr<rtldevice> device, char const* folder);
+
+  //-----------------------------------------------------------------------
+  // Private Type Declarations
+
+  // block_t
+  //
+  // Capture block queued to the writer thread
+  struct block_t
+  {
+
+    uint8_t* data; // Block data
+    size_t length; // Length of the block data
+  };
+
+  // file_t
+  //
+  // Capture file handle type
+#ifdef _WINDOWS
+  using file_t = void*;
+#else
+  using file_t = int;
+#endif
+
+  //-----------------------------------------------------------------------
+  // Private Member Functions
+
+  // close_file
+  //
+  // Closes the capture file, truncating it to the specified length
+  bool close_file(file_t file, uint64_t length) const;
+
+  // open_file
+  //
+  // Creates a new capture file in the capture folder
+  file_t open_file(void) const;
+
+  // write_file
+  //
+  // Writes an aligned block of data to the capture file
+  bool write_file(file_t file, uint8_t const* data, size_t length) const;
+
+  // writer
+  //
+  // Capture file writer thread procedure
+  void writer(file_t file) const;
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  std::unique_ptr<rtldevice> const m_device; // Wrapped device instance
+  std::string const m_folder; // Capture folder
+  mutable uint32_t m_frequency = 0; // Current center frequency
+  mutable uint32_t m_samplerate = 0; // Current sample rate
+
+  // CAPTURE BLOCKS
+  //
+  std::unique_ptr<uint8_t[]> m_storage; // Capture block storage
+  uint8_t* m_blocks = nullptr; // Aligned capture blocks
+  mutable spsc_queue<uint8_t*> m_freeblocks{BLOCK_COUNT}; // Blocks available to fill
+  mutable spsc_queue<block_t> m_fullblocks{BLOCK_COUNT}; // Blocks waiting to be written
+  mutable std::atomic<bool> m_stopwriter{false}; // Flag to stop the writer thread
+
+  // STATISTICS
+  //
+  mutable std::atomic<uint64_t> m_capturedbytes{0}; // Bytes written to the file
+  mutable std::atomic<uint64_t> m_droppedbytes{0}; // Bytes left out of the file
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __CAPTUREDEVICE_H_
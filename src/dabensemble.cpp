@@ -0,0 +1,977 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "dabensemble.h"
+
+#include "exception_control/string_exception.h"
+#include "utils/value_size_defines.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#pragma warning(push, 4)
+
+// dabensemble::MIN_RING_BUFFER_SIZE
+//
+// Minimum input ring buffer size
+size_t const dabensemble::MIN_RING_BUFFER_SIZE = (1 MiB); // 256ms @ 2048000
+
+// dabensemble::SAMPLE_RATE
+//
+// Fixed device sample rate required for DAB
+uint32_t const dabensemble::SAMPLE_RATE = 2048000;
+
+//---------------------------------------------------------------------------
+// dabensemble Constructor (private)
+//
+// Arguments:
+//
+//	device			- RTL-SDR device instance
+//	tunerprops		- Tuner device properties
+//	channelprops	- Channel properties
+//	dabprops		- DAB digital signal processor properties
+
+dabensemble::dabensemble(std::unique_ptr<rtldevice> device,
+                         struct tunerprops const& tunerprops,
+                         struct channelprops const& channelprops,
+                         struct dabprops const& dabprops)
+  : m_device(std::move(device)),
+    m_buffercount(tunerprops.buffercount),
+    m_bufferlength(tunerprops.bufferlength),
+    m_frequency(channelprops.frequency),
+    m_passthrough(dabprops.passthrough),
+    m_unpaced(m_device->is_unpaced()),
+    m_ringbuffer(static_cast<uint32_t>(ringbuffersize(dabprops.outputlatency)))
+{
+  // Initialize the RTL-SDR device instance
+  m_device->set_frequency_correction(tunerprops.freqcorrection + channelprops.freqcorrection);
+  m_device->set_sample_rate(SAMPLE_RATE);
+  m_device->set_center_frequency(channelprops.frequency);
+
+  // Adjust the device gain as specified by the channel properties
+  m_device->set_automatic_gain_control(channelprops.autogain);
+  if (channelprops.autogain == false)
+    m_device->set_gain(channelprops.manualgain);
+
+  // Construct and initialize the demodulator instance
+  RadioControllerInterface& controllerinterface = *static_cast<RadioControllerInterface*>(this);
+  InputInterface& inputinterface = *static_cast<InputInterface*>(this);
+  RadioReceiverOptions options = {};
+  options.disableCoarseCorrector = !dabprops.coarse_corrector;
+  options.freqsyncMethod = static_cast<FreqsyncMethod>(dabprops.coarse_corrector_type);
+  m_receiver = make_aligned<RadioReceiver>(controllerinterface, inputinterface, options, 1);
+
+  // Create the worker thread
+  scalar_condition<bool> started{false};
+  m_worker = std::thread(&dabensemble::worker, this, std::ref(started));
+  started.wait_until_equals(true);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble Destructor
+
+dabensemble::~dabensemble()
+{
+  close();
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::close
+//
+// Closes the ensemble
+//
+// Arguments:
+//
+//	NONE
+
+void dabensemble::close(void)
+{
+  m_stop = true; // Signal worker thread to stop
+
+  // Wake up the worker thread if it's waiting for ring buffer space
+  std::unique_lock<std::mutex> samplelock(m_samplelock);
+  m_spacecv.notify_all();
+  samplelock.unlock();
+
+  if (m_device)
+    m_device->cancel_async(); // Cancel any async read operations
+  if (m_worker.joinable())
+    m_worker.join(); // Wait for thread
+
+  if (m_receiver)
+    m_receiver->stop(); // Stop receiver
+  m_receiver.reset(); // Reset receiver instance
+
+  m_device.reset(); // Release RTL-SDR device
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::create (static)
+//
+// Factory method, creates a new dabensemble instance
+//
+// Arguments:
+//
+//	device			- RTL-SDR device instance
+//	tunerprops		- Tunder device properties
+//	channelprops	- Channel properties
+//	dabprops		- DAB digital signal processor properties
+
+std::shared_ptr<dabensemble> dabensemble::create(std::unique_ptr<rtldevice> device,
+                                                 struct tunerprops const& tunerprops,
+                                                 struct channelprops const& channelprops,
+                                                 struct dabprops const& dabprops)
+{
+  return std::shared_ptr<dabensemble>(
+      new dabensemble(std::move(device), tunerprops, channelprops, dabprops));
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::devicename
+//
+// Gets the device name associated with the ensemble
+//
+// Arguments:
+//
+//	NONE
+
+std::string dabensemble::devicename(void) const
+{
+  return std::string(m_device->get_device_name());
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::devicestatistics
+//
+// Gets the data transfer statistics for the device associated with the ensemble
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void dabensemble::devicestatistics(struct rtldevice::device_statistics& stats) const
+{
+  m_device->get_statistics(stats);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::frequency
+//
+// Gets the frequency of the ensemble
+//
+// Arguments:
+//
+//	NONE
+
+uint32_t dabensemble::frequency(void) const
+{
+  return m_frequency;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::passthrough
+//
+// Gets a flag indicating if the ensemble outputs undecoded audio
+//
+// Arguments:
+//
+//	NONE
+
+bool dabensemble::passthrough(void) const
+{
+  return m_passthrough;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::ringbuffersize (private, static)
+//
+// Calculates the input ring buffer size required to hold the specified latency
+//
+// Arguments:
+//
+//	latency		- Latency to hold in the ring buffer, in milliseconds
+
+size_t dabensemble::ringbuffersize(uint32_t latency)
+{
+  // The ring buffer holds 8-bit I/Q samples and must be a power of two in length
+  size_t const required = (static_cast<size_t>(SAMPLE_RATE) * 2 * latency) / 1000;
+
+  size_t size = MIN_RING_BUFFER_SIZE;
+  while (size < required)
+    size <<= 1;
+
+  return size;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::startdecoding (private)
+//
+// Begins decoding any subscribed subchannels that are present in the ensemble
+//
+// Arguments:
+//
+//	NONE
+
+void dabensemble::startdecoding(void)
+{
+  assert(m_receiver);
+
+  // m_subchannelslock must be held by the caller
+  for (auto& iterator : m_subchannels)
+  {
+
+    subchannel_handler& subchannel = *iterator.second;
+    if (subchannel.decoding)
+      continue; // Subchannel is already being decoded
+
+    // Determine if the subchannel is now present in the decoded services
+    for (auto const& service : m_receiver->getServiceList())
+    {
+      for (auto const& component : m_receiver->getComponents(service))
+      {
+
+        if ((!subchannel.decoding) &&
+            (component.subchannelId == static_cast<int16_t>(iterator.first)))
+        {
+
+          // The subchannel has been found; add it to the set of decoded subchannels
+          subchannel.decoding = m_receiver->addServiceToDecode(subchannel, {}, service);
+          if (subchannel.decoding)
+            subchannel.service = service;
+        }
+      }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::stopped
+//
+// Gets a flag indicating if the ensemble has stopped
+//
+// Arguments:
+//
+//	NONE
+
+bool dabensemble::stopped(void) const
+{
+  return m_stopped.load();
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subscribe
+//
+// Adds a subscriber to the decoded output of an ensemble subchannel
+//
+// Arguments:
+//
+//	subchannel	- DAB subchannel to decode
+//	handler		- Programme handler to receive the decoded output
+//	onstopped	- Callback to invoke when the ensemble has stopped
+
+void dabensemble::subscribe(uint32_t subchannel,
+                            ProgrammeHandlerInterface& handler,
+                            stopped_callback const& onstopped)
+{
+  std::unique_lock<std::mutex> lock(m_subchannelslock);
+
+  // If the ensemble has already stopped, invoke the callback immediately
+  if (m_stopped.load())
+  {
+
+    onstopped(m_worker_exception);
+    return;
+  }
+
+  // Add the subscriber to the fan-out handler for the subchannel, creating it as necessary
+  std::unique_ptr<subchannel_handler>& subchannelhandler = m_subchannels[subchannel];
+  if (!subchannelhandler)
+    subchannelhandler = std::make_unique<subchannel_handler>(m_passthrough);
+  subchannelhandler->add(handler, onstopped);
+
+  // If the subchannel has already been detected it can be decoded right away, otherwise
+  // decoding will begin when the worker thread is notified of the service
+  startdecoding();
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subscribers
+//
+// Gets the number of active subscribers
+//
+// Arguments:
+//
+//	NONE
+
+size_t dabensemble::subscribers(void) const
+{
+  std::unique_lock<std::mutex> lock(m_subchannelslock);
+
+  size_t count = 0;
+  for (auto const& iterator : m_subchannels)
+    count += iterator.second->size();
+
+  return count;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::unpaced
+//
+// Gets a flag indicating if the ensemble input is delivered faster than real time
+//
+// Arguments:
+//
+//	NONE
+
+bool dabensemble::unpaced(void) const
+{
+  return m_unpaced;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::unsubscribe
+//
+// Removes a subscriber from the ensemble
+//
+// Arguments:
+//
+//	handler		- Programme handler that was subscribed
+
+void dabensemble::unsubscribe(ProgrammeHandlerInterface& handler)
+{
+  std::unique_lock<std::mutex> lock(m_subchannelslock);
+
+  for (auto iterator = m_subchannels.begin(); iterator != m_subchannels.end(); iterator++)
+  {
+
+    subchannel_handler& subchannel = *iterator->second;
+    if (!subchannel.remove(handler))
+      continue;
+
+    // When the last subscriber has been removed, stop decoding the subchannel; this will
+    // wait for the subchannel decoder to stop so the handler can be safely destroyed
+    if (subchannel.empty())
+    {
+
+      if ((subchannel.decoding) && (m_receiver))
+        m_receiver->removeServiceToDecode(subchannel.service);
+
+      m_subchannels.erase(iterator);
+    }
+
+    break;
+  }
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::worker (private)
+//
+// Worker thread procedure used to transfer and process data
+//
+// Arguments:
+//
+//	started		- Condition variable to set when thread has started
+
+void dabensemble::worker(scalar_condition<bool>& started)
+{
+  assert(m_device);
+  assert(m_receiver);
+
+  // read_callback_func (local)
+  //
+  // Asynchronous read callback function for the RTL-SDR device
+  auto read_callback_func = [&](uint8_t const* buffer, size_t count) -> void
+  {
+    // Trigger an InputFailure event if no data has been returned from the device
+    if (count == 0)
+      m_streamok.store(false);
+
+    // An unpaced device delivers data faster than the demodulator can process it; wait for
+    // the demodulator to make room in the ring buffer rather than overwriting unread data
+    assert(count <= std::numeric_limits<int32_t>::max());
+    if (m_unpaced)
+    {
+
+      std::unique_lock<std::mutex> lock(m_samplelock);
+      m_spacecv.wait(lock, [&]() -> bool {
+        return (m_stop.test(true)) ||
+               (m_ringbuffer.GetRingBufferWriteAvailable() >= static_cast<int32_t>(count));
+      });
+
+      if (m_stop.test(true))
+        return;
+    }
+
+    // Copy the input data into the ring buffer
+    m_ringbuffer.putDataIntoBuffer(buffer, static_cast<int32_t>(count));
+
+    // Wake up the demodulator if it's waiting for input samples
+    std::unique_lock<std::mutex> samplelock(m_samplelock);
+    m_samplecv.notify_all();
+    samplelock.unlock();
+
+    // Check for and process any new events
+    std::unique_lock<std::mutex> eventslock(m_eventslock);
+    if (m_events.empty() == false)
+    {
+
+      // The threading model is a bit weird here; the callback that queued a new
+      // event needs to be free to continue execution otherwise the DSP may deadlock
+      // while we process that event. Combat this by swapping the queue<> with a new
+      // one, release the lock, then go ahead and process each of the queued events
+
+      event_queue_t events; // Empty event queue<>
+      m_events.swap(events); // Swap with existing queue<>
+      eventslock.unlock(); // Release the queue<> lock
+
+      while (!events.empty())
+      {
+
+        eventid_t eventid = events.front(); // eventid_t
+        events.pop(); // Remove from queue<>
+
+        switch (eventid)
+        {
+
+          // InputFailure
+          //
+          // Something has gone wrong with the input stream
+          case eventid_t::InputFailure:
+
+            throw string_exception("Input Failure"); // TODO: message
+            break;
+
+          // ServiceDetected
+          //
+          // A new service has been detected
+          case eventid_t::ServiceDetected:
+
+            std::unique_lock<std::mutex> lock(m_subchannelslock);
+            startdecoding();
+            break;
+        }
+      }
+    }
+  };
+
+  // Begin streaming from the device via the receiver and inform the caller that the thread is running
+  m_receiver->restart(false);
+  started = true;
+
+  // Continuously read data from the device until cancel_async() has been called
+  // 40 KiB = ~1/100 of a second of data, unless the tuner properties specify otherwise
+  try
+  {
+    m_device->read_async(read_callback_func, (m_bufferlength > 0) ? m_bufferlength : 40 KiB,
+                         m_buffercount);
+  }
+  catch (...)
+  {
+    m_worker_exception = std::current_exception();
+  }
+
+  // Worker thread is now stopped; inform all of the subscribers
+  std::unique_lock<std::mutex> lock(m_subchannelslock);
+  m_stopped.store(true);
+  for (auto const& iterator : m_subchannels)
+    iterator.second->stopped(m_worker_exception);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::getSamples (InputInterface)
+//
+// Reads the specified number of samples from the input device
+//
+// Arguments:
+//
+//	buffer		- Buffer to receive the input samples
+//	size		- Number of samples to read
+
+int32_t dabensemble::getSamples(DSPCOMPLEX* buffer, int32_t size)
+{
+  void* region1 = nullptr; // First ring buffer read region
+  void* region2 = nullptr; // Second ring buffer read region
+  int32_t length1 = 0; // Length of the first read region
+  int32_t length2 = 0; // Length of the second read region
+
+  // Convert the data directly out of the ring buffer instead of copying it into a temporary
+  // buffer first; the data will be split into two regions if it wraps around the buffer
+  int32_t numbytes =
+      m_ringbuffer.GetRingBufferReadRegions(size * 2, &region1, &length1, &region2, &length2);
+  assert(((length1 % 2) == 0) && ((length2 % 2) == 0));
+
+  // Scale the input data from [0,255] to [-1,1] for the demodulator
+  m_converter.convert(reinterpret_cast<uint8_t const*>(region1), reinterpret_cast<float*>(buffer),
+                      length1 / 2);
+  if (length2 > 0)
+    m_converter.convert(reinterpret_cast<uint8_t const*>(region2),
+                        reinterpret_cast<float*>(buffer + (length1 / 2)), length2 / 2);
+
+  // Release the converted data from the ring buffer
+  m_ringbuffer.AdvanceRingBufferReadIndex(numbytes);
+
+  // Wake up the worker thread if it's waiting for ring buffer space
+  if (m_unpaced)
+  {
+
+    std::unique_lock<std::mutex> lock(m_samplelock);
+    m_spacecv.notify_all();
+  }
+
+  return numbytes / 2;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::getSamplesToRead (InputInterface)
+//
+// Gets the number of input samples that are available to read from input
+//
+// Arguments:
+//
+//	NONE
+
+int32_t dabensemble::getSamplesToRead(void)
+{
+  return m_ringbuffer.GetRingBufferReadAvailable() / 2;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::is_ok (InputInterface)
+//
+// Determines if the input is still "OK"
+//
+// Arguments:
+//
+//	NONE
+
+bool dabensemble::is_ok(void)
+{
+  return m_streamok.load();
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::restart (InputInterface)
+//
+// Restarts the input
+//
+// Arguments:
+//
+//	NONE
+
+bool dabensemble::restart(void)
+{
+  assert(m_device);
+
+  m_streamok.store(true);
+  m_device->begin_stream();
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::waitForSamples (InputInterface)
+//
+// Waits for the specified number of input samples to be available to read
+//
+// Arguments:
+//
+//	count		- Number of input samples required
+//	timeoutms	- Maximum amount of time to wait, in milliseconds
+
+int32_t dabensemble::waitForSamples(int32_t count, int32_t timeoutms)
+{
+  std::unique_lock<std::mutex> lock(m_samplelock);
+  m_samplecv.wait_for(lock, std::chrono::milliseconds(timeoutms), [&]() -> bool {
+    return ((getSamplesToRead() >= count) || (m_streamok.load() == false));
+  });
+
+  return getSamplesToRead();
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::onFrequencyCorrectorChange (RadioControllerInterface)
+//
+// Invoked when the frequency correction has been changed
+//
+// Arguments:
+//
+//	fine			- Fine frequency correction value
+//	coarse			- Coarse frequency correction value
+
+void dabensemble::onFrequencyCorrectorChange(int /*fine*/, int /*coarse*/)
+{
+  // TODO - This can be applied to the device real-time?
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::onInputFailure (RadioControllerInterface)
+//
+// Invoked when the receiver has shut down to an input failure
+//
+// Arguments:
+//
+//	NONE
+
+void dabensemble::onInputFailure(void)
+{
+  std::unique_lock<std::mutex> lock(m_eventslock);
+  m_events.emplace(eventid_t::InputFailure);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::onServiceDetected (RadioControllerInterface)
+//
+// Invoked when a new service was detected
+//
+// Arguments:
+//
+//	sId			- New service identifier
+
+void dabensemble::onServiceDetected(uint32_t /*sId*/)
+{
+  std::unique_lock<std::mutex> lock(m_eventslock);
+  m_events.emplace(eventid_t::ServiceDetected);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::onSetEnsembleLabel (RadioControllerInterface)
+//
+// Invoked when the ensemble label has changed
+//
+// Arguments:
+//
+//	label		- New ensemble label
+
+void dabensemble::onSetEnsembleLabel(DabLabel& /*label*/)
+{
+  //
+  // TODO: This can probably be used to automatically generate
+  // a channel group
+  //
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::onSNR (RadioControllerInterface)
+//
+// Invoked when the Signal-to-Nosie Radio has been calculated
+//
+// Arguments:
+//
+//	snr			- Signal-to-Noise Ratio, in dB
+
+void dabensemble::onSNR(float /*snr*/)
+{
+  //
+  // TODO: Figure out what an acceptable SNR is for DAB and provide
+  // the necessary event to change the signal quality metric
+  //
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::onSyncChange (RadioControllerInterface)
+//
+// Invoked when signal synchronization was acquired or lost
+//
+// Arguments:
+//
+//	isSync		- Synchronization flag
+
+void dabensemble::onSyncChange(bool /*isSync*/)
+{
+  //
+  // TODO: This might need to STREAMCHANGE, clear the demux queue,
+  // silence the audio, and maybe throw up a banner to the user
+  //
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler Constructor
+//
+// Arguments:
+//
+//	passthrough		- Flag to generate undecoded audio rather than PCM audio
+
+dabensemble::subchannel_handler::subchannel_handler(bool passthrough) : m_passthrough(passthrough)
+{
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::add
+//
+// Adds a subscriber to the subchannel
+//
+// Arguments:
+//
+//	handler		- Programme handler to receive the decoded output
+//	onstopped	- Callback to invoke when the ensemble has stopped
+
+void dabensemble::subchannel_handler::add(ProgrammeHandlerInterface& handler,
+                                          stopped_callback const& onstopped)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  m_subscribers.push_back({&handler, onstopped});
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::empty
+//
+// Determines if there are no subscribers to the subchannel
+//
+// Arguments:
+//
+//	NONE
+
+bool dabensemble::subchannel_handler::empty(void) const
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  return m_subscribers.empty();
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::remove
+//
+// Removes a subscriber from the subchannel
+//
+// Arguments:
+//
+//	handler		- Programme handler that was subscribed
+
+bool dabensemble::subchannel_handler::remove(ProgrammeHandlerInterface& handler)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+
+  auto found = std::find_if(m_subscribers.begin(), m_subscribers.end(),
+                            [&](subscriber_t const& item) -> bool
+                            { return item.handler == &handler; });
+  if (found == m_subscribers.end())
+    return false;
+
+  m_subscribers.erase(found);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::size
+//
+// Gets the number of subscribers to the subchannel
+//
+// Arguments:
+//
+//	NONE
+
+size_t dabensemble::subchannel_handler::size(void) const
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  return m_subscribers.size();
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::stopped
+//
+// Notifies all subscribers that the ensemble has stopped
+//
+// Arguments:
+//
+//	ex			- Exception that stopped the ensemble, or null
+
+void dabensemble::subchannel_handler::stopped(std::exception_ptr const& ex)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  for (auto const& subscriber : m_subscribers)
+    subscriber.onstopped(ex);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::onFrameErrors (ProgrammeHandlerInterface)
+//
+// Invoked when the number of frame errors has been calculated
+//
+// Arguments:
+//
+//	frameErrors		- Number of frame errors
+
+void dabensemble::subchannel_handler::onFrameErrors(int frameErrors)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  for (auto const& subscriber : m_subscribers)
+    subscriber.handler->onFrameErrors(frameErrors);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::onNewAudio (ProgrammeHandlerInterface)
+//
+// Invoked when a new packet of audio data has been decoded
+//
+// Arguments:
+//
+//	audioData		- vector<> of stereo PCM audio data
+//	sampleRate		- Sample rate of the audio data (subject to change)
+//	mode			- Information about the audio encoding
+
+void dabensemble::subchannel_handler::onNewAudio(std::vector<int16_t>&& audioData,
+                                                 int sampleRate,
+                                                 std::string const& mode)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+
+  // Each subscriber receives a copy of the audio data, except the last which can have
+  // the original moved into it; in the common case of one subscriber nothing is copied
+  for (size_t index = 0; index < m_subscribers.size(); index++)
+  {
+
+    if ((index + 1) == m_subscribers.size())
+      m_subscribers[index].handler->onNewAudio(std::move(audioData), sampleRate, mode);
+    else
+      m_subscribers[index].handler->onNewAudio(std::vector<int16_t>(audioData), sampleRate, mode);
+  }
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::wantsCompressedAudio (ProgrammeHandlerInterface)
+//
+// Indicates if undecoded audio should be generated instead of PCM audio
+//
+// Arguments:
+//
+//	NONE
+
+bool dabensemble::subchannel_handler::wantsCompressedAudio(void)
+{
+  return m_passthrough;
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::onNewCompressedAudio (ProgrammeHandlerInterface)
+//
+// Invoked when a new packet of undecoded audio data is available
+//
+// Arguments:
+//
+//	data			- vector<> of undecoded audio data
+//	durationMs		- Playback duration of the audio data in milliseconds
+//	format			- Format of the audio data ("mp2" or "aac")
+
+void dabensemble::subchannel_handler::onNewCompressedAudio(std::vector<uint8_t>&& data,
+                                                           size_t durationMs,
+                                                           std::string const& format)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+
+  // Each subscriber receives a copy of the audio data, except the last which can have
+  // the original moved into it; in the common case of one subscriber nothing is copied
+  for (size_t index = 0; index < m_subscribers.size(); index++)
+  {
+
+    if ((index + 1) == m_subscribers.size())
+      m_subscribers[index].handler->onNewCompressedAudio(std::move(data), durationMs, format);
+    else
+      m_subscribers[index].handler->onNewCompressedAudio(std::vector<uint8_t>(data), durationMs,
+                                                         format);
+  }
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::onRsErrors (ProgrammeHandlerInterface)
+//
+// Invoked when the Reed-Solomon decoding has completed
+//
+// Arguments:
+//
+//	uncorrectedErrors	- Flag if uncorrected errors were detected
+//	numCorrectedErrors	- Number of corrected errors
+
+void dabensemble::subchannel_handler::onRsErrors(bool uncorrectedErrors, int numCorrectedErrors)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  for (auto const& subscriber : m_subscribers)
+    subscriber.handler->onRsErrors(uncorrectedErrors, numCorrectedErrors);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::onAacErrors (ProgrammeHandlerInterface)
+//
+// Invoked when an AAC decoder error has occurred
+//
+// Arguments:
+//
+//	aacErrors		- Number of AAC decoder errors
+
+void dabensemble::subchannel_handler::onAacErrors(int aacErrors)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  for (auto const& subscriber : m_subscribers)
+    subscriber.handler->onAacErrors(aacErrors);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::onNewDynamicLabel (ProgrammeHandlerInterface)
+//
+// Invoked when a new dynamic label has been decoded
+//
+// Arguments:
+//
+//	label		- The new dynamic label (UTF-8)
+
+void dabensemble::subchannel_handler::onNewDynamicLabel(std::string const& label)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  for (auto const& subscriber : m_subscribers)
+    subscriber.handler->onNewDynamicLabel(label);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::onMOT (ProgrammeHandlerInterface)
+//
+// Invoked when a new slide has been decoded
+//
+// Arguments:
+//
+//	mot_file		- The new slide data
+
+void dabensemble::subchannel_handler::onMOT(mot_file_t const& mot_file)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  for (auto const& subscriber : m_subscribers)
+    subscriber.handler->onMOT(mot_file);
+}
+
+//---------------------------------------------------------------------------
+// dabensemble::subchannel_handler::onPADLengthError (ProgrammeHandlerInterface)
+//
+// Invoked when a PAD length mismatch has been detected
+//
+// Arguments:
+//
+//	announced_xpad_len	- Announced X-PAD length
+//	xpad_len			- Effective X-PAD length
+
+void dabensemble::subchannel_handler::onPADLengthError(size_t announced_xpad_len, size_t xpad_len)
+{
+  std::unique_lock<std::mutex> lock(m_lock);
+  for (auto const& subscriber : m_subscribers)
+    subscriber.handler->onPADLengthError(announced_xpad_len, xpad_len);
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
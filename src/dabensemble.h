@@ -0,0 +1,417 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __DABENSEMBLE_H_
+#define __DABENSEMBLE_H_
+#pragma once
+
+#include "dsp_dab/radio-receiver.h"
+#include "dsp_dab/ringbuffer.h"
+#include "props.h"
+#include "rtldevice.h"
+#include "utils/iqconverter.h"
+#include "utils/scalar_condition.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class dabensemble
+//
+// Implements a shared DAB ensemble receiver.  A single tuner device and a
+// single OFDM/FIC pipeline are maintained per tuned frequency; each of the
+// subchannels requested by the subscribers is decoded once from the MSC and
+// the decoded output is fanned out to every subscriber of that subchannel
+
+class dabensemble : private InputInterface, private RadioControllerInterface
+{
+public:
+  // Destructor
+  //
+  ~dabensemble();
+
+  //-----------------------------------------------------------------------
+  // Type Declarations
+
+  // stopped_callback
+  //
+  // Callback function invoked when the ensemble has stopped; the exception will be null if
+  // the ensemble was stopped normally
+  using stopped_callback = std::function<void(std::exception_ptr const& ex)>;
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // close
+  //
+  // Closes the ensemble
+  void close(void);
+
+  // create (static)
+  //
+  // Factory method, creates a new dabensemble instance
+  static std::shared_ptr<dabensemble> create(std::unique_ptr<rtldevice> device,
+                                             struct tunerprops const& tunerprops,
+                                             struct channelprops const& channelprops,
+                                             struct dabprops const& dabprops);
+
+  // devicename
+  //
+  // Gets the device name associated with the ensemble
+  std::string devicename(void) const;
+
+  // devicestatistics
+  //
+  // Gets the data transfer statistics for the device associated with the ensemble
+  void devicestatistics(struct rtldevice::device_statistics& stats) const;
+
+  // frequency
+  //
+  // Gets the frequency of the ensemble
+  uint32_t frequency(void) const;
+
+  // passthrough
+  //
+  // Gets a flag indicating if the ensemble outputs undecoded audio
+  bool passthrough(void) const;
+
+  // stopped
+  //
+  // Gets a flag indicating if the ensemble has stopped
+  bool stopped(void) const;
+
+  // subscribe
+  //
+  // Adds a subscriber to the decoded output of an ensemble subchannel
+  void subscribe(uint32_t subchannel,
+                 ProgrammeHandlerInterface& handler,
+                 stopped_callback const& onstopped);
+
+  // subscribers
+  //
+  // Gets the number of active subscribers
+  size_t subscribers(void) const;
+
+  // unpaced
+  //
+  // Gets a flag indicating if the ensemble input is delivered faster than real time
+  bool unpaced(void) const;
+
+  // unsubscribe
+  //
+  // Removes a subscriber from the ensemble
+  void unsubscribe(ProgrammeHandlerInterface& handler);
+
+private:
+  dabensemble(dabensemble const&) = delete;
+  dabensemble& operator=(dabensemble const&) = delete;
+
+  // MIN_RING_BUFFER_SIZE
+  //
+  // Minimum input ring buffer size
+  static size_t const MIN_RING_BUFFER_SIZE;
+
+  // SAMPLE_RATE
+  //
+  // Fixed device sample rate required for DAB
+  static uint32_t const SAMPLE_RATE;
+
+  // Instance Constructor
+  //
+  dabensemble(std::unique_ptr<rtldevice> device,
+              struct tunerprops const& tunerprops,
+              struct channelprops const& channelprops,
+              struct dabprops const& dabprops);
+
+  //-----------------------------------------------------------------------
+  // Private Type Declarations
+
+  // eventid_t
+  //
+  // Defines a worker thread event identifier
+  enum class eventid_t
+  {
+
+    InputFailure, // An input failure has occurred
+    ServiceDetected, // A new service has been detected
+  };
+
+  // event_queue_t
+  //
+  // Defines the type of the worker thread event queue
+  using event_queue_t = std::queue<eventid_t>;
+
+  // subscriber_t
+  //
+  // Defines a subchannel subscriber
+  struct subscriber_t
+  {
+
+    ProgrammeHandlerInterface* handler; // Subscriber programme handler
+    stopped_callback onstopped; // Subscriber stopped callback
+  };
+
+  // Class subchannel_handler
+  //
+  // Receives the decoded output of a single subchannel and fans it out to the subscribers
+  class subchannel_handler : public ProgrammeHandlerInterface
+  {
+  public:
+    // Instance Constructor
+    //
+    subchannel_handler(bool passthrough);
+
+    // Destructor
+    //
+    ~subchannel_handler() = default;
+
+    //---------------------------------------------------------------------
+    // Member Functions
+
+    // add
+    //
+    // Adds a subscriber to the subchannel
+    void add(ProgrammeHandlerInterface& handler, stopped_callback const& onstopped);
+
+    // empty
+    //
+    // Determines if there are no subscribers to the subchannel
+    bool empty(void) const;
+
+    // remove
+    //
+    // Removes a subscriber from the subchannel
+    bool remove(ProgrammeHandlerInterface& handler);
+
+    // size
+    //
+    // Gets the number of subscribers to the subchannel
+    size_t size(void) const;
+
+    // stopped
+    //
+    // Notifies all subscribers that the ensemble has stopped
+    void stopped(std::exception_ptr const& ex);
+
+    //---------------------------------------------------------------------
+    // ProgrammeHandlerInterface
+
+    // onFrameErrors
+    //
+    // Invoked when the number of frame errors has been calculated
+    void onFrameErrors(int frameErrors) override;
+
+    // onNewAudio
+    //
+    // Invoked when a new packet of audio data has been decoded
+    void onNewAudio(std::vector<int16_t>&& audioData,
+                    int sampleRate,
+                    const std::string& mode) override;
+
+    // wantsCompressedAudio
+    //
+    // Indicates if undecoded audio should be generated instead of PCM audio
+    bool wantsCompressedAudio(void) override;
+
+    // onNewCompressedAudio
+    //
+    // Invoked when a new packet of undecoded audio data is available
+    void onNewCompressedAudio(std::vector<uint8_t>&& data,
+                              size_t durationMs,
+                              const std::string& format) override;
+
+    // onRsErrors
+    //
+    // Invoked when the Reed-Solomon decoding has completed
+    void onRsErrors(bool uncorrectedErrors, int numCorrectedErrors) override;
+
+    // onAacErrors
+    //
+    // Invoked when an AAC decoder error has occurred
+    void onAacErrors(int aacErrors) override;
+
+    // onNewDynamicLabel
+    //
+    // Invoked when a new dynamic label has been decoded
+    void onNewDynamicLabel(const std::string& label) override;
+
+    // onMOT
+    //
+    // Invoked when a new slide has been decoded
+    void onMOT(const mot_file_t& mot_file) override;
+
+    // onPADLengthError
+    //
+    // Invoked when a PAD length mismatch has been detected
+    void onPADLengthError(size_t announced_xpad_len, size_t xpad_len) override;
+
+    //---------------------------------------------------------------------
+    // Member Variables
+
+    bool decoding{false}; // Flag if the subchannel is being decoded
+    Service service{0}; // Service being decoded for the subchannel
+
+  private:
+    subchannel_handler(subchannel_handler const&) = delete;
+    subchannel_handler& operator=(subchannel_handler const&) = delete;
+
+    //---------------------------------------------------------------------
+    // Member Variables
+
+    bool const m_passthrough; // Flag to generate undecoded audio
+    std::vector<subscriber_t> m_subscribers; // vector<> of subscribers
+    mutable std::mutex m_lock; // Synchronization object
+  };
+
+  // subchannel_map_t
+  //
+  // Defines the type of the subchannel handler map
+  using subchannel_map_t = std::map<uint32_t, std::unique_ptr<subchannel_handler>>;
+
+  //-----------------------------------------------------------------------
+  // Private Member Functions
+
+  // ringbuffersize (static)
+  //
+  // Calculates the input ring buffer size required to hold the specified latency
+  static size_t ringbuffersize(uint32_t latency);
+
+  // startdecoding
+  //
+  // Begins decoding any subscribed subchannels that are present in the ensemble
+  void startdecoding(void);
+
+  // worker
+  //
+  // Worker thread procedure used to transfer and process data
+  void worker(scalar_condition<bool>& started);
+
+  //-----------------------------------------------------------------------
+  // InputInterface Implementation
+
+  // getSamples
+  //
+  // Reads the specified number of samples from the input device
+  int32_t getSamples(DSPCOMPLEX* buffer, int32_t size) override;
+
+  // getSamplesToRead
+  //
+  // Gets the number of input samples that are available to read from input
+  int32_t getSamplesToRead(void) override;
+
+  // is_ok
+  //
+  // Determines if the input is still "OK"
+  bool is_ok(void) override;
+
+  // restart
+  //
+  // Restarts the input
+  bool restart(void) override;
+
+  // waitForSamples
+  //
+  // Waits for the specified number of input samples to be available to read
+  int32_t waitForSamples(int32_t count, int32_t timeoutms) override;
+
+  //-----------------------------------------------------------------------
+  // RadioControllerInterface
+
+  // onFrequencyCorrectorChange
+  //
+  // Invoked when the frequency correction has been changed
+  void onFrequencyCorrectorChange(int fine, int coarse) override;
+
+  // onInputFailure
+  //
+  // Invoked when the receiver has shut down to an input failure
+  void onInputFailure(void) override;
+
+  // onServiceDetected
+  //
+  // Invoked when a new service was detected
+  void onServiceDetected(uint32_t sId) override;
+
+  // onSetEnsembleLabel
+  //
+  // Invoked when the ensemble label has changed
+  void onSetEnsembleLabel(DabLabel& label) override;
+
+  // onSNR
+  //
+  // Invoked when the Signal-to-Nosie Radio has been calculated
+  void onSNR(float snr) override;
+
+  // onSyncChange
+  //
+  // Invoked when signal synchronization was acquired or lost
+  void onSyncChange(bool isSync) override;
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  std::unique_ptr<rtldevice> m_device; // RTL-SDR device instance
+  uint32_t const m_buffercount; // Device transfer buffer count
+  uint32_t const m_bufferlength; // Device transfer buffer length
+  uint32_t const m_frequency; // Ensemble frequency
+  bool const m_passthrough; // Flag to generate undecoded audio
+  bool const m_unpaced; // Flag to wait for ring buffer space
+  aligned_ptr<RadioReceiver> m_receiver; // RadioReceiver instance
+  RingBuffer<uint8_t> m_ringbuffer; // I/Q sample ring buffer
+  iqconverter m_converter{128.0f, 1.0f / 128.0f}; // I/Q sample converter
+  std::mutex m_samplelock; // Synchronization object
+  std::condition_variable m_samplecv; // Input samples condition variable
+  std::condition_variable m_spacecv; // Ring buffer space condition variable
+  std::atomic<bool> m_streamok{true}; // "OK" flag for the stream
+
+  // SUBSCRIBERS
+  //
+  subchannel_map_t m_subchannels; // map<> of subscribed subchannels
+  mutable std::mutex m_subchannelslock; // Synchronization object
+
+  // WORKER THREAD
+  //
+  std::thread m_worker; // Data transfer thread
+  std::exception_ptr m_worker_exception; // Exception on worker thread
+  scalar_condition<bool> m_stop{false}; // Condition to stop data transfer
+  std::atomic<bool> m_stopped{false}; // Data transfer stopped flag
+  event_queue_t m_events; // queue<> of worker events
+  mutable std::mutex m_eventslock; // Synchronization object
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __DABENSEMBLE_H_
@@ -118,6 +118,11 @@ void dabmuxscanner::inputsamples(uint8_t const* samples, size_t length)
   assert(length <= std::numeric_limits<int32_t>::max());
   m_ringbuffer.putDataIntoBuffer(samples, static_cast<int32_t>(length));
 
+  // Wake up the demodulator if it's waiting for input samples
+  std::unique_lock<std::mutex> samplelock(m_samplelock);
+  m_samplecv.notify_all();
+  samplelock.unlock();
+
   // Check for and process any new events
   std::unique_lock<std::mutex> eventslock(m_eventslock);
   if (m_events.empty() == false)
@@ -265,25 +270,28 @@ void dabmuxscanner::inputsamples(uint8_t const* samples, size_t length)
 
 int32_t dabmuxscanner::getSamples(DSPCOMPLEX* buffer, int32_t size)
 {
-  int32_t numsamples = 0; // Number of available samples in the buffer
-
-  // Allocate a temporary buffer to pull the data out of the ring buffer
-  std::unique_ptr<uint8_t[]> tempbuffer(new uint8_t[size * 2]);
+  void* region1 = nullptr; // First ring buffer read region
+  void* region2 = nullptr; // Second ring buffer read region
+  int32_t length1 = 0; // Length of the first read region
+  int32_t length2 = 0; // Length of the second read region
 
-  // Get the data from the ring buffer
-  numsamples = m_ringbuffer.getDataFromBuffer(tempbuffer.get(), size * 2);
+  // Convert the data directly out of the ring buffer instead of copying it into a temporary
+  // buffer first; the data will be split into two regions if it wraps around the buffer
+  int32_t numbytes =
+      m_ringbuffer.GetRingBufferReadRegions(size * 2, &region1, &length1, &region2, &length2);
+  assert(((length1 % 2) == 0) && ((length2 % 2) == 0));
 
   // Scale the input data from [0,255] to [-1,1] for the demodulator
-  for (int32_t index = 0; index < numsamples / 2; index++)
-  {
+  m_converter.convert(reinterpret_cast<uint8_t const*>(region1), reinterpret_cast<float*>(buffer),
+                      length1 / 2);
+  if (length2 > 0)
+    m_converter.convert(reinterpret_cast<uint8_t const*>(region2),
+                        reinterpret_cast<float*>(buffer + (length1 / 2)), length2 / 2);
 
-    buffer[index] =
-        DSPCOMPLEX((static_cast<float>(tempbuffer[index * 2]) - 128.0f) / 128.0f, // real
-                   (static_cast<float>(tempbuffer[(index * 2) + 1]) - 128.0f) / 128.0f // imaginary
-        );
-  }
+  // Release the converted data from the ring buffer
+  m_ringbuffer.AdvanceRingBufferReadIndex(numbytes);
 
-  return numsamples / 2;
+  return numbytes / 2;
 }
 
 //---------------------------------------------------------------------------
@@ -328,6 +336,25 @@ bool dabmuxscanner::restart(void)
   return true;
 }
 
+//---------------------------------------------------------------------------
+// dabmuxscanner::waitForSamples (InputInterface)
+//
+// Waits for the specified number of input samples to be available to read
+//
+// Arguments:
+//
+//	count		- Number of input samples required
+//	timeoutms	- Maximum amount of time to wait, in milliseconds
+
+int32_t dabmuxscanner::waitForSamples(int32_t count, int32_t timeoutms)
+{
+  std::unique_lock<std::mutex> lock(m_samplelock);
+  m_samplecv.wait_for(lock, std::chrono::milliseconds(timeoutms),
+                      [&]() -> bool { return (getSamplesToRead() >= count); });
+
+  return getSamplesToRead();
+}
+
 //---------------------------------------------------------------------------
 // dabmuxscanner::onServiceDetected (RadioControllerInterface)
 //
@@ -27,6 +27,7 @@
 #include "dsp_dab/radio-receiver.h"
 #include "dsp_dab/ringbuffer.h"
 #include "muxscanner.h"
+#include "utils/iqconverter.h"
 
 #include <atomic>
 #include <chrono>
@@ -142,6 +143,11 @@ private:
   // Restarts the input
   bool restart(void) override;
 
+  // waitForSamples
+  //
+  // Waits for the specified number of input samples to be available to read
+  int32_t waitForSamples(int32_t count, int32_t timeoutms) override;
+
   //-----------------------------------------------------------------------
   // RadioControllerInterface
 
@@ -175,6 +181,9 @@ private:
   //
   aligned_ptr<RadioReceiver> m_receiver; // RadioReceiver instance
   RingBuffer<uint8_t> m_ringbuffer; // I/Q sample ring buffer
+  iqconverter m_converter{128.0f, 1.0f / 128.0f}; // I/Q sample converter
+  std::mutex m_samplelock; // Synchronization object
+  std::condition_variable m_samplecv; // Input samples condition variable
 
   // EVENT QUEUE
   //
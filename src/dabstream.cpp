@@ -23,7 +23,8 @@
 #include "dabstream.h"
 
 #include "exception_control/string_exception.h"
-#include "utils/value_size_defines.h"
+
+#include <string.h>
 
 #pragma warning(push, 4)
 
@@ -32,20 +33,15 @@
 // The default audio output sample rate
 int const dabstream::DEFAULT_AUDIO_RATE = 48000;
 
-// dabstream::MAX_PACKET_QUEUE
-//
-// Maximum number of queued demux packets
-size_t const dabstream::MAX_PACKET_QUEUE = 200; // ~5 seconds @ 24ms; 12 seconds @ 60ms
-
-// dabstream::RING_BUFFER_SIZE
+// dabstream::DEFAULT_PAYLOAD_SIZE
 //
-// Input ring buffer size
-size_t const dabstream::RING_BUFFER_SIZE = (4 MiB); // 1 second @ 2048000
+// Default length of a pooled demux packet payload buffer
+size_t const dabstream::DEFAULT_PAYLOAD_SIZE = 8192; // 2048 stereo 16-bit samples (HE-AAC)
 
-// dabstream::SAMPLE_RATE
+// dabstream::PACKET_POOL_SIZE
 //
-// Fixed device sample rate required for DAB
-uint32_t const dabstream::SAMPLE_RATE = 2048000;
+// Number of demux packets preallocated in the packet pool
+size_t const dabstream::PACKET_POOL_SIZE = 200; // ~5 seconds @ 24ms; 12 seconds @ 60ms
 
 // dabstream::STREAM_ID_AUDIOBASE
 //
@@ -62,44 +58,40 @@ int const dabstream::STREAM_ID_ID3TAG = 0;
 //
 // Arguments:
 //
-//	device			- RTL-SDR device instance
-//	tunerprops		- Tuner device properties
-//	channelprops	- Channel properties
+//	ensemble		- Shared DAB ensemble instance
 //	dabprops		- DAB digital signal processor properties
 //	subchannel		- DAB subchannel to decode/stream
 
-dabstream::dabstream(std::unique_ptr<rtldevice> device,
-                     struct tunerprops const& tunerprops,
-                     struct channelprops const& channelprops,
+dabstream::dabstream(std::shared_ptr<dabensemble> ensemble,
                      struct dabprops const& dabprops,
                      uint32_t subchannel)
-  : m_device(std::move(device)),
-    m_ringbuffer(RING_BUFFER_SIZE),
+  : m_ensemble(std::move(ensemble)),
     m_subchannel((subchannel > 0) ? subchannel : 1),
-    m_pcmgain(powf(10.0f, dabprops.outputgain / 10.0f))
+    m_unpaced(m_ensemble->unpaced()),
+    m_freerun((dabprops.freerun) || (m_unpaced)),
+    m_pcmgain(powf(10.0f, dabprops.outputgain / 10.0f)),
+    m_latency(dabprops.outputlatency, dabprops.adaptivelatency, m_freerun),
+    m_clock(m_latency.target(), m_freerun),
+    m_packetpool(PACKET_POOL_SIZE, DEFAULT_PAYLOAD_SIZE)
 {
-  // Initialize the RTL-SDR device instance
-  m_device->set_frequency_correction(tunerprops.freqcorrection + channelprops.freqcorrection);
-  m_device->set_sample_rate(SAMPLE_RATE);
-  m_device->set_center_frequency(channelprops.frequency);
-
-  // Adjust the device gain as specified by the channel properties
-  m_device->set_automatic_gain_control(channelprops.autogain);
-  if (channelprops.autogain == false)
-    m_device->set_gain(channelprops.manualgain);
-
-  // Construct and initialize the demodulator instance
-  RadioControllerInterface& controllerinterface = *static_cast<RadioControllerInterface*>(this);
-  InputInterface& inputinterface = *static_cast<InputInterface*>(this);
-  RadioReceiverOptions options = {};
-  options.disableCoarseCorrector = !dabprops.coarse_corrector;
-  options.freqsyncMethod = static_cast<FreqsyncMethod>(dabprops.coarse_corrector_type);
-  m_receiver = make_aligned<RadioReceiver>(controllerinterface, inputinterface, options, 1);
-
-  // Create the worker thread
-  scalar_condition<bool> started{false};
-  m_worker = std::thread(&dabstream::worker, this, std::ref(started));
-  started.wait_until_equals(true);
+  assert(m_ensemble);
+
+  m_consumed.reserve(PACKET_POOL_SIZE);
+
+  // onstopped (local)
+  //
+  // Invoked when the ensemble has stopped, either normally or due to an exception
+  auto onstopped = [&](std::exception_ptr const& ex) -> void
+  {
+    std::unique_lock<std::mutex> lock(m_queuelock);
+    m_ensemble_exception = ex;
+    m_stopped.store(true);
+    m_queuecv.notify_all(); // Unblock any demux queue waiters
+  };
+
+  // Subscribe to the decoded output of the subchannel from the ensemble
+  ProgrammeHandlerInterface& handler = *static_cast<ProgrammeHandlerInterface*>(this);
+  m_ensemble->subscribe(m_subchannel, handler, onstopped);
 }
 
 //---------------------------------------------------------------------------
@@ -110,6 +102,20 @@ dabstream::~dabstream()
   close();
 }
 
+//---------------------------------------------------------------------------
+// dabstream::canpause
+//
+// Gets a flag indicating if the stream allows pause operations
+//
+// Arguments:
+//
+//	NONE
+
+bool dabstream::canpause(void) const
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // dabstream::canseek
 //
@@ -135,17 +141,18 @@ bool dabstream::canseek(void) const
 
 void dabstream::close(void)
 {
-  m_stop = true; // Signal worker thread to stop
-  if (m_device)
-    m_device->cancel_async(); // Cancel any async read operations
-  if (m_worker.joinable())
-    m_worker.join(); // Wait for thread
-
-  if (m_receiver)
-    m_receiver->stop(); // Stop receiver
-  m_receiver.reset(); // Reset receiver instance
+  // Release an ensemble decoder thread waiting for demux queue space, it has to be able
+  // to return before the subscriber can be removed
+  std::unique_lock<std::mutex> lock(m_queuelock);
+  m_stopped.store(true);
+  m_queuecv.notify_all();
+  lock.unlock();
 
-  m_device.reset(); // Release RTL-SDR device
+  // Unsubscribe from the ensemble and release it; the ensemble will be closed
+  // when the last of the subscribers that share it has been released
+  if (m_ensemble)
+    m_ensemble->unsubscribe(*static_cast<ProgrammeHandlerInterface*>(this));
+  m_ensemble.reset();
 }
 
 //---------------------------------------------------------------------------
@@ -155,20 +162,15 @@ void dabstream::close(void)
 //
 // Arguments:
 //
-//	device			- RTL-SDR device instance
-//	tunerprops		- Tunder device properties
-//	channelprops	- Channel properties
+//	ensemble		- Shared DAB ensemble instance
 //	dabprops		- DAB digital signal processor properties
 //	subchannel		- DAB subchannel to decode/stream
 
-std::unique_ptr<dabstream> dabstream::create(std::unique_ptr<rtldevice> device,
-                                             struct tunerprops const& tunerprops,
-                                             struct channelprops const& channelprops,
+std::unique_ptr<dabstream> dabstream::create(std::shared_ptr<dabensemble> ensemble,
                                              struct dabprops const& dabprops,
                                              uint32_t subchannel)
 {
-  return std::unique_ptr<dabstream>(
-      new dabstream(std::move(device), tunerprops, channelprops, dabprops, subchannel));
+  return std::unique_ptr<dabstream>(new dabstream(std::move(ensemble), dabprops, subchannel));
 }
 
 //---------------------------------------------------------------------------
@@ -208,35 +210,71 @@ void dabstream::demuxflush(void)
 
 DEMUX_PACKET* dabstream::demuxread(std::function<DEMUX_PACKET*(int)> const& allocator)
 {
-  std::unique_lock<std::mutex> lock(m_queuelock);
+  // Hold back the output while the queue fills up to the target latency; wait for up to
+  // 50ms for the ensemble to stop before returning an empty demultiplexer packet
+  double const queuedms = queuelength();
+  if ((m_stopped.load() == false) && (m_latency.buffering(queuedms > 0.0, queuedms)))
+  {
 
-  // Wait up to 50ms for there to be a packet available for processing
-  if (!m_queuecv.wait_for(lock, std::chrono::milliseconds(50),
-                          [&]() -> bool
-                          { return ((m_queue.size() > 0) || m_stopped.load() == true); }))
+    std::unique_lock<std::mutex> lock(m_queuelock);
+    m_queuecv.wait_for(lock, std::chrono::milliseconds(50),
+                       [&]() -> bool { return m_stopped.load() == true; });
     return allocator(0);
+  }
 
-  // If the worker thread was stopped, check for and re-throw any exception that occurred,
-  // otherwise assume it was stopped normally and return an empty demultiplexer packet
-  if (m_stopped.load() == true)
+  // Packets are taken from the shared queue in batches; only when the current batch
+  // has been exhausted does the queue need to be locked again
+  if (m_readqueue.empty())
   {
 
-    if (m_worker_exception)
-      std::rethrow_exception(m_worker_exception);
-    else
+    // Return the packets consumed from the previous batch to the pool
+    m_packetpool.release(m_consumed.begin(), m_consumed.end());
+    m_consumed.clear();
+
+    std::unique_lock<std::mutex> lock(m_queuelock);
+
+    // Wait up to 50ms for there to be a packet available for processing
+    if (!m_queuecv.wait_for(lock, std::chrono::milliseconds(50),
+                            [&]() -> bool
+                            { return ((m_queue.size() > 0) || m_stopped.load() == true); }))
       return allocator(0);
+
+    // If the ensemble was stopped, check for and re-throw any exception that occurred,
+    // otherwise assume it was stopped normally and return an empty demultiplexer packet
+    if (m_stopped.load() == true)
+    {
+
+      if (m_ensemble_exception)
+        std::rethrow_exception(m_ensemble_exception);
+      else
+        return allocator(0);
+    }
+
+    // Take everything that has been queued as the next batch
+    m_readqueue.swap(m_queue);
   }
 
-  // Pop off the topmost object from the queue<> and release the lock
-  std::unique_ptr<demux_packet_t> packet(std::move(m_queue.front()));
-  m_queue.pop();
-  lock.unlock();
+  // Pop off the topmost object from the batch; it's returned to the pool later
+  m_consumed.emplace_back(std::move(m_readqueue.front()));
+  m_readqueue.pop_front();
+  demux_packet_t const& packet = m_consumed.back();
 
   // The packet queue should never have a null packet in it
   assert(packet);
   if (!packet)
     return allocator(0);
 
+  // The packet is no longer part of the queued audio
+  m_queuedtime.fetch_sub(static_cast<int64_t>(packet->duration));
+
+  // Wake up an ensemble decoder thread that is waiting for demux queue space
+  if (m_unpaced)
+  {
+
+    std::unique_lock<std::mutex> lock(m_queuelock);
+    m_queuecv.notify_all();
+  }
+
   // Allocate and initialize the DEMUX_PACKET
   DEMUX_PACKET* demuxpacket = allocator(packet->size);
   if (demuxpacket != nullptr)
@@ -278,7 +316,21 @@ void dabstream::demuxreset(void)
 
 std::string dabstream::devicename(void) const
 {
-  return std::string(m_device->get_device_name());
+  return m_ensemble->devicename();
+}
+
+//---------------------------------------------------------------------------
+// dabstream::devicestatistics
+//
+// Gets the data transfer statistics for the device associated with the stream
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void dabstream::devicestatistics(struct rtldevice::device_statistics& stats) const
+{
+  m_ensemble->devicestatistics(stats);
 }
 
 //---------------------------------------------------------------------------
@@ -295,7 +347,7 @@ void dabstream::enumproperties(std::function<void(struct streamprops const& prop
   // AUDIO STREAM
   //
   streamprops audio = {};
-  audio.codec = "pcm_s16le";
+  audio.codec = m_audiocodec.load();
   audio.pid = m_audioid.load();
   audio.channels = 2;
   audio.samplerate = m_audiorate.load();
@@ -332,281 +384,224 @@ std::string dabstream::muxname(void) const
 }
 
 //---------------------------------------------------------------------------
-// dabstream::position
+// dabstream::overruns
 //
-// Gets the current position of the stream
+// Gets the number of times that data was dropped because the stream fell behind
 //
 // Arguments:
 //
 //	NONE
 
-long long dabstream::position(void) const
+uint64_t dabstream::overruns(void) const
 {
-  return -1;
+  return m_overruns.load();
 }
 
 //---------------------------------------------------------------------------
-// dabstream::read
+// dabstream::position
 //
-// Reads data from the live stream
+// Gets the current position of the stream
 //
 // Arguments:
 //
-//	buffer		- Buffer to receive the live stream data
-//	count		- Size of the destination buffer in bytes
+//	NONE
 
-size_t dabstream::read(uint8_t* /*buffer*/, size_t /*count*/)
+long long dabstream::position(void) const
 {
-  return 0;
+  return -1;
 }
 
 //---------------------------------------------------------------------------
-// dabstream::realtime
+// dabstream::queueaudio (private)
 //
-// Gets a flag indicating if the stream is real-time
+// Queues a demux packet of audio data, handling format changes and queue overruns
 //
 // Arguments:
 //
-//	NONE
+//	codec		- Codec of the audio data (string literal)
+//	samplerate	- Sample rate of the audio data
+//	packet		- Pooled packet containing the audio data and duration
 
-bool dabstream::realtime(void) const
+void dabstream::queueaudio(char const* codec, int samplerate, demux_packet_t packet)
 {
-  return true;
+  std::unique_lock<std::mutex> lock(m_queuelock);
+
+  // Detect and handle a change in the audio output codec or sample rate
+  if ((strcmp(codec, m_audiocodec.load()) != 0) || (samplerate != m_audiorate))
+  {
+
+    m_audioid.fetch_add(1); // Increment the audio stream id
+    m_audiocodec.store(codec); // Change the codec
+    m_audiorate.store(samplerate); // Change the sample rate
+
+    // Queue a DEMUX_SPECIALID_STREAMCHANGE packet to inform of the stream change
+    demux_packet_t streamchange = m_packetpool.acquire(0);
+    streamchange->streamid = DEMUX_SPECIALID_STREAMCHANGE;
+    m_queue.emplace_back(std::move(streamchange));
+  }
+
+  // An unpaced input is decoded faster than real time; wait for the demux read function to
+  // make room in the queue instead of discarding the queued audio
+  if (m_unpaced)
+  {
+
+    m_queuecv.wait(lock, [&]() -> bool
+                   { return (queuelength() < m_latency.limit()) || (m_stopped.load() == true); });
+
+    if (m_stopped.load() == true)
+    {
+
+      m_packetpool.release(std::move(packet));
+      return;
+    }
+  }
+
+  // If the queued audio has exceeded the latency limit, the packets aren't being
+  // processed quickly enough by the demux read function
+  if (queuelength() >= m_latency.limit())
+  {
+
+    for (auto const& item : m_queue)
+      m_queuedtime.fetch_sub(static_cast<int64_t>(item->duration));
+
+    m_packetpool.release(m_queue.begin(), m_queue.end());
+    m_queue.clear(); // Empty the deque<>
+    m_overruns.fetch_add(1); // Count the overrun
+
+    // Queue a DEMUX_SPECIALID_STREAMCHANGE packet into the emptied queue
+    demux_packet_t streamchange = m_packetpool.acquire(0);
+    streamchange->streamid = DEMUX_SPECIALID_STREAMCHANGE;
+    m_queue.emplace_back(std::move(streamchange));
+
+    m_dts = STREAM_TIME_BASE; // Reset DTS back to base time
+    m_clock.reset(); // Reset the output clock recovery
+  }
+
+  // Stamp and queue the demux audio packet
+  packet->streamid = m_audioid.load();
+  packet->dts = packet->pts = m_dts;
+
+  m_dts += packet->duration;
+  m_queuedtime.fetch_add(static_cast<int64_t>(packet->duration));
+
+  m_queue.emplace_back(std::move(packet));
+  m_queuecv.notify_all();
 }
 
 //---------------------------------------------------------------------------
-// dabstream::seek
+// dabstream::queuelength (private)
 //
-// Sets the stream pointer to a specific position
+// Gets the duration of the audio in the demux queue, in milliseconds
 //
 // Arguments:
 //
-//	position	- Delta within the stream to seek, relative to whence
-//	whence		- Starting position from which to apply the delta
+//	NONE
 
-long long dabstream::seek(long long /*position*/, int /*whence*/)
+double dabstream::queuelength(void) const
 {
-  return -1;
+  return (m_queuedtime.load() * 1000.0) / STREAM_TIME_BASE;
 }
 
 //---------------------------------------------------------------------------
-// dabstream::servicename
+// dabstream::read
 //
-// Gets the service name associated with the stream
+// Reads data from the live stream
 //
 // Arguments:
 //
-//	NONE
+//	buffer		- Buffer to receive the live stream data
+//	count		- Size of the destination buffer in bytes
 
-std::string dabstream::servicename(void) const
+size_t dabstream::read(uint8_t* /*buffer*/, size_t /*count*/)
 {
-  return ""; // TODO
+  return 0;
 }
 
 //---------------------------------------------------------------------------
-// dabstream::signalquality
+// dabstream::realtime
 //
-// Gets the signal quality as percentages
+// Gets a flag indicating if the stream is real-time
 //
 // Arguments:
 //
 //	NONE
 
-void dabstream::signalquality(int& quality, int& snr) const
+bool dabstream::realtime(void) const
 {
-  quality = snr = 0; // TODO
+  return true;
 }
 
 //---------------------------------------------------------------------------
-// dabstream::worker (private)
+// dabstream::seek
 //
-// Worker thread procedure used to transfer and process data
+// Sets the stream pointer to a specific position
 //
 // Arguments:
 //
-//	started		- Condition variable to set when thread has started
+//	position	- Delta within the stream to seek, relative to whence
+//	whence		- Starting position from which to apply the delta
 
-void dabstream::worker(scalar_condition<bool>& started)
+long long dabstream::seek(long long /*position*/, int /*whence*/)
 {
-  std::vector<Service> servicelist; // vector<> of current services
-  bool foundsub = false; // Flag indicating the desired subchannel was found
-
-  assert(m_device);
-  assert(m_receiver);
-
-  // read_callback_func (local)
-  //
-  // Asynchronous read callback function for the RTL-SDR device
-  auto read_callback_func = [&](uint8_t const* buffer, size_t count) -> void
-  {
-    // Trigger an InputFailure event if no data has been returned from the device
-    if (count == 0)
-      m_streamok.store(false);
-
-    // Copy the input data into the ring buffer
-    assert(count <= std::numeric_limits<int32_t>::max());
-    m_ringbuffer.putDataIntoBuffer(buffer, static_cast<int32_t>(count));
-
-    // Check for and process any new events
-    std::unique_lock<std::mutex> eventslock(m_eventslock);
-    if (m_events.empty() == false)
-    {
-
-      // The threading model is a bit weird here; the callback that queued a new
-      // event needs to be free to continue execution otherwise the DSP may deadlock
-      // while we process that event. Combat this by swapping the queue<> with a new
-      // one, release the lock, then go ahead and process each of the queued events
-
-      event_queue_t events; // Empty event queue<>
-      m_events.swap(events); // Swap with existing queue<>
-      eventslock.unlock(); // Release the queue<> lock
-
-      while (!events.empty())
-      {
-
-        eventid_t eventid = events.front(); // eventid_t
-        events.pop(); // Remove from queue<>
-
-        switch (eventid)
-        {
-
-          // InputFailure
-          //
-          // Something has gone wrong with the input stream
-          case eventid_t::InputFailure:
-
-            throw string_exception("Input Failure"); // TODO: message
-            break;
-
-          // ServiceDetected
-          //
-          // A new service has been detected
-          case eventid_t::ServiceDetected:
-
-            if (foundsub)
-              break; // Subchannel has already been found; ignore
-
-            // Determine if the desired subchannel is now present in the decoded services
-            servicelist = m_receiver->getServiceList();
-            for (auto const& service : servicelist)
-            {
-              for (auto const& component : m_receiver->getComponents(service))
-              {
-
-                if (component.subchannelId == static_cast<int16_t>(m_subchannel))
-                {
-
-                  // The desired subchannel has been found; begin audio playback
-                  ProgrammeHandlerInterface& phi = *static_cast<ProgrammeHandlerInterface*>(this);
-                  m_receiver->playSingleProgramme(phi, {}, service);
-
-                  foundsub = true; //  Stop processing service events
-                }
-              }
-            }
-            break;
-        }
-      }
-    }
-  };
-
-  // Begin streaming from the device via the receiver and inform the caller that the thread is running
-  m_receiver->restart(false);
-  started = true;
-
-  // Continuously read data from the device until cancel_async() has been called
-  // 40 KiB = ~1/100 of a second of data
-  try
-  {
-    m_device->read_async(read_callback_func, 40 KiB);
-  }
-  catch (...)
-  {
-    m_worker_exception = std::current_exception();
-  }
-
-  m_stopped.store(true); // Worker thread is now stopped
-  m_queuecv.notify_all(); // Unblock any demux queue waiters
+  return -1;
 }
 
 //---------------------------------------------------------------------------
-// dabstream::getSamples (InputInterface)
+// dabstream::seektime
 //
-// Reads the specified number of samples from the input device
+// Sets the stream pointer to a specific time
 //
 // Arguments:
 //
-//	buffer		- Buffer to receive the input samples
-//	size		- Number of samples to read
+//	time		- Time to seek to, in milliseconds
+//	backwards	- Flag indicating a backwards seek
+//	startpts	- On success, receives the PTS of the first packet after the seek
 
-int32_t dabstream::getSamples(DSPCOMPLEX* buffer, int32_t size)
+bool dabstream::seektime(double /*time*/, bool /*backwards*/, double& /*startpts*/)
 {
-  int32_t numsamples = 0; // Number of available samples in the buffer
-
-  // Allocate a temporary buffer to pull the data out of the ring buffer
-  std::unique_ptr<uint8_t[]> tempbuffer(new uint8_t[size * 2]);
-
-  // Get the data from the ring buffer
-  numsamples = m_ringbuffer.getDataFromBuffer(tempbuffer.get(), size * 2);
-
-  // Scale the input data from [0,255] to [-1,1] for the demodulator
-  for (int32_t index = 0; index < numsamples / 2; index++)
-  {
-
-    buffer[index] =
-        DSPCOMPLEX((static_cast<float>(tempbuffer[index * 2]) - 128.0f) / 128.0f, // real
-                   (static_cast<float>(tempbuffer[(index * 2) + 1]) - 128.0f) / 128.0f // imaginary
-        );
-  }
-
-  return numsamples / 2;
+  return false;
 }
 
 //---------------------------------------------------------------------------
-// dabstream::getSamplesToRead (InputInterface)
+// dabstream::servicename
 //
-// Gets the number of input samples that are available to read from input
+// Gets the service name associated with the stream
 //
 // Arguments:
 //
 //	NONE
 
-int32_t dabstream::getSamplesToRead(void)
+std::string dabstream::servicename(void) const
 {
-  return m_ringbuffer.GetRingBufferReadAvailable() / 2;
+  return ""; // TODO
 }
 
 //---------------------------------------------------------------------------
-// dabstream::is_ok (InputInterface)
+// dabstream::signalquality
 //
-// Determines if the input is still "OK"
+// Gets the signal quality as percentages
 //
 // Arguments:
 //
 //	NONE
 
-bool dabstream::is_ok(void)
+void dabstream::signalquality(int& quality, int& snr) const
 {
-  return m_streamok.load();
+  quality = snr = 0; // TODO
 }
 
 //---------------------------------------------------------------------------
-// dabstream::restart (InputInterface)
+// dabstream::streamtimes
 //
-// Restarts the input
+// Gets the time shift boundaries of the stream
 //
 // Arguments:
 //
-//	NONE
+//	times		- Structure to receive the stream times
 
-bool dabstream::restart(void)
+bool dabstream::streamtimes(struct streamtimes& /*times*/) const
 {
-  assert(m_device);
-
-  m_streamok.store(true);
-  m_device->begin_stream();
-
-  return true;
+  return false;
 }
 
 //---------------------------------------------------------------------------
@@ -627,57 +622,66 @@ void dabstream::onNewAudio(std::vector<int16_t>&& audioData,
   if (audioData.size() == 0)
     return;
 
-  // Allocate the uint8_t buffer to hold the PCM audio data
-  size_t pcmsize = audioData.size() * sizeof(int16_t);
-  std::unique_ptr<uint8_t[]> pcm(new uint8_t[pcmsize]);
+  // A change in the sample rate is a discontinuity for the output clock recovery
+  if (sampleRate != m_audiorate.load())
+  {
 
-  // Copy the audio data into the buffer while applying the specified PCM output gain
-  int16_t* pcmdata = reinterpret_cast<int16_t*>(pcm.get());
-  for (size_t index = 0; index < audioData.size(); index++)
-    pcmdata[index] = static_cast<int16_t>(audioData[index] * m_pcmgain);
+    m_resampler.reset();
+    m_clock.reset();
+  }
 
-  std::unique_lock<std::mutex> lock(m_queuelock);
+  // Trim the resampling rate to hold the amount of queued audio at the target latency, which
+  // compensates for the difference between the device and the consumer clocks
+  m_clock.target(m_latency.target());
+  double const rate = m_clock.update(queuelength());
+  size_t const frames = audioData.size() / 2;
 
-  // Detect and handle a change in the audio output sample rate
-  if (sampleRate != m_audiorate)
-  {
+  // Acquire a pooled packet large enough to hold the resampled PCM audio data
+  demux_packet_t packet =
+      m_packetpool.acquire(pcmresampler::maxoutput(frames, rate) * 2 * sizeof(int16_t));
+  int16_t* output = reinterpret_cast<int16_t*>(packet->data.get());
 
-    m_audioid.fetch_add(1); // Increment the audio stream id
-    m_audiorate.store(sampleRate); // Change the sample rate
+  // Resample the audio data into the packet and apply the specified PCM output gain
+  size_t const outframes = m_resampler.resample(audioData.data(), frames, rate, output);
+  m_pcmgain.apply(output, outframes * 2);
 
-    // Queue a DEMUX_SPECIALID_STREAMCHANGE packet to inform of the stream change
-    std::unique_ptr<demux_packet_t> packet = std::make_unique<demux_packet_t>();
-    packet->streamid = DEMUX_SPECIALID_STREAMCHANGE;
-    m_queue.emplace(std::move(packet));
-  }
+  packet->size = static_cast<int>(outframes * 2 * sizeof(int16_t));
+  packet->duration = (outframes / static_cast<double>(sampleRate)) * STREAM_TIME_BASE;
 
-  // If the queue size has exceeded the maximum, the packets aren't being
-  // processed quickly enough by the demux read function
-  if (m_queue.size() >= MAX_PACKET_QUEUE)
-  {
+  queueaudio("pcm_s16le", sampleRate, std::move(packet));
+}
 
-    m_queue = demux_queue_t(); // Replace the queue<>
+//---------------------------------------------------------------------------
+// dabstream::onNewCompressedAudio (ProgrammeHandlerInterface)
+//
+// Invoked when a new packet of undecoded audio data is available
+//
+// Arguments:
+//
+//	data			- vector<> of undecoded audio data
+//	durationMs		- Playback duration of the audio data in milliseconds
+//	format			- Format of the audio data ("mp2" or "aac")
 
-    // Queue a DEMUX_SPECIALID_STREAMCHANGE packet into the new queue
-    std::unique_ptr<demux_packet_t> packet = std::make_unique<demux_packet_t>();
-    packet->streamid = DEMUX_SPECIALID_STREAMCHANGE;
-    m_queue.emplace(std::move(packet));
+void dabstream::onNewCompressedAudio(std::vector<uint8_t>&& data,
+                                     size_t durationMs,
+                                     std::string const& format)
+{
+  if ((data.size() == 0) || (durationMs == 0))
+    return;
 
-    m_dts = STREAM_TIME_BASE; // Reset DTS back to base time
-  }
+  // MP2 frames are passed through as-is; AAC access units are delivered wrapped in
+  // a LATM/LOAS AudioSyncStream that carries the AudioSpecificConfig in-band
+  char const* codec = (format == "mp2") ? "mp2" : "aac_latm";
 
-  // Generate and queue the demux audio packet
-  std::unique_ptr<demux_packet_t> packet = std::make_unique<demux_packet_t>();
-  packet->streamid = m_audioid.load();
-  packet->size = static_cast<int>(pcmsize);
-  packet->duration = (audioData.size() / 2.0 / static_cast<double>(sampleRate)) * STREAM_TIME_BASE;
-  packet->dts = packet->pts = m_dts;
-  packet->data = std::move(pcm);
+  // DAB MP2 frames are 24ms at 48KHz or 48ms at 24KHz (LSF); the AAC sample rate is only
+  // a hint to the decoder since the actual rate comes from the in-band configuration
+  int samplerate = ((format == "mp2") && (durationMs == 48)) ? 24000 : DEFAULT_AUDIO_RATE;
 
-  m_dts += packet->duration;
+  demux_packet_t packet = m_packetpool.acquire(data.size());
+  packet->duration = (durationMs / 1000.0) * STREAM_TIME_BASE;
+  memcpy(packet->data.get(), data.data(), data.size());
 
-  m_queue.emplace(std::move(packet));
-  m_queuecv.notify_all();
+  queueaudio(codec, samplerate, std::move(packet));
 }
 
 //---------------------------------------------------------------------------
@@ -713,102 +717,6 @@ void dabstream::onMOT(mot_file_t const& /*mot_file*/)
   //
 }
 
-//---------------------------------------------------------------------------
-// dabstream::onFrequencyCorrectorChange (RadioControllerInterface)
-//
-// Invoked when the frequency correction has been changed
-//
-// Arguments:
-//
-//	fine			- Fine frequency correction value
-//	coarse			- Coarse frequency correction value
-
-void dabstream::onFrequencyCorrectorChange(int /*fine*/, int /*coarse*/)
-{
-  // TODO - This can be applied to the device real-time?
-}
-
-//---------------------------------------------------------------------------
-// dabstream::onInputFailure (RadioControllerInterface)
-//
-// Invoked when the receiver has shut down to an input failure
-//
-// Arguments:
-//
-//	NONE
-
-void dabstream::onInputFailure(void)
-{
-  std::unique_lock<std::mutex> lock(m_eventslock);
-  m_events.emplace(eventid_t::InputFailure);
-}
-
-//---------------------------------------------------------------------------
-// dabstream::onServiceDetected (RadioControllerInterface)
-//
-// Invoked when a new service was detected
-//
-// Arguments:
-//
-//	sId			- New service identifier
-
-void dabstream::onServiceDetected(uint32_t /*sId*/)
-{
-  std::unique_lock<std::mutex> lock(m_eventslock);
-  m_events.emplace(eventid_t::ServiceDetected);
-}
-
-//---------------------------------------------------------------------------
-// dabstream::onSetEnsembleLabel (RadioControllerInterface)
-//
-// Invoked when the ensemble label has changed
-//
-// Arguments:
-//
-//	label		- New ensemble label
-
-void dabstream::onSetEnsembleLabel(DabLabel& /*label*/)
-{
-  //
-  // TODO: This can probably be used to automatically generate
-  // a channel group
-  //
-}
-
-//---------------------------------------------------------------------------
-// dabstream::onSNR (RadioControllerInterface)
-//
-// Invoked when the Signal-to-Nosie Radio has been calculated
-//
-// Arguments:
-//
-//	snr			- Signal-to-Noise Ratio, in dB
-
-void dabstream::onSNR(float /*snr*/)
-{
-  //
-  // TODO: Figure out what an acceptable SNR is for DAB and provide
-  // the necessary event to change the signal quality metric
-  //
-}
-
-//---------------------------------------------------------------------------
-// dabstream::onSyncChange (RadioControllerInterface)
-//
-// Invoked when signal synchronization was acquired or lost
-//
-// Arguments:
-//
-//	isSync		- Synchronization flag
-
-void dabstream::onSyncChange(bool /*isSync*/)
-{
-  //
-  // TODO: This might need to STREAMCHANGE, clear the demux queue,
-  // silence the audio, and maybe throw up a banner to the user
-  //
-}
-
 //---------------------------------------------------------------------------
 
 #pragma warning(pop)
@@ -24,31 +24,31 @@
 #define __DABSTREAM_H_
 #pragma once
 
-#include "dsp_dab/radio-receiver.h"
-#include "dsp_dab/ringbuffer.h"
+#include "dabensemble.h"
 #include "props.h"
+#include "pcmresampler.h"
 #include "pvrstream.h"
-#include "rtldevice.h"
-#include "utils/scalar_condition.h"
+#include "utils/clockrecovery.h"
+#include "utils/latencycontrol.h"
+#include "utils/packetpool.h"
+#include "utils/pcmgain.h"
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <exception>
 #include <memory>
 #include <mutex>
-#include <queue>
-#include <thread>
+#include <vector>
 
 #pragma warning(push, 4)
 
 //---------------------------------------------------------------------------
 // Class dabstream
 //
-// Implements a DAB stream
+// Implements a DAB stream as a subscriber to a shared DAB ensemble
 
-class dabstream : public pvrstream,
-                  private InputInterface,
-                  private ProgrammeHandlerInterface,
-                  private RadioControllerInterface
+class dabstream : public pvrstream, private ProgrammeHandlerInterface
 {
 public:
   // Destructor
@@ -58,6 +58,11 @@ public:
   //-----------------------------------------------------------------------
   // Member Functions
 
+  // canpause
+  //
+  // Flag indicating if the stream allows pause operations
+  bool canpause(void) const override;
+
   // canseek
   //
   // Flag indicating if the stream allows seek operations
@@ -71,9 +76,7 @@ public:
   // create (static)
   //
   // Factory method, creates a new dab instance
-  static std::unique_ptr<dabstream> create(std::unique_ptr<rtldevice> device,
-                                           struct tunerprops const& tunerprops,
-                                           struct channelprops const& channelprops,
+  static std::unique_ptr<dabstream> create(std::shared_ptr<dabensemble> ensemble,
                                            struct dabprops const& dabprops,
                                            uint32_t subchannel);
 
@@ -102,6 +105,11 @@ public:
   // Gets the device name associated with the stream
   std::string devicename(void) const override;
 
+  // devicestatistics
+  //
+  // Gets the data transfer statistics for the device associated with the stream
+  void devicestatistics(struct rtldevice::device_statistics& stats) const override;
+
   // enumproperties
   //
   // Enumerates the stream properties
@@ -118,6 +126,11 @@ public:
   // Gets the mux name associated with the stream
   std::string muxname(void) const override;
 
+  // overruns
+  //
+  // Gets the number of times that data was dropped because the stream fell behind
+  uint64_t overruns(void) const override;
+
   // position
   //
   // Gets the current position of the stream
@@ -138,6 +151,11 @@ public:
   // Sets the stream pointer to a specific position
   long long seek(long long position, int whence) override;
 
+  // seektime
+  //
+  // Sets the stream pointer to a specific time
+  bool seektime(double time, bool backwards, double& startpts) override;
+
   // servicename
   //
   // Gets the service name associated with the stream
@@ -148,6 +166,11 @@ public:
   // Gets the signal quality as percentages
   void signalquality(int& quality, int& snr) const override;
 
+  // streamtimes
+  //
+  // Gets the time shift boundaries of the stream
+  bool streamtimes(struct streamtimes& times) const override;
+
 private:
   dabstream(dabstream const&) = delete;
   dabstream& operator=(dabstream const&) = delete;
@@ -157,20 +180,15 @@ private:
   // The default audio output sample rate
   static int const DEFAULT_AUDIO_RATE;
 
-  // MAX_PACKET_QUEUE
+  // DEFAULT_PAYLOAD_SIZE
   //
-  // Maximum number of queued demux packets
-  static size_t const MAX_PACKET_QUEUE;
+  // Default length of a pooled demux packet payload buffer
+  static size_t const DEFAULT_PAYLOAD_SIZE;
 
-  // RING_BUFFER_SIZE
+  // PACKET_POOL_SIZE
   //
-  // Input ring buffer size
-  static size_t const RING_BUFFER_SIZE;
-
-  // SAMPLE_RATE
-  //
-  // Fixed device sample rate required for DAB
-  static uint32_t const SAMPLE_RATE;
+  // Number of demux packets preallocated in the packet pool
+  static size_t const PACKET_POOL_SIZE;
 
   // STREAM_ID_AUDIOBASE
   //
@@ -184,9 +202,7 @@ private:
 
   // Instance Constructor
   //
-  dabstream(std::unique_ptr<rtldevice> device,
-            struct tunerprops const& tunerprops,
-            struct channelprops const& channelprops,
+  dabstream(std::shared_ptr<dabensemble> ensemble,
             struct dabprops const& dabprops,
             uint32_t subchannel);
 
@@ -195,68 +211,26 @@ private:
 
   // demux_packet_t
   //
-  // Defines the conents of a queued demux packet
-  struct demux_packet_t
-  {
-
-    int streamid = 0;
-    int size = 0;
-    double duration = 0;
-    double dts = 0;
-    double pts = 0;
-    std::unique_ptr<uint8_t[]> data;
-  };
+  // Defines the type of a queued demux packet
+  using demux_packet_t = packetpool::packet_ptr;
 
   // demux_queue_t
   //
   // Defines the type of the demux queue
-  using demux_queue_t = std::queue<std::unique_ptr<demux_packet_t>>;
-
-  // eventid_t
-  //
-  // Defines a worker thread event identifier
-  enum class eventid_t
-  {
-
-    InputFailure, // An input failure has occurred
-    ServiceDetected, // A new service has been detected
-  };
-
-  // event_queue_t
-  //
-  // Defines the type of the worker thread event queue
-  using event_queue_t = std::queue<eventid_t>;
+  using demux_queue_t = std::deque<demux_packet_t>;
 
   //-----------------------------------------------------------------------
   // Private Member Functions
 
-  // worker
-  //
-  // Worker thread procedure used to transfer and process data
-  void worker(scalar_condition<bool>& started);
-
-  //-----------------------------------------------------------------------
-  // InputInterface Implementation
-
-  // getSamples
-  //
-  // Reads the specified number of samples from the input device
-  int32_t getSamples(DSPCOMPLEX* buffer, int32_t size) override;
-
-  // getSamplesToRead
+  // queueaudio
   //
-  // Gets the number of input samples that are available to read from input
-  int32_t getSamplesToRead(void) override;
+  // Queues a demux packet of audio data, handling format changes and queue overruns
+  void queueaudio(char const* codec, int samplerate, demux_packet_t packet);
 
-  // is_ok
+  // queuelength
   //
-  // Determines if the input is still "OK"
-  bool is_ok(void) override;
-
-  // restart
-  //
-  // Restarts the input
-  bool restart(void) override;
+  // Gets the duration of the audio in the demux queue, in milliseconds
+  double queuelength(void) const;
 
   //-----------------------------------------------------------------------
   // ProgrammeHandlerInterface
@@ -268,6 +242,13 @@ private:
                   int sampleRate,
                   const std::string& mode) override;
 
+  // onNewCompressedAudio
+  //
+  // Invoked when a new packet of undecoded audio data is available
+  void onNewCompressedAudio(std::vector<uint8_t>&& data,
+                            size_t durationMs,
+                            const std::string& format) override;
+
   // onNewDynamicLabel
   //
   // Invoked when a new dynamic label has been decoded
@@ -278,69 +259,40 @@ private:
   // Invoked when a new slide has been decoded
   void onMOT(const mot_file_t& mot_file) override;
 
-  //-----------------------------------------------------------------------
-  // RadioControllerInterface
-
-  // onFrequencyCorrectorChange
-  //
-  // Invoked when the frequency correction has been changed
-  void onFrequencyCorrectorChange(int fine, int coarse) override;
-
-  // onInputFailure
-  //
-  // Invoked when the receiver has shut down to an input failure
-  void onInputFailure(void) override;
-
-  // onServiceDetected
-  //
-  // Invoked when a new service was detected
-  void onServiceDetected(uint32_t sId) override;
-
-  // onSetEnsembleLabel
-  //
-  // Invoked when the ensemble label has changed
-  void onSetEnsembleLabel(DabLabel& label) override;
-
-  // onSNR
-  //
-  // Invoked when the Signal-to-Nosie Radio has been calculated
-  void onSNR(float snr) override;
-
-  // onSyncChange
-  //
-  // Invoked when signal synchronization was acquired or lost
-  void onSyncChange(bool isSync) override;
-
   //-----------------------------------------------------------------------
   // Member Variables
 
-  std::unique_ptr<rtldevice> m_device; // RTL-SDR device instance
-  aligned_ptr<RadioReceiver> m_receiver; // RadioReceiver instance
-  RingBuffer<uint8_t> m_ringbuffer; // I/Q sample ring buffer
+  std::shared_ptr<dabensemble> m_ensemble; // Shared DAB ensemble instance
 
   // STREAM CONTROL
   //
   uint32_t const m_subchannel; // Ensemble subchannel number
-  float const m_pcmgain; // Output gain
-  std::atomic<bool> m_streamok{true}; // "OK" flag for the stream
+  bool const m_unpaced; // Flag to wait for demux queue space
+  bool const m_freerun; // Flag if the output is not paced by the player
+  pcmgain const m_pcmgain; // Output gain
   double m_dts{STREAM_TIME_BASE}; // Current decode time stamp
   std::atomic<int> m_audioid{STREAM_ID_AUDIOBASE}; // Current audio stream id
   std::atomic<int> m_audiorate{DEFAULT_AUDIO_RATE}; // Current audio output rate
+  std::atomic<char const*> m_audiocodec{"pcm_s16le"}; // Current audio output codec
+  latencycontrol m_latency; // Output latency control
+  pcmresampler m_resampler; // Output clock resampler
+  clockrecovery m_clock; // Output clock recovery
 
   // DEMUX QUEUE
   //
-  demux_queue_t m_queue; // queue<> of demux objects
+  packetpool m_packetpool; // Pool of recycled demux packets
+  demux_queue_t m_queue; // deque<> of demux objects
   mutable std::mutex m_queuelock; // Synchronization object
   std::condition_variable m_queuecv; // Event condition variable
+  demux_queue_t m_readqueue; // Batch of demux objects being read
+  std::vector<demux_packet_t> m_consumed; // Demux objects to return to the pool
+  std::atomic<int64_t> m_queuedtime{0}; // Duration of the queued demux objects
 
-  // WORKER THREAD
+  // ENSEMBLE STATE
   //
-  std::thread m_worker; // Data transfer thread
-  std::exception_ptr m_worker_exception; // Exception on worker thread
-  scalar_condition<bool> m_stop{false}; // Condition to stop data transfer
-  std::atomic<bool> m_stopped{false}; // Data transfer stopped flag
-  event_queue_t m_events; // queue<> of worker events
-  mutable std::mutex m_eventslock; // Synchronization object
+  std::exception_ptr m_ensemble_exception; // Exception that stopped the ensemble
+  std::atomic<bool> m_stopped{false}; // Ensemble stopped flag
+  std::atomic<uint64_t> m_overruns{0}; // Number of demux queue overruns
 };
 
 //-----------------------------------------------------------------------------
@@ -32,13 +32,20 @@ DecoderAdapter::DecoderAdapter(ProgrammeHandlerInterface &mr, int16_t bitRate, A
     myInterface(mr),
     padDecoder(this, true)
 {
+    // If the programme handler wants the undecoded audio frames there is no
+    // need to decode AAC; MP2 frames are still decoded by mpg123 internally
+    compressedAudio = myInterface.wantsCompressedAudio();
+
     if (dabModus == AudioServiceComponentType::DAB)
         decoder = std::make_unique<MP2Decoder>(this, false);
     else if (dabModus == AudioServiceComponentType::DABPlus)
-        decoder = std::make_unique<SuperframeFilter>(this, true, false);
+        decoder = std::make_unique<SuperframeFilter>(this, !compressedAudio, false);
     else
         throw std::runtime_error("DecoderAdapter: Unknown service component");
 
+    if (compressedAudio)
+        decoder->AddUntouchedStreamConsumer(this);
+
     // Open a dump file (XPADxpert) if the user defined it
     if (!dumpFileName.empty()) {
         FILE *fd = fopen(dumpFileName.c_str(), "wb");
@@ -92,6 +99,9 @@ void DecoderAdapter::StartAudio(int samplerate, int channels, bool float32)
 
 void DecoderAdapter::PutAudio(const uint8_t *data, size_t len)
 {
+    if (compressedAudio)
+        return;
+
     // Then len is given in bytes. For stereo it is the double times of mono.
     // But we need two channels even if we have mono.
     // Mono: len = len / 2 * 2 We have len to divide by 2 and for two channels we have multiply by two
@@ -175,3 +185,11 @@ void DecoderAdapter::PADLengthError(size_t announced_xpad_len, size_t xpad_len)
 {
     myInterface.onPADLengthError(announced_xpad_len, xpad_len);
 }
+
+void DecoderAdapter::ProcessUntouchedStream(const uint8_t *data, size_t len, size_t duration_ms)
+{
+    myInterface.onNewCompressedAudio(
+        std::vector<uint8_t>(data, data + len),
+        duration_ms,
+        decoder->GetUntouchedStreamFileExtension());
+}
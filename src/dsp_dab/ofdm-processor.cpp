@@ -30,6 +30,7 @@
  *
  */
 
+#include <algorithm>
 #include <cstddef>
 #include "ofdm-processor.h"
 #include "MathHelper.h"
@@ -42,9 +43,95 @@
 #include <math.h>
 #endif
 
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define OFDM_PROCESSOR_SSE2
+#include <emmintrin.h>
+#endif
+
 //
 #define SEARCH_RANGE        (2 * 36)
 #define CORRELATION_LENGTH  24
+#define SAMPLE_BLOCK_SIZE   2048
+#define INPUT_WAIT_MS       50
+#define NCO_BLOCK           64
+#define LEVEL_ALPHA         0.00001
+
+/**
+ * \brief oscillator
+ * Computes the oscillator value for a phase, specified in
+ * Hz at INPUT_RATE.  The value is computed the same way the
+ * entries of the old 2,048,000 entry oscillator table were,
+ * which is what keeps the NCO exact at every reseed
+ */
+static inline int64_t oscillatorIndex(int64_t phase)
+{
+    return ((phase % INPUT_RATE) + INPUT_RATE) % INPUT_RATE;
+}
+
+static DSPCOMPLEX oscillator(int64_t phase)
+{
+    phase = oscillatorIndex(phase);
+    return DSPCOMPLEX(cos(2.0 * M_PI * phase / INPUT_RATE),
+            sin(2.0 * M_PI * phase / INPUT_RATE));
+}
+
+/**
+ * \brief rotate
+ * Plain complex multiply; std::complex<float>::operator*
+ * carries the C99 Annex G inf/nan recovery which prevents
+ * the compiler from keeping it inline
+ */
+static inline DSPCOMPLEX rotate(const DSPCOMPLEX& a, const DSPCOMPLEX& b)
+{
+    return DSPCOMPLEX(a.real() * b.real() - a.imag() * b.imag(),
+            a.real() * b.imag() + a.imag() * b.real());
+}
+
+/**
+ * \brief mixSamples
+ * Multiplies n samples by the matching oscillator values
+ * in place, and returns the sum of the L1 norms of the mixed
+ * samples weighted by the (per float lane) weights
+ */
+static float mixSamples(DSPCOMPLEX *v, const DSPCOMPLEX *osc,
+        const float *weights, int32_t n)
+{
+    float   level = 0;
+    int32_t i = 0;
+
+#ifdef OFDM_PROCESSOR_SSE2
+    float       *fv = reinterpret_cast<float *>(v);
+    const float *fo = reinterpret_cast<const float *>(osc);
+    const __m128 signmask = _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    const __m128 absmask  = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 acc = _mm_setzero_ps();
+
+    //  two complex samples per iteration: [re0, im0, re1, im1]
+    for (; i + 2 <= n; i += 2) {
+        __m128 a  = _mm_loadu_ps(fv + 2 * i);
+        __m128 b  = _mm_loadu_ps(fo + 2 * i);
+        __m128 br = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 bi = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 as = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 r  = _mm_add_ps(_mm_mul_ps(a, br),
+                _mm_xor_ps(_mm_mul_ps(as, bi), signmask));
+        _mm_storeu_ps(fv + 2 * i, r);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_and_ps(r, absmask),
+                    _mm_loadu_ps(weights + 2 * i)));
+    }
+
+    acc   = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc   = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+    level = _mm_cvtss_f32(acc);
+#endif
+
+    for (; i < n; i ++) {
+        v[i]   = rotate(v[i], osc[i]);
+        level += weights[2 * i] * l1_norm(v[i]);
+    }
+
+    return level;
+}
 
 /**
   * \brief OFDMProcessor
@@ -76,7 +163,6 @@ OFDMProcessor::OFDMProcessor(
     T_u(params.T_u),
     T_s(params.T_s),
     T_F(params.T_F),
-    oscillatorTable(INPUT_RATE),
     phaseRef(params, rro.fftPlacementMethod),
     ofdmDecoder(params, ri, fic, msc),
     fft_handler(params.T_u),
@@ -97,9 +183,21 @@ OFDMProcessor::OFDMProcessor(
      * the decoded symbols
      */
 
-    for (int i = 0; i < INPUT_RATE; i ++)
-        oscillatorTable[i] = DSPCOMPLEX(cos(2.0 * M_PI * i / INPUT_RATE),
-                sin(2.0 * M_PI * i / INPUT_RATE));
+    /**
+     * The oscillator is a recursive NCO that is reseeded with
+     * the exact value every NCO_BLOCK samples. sLevel is updated
+     * per block, using the weights that the per-sample IIR
+     * would have applied to each sample of the block
+     */
+    ncoBuffer.resize(NCO_BLOCK);
+    levelWeights.resize(2 * NCO_BLOCK);
+    levelDecay.resize(NCO_BLOCK + 1);
+    for (int i = 0; i < NCO_BLOCK; i ++) {
+        levelWeights[2 * i] = levelWeights[2 * i + 1] =
+            LEVEL_ALPHA * pow(1 - LEVEL_ALPHA, NCO_BLOCK - 1 - i);
+    }
+    for (int i = 0; i <= NCO_BLOCK; i ++)
+        levelDecay[i] = pow(1 - LEVEL_ALPHA, i);
 
     //  and for the correlation
     refArg.resize(CORRELATION_LENGTH);
@@ -109,6 +207,9 @@ OFDMProcessor::OFDMProcessor(
     }
 
     correlationVector.resize(SEARCH_RANGE + CORRELATION_LENGTH);
+
+    //  read-ahead block used by getSample
+    sampleBuffer.resize(SAMPLE_BLOCK_SIZE);
 }
 
 OFDMProcessor::~OFDMProcessor()
@@ -134,6 +235,11 @@ void OFDMProcessor::restart()
     syncBufferIndex    = 0;
     sLevel             = 0;
     localPhase         = 0;
+    ncoPhase           = 0;
+    ncoStep            = DSPCOMPLEX(1, 0);
+    ncoCount           = NCO_BLOCK;
+    sampleBufferIndex  = 0;
+    sampleBufferCount  = 0;
     input.restart();
     running            = true;
     threadHandle       = std::thread(&OFDMProcessor::run, this);
@@ -142,12 +248,36 @@ void OFDMProcessor::restart()
 class InputFailure { };
 class NotRunningAnymore { };
 
+/**
+ * \brief waitForSamples
+ * Blocks until the input has at least n samples available
+ * to read, rather than polling the input for them.  The wait
+ * is done in slices so that a stop request or an input failure
+ * is still noticed when the device has gone quiet
+ */
+
+int32_t OFDMProcessor::waitForSamples(int32_t n)
+{
+    while (running) {
+        int32_t available = input.waitForSamples(n, INPUT_WAIT_MS);
+        if (available >= n)
+            return available;
+        if (not input.is_ok()) {
+            throw InputFailure();
+        }
+    }
+
+    throw NotRunningAnymore();
+}
+
 /**
  * \brief getSample
  * Profiling shows that getting a sample, together
  * with the frequency shift, is a real performance killer.
  * we therefore distinguish between getting a single sample
- * and getting a vector full of samples
+ * and getting a vector full of samples.  Single samples are
+ * served out of a block read ahead from the input; anything
+ * left in the block is drained first by getSamples
  */
 
 DSPCOMPLEX OFDMProcessor::getSample(int32_t phase)
@@ -155,32 +285,38 @@ DSPCOMPLEX OFDMProcessor::getSample(int32_t phase)
     DSPCOMPLEX temp;
     if (!running)
         throw NotRunningAnymore();
-    /// bufferContent is an indicator for the value of ...->Samples ()
-    if (bufferContent == 0) {
-        bufferContent = input.getSamplesToRead ();
-        while ((bufferContent == 0) && running) {
-            if (not input.is_ok()) {
-                throw InputFailure();
-            }
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-            bufferContent = input.getSamplesToRead ();
-        }
+
+    if (sampleBufferIndex == sampleBufferCount) {
+        int32_t available = waitForSamples(1);
+        sampleBufferCount = input.getSamples(sampleBuffer.data(),
+                std::min(available, static_cast<int32_t>(sampleBuffer.size())));
+        sampleBufferIndex = 0;
     }
 
-    if (!running)
-        throw NotRunningAnymore();
     //
-    //  so here, bufferContent > 0
-    input.getSamples (&temp, 1);
-    bufferContent --;
+    //  so here, sampleBufferIndex < sampleBufferCount
+    temp = sampleBuffer[sampleBufferIndex ++];
 
     //
     //  OK, we have a sample!!
     //  first: adjust frequency. We need Hz accuracy
     localPhase  -= phase;
     localPhase  = (localPhase + INPUT_RATE) % INPUT_RATE;
-    temp        *= oscillatorTable[localPhase];
-    sLevel      = 0.00001 * l1_norm(temp) + (1 - 0.00001) * sLevel;
+    if (phase != ncoPhase) {
+        ncoPhase    = phase;
+        ncoStep     = oscillator(-phase);
+        ncoCount    = NCO_BLOCK;
+    }
+    if (ncoCount >= NCO_BLOCK) {
+        ncoValue    = oscillator(localPhase);
+        ncoCount    = 1;
+    }
+    else {
+        ncoValue    = rotate(ncoValue, ncoStep);
+        ncoCount    ++;
+    }
+    temp        = rotate(temp, ncoValue);
+    sLevel      = LEVEL_ALPHA * l1_norm(temp) + (1 - LEVEL_ALPHA) * sLevel;
 #define N   5
     sampleCnt   ++;
     if (++ sampleCnt > INPUT_RATE / N) {
@@ -194,34 +330,47 @@ DSPCOMPLEX OFDMProcessor::getSample(int32_t phase)
 void OFDMProcessor::getSamples(DSPCOMPLEX *v, int16_t n, int32_t phase)
 {
     int32_t     i;
+    int32_t     count;
 
     if (!running)
         throw NotRunningAnymore();
-    if (n > bufferContent) {
-        bufferContent = input.getSamplesToRead ();
-        while ((bufferContent < n) && running) {
-            if (not input.is_ok()) {
-                throw InputFailure();
-            }
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-            bufferContent = input.getSamplesToRead();
-        }
+
+    //  first drain whatever is left of the block read ahead by getSample
+    count = std::min(static_cast<int32_t>(n), sampleBufferCount - sampleBufferIndex);
+    std::copy(sampleBuffer.data() + sampleBufferIndex,
+            sampleBuffer.data() + sampleBufferIndex + count, v);
+    sampleBufferIndex += count;
+
+    //  and wait for the input to provide the remainder
+    if (count < n) {
+        waitForSamples(n - count);
+        count += input.getSamples(v + count, n - count);
     }
-    if (!running)
-        throw NotRunningAnymore();
-    //
-    //  so here, bufferContent >= n
-    n = input.getSamples (v, n);
-    bufferContent -= n;
+    n = count;
 
     //  OK, we have samples!!
     //  first: adjust frequency. We need Hz accuracy
-    for (i = 0; i < n; i ++) {
+    if (phase != ncoPhase) {
+        ncoPhase    = phase;
+        ncoStep     = oscillator(-phase);
+    }
+    for (i = 0; i < n; i += NCO_BLOCK) {
+        int32_t m = std::min(static_cast<int32_t>(n) - i, NCO_BLOCK);
+
+        //  seed the block with the exact oscillator value, then rotate
         localPhase  -= phase;
         localPhase   = (localPhase + INPUT_RATE) % INPUT_RATE;
-        v[i]    *= oscillatorTable[localPhase];
-        sLevel   = 0.00001 * l1_norm(v[i]) + (1 - 0.00001) * sLevel;
+        ncoBuffer[0] = oscillator(localPhase);
+        for (int32_t j = 1; j < m; j ++)
+            ncoBuffer[j] = rotate(ncoBuffer[j - 1], ncoStep);
+        localPhase   = static_cast<int32_t>(oscillatorIndex(
+                    localPhase - static_cast<int64_t>(m - 1) * phase));
+
+        sLevel = levelDecay[m] * sLevel + mixSamples(&v[i], ncoBuffer.data(),
+                &levelWeights[2 * (NCO_BLOCK - m)], m);
+        ncoValue = ncoBuffer[m - 1];
     }
+    ncoCount = NCO_BLOCK;
 
     sampleCnt += n;
     if (sampleCnt > INPUT_RATE / N) {
@@ -88,9 +88,14 @@ class OFDMProcessor
         int32_t T_F;
         int32_t coarseSyncCounter = 0;
 
-        std::vector<DSPCOMPLEX> oscillatorTable;
-
         int32_t localPhase = 0;
+        int32_t ncoPhase = 0;
+        int32_t ncoCount = 0;
+        DSPCOMPLEX ncoValue = DSPCOMPLEX(1, 0);
+        DSPCOMPLEX ncoStep = DSPCOMPLEX(1, 0);
+        std::vector<DSPCOMPLEX> ncoBuffer;
+        std::vector<float> levelWeights;
+        std::vector<float> levelDecay;
 
         float sLevel = 0;
         int32_t sampleCnt = 0;
@@ -109,11 +114,14 @@ class OFDMProcessor
         bool scanMode = false;
         int attempts = 0;
 
-        int32_t bufferContent = 0;
+        std::vector<DSPCOMPLEX> sampleBuffer;
+        int32_t sampleBufferIndex = 0;
+        int32_t sampleBufferCount = 0;
 
         fft::Forward fft_handler;
         DSPCOMPLEX *fft_buffer; // of size T_u
 
+        int32_t waitForSamples(int32_t);
         DSPCOMPLEX getSample(int32_t);
         void getSamples(DSPCOMPLEX *, int16_t, int32_t);
         void run(void);
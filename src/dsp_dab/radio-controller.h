@@ -151,6 +151,18 @@ class ProgrammeHandlerInterface {
          * used.  */
         virtual void onNewAudio(std::vector<int16_t>&& audioData, int sampleRate, const std::string& mode) {}
 
+        /* Return true to receive the undecoded audio frames through
+         * onNewCompressedAudio instead of decoded PCM through onNewAudio.
+         * This is queried once when decoding of the programme starts. */
+        virtual bool wantsCompressedAudio(void) { return false; }
+
+        /* New undecoded audio data is available. format is "mp2" for a
+         * complete MPEG-1/2 Layer II frame or "aac" for a single AAC access
+         * unit wrapped in a LATM/LOAS AudioSyncStream, which carries the
+         * AudioSpecificConfig in-band. durationMs is the playback duration
+         * of the frame.  */
+        virtual void onNewCompressedAudio(std::vector<uint8_t>&& data, size_t durationMs, const std::string& format) {}
+
         /* (DAB+ only) Reed-Solomon decoding error indicator, and
          * number of corrected errors.
          * The function will also be called in the absence of errors,
@@ -223,6 +235,7 @@ public:
     virtual bool restart(void) = 0;
     virtual int32_t getSamples(DSPCOMPLEX* buffer, int32_t size) = 0;
     virtual int32_t getSamplesToRead(void) = 0;
+    virtual int32_t waitForSamples(int32_t count, int32_t timeoutms) = 0;
 };
 
 #endif
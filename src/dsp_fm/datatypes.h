@@ -11,12 +11,16 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <cmath>
+#include <mutex>
 
-// uncomment to use double precision math
+// uncomment to make double precision the default sample type of the DSP
+// class templates; both precisions can be instantiated either way
 // #define FMDSP_USE_DOUBLE_PRECISION
 
-// uncomment to enable thread safety mechanisms
-// #define FMDSP_THREAD_SAFE
+// comment out to use only the built-in Ooura FFT instead of FFTW; FFTW is
+// linked in single precision only, double precision samples always use Ooura
+#define FMDSP_USE_FFTW
 
 // Qt compatibility
 //
@@ -31,17 +35,15 @@ typedef uint32_t quint32;
 typedef float tSReal;
 typedef double tDReal;
 
-typedef struct _sCplx
+template<typename T>
+struct tComplex
 {
-	tSReal re;
-	tSReal im;
-}tSComplex;
+	T re;
+	T im;
+};
 
-typedef struct _dCplx
-{
-	tDReal re;
-	tDReal im;
-}tDComplex;
+typedef tComplex<tSReal> tSComplex;
+typedef tComplex<tDReal> tDComplex;
 
 typedef struct _isCplx
 {
@@ -92,6 +94,7 @@ typedef union
 	unsigned short all;
 }tBtoS;
 
+//default sample type of the DSP class templates
 #ifdef FMDSP_USE_DOUBLE_PRECISION
  #define TYPEREAL tDReal
  #define TYPECPX	tDComplex
@@ -126,6 +129,20 @@ typedef union
  #define MATAN2(x,y) atan2f(x,y)
 #endif
 
+//sample type independent math functions for the DSP class templates, called
+//with the sample type (ie TSIN<T>(x)) to get the float or double version
+template<typename T> inline T TSIN(T x) { return std::sin(x); }
+template<typename T> inline T TCOS(T x) { return std::cos(x); }
+template<typename T> inline T TPOW(T x, T y) { return std::pow(x, y); }
+template<typename T> inline T TEXP(T x) { return std::exp(x); }
+template<typename T> inline T TFABS(T x) { return std::fabs(x); }
+template<typename T> inline T TLOG(T x) { return std::log(x); }
+template<typename T> inline T TLOG10(T x) { return std::log10(x); }
+template<typename T> inline T TSQRT(T x) { return std::sqrt(x); }
+template<typename T> inline T TATAN(T x) { return std::atan(x); }
+template<typename T> inline T TFMOD(T x, T y) { return std::fmod(x, y); }
+template<typename T> inline T TATAN2(T y, T x) { return std::atan2(y, x); }
+
 #define TYPESTEREO16 tStereo16
 #define TYPEMONO16 qint16
 
@@ -140,5 +157,17 @@ typedef union
 #define NULL 0
 #endif
 
+//Locking policies for the CFir, CFastFIR, CFft, CDownConvert and CDemodulator
+//templates.  Use CMutexLock for instances shared between threads and CNoLock
+//for instances only used from one thread; CNoLock compiles away to nothing.
+class CNoLock
+{
+public:
+	void lock() {}
+	void unlock() {}
+};
+
+typedef std::mutex CMutexLock;
+
 
 #endif // DATATYPES_H
@@ -43,12 +43,13 @@
 //////////////////////////////////////////////////////////////////
 //	Constructor/Destructor
 //////////////////////////////////////////////////////////////////
-CDemodulator::CDemodulator()
+template<typename T, class LOCK>
+CDemodulator<T, LOCK>::CDemodulator()
 {
 	m_DownConverterOutputRate = 48000.0;
 	m_DemodOutputRate = 48000.0;
-	m_pDemodInBuf = new TYPECPX[MAX_INBUFSIZE];
-	m_pDemodTmpBuf = new TYPECPX[MAX_INBUFSIZE];
+	m_pDemodInBuf = new tComplex<T>[MAX_INBUFSIZE];
+	m_pDemodTmpBuf = new tComplex<T>[MAX_INBUFSIZE];
 	m_InBufPos = 0;
 	m_InBufLimit = 1000;
 	m_DemodMode = -1;
@@ -58,7 +59,8 @@ CDemodulator::CDemodulator()
 	SetDemodFreq(0.0);
 }
 
-CDemodulator::~CDemodulator()
+template<typename T, class LOCK>
+CDemodulator<T, LOCK>::~CDemodulator()
 {
 	DeleteAllDemods();
 	if(m_pDemodInBuf)
@@ -70,7 +72,8 @@ CDemodulator::~CDemodulator()
 //////////////////////////////////////////////////////////////////
 //	Deletes all demod objects
 //////////////////////////////////////////////////////////////////
-void CDemodulator::DeleteAllDemods()
+template<typename T, class LOCK>
+void CDemodulator<T, LOCK>::DeleteAllDemods()
 {
 	if(m_pFmDemod)
 		delete m_pFmDemod;
@@ -83,7 +86,8 @@ void CDemodulator::DeleteAllDemods()
 //////////////////////////////////////////////////////////////////
 //	Called to set/change the demodulator input sample rate
 //////////////////////////////////////////////////////////////////
-void CDemodulator::SetInputSampleRate(TYPEREAL InputRate)
+template<typename T, class LOCK>
+void CDemodulator<T, LOCK>::SetInputSampleRate(T InputRate)
 {
 	if(m_InputRate != InputRate)
 	{
@@ -110,11 +114,10 @@ void CDemodulator::SetInputSampleRate(TYPEREAL InputRate)
 //	Called to set/change the active Demod object
 //or if a demod parameter or filter parameter changes
 //////////////////////////////////////////////////////////////////
-void CDemodulator::SetDemod(int Mode, tDemodInfo CurrentDemodInfo)
+template<typename T, class LOCK>
+void CDemodulator<T, LOCK>::SetDemod(int Mode, tDemodInfo CurrentDemodInfo)
 {
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	m_DownConvert.SetQuality(CurrentDemodInfo.WfmDownsampleQuality);
 
@@ -130,12 +133,12 @@ void CDemodulator::SetDemod(int Mode, tDemodInfo CurrentDemodInfo)
 		{
 			case DEMOD_FM:
 				m_DownConverterOutputRate = m_DownConvert.SetDataRate(m_InputRate, m_DesiredMaxOutputBandwidth);
-				m_pFmDemod = new CFmDemod(m_DownConverterOutputRate);
+				m_pFmDemod = new CFmDemod<T>(m_DownConverterOutputRate);
 				m_DemodOutputRate = m_DownConverterOutputRate;
 				break;
 			case DEMOD_WFM:
 				m_DownConverterOutputRate = m_DownConvert.SetWfmDataRate(m_InputRate, 100000);
-				m_pWFmDemod = new CWFmDemod(m_DownConverterOutputRate);
+				m_pWFmDemod = new CWFmDemod<T>(m_DownConverterOutputRate);
 				m_DemodOutputRate = m_pWFmDemod->GetDemodRate();
 				break;
 		}
@@ -156,13 +159,12 @@ void CDemodulator::SetDemod(int Mode, tDemodInfo CurrentDemodInfo)
 //	Called with complex data from radio and performs the demodulation
 // with MONO audio output
 //////////////////////////////////////////////////////////////////
-int CDemodulator::ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
+template<typename T, class LOCK>
+int CDemodulator<T, LOCK>::ProcessData(int InLength, tComplex<T>* pInData, T* pOutData)
 {
 int ret = 0;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	for(int i=0; i<InLength; i++)
 	{	//place in demod buffer
@@ -204,13 +206,12 @@ int ret = 0;
 //	Called with complex data from radio and performs the demodulation
 // with STEREO audio output
 //////////////////////////////////////////////////////////////////
-int CDemodulator::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template<typename T, class LOCK>
+int CDemodulator<T, LOCK>::ProcessData(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData)
 {
 int ret = 0;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	for(int i=0; i<InLength; i++)
 	{	//place in demod buffer
@@ -250,16 +251,17 @@ int ret = 0;
 }
 
 // Added to provide a running signal quality calculations
-void CDemodulator::MeasureSignalQuality(int length, TYPECPX* pInData)
+template<typename T, class LOCK>
+void CDemodulator<T, LOCK>::MeasureSignalQuality(int length, tComplex<T>* pInData)
 {
 	int sample_index = 0;			// Index into current sample set
 
 	if(length <= 0) return;
 
 	// Get the level of the first sample
-	TYPEREAL& re = pInData[sample_index].re;
-	TYPEREAL& im = pInData[sample_index].im;
-	TYPEREAL level = (re * re) + (im * im);
+	T& re = pInData[sample_index].re;
+	T& im = pInData[sample_index].im;
+	T level = (re * re) + (im * im);
 
 	// First sample, reset sum and sum squared to new values
 	if(m_smeter_samples == 0) {
@@ -283,7 +285,7 @@ void CDemodulator::MeasureSignalQuality(int length, TYPECPX* pInData)
 		if(level > m_smeter_max) m_smeter_max = level;
 		m_smeter_samples++;
 
-		m_smeter_variance_new_m = m_smeter_variance_old_m + (level - m_smeter_variance_old_m) / static_cast<TYPEREAL>(m_smeter_samples);
+		m_smeter_variance_new_m = m_smeter_variance_old_m + (level - m_smeter_variance_old_m) / static_cast<T>(m_smeter_samples);
 		m_smeter_variance_new_s = m_smeter_variance_old_s + (level - m_smeter_variance_old_m) * (level - m_smeter_variance_new_m);
 		m_smeter_variance_old_m = m_smeter_variance_new_m;
 		m_smeter_variance_old_s = m_smeter_variance_new_s;
@@ -293,7 +295,8 @@ void CDemodulator::MeasureSignalQuality(int length, TYPECPX* pInData)
 }
 
 // Retrieves the signal levels from the demodulator and resets the statistics
-void CDemodulator::GetSignalLevels(TYPEREAL& quality, TYPEREAL& snr)
+template<typename T, class LOCK>
+void CDemodulator<T, LOCK>::GetSignalLevels(T& quality, T& snr)
 {
 	quality = snr = 0;
 
@@ -301,15 +304,23 @@ void CDemodulator::GetSignalLevels(TYPEREAL& quality, TYPEREAL& snr)
 	if(m_smeter_samples > 1) {
 
 		// Calcluate the variance, standard deviation, and coeficient of variation
-		TYPEREAL variance = m_smeter_variance_new_s / static_cast<TYPEREAL>(m_smeter_samples - 1);
-		TYPEREAL sd = sqrt(variance);
-		TYPEREAL cv = sd / fabs(m_smeter_sum / static_cast<TYPEREAL>(m_smeter_samples));
+		T variance = m_smeter_variance_new_s / static_cast<T>(m_smeter_samples - 1);
+		T sd = sqrt(variance);
+		T cv = sd / fabs(m_smeter_sum / static_cast<T>(m_smeter_samples));
 		quality = 1.0 - cv;
 	}
 
 	// SNR is based on ratio of the mean and the maximum power levels
-	TYPEREAL mean = m_smeter_sum / static_cast<TYPEREAL>(m_smeter_samples);
+	T mean = m_smeter_sum / static_cast<T>(m_smeter_samples);
 	snr = mean / m_smeter_max;
 
 	m_smeter_samples = 0;				// Reset statistics on next pass
 }
+
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types and locking policies
+//////////////////////////////////////////////////////////////////////
+template class CDemodulator<tSReal, CNoLock>;
+template class CDemodulator<tSReal, CMutexLock>;
+template class CDemodulator<tDReal, CNoLock>;
+template class CDemodulator<tDReal, CMutexLock>;
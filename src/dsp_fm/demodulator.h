@@ -67,21 +67,22 @@ typedef struct _sdmd
 
 }tDemodInfo;
 
+template<typename T = TYPEREAL, class LOCK = CNoLock>
 class CDemodulator
 {
 public:
 	CDemodulator();
 	virtual ~CDemodulator();
 
-	void SetInputSampleRate(TYPEREAL InputRate);
-	TYPEREAL GetOutputRate(){return m_DemodOutputRate;}
+	void SetInputSampleRate(T InputRate);
+	T GetOutputRate(){return m_DemodOutputRate;}
 
 	void SetDemod(int Mode, tDemodInfo CurrentDemodInfo);
-	void SetDemodFreq(TYPEREAL Freq){m_DownConvert.SetFrequency(Freq);}
+	void SetDemodFreq(T Freq){m_DownConvert.SetFrequency(Freq);}
 
 	//overloaded functions to perform demod mono or stereo
-	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
-	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
+	int ProcessData(int InLength, tComplex<T>* pInData, T* pOutData);
+	int ProcessData(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData);
 
 	void SetUSFmVersion(bool USFm){m_USFm = USFm;}
 	bool GetUSFmVersion(){return m_USFm;}
@@ -100,40 +101,38 @@ public:
 	}
 
 	// Gets the signal quality values
-	void GetSignalLevels(TYPEREAL& quality, TYPEREAL& snr);
+	void GetSignalLevels(T& quality, T& snr);
 
 private:
 	void DeleteAllDemods();
-	CDownConvert m_DownConvert;
-	CFastFIR m_FastFIR;
-#ifdef FMDSP_THREAD_SAFE
-	mutable std::mutex m_Mutex;		//for keeping threads from stomping on each other
-#endif
+	CDownConvert<T> m_DownConvert;
+	CFastFIR<T> m_FastFIR;
+	mutable LOCK m_Mutex;		//for keeping threads from stomping on each other
 	tDemodInfo m_DemodInfo;
-	TYPEREAL m_InputRate = 0;
-	TYPEREAL m_DownConverterOutputRate;
-	TYPEREAL m_DemodOutputRate;
-	TYPEREAL m_DesiredMaxOutputBandwidth;
-	TYPECPX* m_pDemodInBuf;
-	TYPECPX* m_pDemodTmpBuf;
+	T m_InputRate = 0;
+	T m_DownConverterOutputRate;
+	T m_DemodOutputRate;
+	T m_DesiredMaxOutputBandwidth;
+	tComplex<T>* m_pDemodInBuf;
+	tComplex<T>* m_pDemodTmpBuf;
 	bool m_USFm;
 	int m_DemodMode;
 	int m_InBufPos;
 	int m_InBufLimit;
 	//pointers to all the various implemented demodulator classes
-	CFmDemod* m_pFmDemod;
-	CWFmDemod* m_pWFmDemod;
+	CFmDemod<T>* m_pFmDemod;
+	CWFmDemod<T>* m_pWFmDemod;
 
 	// Signal quality calculations
-	void MeasureSignalQuality(int n, TYPECPX* pInData);
+	void MeasureSignalQuality(int n, tComplex<T>* pInData);
 
 	int m_smeter_samples = 0;
-	TYPEREAL m_smeter_max = 0;
-	TYPEREAL m_smeter_sum = 0;
-	TYPEREAL m_smeter_variance_old_m = 0;
-	TYPEREAL m_smeter_variance_new_m = 0;
-	TYPEREAL m_smeter_variance_old_s = 0;
-	TYPEREAL m_smeter_variance_new_s = 0;
+	T m_smeter_max = 0;
+	T m_smeter_sum = 0;
+	T m_smeter_variance_old_m = 0;
+	T m_smeter_variance_new_m = 0;
+	T m_smeter_variance_old_s = 0;
+	T m_smeter_variance_new_s = 0;
 };
 
 #endif // DEMODULATOR_H
@@ -44,6 +44,9 @@
 #include <algorithm>
 #include <assert.h>
 #include <string.h>
+#include <utility>
+
+#include "../utils/simd.h"
 
 //pick a method of calculating the NCO
 #define NCO_LIB 0		//normal sin cos library (188nS)
@@ -53,12 +56,11 @@
 
 #define MIN_OUTPUT_RATE (7900.0*2.0)
 
-#define MAX_HALF_BAND_BUFSIZE 32768
-
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CDownConvert()
+template<typename T, class LOCK>
+CDownConvert<T, LOCK>::CDownConvert()
 {
 int i;
 	m_NcoInc = 0.0;
@@ -72,7 +74,8 @@ int i;
 	m_Osc1.im = 0.0;
 }
 
-CDownConvert::~CDownConvert()
+template<typename T, class LOCK>
+CDownConvert<T, LOCK>::~CDownConvert()
 {
 	DeleteFilters();
 }
@@ -80,7 +83,8 @@ CDownConvert::~CDownConvert()
 //////////////////////////////////////////////////////////////////////
 // Delete all active Filters in m_pDecimatorPtrs array
 //////////////////////////////////////////////////////////////////////
-void CDownConvert::DeleteFilters()
+template<typename T, class LOCK>
+void CDownConvert<T, LOCK>::DeleteFilters()
 {
 	for(int i=0; i<MAX_DECSTAGES; i++)
 	{
@@ -95,12 +99,13 @@ void CDownConvert::DeleteFilters()
 //////////////////////////////////////////////////////////////////////
 // Sets NCO Frequency parameters
 //////////////////////////////////////////////////////////////////////
-void CDownConvert::SetFrequency(TYPEREAL NcoFreq)
+template<typename T, class LOCK>
+void CDownConvert<T, LOCK>::SetFrequency(T NcoFreq)
 {
 	m_NcoFreq = NcoFreq;
 	m_NcoInc = K_2PI*m_NcoFreq/m_InRate;
-	m_OscCos = MCOS(m_NcoInc);
-	m_OscSin = MSIN(m_NcoInc);
+	m_OscCos = TCOS<T>(m_NcoInc);
+	m_OscSin = TSIN<T>(m_NcoInc);
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -108,19 +113,18 @@ void CDownConvert::SetFrequency(TYPEREAL NcoFreq)
 // input sample rate and desired output bandwidth.  Returns final output rate
 //from divide by 2 stages.
 //////////////////////////////////////////////////////////////////////
-TYPEREAL CDownConvert::SetDataRate(TYPEREAL InRate, TYPEREAL MaxBW)
+template<typename T, class LOCK>
+T CDownConvert<T, LOCK>::SetDataRate(T InRate, T MaxBW)
 {
 int n = 0;
-TYPEREAL f = InRate;
+T f = InRate;
 	if( (m_InRate!=InRate) ||
 		(m_MaxBW!=MaxBW) )
 	{
 		m_InRate = InRate;
 		m_MaxBW = MaxBW;
 
-	#ifdef FMDSP_THREAD_SAFE
-		std::unique_lock<std::mutex> lock(m_Mutex);
-	#endif
+		std::unique_lock<LOCK> lock(m_Mutex);
 
 		DeleteFilters();
 		//loop until closest output rate is found and list of pointers to decimate by 2 stages is generated
@@ -131,43 +135,41 @@ TYPEREAL f = InRate;
 						new CCicN3DecimateBy2;
 			else if(f >= (m_MaxBW / HB11TAP_MAX) )	//See if can use fixed 11 Tap Halfband
 				m_pDecimatorPtrs[n++] =
-						new CHalfBand11TapDecimateBy2();
+						new CHalfBandDecimateBy2<HB11TAP_LENGTH>(HB11TAP_H<T>);
 			else if(f >= (m_MaxBW / HB15TAP_MAX) )	//See if can use Halfband 15 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB15TAP_LENGTH, HB15TAP_H);
+						new CHalfBandDecimateBy2<HB15TAP_LENGTH>(HB15TAP_H<T>);
 			else if(f >= (m_MaxBW / HB19TAP_MAX) )	//See if can use Halfband 19 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB19TAP_LENGTH, HB19TAP_H);
+						new CHalfBandDecimateBy2<HB19TAP_LENGTH>(HB19TAP_H<T>);
 			else if(f >= (m_MaxBW / HB23TAP_MAX) )	//See if can use Halfband 23 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB23TAP_LENGTH, HB23TAP_H);
+						new CHalfBandDecimateBy2<HB23TAP_LENGTH>(HB23TAP_H<T>);
 			else if(f >= (m_MaxBW / HB27TAP_MAX) )	//See if can use Halfband 27 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB27TAP_LENGTH, HB27TAP_H);
+						new CHalfBandDecimateBy2<HB27TAP_LENGTH>(HB27TAP_H<T>);
 			else if(f >= (m_MaxBW / HB31TAP_MAX) )	//See if can use Halfband 31 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB31TAP_LENGTH, HB31TAP_H);
+						new CHalfBandDecimateBy2<HB31TAP_LENGTH>(HB31TAP_H<T>);
 			else if(f >= (m_MaxBW / HB35TAP_MAX) )	//See if can use Halfband 35 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB35TAP_LENGTH, HB35TAP_H);
+						new CHalfBandDecimateBy2<HB35TAP_LENGTH>(HB35TAP_H<T>);
 			else if(f >= (m_MaxBW / HB39TAP_MAX) )	//See if can use Halfband 39 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB39TAP_LENGTH, HB39TAP_H);
+						new CHalfBandDecimateBy2<HB39TAP_LENGTH>(HB39TAP_H<T>);
 			else if(f >= (m_MaxBW / HB43TAP_MAX) )	//See if can use Halfband 43 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB43TAP_LENGTH, HB43TAP_H);
+						new CHalfBandDecimateBy2<HB43TAP_LENGTH>(HB43TAP_H<T>);
 			else if(f >= (m_MaxBW / HB47TAP_MAX) )	//See if can use Halfband 47 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
+						new CHalfBandDecimateBy2<HB47TAP_LENGTH>(HB47TAP_H<T>);
 			else if(f >= (m_MaxBW / HB51TAP_MAX) )	//See if can use Halfband 51 Tap
 				m_pDecimatorPtrs[n++] =
-						new CHalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
+						new CHalfBandDecimateBy2<HB51TAP_LENGTH>(HB51TAP_H<T>);
 			f /= 2.0;
 		}
 
-	#ifdef FMDSP_THREAD_SAFE
 		lock.unlock();
-	#endif
 
 		m_OutputRate = f;
 		SetFrequency(m_NcoFreq);
@@ -180,19 +182,18 @@ TYPEREAL f = InRate;
 // input sample rate and desired output bandwidth.  Returns final output rate
 //from divide by 2 stages.
 //////////////////////////////////////////////////////////////////////
-TYPEREAL CDownConvert::SetWfmDataRate(TYPEREAL InRate, TYPEREAL MaxBW)
+template<typename T, class LOCK>
+T CDownConvert<T, LOCK>::SetWfmDataRate(T InRate, T MaxBW)
 {
 int n = 0;
-TYPEREAL f = InRate;
+T f = InRate;
 	if( (m_InRate!=InRate) ||
 		(m_MaxBW!=MaxBW) )
 	{
 		m_InRate = InRate;
 		m_MaxBW = MaxBW;
 
-	#ifdef FMDSP_THREAD_SAFE
-		std::unique_lock<std::mutex> lock(m_Mutex);
-	#endif
+		std::unique_lock<LOCK> lock(m_Mutex);
 
 		DeleteFilters();
 
@@ -203,22 +204,22 @@ TYPEREAL f = InRate;
 
 				// HIGH: 51 tap
 				case DownsampleQuality::High:
-					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
+					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2<HB51TAP_LENGTH>(HB51TAP_H<T>);
 					break;
 
 				// MEDIUM: 27 tap
 				case DownsampleQuality::Medium:
-					m_pDecimatorPtrs[n++] = new CHalfBandDecimateBy2(HB27TAP_LENGTH, HB27TAP_H);
+					m_pDecimatorPtrs[n++] = new CHalfBandDecimateBy2<HB27TAP_LENGTH>(HB27TAP_H<T>);
 					break;
 
 				// LOW: 11 tap
 				case DownsampleQuality::Low:
-					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBand11TapDecimateBy2();
+					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2<HB11TAP_LENGTH>(HB11TAP_H<T>);
 					break;
 
 				// DEFAULT: 51 tap
 				default:
-					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
+					m_pDecimatorPtrs[n++] = new CDownConvert::CHalfBandDecimateBy2<HB51TAP_LENGTH>(HB51TAP_H<T>);
 					break;
 			}
 
@@ -226,9 +227,7 @@ TYPEREAL f = InRate;
 		}
 
 		m_OutputRate = f;
-	#ifdef FMDSP_THREAD_SAFE
 		lock.unlock();
-	#endif
 
 		SetFrequency(m_NcoFreq);
 	}
@@ -246,18 +245,19 @@ TYPEREAL f = InRate;
 // decimation by 2 stages expected.
 // ~50nSec/sample at decimation by 128
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template<typename T, class LOCK>
+int CDownConvert<T, LOCK>::ProcessData(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData)
 {
 int i,j;
-TYPECPX dtmp;
-TYPECPX Osc;
+tComplex<T> dtmp;
+tComplex<T> Osc;
 
 #if (NCO_VCASM || NCO_GCCASM)
-TYPEREAL	dPhaseAcc = m_NcoTime;
-TYPEREAL	dASMCos   = 0.0;
-TYPEREAL	dASMSin   = 0.0;
-TYPEREAL*	pdCosAns  = &dASMCos;
-TYPEREAL*	pdSinAns  = &dASMSin;
+T	dPhaseAcc = m_NcoTime;
+T	dASMCos   = 0.0;
+T	dASMSin   = 0.0;
+T*	pdCosAns  = &dASMCos;
+T*	pdSinAns  = &dASMSin;
 #endif
 
 //263uS using sin/cos or 70uS using quadrature osc or 200uS using _asm
@@ -265,11 +265,11 @@ TYPEREAL*	pdSinAns  = &dASMSin;
 	{
 		dtmp = pInData[i];
 #if NCO_LIB
-		Osc.re = MCOS(m_NcoTime);
-		Osc.im = MSIN(m_NcoTime);
+		Osc.re = TCOS<T>(m_NcoTime);
+		Osc.im = TSIN<T>(m_NcoTime);
 		m_NcoTime += m_NcoInc;
 #elif NCO_OSC
-		TYPEREAL OscGn;
+		T OscGn;
 		Osc.re = m_Osc1.re * m_OscCos - m_Osc1.im * m_OscSin;
 		Osc.im = m_Osc1.im * m_OscCos + m_Osc1.re * m_OscSin;
 		OscGn = 1.95 - (m_Osc1.re*m_Osc1.re + m_Osc1.im*m_Osc1.im);
@@ -302,7 +302,7 @@ TYPEREAL*	pdSinAns  = &dASMSin;
 #if (NCO_VCASM || NCO_GCCASM)
 	m_NcoTime = dPhaseAcc;
 #elif !NCO_OSC
-	m_NcoTime = MFMOD(m_NcoTime, K_2PI);	//keep radian counter bounded
+	m_NcoTime = TFMOD<T>(m_NcoTime, K_2PI);	//keep radian counter bounded
 #endif
 
 	//now perform decimation of pInData by calling decimate by 2 stages
@@ -310,18 +310,14 @@ TYPEREAL*	pdSinAns  = &dASMSin;
 	int n = InLength;
 	j = 0;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	while(m_pDecimatorPtrs[j])
 	{
 		n = m_pDecimatorPtrs[j++]->DecBy2(n, pInData, pInData);
 
 	}
-#ifdef FMDSP_THREAD_SAFE
 	lock.unlock();
-#endif
 	for(i=0; i<n; i++)
 		pOutData[i] = pInData[i];
 
@@ -331,159 +327,224 @@ TYPEREAL*	pdSinAns  = &dASMSin;
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Halfband filter class implementation
+// Half band filter kernels
+//  Each kernel computes 'count' outputs from x, where output k is
+//   sum(h[p] * (x[2k+2p] + x[2k+TAPS-1-2p])) + hc * x[2k+(TAPS-1)/2]
+//  for p = 0 to (TAPS+1)/4 - 1.  The tap loops are expanded at compile
+//  time over the folded tap pairs, and no kernel reads beyond the last
+//  sample of the last output's window.  The SIMD kernels process as many
+//  outputs as possible and return the number of outputs processed.
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CHalfBandDecimateBy2::CHalfBandDecimateBy2(int len,const TYPEREAL* pCoef )
-	: m_FirLength(len), m_pCoef(pCoef)
+template<int TAPS>
+using HalfBandFolds = std::make_integer_sequence<int, (TAPS + 1) / 4>;
+
+//scalar kernel, 1 output
+template<int TAPS, typename T, int... P>
+static inline tComplex<T> HalfBandScalar(const tComplex<T>* x, const T* h, T hc,
+										 std::integer_sequence<int, P...>)
 {
-	//create buffer for FIR implementation
-	m_pHBFirBuf = new TYPECPX[MAX_HALF_BAND_BUFSIZE];
-	TYPECPX CPXZERO = {0.0,0.0};
-	for(int i=0; i<MAX_HALF_BAND_BUFSIZE ;i++)
-		m_pHBFirBuf[i] = CPXZERO;
+	tComplex<T> acc;
+	acc.re = hc * x[(TAPS - 1) / 2].re;
+	acc.im = hc * x[(TAPS - 1) / 2].im;
+	((acc.re += h[P] * (x[2 * P].re + x[TAPS - 1 - (2 * P)].re),
+	  acc.im += h[P] * (x[2 * P].im + x[TAPS - 1 - (2 * P)].im)), ...);
+	return acc;
 }
 
-//////////////////////////////////////////////////////////////////////
-// Half band filter and decimate by 2 function.
-// Two restrictions on this routine:
-// InLength must be larger or equal to the Number of Halfband Taps
-// InLength must be an even number  ~37nS
-//////////////////////////////////////////////////////////////////////
-int CDownConvert::CHalfBandDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+#if defined(SIMD_X86)
+static const bool s_HasAvx2 = simd::has_avx2();
+
+//SSE2 kernel, 2 outputs per iteration
+// lo holds samples s,s+1 and hi holds s+1,s+2; gathers samples s,s+2
+template<int TAPS, int P>
+static inline __m128 HalfBandFoldSSE2(const float* x)
 {
-int i;
-int j;
-int numoutsamples = 0;
-	if(InLength<m_FirLength)	//safety net to make sure InLength is large enough to process
-		return InLength/2;
-	//copy input samples into buffer starting at position m_FirLength-1
-	for(i=0,j = m_FirLength - 1; i<InLength; i++)
-		m_pHBFirBuf[j++] = pInData[i];
-	//perform decimation FIR filter on even samples
-	for(i=0; i<InLength; i+=2)
-	{
-		TYPECPX acc;
-		acc.re = ( m_pHBFirBuf[i].re * m_pCoef[0] );
-		acc.im = ( m_pHBFirBuf[i].im * m_pCoef[0] );
-		for(j=0; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
-		{
-			acc.re += ( m_pHBFirBuf[i+j].re * m_pCoef[j] );
-			acc.im += ( m_pHBFirBuf[i+j].im * m_pCoef[j] );
-		}
-		//now multiply the center coefficient
-		acc.re += ( m_pHBFirBuf[i+(m_FirLength-1)/2].re * m_pCoef[(m_FirLength-1)/2] );
-		acc.im += ( m_pHBFirBuf[i+(m_FirLength-1)/2].im * m_pCoef[(m_FirLength-1)/2] );
-		pOutData[numoutsamples++] = acc;	//put output buffer
+	const float* f = x + (4 * P);						//sample 2p
+	const float* r = x + (2 * (TAPS - 1 - (2 * P)));	//sample TAPS-1-2p
+	__m128 lo = _mm_add_ps(_mm_loadu_ps(f), _mm_loadu_ps(r));
+	__m128 hi = _mm_add_ps(_mm_loadu_ps(f + 2), _mm_loadu_ps(r + 2));
+	return _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 2, 1, 0));
+}
 
-	}
-	//need to copy last m_FirLength - 1 input samples in buffer to beginning of buffer
-	// for FIR wrap around management
-	for(i=0,j = InLength-m_FirLength+1; i<m_FirLength - 1; i++)
-		m_pHBFirBuf[i] = pInData[j++];
+template<int TAPS, int... P>
+static inline void HalfBandSSE2(const float* x, const float* h, float hc, float* out,
+								std::integer_sequence<int, P...>)
+{
+	const float* c = x + (TAPS - 1);					//sample (TAPS-1)/2
+	__m128 acc = _mm_mul_ps(_mm_set1_ps(hc),
+			_mm_shuffle_ps(_mm_loadu_ps(c), _mm_loadu_ps(c + 2), _MM_SHUFFLE(3, 2, 1, 0)));
+	((acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(h[P]), HalfBandFoldSSE2<TAPS, P>(x)))), ...);
+	_mm_storeu_ps(out, acc);
+}
 
-	return numoutsamples;
+template<int TAPS>
+static int HalfBandKernelSSE2(int count, const tSComplex* x, const tSReal* h, tSReal hc, tSComplex* out)
+{
+	int blocks = count / 2;
+	for(int i=0; i<blocks; i++)
+		HalfBandSSE2<TAPS>((const float*)(x + (i * 4)), h, hc, (float*)(out + (i * 2)),
+						   HalfBandFolds<TAPS>());
+	return blocks * 2;
 }
 
-// *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
+//AVX2 kernel, 4 outputs per iteration
+// lo holds samples s..s+3 and hi holds s+3..s+6; the blend gathers samples
+// s,s+4,s+2,s+6 and the outputs are put back in order after accumulation
+template<int TAPS, int P>
+SIMD_TARGET_AVX2 static inline __m256 HalfBandFoldAVX2(const float* x)
+{
+	const float* f = x + (4 * P);						//sample 2p
+	const float* r = x + (2 * (TAPS - 1 - (2 * P)));	//sample TAPS-1-2p
+	__m256 lo = _mm256_add_ps(_mm256_loadu_ps(f), _mm256_loadu_ps(r));
+	__m256 hi = _mm256_add_ps(_mm256_loadu_ps(f + 6), _mm256_loadu_ps(r + 6));
+	return _mm256_castpd_ps(_mm256_blend_pd(_mm256_castps_pd(lo), _mm256_castps_pd(hi), 0xA));
+}
+
+template<int TAPS, int... P>
+SIMD_TARGET_AVX2 static inline void HalfBandAVX2(const float* x, const float* h, float hc, float* out,
+												 std::integer_sequence<int, P...>)
+{
+	const float* c = x + (TAPS - 1);					//sample (TAPS-1)/2
+	__m256d center = _mm256_blend_pd(_mm256_castps_pd(_mm256_loadu_ps(c)),
+									 _mm256_castps_pd(_mm256_loadu_ps(c + 6)), 0xA);
+	__m256 acc = _mm256_mul_ps(_mm256_set1_ps(hc), _mm256_castpd_ps(center));
+	((acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(h[P]), HalfBandFoldAVX2<TAPS, P>(x)))), ...);
+	_mm256_storeu_ps(out, _mm256_castpd_ps(
+			_mm256_permute4x64_pd(_mm256_castps_pd(acc), _MM_SHUFFLE(3, 1, 2, 0))));
+}
+
+template<int TAPS>
+SIMD_TARGET_AVX2 static int HalfBandKernelAVX2(int count, const tSComplex* x, const tSReal* h,
+											   tSReal hc, tSComplex* out)
+{
+	int blocks = count / 4;
+	for(int i=0; i<blocks; i++)
+		HalfBandAVX2<TAPS>((const float*)(x + (i * 8)), h, hc, (float*)(out + (i * 4)),
+						   HalfBandFolds<TAPS>());
+	return blocks * 4;
+}
+#endif
+
+#if defined(SIMD_NEON)
+//NEON kernel, 2 outputs per iteration
+// lo holds samples s,s+1 and hi holds s+1,s+2; gathers samples s,s+2
+template<int TAPS, int P>
+static inline float32x4_t HalfBandFoldNEON(const float* x)
+{
+	const float* f = x + (4 * P);						//sample 2p
+	const float* r = x + (2 * (TAPS - 1 - (2 * P)));	//sample TAPS-1-2p
+	float32x4_t lo = vaddq_f32(vld1q_f32(f), vld1q_f32(r));
+	float32x4_t hi = vaddq_f32(vld1q_f32(f + 2), vld1q_f32(r + 2));
+	return vcombine_f32(vget_low_f32(lo), vget_high_f32(hi));
+}
+
+template<int TAPS, int... P>
+static inline void HalfBandNEON(const float* x, const float* h, float hc, float* out,
+								std::integer_sequence<int, P...>)
+{
+	const float* c = x + (TAPS - 1);					//sample (TAPS-1)/2
+	float32x4_t acc = vmulq_n_f32(vcombine_f32(vget_low_f32(vld1q_f32(c)),
+											   vget_high_f32(vld1q_f32(c + 2))), hc);
+	((acc = vmlaq_n_f32(acc, HalfBandFoldNEON<TAPS, P>(x), h[P])), ...);
+	vst1q_f32(out, acc);
+}
+
+template<int TAPS>
+static int HalfBandKernelNEON(int count, const tSComplex* x, const tSReal* h, tSReal hc, tSComplex* out)
+{
+	int blocks = count / 2;
+	for(int i=0; i<blocks; i++)
+		HalfBandNEON<TAPS>((const float*)(x + (i * 4)), h, hc, (float*)(out + (i * 2)),
+						   HalfBandFolds<TAPS>());
+	return blocks * 2;
+}
+#endif
+
+//runs the fastest available SIMD kernel on single precision samples
+template<int TAPS>
+static int HalfBandSIMD(int count, const tSComplex* x, const tSReal* h, tSReal hc, tSComplex* out)
+{
+	int i = 0;
+#if defined(SIMD_X86)
+	i = s_HasAvx2 ? HalfBandKernelAVX2<TAPS>(count, x, h, hc, out) :
+					HalfBandKernelSSE2<TAPS>(count, x, h, hc, out);
+#elif defined(SIMD_NEON)
+	i = HalfBandKernelNEON<TAPS>(count, x, h, hc, out);
+#else
+	(void)count; (void)x; (void)h; (void)hc; (void)out;
+#endif
+	return i;
+}
+
+//the SIMD kernels are single precision only
+template<int TAPS>
+static int HalfBandSIMD(int, const tDComplex*, const tDReal*, tDReal, tDComplex*)
+{
+	return 0;
+}
+
+//runs the SIMD kernels and finishes the remaining outputs with the scalar kernel
+template<int TAPS, typename T>
+static void HalfBandFilter(int count, const tComplex<T>* x, const T* h, T hc, tComplex<T>* out)
+{
+	int i = HalfBandSIMD<TAPS>(count, x, h, hc, out);
+	for( ; i<count; i++)
+		out[i] = HalfBandScalar<TAPS>(x + (i * 2), h, hc, HalfBandFolds<TAPS>());
+}
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Fixed 11 Tap Halfband filter class implementation
-// Loop unrolled for speed ~9nS /samp
+//Decimate by 2 Halfband filter class implementation
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CHalfBand11TapDecimateBy2::CHalfBand11TapDecimateBy2()
+template<typename T, class LOCK>
+template<int TAPS>
+CDownConvert<T, LOCK>::CHalfBandDecimateBy2<TAPS>::CHalfBandDecimateBy2(const T* pCoef)
 {
-	//preload only the taps that are used since evey other one is zero
-	//except center tap 5
-	H0 = HB11TAP_H[0]; H2 = HB11TAP_H[2]; H4 = HB11TAP_H[4];
-	H5 = HB11TAP_H[5];
-	H6 = HB11TAP_H[6]; H8 = HB11TAP_H[8]; H10 = HB11TAP_H[10];
-	TYPECPX CPXZERO = {0.0,0.0};
-	d0 = CPXZERO; d1 = CPXZERO;	d2 = CPXZERO; d3 = CPXZERO;
-	d4 = CPXZERO; d5 = CPXZERO;	d6 = CPXZERO; d7 = CPXZERO;
-	d8 = CPXZERO; d9 = CPXZERO;
+	//preload only the taps that are used since every other one is zero
+	//except the center tap, and the filter is symmetric
+	for(int i=0; i<(TAPS + 1) / 4; i++)
+		m_Coef[i] = pCoef[i * 2];
+	m_Center = pCoef[(TAPS - 1) / 2];
+	memset(m_Work, 0, sizeof(m_Work));
+	memset(m_Head, 0, sizeof(m_Head));
 }
 
 //////////////////////////////////////////////////////////////////////
-//Decimate by 2 Fixed 11 Tap Halfband filter class implementation
+// Half band filter and decimate by 2 function.
 // Two restrictions on this routine:
-// InLength must be larger or equal to the Number of Halfband Taps(11)
+// InLength must be larger or equal to the Number of Halfband Taps
 // InLength must be an even number
-// Loop unrolled for speed ~15nS/samp
+// pInData and pOutData can be the same buffer; the input is filtered
+// in place except for the first TAPS-2 outputs, whose windows reach
+// back into the previous block
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::CHalfBand11TapDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template<typename T, class LOCK>
+template<int TAPS>
+int CDownConvert<T, LOCK>::CHalfBandDecimateBy2<TAPS>::DecBy2(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData)
 {
-	//first calculate beginning 10 samples using previous samples in delay buffer
-	TYPECPX tmpout[9];	//use temp buffer so outbuf can be same as inbuf
-	tmpout[0].re = H0*d0.re + H2*d2.re + H4*d4.re + H5*d5.re + H6*d6.re + H8*d8.re
-					 + H10*pInData[0].re;
-	tmpout[0].im = H0*d0.im + H2*d2.im + H4*d4.im + H5*d5.im + H6*d6.im + H8*d8.im
-					 + H10*pInData[0].im;
-
-	tmpout[1].re = H0*d2.re + H2*d4.re + H4*d6.re + H5*d7.re + H6*d8.re
-					 + H8*pInData[0].re + H10*pInData[2].re;
-	tmpout[1].im = H0*d2.im + H2*d4.im + H4*d6.im + H5*d7.im + H6*d8.im
-					 + H8*pInData[0].im + H10*pInData[2].im;
-
-	tmpout[2].re = H0*d4.re + H2*d6.re + H4*d8.re + H5*d9.re
-					 + H6*pInData[0].re + H8*pInData[2].re + H10*pInData[4].re;
-	tmpout[2].im = H0*d4.im + H2*d6.im + H4*d8.im + H5*d9.im
-					 + H6*pInData[0].im + H8*pInData[2].im + H10*pInData[4].im;
-
-	tmpout[3].re = H0*d6.re + H2*d8.re + H4*pInData[0].re + H5*pInData[1].re
-					 + H6*pInData[2].re + H8*pInData[4].re + H10*pInData[6].re;
-	tmpout[3].im = H0*d6.im + H2*d8.im + H4*pInData[0].im + H5*pInData[1].im
-					 + H6*pInData[2].im + H8*pInData[4].im + H10*pInData[6].im;
-
-	tmpout[4].re = H0*d8.re + H2*pInData[0].re + H4*pInData[2].re + H5*pInData[3].re
-					 + H6*pInData[4].re + H8*pInData[6].re + H10*pInData[8].re;
-	tmpout[4].im = H0*d8.im + H2*pInData[0].im + H4*pInData[2].im + H5*pInData[3].im
-					 + H6*pInData[4].im + H8*pInData[6].im + H10*pInData[8].im;
-
-	tmpout[5].re = H0*pInData[0].re + H2*pInData[2].re + H4*pInData[4].re + H5*pInData[5].re
-					 + H6*pInData[6].re + H8*pInData[8].re + H10*pInData[10].re;
-	tmpout[5].im = H0*pInData[0].im + H2*pInData[2].im + H4*pInData[4].im + H5*pInData[5].im
-					 + H6*pInData[6].im + H8*pInData[8].im + H10*pInData[10].im;
-
-	tmpout[6].re = H0*pInData[2].re + H2*pInData[4].re + H4*pInData[6].re + H5*pInData[7].re
-					 + H6*pInData[8].re + H8*pInData[10].re + H10*pInData[12].re;
-	tmpout[6].im = H0*pInData[2].im + H2*pInData[4].im + H4*pInData[6].im + H5*pInData[7].im
-					 + H6*pInData[8].im + H8*pInData[10].im + H10*pInData[12].im;
-
-	tmpout[7].re = H0*pInData[4].re + H2*pInData[6].re + H4*pInData[8].re + H5*pInData[9].re
-					 + H6*pInData[10].re + H8*pInData[12].re + H10*pInData[14].re;
-	tmpout[7].im = H0*pInData[4].im + H2*pInData[6].im + H4*pInData[8].im + H5*pInData[9].im
-					 + H6*pInData[10].im + H8*pInData[12].im + H10*pInData[14].im;
-
-	tmpout[8].re = H0*pInData[6].re + H2*pInData[8].re + H4*pInData[10].re + H5*pInData[11].re
-					 + H6*pInData[12].re + H8*pInData[14].re + H10*pInData[16].re;
-	tmpout[8].im = H0*pInData[6].im + H2*pInData[8].im + H4*pInData[10].im + H5*pInData[11].im
-					 + H6*pInData[12].im + H8*pInData[14].im + H10*pInData[16].im;
-
-	//now loop through remaining input samples
-	TYPECPX* pIn = &pInData[8];
-	TYPECPX* pOut = &pOutData[9];
-	for(int i=0; i<(InLength-11-6 )/2; i++)
-	{
-		(*pOut).re   = H0*pIn[0].re + H2*pIn[2].re + H4*pIn[4].re + H5*pIn[5].re
-					  + H6*pIn[6].re + H8*pIn[8].re + H10*pIn[10].re;
-		(*pOut++).im = H0*pIn[0].im + H2*pIn[2].im + H4*pIn[4].im + H5*pIn[5].im
-					  + H6*pIn[6].im + H8*pIn[8].im + H10*pIn[10].im;
-		pIn += 2;
-	}
-	//copy first outputs back into output array so outbuf can be same as inbuf
-	pOutData[0] = tmpout[0]; pOutData[1] = tmpout[1];
-	pOutData[2] = tmpout[2]; pOutData[3] = tmpout[3];
-	pOutData[4] = tmpout[4]; pOutData[5] = tmpout[5];
-	pOutData[6] = tmpout[6]; pOutData[7] = tmpout[7];
-	pOutData[8] = tmpout[8];
-
-	//copy last 10 input samples into delay buffer for next time
-	pIn = &pInData[InLength-1];
-	d9 = *pIn--; d8 = *pIn--; d7 = *pIn--;
-	d6 = *pIn--; d5 = *pIn--; d4 = *pIn--;
-	d3 = *pIn--; d2 = *pIn--; d1 = *pIn--; d0 = *pIn;
-
-	return InLength/2;
+tComplex<T> history[TAPS - 1];
+	if(InLength<TAPS)	//safety net to make sure InLength is large enough to process
+		return InLength/2;
+	int numoutsamples = InLength/2;
+	int head = std::min(TAPS - 2, numoutsamples);
+
+	//save the last TAPS-1 input samples for the next block before they can be overwritten
+	memcpy(history, &pInData[InLength - (TAPS - 1)], sizeof(history));
+
+	//filter the first outputs from the previous block's samples followed by the head of the input
+	memcpy(&m_Work[TAPS - 1], pInData, sizeof(tComplex<T>) * ((head * 2) - 1));
+	HalfBandFilter<TAPS>(head, m_Work, m_Coef, m_Center, m_Head);
+
+	//filter the remaining outputs directly from the input; output k only overwrites
+	//input samples that were already used by the time it is written
+	if(numoutsamples > head)
+		HalfBandFilter<TAPS>(numoutsamples - head, &pInData[(head * 2) - (TAPS - 1)], m_Coef,
+							 m_Center, &pOutData[head]);
+
+	//copy first outputs into output array so outbuf can be same as inbuf
+	memcpy(pOutData, m_Head, sizeof(tComplex<T>) * head);
+	memcpy(m_Work, history, sizeof(history));
+
+	return numoutsamples;
 }
 
 // *&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*&*
@@ -492,7 +553,8 @@ int CDownConvert::CHalfBand11TapDecimateBy2::DecBy2(int InLength, TYPECPX* pInDa
 //Decimate by 2 CIC 3 stage
 // -80dB alias rejection up to Fs * (.5 - .4985)
 //////////////////////////////////////////////////////////////////////
-CDownConvert::CCicN3DecimateBy2::CCicN3DecimateBy2()
+template<typename T, class LOCK>
+CDownConvert<T, LOCK>::CCicN3DecimateBy2::CCicN3DecimateBy2()
 {
 	m_Xodd.re = 0.0; m_Xodd.im = 0.0;
 	m_Xeven.re = 0.0; m_Xeven.im = 0.0;
@@ -505,10 +567,11 @@ CDownConvert::CCicN3DecimateBy2::CCicN3DecimateBy2()
 //returns number of output samples processed
 // 6nS/sample
 //////////////////////////////////////////////////////////////////////
-int CDownConvert::CCicN3DecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template<typename T, class LOCK>
+int CDownConvert<T, LOCK>::CCicN3DecimateBy2::DecBy2(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData)
 {
 int i,j;
-TYPECPX even,odd;
+tComplex<T> even,odd;
 
 	for(i=0,j=0; i<InLength; i+=2,j++)
 	{	//mag gn=8
@@ -522,3 +585,11 @@ TYPECPX even,odd;
 
 	return j;
 }
+
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types and locking policies
+//////////////////////////////////////////////////////////////////////
+template class CDownConvert<tSReal, CNoLock>;
+template class CDownConvert<tSReal, CMutexLock>;
+template class CDownConvert<tDReal, CNoLock>;
+template class CDownConvert<tDReal, CMutexLock>;
@@ -55,15 +55,16 @@ enum class DownsampleQuality
 //////////////////////////////////////////////////////////////////////////////////
 // Main Downconverter Class
 //////////////////////////////////////////////////////////////////////////////////
-class CDownConvert  
+template<typename T = TYPEREAL, class LOCK = CNoLock>
+class CDownConvert
 {
 public:
 	CDownConvert();
 	virtual ~CDownConvert();
-	void SetFrequency(TYPEREAL NcoFreq);
-	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-	TYPEREAL SetDataRate(TYPEREAL InRate, TYPEREAL MaxBW);
-	TYPEREAL SetWfmDataRate(TYPEREAL InRate, TYPEREAL MaxBW);
+	void SetFrequency(T NcoFreq);
+	int ProcessData(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData);
+	T SetDataRate(T InRate, T MaxBW);
+	T SetWfmDataRate(T InRate, T MaxBW);
 	void SetQuality(enum DownsampleQuality Quality) { m_Quality = Quality; }
 
 private:
@@ -76,50 +77,27 @@ private:
 	public:
 		CDec2(){}
 		virtual ~CDec2(){}
-		virtual int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData) = 0;
+		virtual int DecBy2(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData) = 0;
 	};
 
 	////////////
-	//private class for the Half Band decimate by 2 stages
+	//private template class for the Half Band decimate by 2 stages
+	//The filters are symmetric and every odd tap except the center tap is zero,
+	//so each output is computed from (TAPS+1)/4 folded tap pairs plus the center
+	//tap, with the tap loops unrolled for each filter length.
 	////////////
+	template<int TAPS>
 	class CHalfBandDecimateBy2 : public CDec2
 	{
+		static_assert((TAPS % 4) == 3, "Half Band filter length must be 4n+3");
 	public:
-		CHalfBandDecimateBy2(int len,const TYPEREAL* pCoef);
-		~CHalfBandDecimateBy2(){if(m_pHBFirBuf) delete m_pHBFirBuf;}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPECPX* m_pHBFirBuf;
-		int m_FirLength;
-		const TYPEREAL* m_pCoef;
-	};
-
-
-	////////////
-	//private class for the fixed 11 tap Half Band decimate by 2 stages
-	////////////
-	class CHalfBand11TapDecimateBy2 : public CDec2
-	{
-	public:
-		CHalfBand11TapDecimateBy2();
-		~CHalfBand11TapDecimateBy2(){}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPEREAL H0;	//unwrapped coeeficients
-		TYPEREAL H2;
-		TYPEREAL H4;
-		TYPEREAL H5;
-		TYPEREAL H6;
-		TYPEREAL H8;
-		TYPEREAL H10;
-		TYPECPX d0;		//unwrapped delay buffer
-		TYPECPX d1;
-		TYPECPX d2;
-		TYPECPX d3;
-		TYPECPX d4;
-		TYPECPX d5;
-		TYPECPX d6;
-		TYPECPX d7;
-		TYPECPX d8;
-		TYPECPX d9;
+		CHalfBandDecimateBy2(const T* pCoef);
+		~CHalfBandDecimateBy2(){}
+		int DecBy2(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData);
+		T m_Coef[(TAPS + 1) / 4];	//folded even coefficients
+		T m_Center;					//center coefficient
+		tComplex<T> m_Work[(TAPS * 3) - 6];		//last TAPS-1 samples of the previous block + head of the input
+		tComplex<T> m_Head[TAPS - 2];			//outputs that depend on the previous block
 	};
 
 	////////////
@@ -130,9 +108,9 @@ private:
 	public:
 		CCicN3DecimateBy2();
 		~CCicN3DecimateBy2(){}
-		int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-		TYPECPX m_Xodd;
-		TYPECPX m_Xeven;
+		int DecBy2(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData);
+		tComplex<T> m_Xodd;
+		tComplex<T> m_Xeven;
 	};
 
 private:
@@ -141,18 +119,16 @@ private:
 
 	enum DownsampleQuality m_Quality = DownsampleQuality::High;
 
-	TYPEREAL m_OutputRate;
-	TYPEREAL m_NcoFreq;
-	TYPEREAL m_NcoInc;
-	TYPEREAL m_NcoTime;
-	TYPEREAL m_InRate;
-	TYPEREAL m_MaxBW;
-	TYPECPX m_Osc1;
-	TYPEREAL m_OscCos;
-	TYPEREAL m_OscSin;
-#ifdef FMDSP_THREAD_SAFE
-	mutable std::mutex m_Mutex;		//for keeping threads from stomping on each other
-#endif
+	T m_OutputRate;
+	T m_NcoFreq;
+	T m_NcoInc;
+	T m_NcoTime;
+	T m_InRate;
+	T m_MaxBW;
+	tComplex<T> m_Osc1;
+	T m_OscCos;
+	T m_OscSin;
+	mutable LOCK m_Mutex;		//for keeping threads from stomping on each other
 	//array of pointers for performing decimate by 2 stages
 	CDec2* m_pDecimatorPtrs[MAX_DECSTAGES];
 
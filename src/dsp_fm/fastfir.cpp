@@ -46,91 +46,190 @@
 //==========================================================================================
 #include "fastfir.h"
 #include <math.h>
+#include <string.h>
+
+#include "../utils/simd.h"
 
 
 //////////////////////////////////////////////////////////////////////
-// Local Defines
+// Complex multiply kernels
+//  Each kernel multiplies the N point array m with src and places the
+//  result in dest, processing as many points as possible and returning
+//  the number of points processed.  src and dest can be the same buffer.
+//  The kernels are single precision only.
 //////////////////////////////////////////////////////////////////////
-#define CONV_FFT_SIZE 2048	//must be power of 2
-#define CONV_FIR_SIZE 1025	//must be <= FFT size. Make 1/2 +1 if want
-							//output to be in power of 2
+typedef int (*CpxMpyKernel)(int N, const tSComplex* m, const tSComplex* src, tSComplex* dest);
 
+#if defined(SIMD_X86)
+//SSE2 kernel, 2 complex points per iteration
+static int CpxMpySSE2(int N, const tSComplex* m, const tSComplex* src, tSComplex* dest)
+{
+	const __m128 sign = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+	int blocks = N / 2;
+	for(int i=0; i<blocks; i++)
+	{
+		__m128 vm = _mm_loadu_ps((const float*)(m + i*2));
+		__m128 vs = _mm_loadu_ps((const float*)(src + i*2));
+		__m128 mre = _mm_shuffle_ps(vm, vm, _MM_SHUFFLE(2, 2, 0, 0));	//m.re m.re
+		__m128 mim = _mm_shuffle_ps(vm, vm, _MM_SHUFFLE(3, 3, 1, 1));	//m.im m.im
+		__m128 sswap = _mm_shuffle_ps(vs, vs, _MM_SHUFFLE(2, 3, 0, 1));	//s.im s.re
+		__m128 t = _mm_xor_ps(_mm_mul_ps(mim, sswap), sign);			//-m.im*s.im m.im*s.re
+		_mm_storeu_ps((float*)(dest + i*2), _mm_add_ps(_mm_mul_ps(mre, vs), t));
+	}
+	return blocks * 2;
+}
 
-#define CONV_INBUF_SIZE (CONV_FFT_SIZE+CONV_FIR_SIZE-1)
+//AVX2 kernel, 4 complex points per iteration
+SIMD_TARGET_AVX2 static int CpxMpyAVX2(int N, const tSComplex* m, const tSComplex* src, tSComplex* dest)
+{
+	int blocks = N / 4;
+	for(int i=0; i<blocks; i++)
+	{
+		__m256 vm = _mm256_loadu_ps((const float*)(m + i*4));
+		__m256 vs = _mm256_loadu_ps((const float*)(src + i*4));
+		__m256 mre = _mm256_moveldup_ps(vm);			//m.re m.re
+		__m256 mim = _mm256_movehdup_ps(vm);			//m.im m.im
+		__m256 sswap = _mm256_permute_ps(vs, 0xB1);		//s.im s.re
+		_mm256_storeu_ps((float*)(dest + i*4),
+			_mm256_addsub_ps(_mm256_mul_ps(mre, vs), _mm256_mul_ps(mim, sswap)));
+	}
+	return blocks * 4;
+}
+#endif
+
+#if defined(SIMD_NEON)
+//NEON kernel, 4 complex points per iteration
+static int CpxMpyNEON(int N, const tSComplex* m, const tSComplex* src, tSComplex* dest)
+{
+	int blocks = N / 4;
+	for(int i=0; i<blocks; i++)
+	{
+		float32x4x2_t vm = vld2q_f32((const float*)(m + i*4));	//deinterleaved re/im
+		float32x4x2_t vs = vld2q_f32((const float*)(src + i*4));
+		float32x4x2_t vd;
+		vd.val[0] = vmlsq_f32(vmulq_f32(vm.val[0], vs.val[0]), vm.val[1], vs.val[1]);
+		vd.val[1] = vmlaq_f32(vmulq_f32(vm.val[0], vs.val[1]), vm.val[1], vs.val[0]);
+		vst2q_f32((float*)(dest + i*4), vd);
+	}
+	return blocks * 4;
+}
+#endif
+
+//selects the fastest complex multiply kernel available on this system
+static CpxMpyKernel SelectCpxMpyKernel()
+{
+#if defined(SIMD_X86)
+	if(simd::has_avx2())
+		return CpxMpyAVX2;
+	return CpxMpySSE2;
+#elif defined(SIMD_NEON)
+	return CpxMpyNEON;
+#else
+	return NULL;
+#endif
+}
+
+static const CpxMpyKernel s_CpxMpyKernel = SelectCpxMpyKernel();
+
+//runs the SIMD kernel for single precision samples; double precision
+//samples are all processed by the scalar loop
+static inline int CpxMpySIMD(int N, tSComplex* m, tSComplex* src, tSComplex* dest)
+{
+	return (s_CpxMpyKernel != NULL) ? s_CpxMpyKernel(N, m, src, dest) : 0;
+}
+
+static inline int CpxMpySIMD(int, tDComplex*, tDComplex*, tDComplex*)
+{
+	return 0;
+}
 
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
 
-CFastFIR::CFastFIR()
+template<typename T, class LOCK>
+CFastFIR<T, LOCK>::CFastFIR() : CFastFIR(DEFAULT_FFT_SIZE, DEFAULT_FIR_SIZE)
+{
+}
+
+//////////////////////////////////////////////////////////////////////
+// FFTSize is the convolution FFT size, rounded up to a power of 2 in
+//  the range supported by CFft.
+// FIRSize is the number of FIR filter taps, limited to the FFT size.
+//  Each FFT block produces FFTSize-FIRSize+1 output samples; make it
+//  FFTSize/2+1 if the output should be in blocks of a power of 2.
+//////////////////////////////////////////////////////////////////////
+template<typename T, class LOCK>
+CFastFIR<T, LOCK>::CFastFIR(int FFTSize, int FIRSize)
 {
 int i;
+	m_FFTSize = MIN_FFT_SIZE;
+	while( (m_FFTSize < FFTSize) && (m_FFTSize < MAX_FFT_SIZE) )
+		m_FFTSize <<= 1;
+	m_FIRSize = FIRSize;
+	if(m_FIRSize < 3)
+		m_FIRSize = 3;
+	if(m_FIRSize > m_FFTSize)
+		m_FIRSize = m_FFTSize;
+
 	m_pWindowTbl = NULL;
 	m_pFFTBuf = NULL;
 	m_pFFTOverlapBuf = NULL;
 	m_pFilterCoef = NULL;
 	//allocate internal buffer space on Heap
-	m_pWindowTbl = new TYPEREAL[CONV_FIR_SIZE];
-	m_pFilterCoef = new TYPECPX[CONV_FFT_SIZE];
-	m_pFFTBuf = new TYPECPX[CONV_FFT_SIZE];
-	m_pFFTOverlapBuf = new TYPECPX[CONV_FIR_SIZE];
+	m_pWindowTbl = new T[m_FIRSize];
+	m_pFilterCoef = new tComplex<T>[m_FFTSize];
+	m_pFFTBuf = new tComplex<T>[m_FFTSize];
+	m_pFFTOverlapBuf = new tComplex<T>[m_FIRSize];
 
 	if(!m_pWindowTbl || !m_pFilterCoef || !m_pFFTBuf || !m_pFFTOverlapBuf)
 	{
 		//major poblems if memory fails here
 		return;
 	}
-	m_InBufInPos = (CONV_FIR_SIZE - 1);
-	for( i=0; i<CONV_FFT_SIZE; i++)
-	{
-		m_pFFTBuf[i].re = 0.0;
-		m_pFFTBuf[i].im = 0.0;
-	}
+	m_InBufInPos = (m_FIRSize - 1);
+	memset(m_pFFTBuf, 0, sizeof(tComplex<T>) * m_FFTSize);
+	memset(m_pFFTOverlapBuf, 0, sizeof(tComplex<T>) * m_FIRSize);
 #if 1
 	//create Blackman-Nuttall window function for windowed sinc low pass filter design
-	for( i=0; i<CONV_FIR_SIZE; i++)
+	for( i=0; i<m_FIRSize; i++)
 	{
 		m_pWindowTbl[i] = (0.3635819
-			- 0.4891775*MCOS( (K_2PI*i)/(CONV_FIR_SIZE-1) )
-			+ 0.1365995*MCOS( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
-			- 0.0106411*MCOS( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
-		m_pFFTOverlapBuf[i].re = 0.0;
-		m_pFFTOverlapBuf[i].im = 0.0;
+			- 0.4891775*TCOS<T>( (K_2PI*i)/(m_FIRSize-1) )
+			+ 0.1365995*TCOS<T>( (2.0*K_2PI*i)/(m_FIRSize-1) )
+			- 0.0106411*TCOS<T>( (3.0*K_2PI*i)/(m_FIRSize-1) ) );
 	}
 #endif
 #if 0
 	//create Blackman-Harris window function for windowed sinc low pass filter design
-	for( i=0; i<CONV_FIR_SIZE; i++)
+	for( i=0; i<m_FIRSize; i++)
 	{
 		m_pWindowTbl[i] = (0.35875
-			- 0.48829*MCOS( (K_2PI*i)/(CONV_FIR_SIZE-1) )
-			+ 0.14128*MCOS( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
-			- 0.01168*MCOS( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
-		m_pFFTOverlapBuf[i].re = 0.0;
-		m_pFFTOverlapBuf[i].im = 0.0;
+			- 0.48829*TCOS<T>( (K_2PI*i)/(m_FIRSize-1) )
+			+ 0.14128*TCOS<T>( (2.0*K_2PI*i)/(m_FIRSize-1) )
+			- 0.01168*TCOS<T>( (3.0*K_2PI*i)/(m_FIRSize-1) ) );
 	}
 #endif
 #if 0
 	//create Nuttall window function for windowed sinc low pass filter design
-	for( i=0; i<CONV_FIR_SIZE; i++)
+	for( i=0; i<m_FIRSize; i++)
 	{
 		m_pWindowTbl[i] = (0.355768
-			- 0.487396*MCOS( (K_2PI*i)/(CONV_FIR_SIZE-1) )
-			+ 0.144232*MCOS( (2.0*K_2PI*i)/(CONV_FIR_SIZE-1) )
-			- 0.012604*MCOS( (3.0*K_2PI*i)/(CONV_FIR_SIZE-1) ) );
-		m_pFFTOverlapBuf[i].re = 0.0;
-		m_pFFTOverlapBuf[i].im = 0.0;
+			- 0.487396*TCOS<T>( (K_2PI*i)/(m_FIRSize-1) )
+			+ 0.144232*TCOS<T>( (2.0*K_2PI*i)/(m_FIRSize-1) )
+			- 0.012604*TCOS<T>( (3.0*K_2PI*i)/(m_FIRSize-1) ) );
 	}
 #endif
-	m_Fft.SetFFTParams(CONV_FFT_SIZE, false, 0.0, 1.0);
+	m_Fft.SetFFTParams(m_FFTSize, false, 0.0, 1.0);
 	m_FLoCut = -1.0;
 	m_FHiCut = 1.0;
 	m_Offset = 1.0;
 	m_SampleRate = 1.0;
 }
 
-CFastFIR::~CFastFIR()
+template<typename T, class LOCK>
+CFastFIR<T, LOCK>::~CFastFIR()
 {
 	FreeMemory();
 
@@ -139,7 +238,8 @@ CFastFIR::~CFastFIR()
 //////////////////////////////////////////////////////////////////////
 //delete all heap memory
 //////////////////////////////////////////////////////////////////////
-void CFastFIR::FreeMemory()
+template<typename T, class LOCK>
+void CFastFIR<T, LOCK>::FreeMemory()
 {
 	if(m_pWindowTbl)
 	{
@@ -174,8 +274,9 @@ void CFastFIR::FreeMemory()
 //		example to make 2700Hz USB filter:
 //	SetupParameters( 100, 2800, 0, 48000);
 //////////////////////////////////////////////////////////////////////
-void CFastFIR::SetupParameters( TYPEREAL FLoCut, TYPEREAL FHiCut,
-								TYPEREAL Offset, TYPEREAL SampleRate)
+template<typename T, class LOCK>
+void CFastFIR<T, LOCK>::SetupParameters( T FLoCut, T FHiCut,
+								T Offset, T SampleRate)
 {
 int i;
 	if( (FLoCut==m_FLoCut) && (FHiCut==m_FHiCut) &&
@@ -200,37 +301,35 @@ int i;
 		return;
 	}
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	//calculate some normalized filter parameters
-	TYPEREAL nFL = FLoCut/SampleRate;
-	TYPEREAL nFH = FHiCut/SampleRate;
-	TYPEREAL nFc = (nFH-nFL)/2.0;		//prototype LP filter cutoff
-	TYPEREAL nFs = K_2PI*(nFH+nFL)/2.0;		//2 PI times required frequency shift (FHiCut+FLoCut)/2
-	TYPEREAL fCenter = 0.5*(TYPEREAL)(CONV_FIR_SIZE-1);	//floating point center index of FIR filter
+	T nFL = FLoCut/SampleRate;
+	T nFH = FHiCut/SampleRate;
+	T nFc = (nFH-nFL)/2.0;		//prototype LP filter cutoff
+	T nFs = K_2PI*(nFH+nFL)/2.0;		//2 PI times required frequency shift (FHiCut+FLoCut)/2
+	T fCenter = 0.5*(T)(m_FIRSize-1);	//floating point center index of FIR filter
 
-	for(i=0; i<CONV_FFT_SIZE; i++)		//zero pad entire coefficient buffer to FFT size
+	for(i=0; i<m_FFTSize; i++)		//zero pad entire coefficient buffer to FFT size
 	{
 		m_pFilterCoef[i].re = 0.0;
 		m_pFilterCoef[i].im = 0.0;
 	}
 
 	//create LP FIR windowed sinc, sin(x)/x complex LP filter coefficients
-	for(i=0; i<CONV_FIR_SIZE; i++)
+	for(i=0; i<m_FIRSize; i++)
 	{
-		TYPEREAL x = (TYPEREAL)i - fCenter;
-		TYPEREAL z;
-		if( (TYPEREAL)i == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
+		T x = (T)i - fCenter;
+		T z;
+		if( (T)i == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
 			z = 2.0 * nFc;
 		else
-			z = (TYPEREAL)MSIN(K_2PI*x*nFc)/(K_PI*x) * m_pWindowTbl[i];
+			z = (T)TSIN<T>(K_2PI*x*nFc)/(K_PI*x) * m_pWindowTbl[i];
 
 		//shift lowpass filter coefficients in frequency by (hicut+lowcut)/2 to form bandpass filter anywhere in range
 		// (also scales by 1/FFTsize since inverse FFT routine scales by FFTsize)
-		m_pFilterCoef[i].re  =  z * MCOS(nFs * x)/(TYPEREAL)CONV_FFT_SIZE;
-		m_pFilterCoef[i].im = z * MSIN(nFs * x)/(TYPEREAL)CONV_FFT_SIZE;
+		m_pFilterCoef[i].re  =  z * TCOS<T>(nFs * x)/(T)m_FFTSize;
+		m_pFilterCoef[i].im = z * TSIN<T>(nFs * x)/(T)m_FFTSize;
 	}
 
 	//convert FIR coefficients to frequency domain by taking forward FFT
@@ -244,42 +343,42 @@ int i;
 //input samples due to FFT block size processing.
 //600ns/samp
 ///////////////////////////////////////////////////////////////////////////////
-int CFastFIR::ProcessData(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
+template<typename T, class LOCK>
+int CFastFIR<T, LOCK>::ProcessData(int InLength, tComplex<T>* InBuf, tComplex<T>* OutBuf)
 {
-int i = 0;
-int j;
-int len = InLength;
 int outpos = 0;
+int overlap = m_FIRSize - 1;			//samples kept from the previous block
+int blocksize = m_FFTSize - overlap;	//new input/output samples per FFT block
 	if( !InLength)	//if nothing to do
 		return 0;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
-	while(len--)
+	while(InLength > 0)
 	{
-		j = m_InBufInPos - (CONV_FFT_SIZE - CONV_FIR_SIZE + 1) ;
-		if(j >= 0 )
-		{	//keep copy of last CONV_FIR_SIZE-1 samples for overlap save
-			m_pFFTOverlapBuf[j] = InBuf[i];
-		}
-		m_pFFTBuf[m_InBufInPos++] = InBuf[i++];
-		if(m_InBufInPos >= CONV_FFT_SIZE)
-		{	//perform FFT -> complexMultiply by FIR coefficients -> inverse FFT on filled FFT input buffer
+		//copy as much input as will fit into the FFT input buffer
+		int count = m_FFTSize - m_InBufInPos;
+		if(count > InLength)
+			count = InLength;
+		memcpy(&m_pFFTBuf[m_InBufInPos], InBuf, sizeof(tComplex<T>) * count);
+		m_InBufInPos += count;
+		InBuf += count;
+		InLength -= count;
+
+		if(m_InBufInPos >= m_FFTSize)
+		{	//keep copy of last m_FIRSize-1 samples for overlap save
+			memcpy(m_pFFTOverlapBuf, &m_pFFTBuf[blocksize], sizeof(tComplex<T>) * overlap);
+			//perform FFT -> complexMultiply by FIR coefficients -> inverse FFT on filled FFT input buffer
 			m_Fft.FwdFFT(m_pFFTBuf);
-			CpxMpy(CONV_FFT_SIZE, m_pFilterCoef, m_pFFTBuf, m_pFFTBuf);
+			CpxMpy(m_FFTSize, m_pFilterCoef, m_pFFTBuf, m_pFFTBuf);
 			m_Fft.RevFFT(m_pFFTBuf);
-			for(j=(CONV_FIR_SIZE-1); j<CONV_FFT_SIZE; j++)
-			{	//copy FFT output into OutBuf minus CONV_FIR_SIZE-1 samples at beginning
-				OutBuf[outpos++] = m_pFFTBuf[j];
-			}
-			for(j=0; j<(CONV_FIR_SIZE - 1);j++)
-			{	//copy overlap buffer into start of fft input buffer
-				m_pFFTBuf[j] = m_pFFTOverlapBuf[j];
-			}
+			//copy FFT output into OutBuf minus m_FIRSize-1 samples at beginning
+			memcpy(&OutBuf[outpos], &m_pFFTBuf[overlap], sizeof(tComplex<T>) * blocksize);
+			outpos += blocksize;
+			//copy overlap buffer into start of fft input buffer
+			memcpy(m_pFFTBuf, m_pFFTOverlapBuf, sizeof(tComplex<T>) * overlap);
 			//reset input position to data start position of fft input buffer
-			m_InBufInPos = CONV_FIR_SIZE - 1;
+			m_InBufInPos = overlap;
 		}
 	}
 
@@ -290,14 +389,23 @@ int outpos = 0;
 //   Complex multiply N point array m with src and place in dest.  
 // src and dest can be the same buffer.
 ///////////////////////////////////////////////////////////////////////////////
-inline void CFastFIR::CpxMpy(int N, TYPECPX* m, TYPECPX* src, TYPECPX* dest)
+template<typename T, class LOCK>
+inline void CFastFIR<T, LOCK>::CpxMpy(int N, tComplex<T>* m, tComplex<T>* src, tComplex<T>* dest)
 {
-	for(int i=0; i<N; i++)
+	int i = CpxMpySIMD(N, m, src, dest);
+	for( ; i<N; i++)
 	{
-		TYPEREAL sr = src[i].re;
-		TYPEREAL si = src[i].im;
+		T sr = src[i].re;
+		T si = src[i].im;
 		dest[i].re = m[i].re * sr - m[i].im * si;
 		dest[i].im = m[i].re * si + m[i].im * sr;
 	}
 }
 
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types and locking policies
+//////////////////////////////////////////////////////////////////////
+template class CFastFIR<tSReal, CNoLock>;
+template class CFastFIR<tSReal, CMutexLock>;
+template class CFastFIR<tDReal, CNoLock>;
+template class CFastFIR<tDReal, CMutexLock>;
@@ -4,6 +4,7 @@
 //  This class implements a FIR Bandpass filter using a FFT convolution algorithm
 //The filter is complex and is specified with 3 parameters:
 // sample frequency, Hicut and Lowcut frequency
+//The FFT and FIR sizes can be specified at construction.
 //
 // History:
 //	2010-09-15  Initial creation MSW
@@ -45,32 +46,41 @@
 
 #include <mutex>
 
-class CFastFIR  
+template<typename T = TYPEREAL, class LOCK = CNoLock>
+class CFastFIR
 {
 public:
 	CFastFIR();
+	CFastFIR(int FFTSize, int FIRSize);
 	virtual ~CFastFIR();
 
-	void SetupParameters( TYPEREAL FLoCut,TYPEREAL FHiCut,TYPEREAL Offset, TYPEREAL SampleRate);
-	int ProcessData(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
+	//default FFT and FIR sizes, produces output in blocks of 1024 samples
+	static const int DEFAULT_FFT_SIZE = 2048;
+	static const int DEFAULT_FIR_SIZE = 1025;
+
+	int GetFFTSize() const { return m_FFTSize; }
+	int GetFIRSize() const { return m_FIRSize; }
+
+	void SetupParameters( T FLoCut,T FHiCut,T Offset, T SampleRate);
+	int ProcessData(int InLength, tComplex<T>* InBuf, tComplex<T>* OutBuf);
 
 private:
-	inline void CpxMpy(int N, TYPECPX* m, TYPECPX* src, TYPECPX* dest);
+	inline void CpxMpy(int N, tComplex<T>* m, tComplex<T>* src, tComplex<T>* dest);
 	void FreeMemory();
 
-	TYPEREAL m_FLoCut;
-	TYPEREAL m_FHiCut;
-	TYPEREAL m_Offset;
-	TYPEREAL m_SampleRate;
+	T m_FLoCut;
+	T m_FHiCut;
+	T m_Offset;
+	T m_SampleRate;
 
+	int m_FFTSize;
+	int m_FIRSize;
 	int m_InBufInPos;
-	TYPEREAL* m_pWindowTbl;
-	TYPECPX* m_pFFTOverlapBuf;
-	TYPECPX* m_pFilterCoef;
-	TYPECPX* m_pFFTBuf;
-#ifdef FMDSP_THREAD_SAFE
-	mutable std::mutex m_Mutex;		//for keeping threads from stomping on each other
-#endif
-	CFft m_Fft;
+	T* m_pWindowTbl;
+	tComplex<T>* m_pFFTOverlapBuf;
+	tComplex<T>* m_pFilterCoef;
+	tComplex<T>* m_pFFTBuf;
+	mutable LOCK m_Mutex;		//for keeping threads from stomping on each other
+	CFft<T> m_Fft;
 };
 #endif // FASTFIR_H
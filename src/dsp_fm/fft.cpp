@@ -11,6 +11,12 @@
 #include <math.h>
 #include "fft.h"
 
+#ifdef FMDSP_USE_FFTW
+#include <map>
+#include <tuple>
+#include <type_traits>
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // Local Defines
 //////////////////////////////////////////////////////////////////////
@@ -22,11 +28,68 @@
 #define OVER_LIMIT 32000.0	//limit for detecting over ranging inputs
 
 
+#ifdef FMDSP_USE_FFTW
+//////////////////////////////////////////////////////////////////////
+// FFTW plan cache
+//  The FFTW planner is not thread-safe so plan creation and wisdom
+//  operations are serialized.  Plans are measured once per size and
+//  kept for the life of the process; they are shared by all instances
+//  since the new-array execute functions are thread-safe.
+//////////////////////////////////////////////////////////////////////
+static std::mutex s_PlanMutex;
+static std::map<std::tuple<qint32, int, bool>, FMDSP_FFTW(plan)> s_PlanCache;
+
+static FMDSP_FFTW(plan) GetCachedPlan(qint32 size, int sign, bool aligned)
+{
+	std::unique_lock<std::mutex> lock(s_PlanMutex);
+
+	std::tuple<qint32, int, bool> key = std::make_tuple(size, sign, aligned);
+	auto found = s_PlanCache.find(key);
+	if(found != s_PlanCache.end())
+		return found->second;
+
+	//plan against a scratch buffer since FFTW_MEASURE overwrites the array
+	FMDSP_FFTW(complex)* pScratch = (FMDSP_FFTW(complex)*)FMDSP_FFTW(malloc)(sizeof(FMDSP_FFTW(complex))*size);
+	if(pScratch == NULL)
+		return NULL;
+	FMDSP_FFTW(plan) plan = FMDSP_FFTW(plan_dft_1d)(size, pScratch, pScratch, sign,
+								FFTW_MEASURE | (aligned ? 0 : FFTW_UNALIGNED));
+	FMDSP_FFTW(free)(pScratch);
+
+	if(plan != NULL)
+		s_PlanCache[key] = plan;
+	return plan;
+}
+#endif
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
-CFft::CFft()
+#ifdef FMDSP_USE_FFTW
+template<typename T, class LOCK>
+CFft<T, LOCK>::CFft() : CFft(FFT_ENGINE_FFTW)
+#else
+template<typename T, class LOCK>
+CFft<T, LOCK>::CFft() : CFft(FFT_ENGINE_OOURA)
+#endif
 {
+}
+
+template<typename T, class LOCK>
+CFft<T, LOCK>::CFft(eFftEngine Engine)
+{
+#ifdef FMDSP_USE_FFTW
+	//FFTW is only linked in single precision
+	m_Engine = std::is_same<T, tSReal>::value ? Engine : FFT_ENGINE_OOURA;
+	for(qint32 i=0; i<2; i++)
+	{
+		m_FwdPlan[i] = NULL;
+		m_RevPlan[i] = NULL;
+	}
+#else
+	(void)Engine;
+	m_Engine = FFT_ENGINE_OOURA;	//FFTW support is not compiled in
+#endif
 	m_Overload = false;
 	m_Invert = false;
 	m_AveSize = 1;
@@ -47,12 +110,14 @@ CFft::CFft()
 	SetFFTAve( 1);
 }
 
-CFft::~CFft()
+template<typename T, class LOCK>
+CFft<T, LOCK>::~CFft()
 {							// free all resources
 	FreeMemory();
 }
 
-void CFft::FreeMemory()
+template<typename T, class LOCK>
+void CFft<T, LOCK>::FreeMemory()
 {
 	if(m_pWorkArea)
 	{
@@ -96,10 +161,73 @@ void CFft::FreeMemory()
 	}
 }
 
+///////////////////////////////////////////////////////////////////
+//Gets the FFTW plans for the current FFT size.  Ooura's forward
+// transform uses a positive exponent, which FFTW calls FFTW_BACKWARD.
+// Falls back to the Ooura FFT if the plans cannot be created.
+///////////////////////////////////////////////////////////////////
+template<typename T, class LOCK>
+void CFft<T, LOCK>::CreatePlans()
+{
+#ifdef FMDSP_USE_FFTW
+	if(m_Engine != FFT_ENGINE_FFTW)
+		return;
+
+	for(qint32 i=0; i<2; i++)
+	{
+		m_FwdPlan[i] = GetCachedPlan(m_FFTSize, FFTW_BACKWARD, (i != 0));
+		m_RevPlan[i] = GetCachedPlan(m_FFTSize, FFTW_FORWARD, (i != 0));
+		if( (m_FwdPlan[i] == NULL) || (m_RevPlan[i] == NULL) )
+			m_Engine = FFT_ENGINE_OOURA;
+	}
+#endif
+}
+
+///////////////////////////////////////////////////////////////////
+//Gets the name of an FFT engine
+///////////////////////////////////////////////////////////////////
+template<typename T, class LOCK>
+const char* CFft<T, LOCK>::GetEngineName(eFftEngine Engine)
+{
+	return (Engine == FFT_ENGINE_FFTW) ? "fftw" : "ooura";
+}
+
+///////////////////////////////////////////////////////////////////
+//Loads previously saved FFTW planner wisdom so the plans measured
+// in an earlier session can be recreated without measuring again
+///////////////////////////////////////////////////////////////////
+template<typename T, class LOCK>
+bool CFft<T, LOCK>::ImportWisdom(const char* pFileName)
+{
+#ifdef FMDSP_USE_FFTW
+	std::unique_lock<std::mutex> lock(s_PlanMutex);
+	return (FMDSP_FFTW(import_wisdom_from_filename)(pFileName) != 0);
+#else
+	(void)pFileName;
+	return false;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////
+//Saves the accumulated FFTW planner wisdom
+///////////////////////////////////////////////////////////////////
+template<typename T, class LOCK>
+bool CFft<T, LOCK>::ExportWisdom(const char* pFileName)
+{
+#ifdef FMDSP_USE_FFTW
+	std::unique_lock<std::mutex> lock(s_PlanMutex);
+	return (FMDSP_FFTW(export_wisdom_to_filename)(pFileName) != 0);
+#else
+	(void)pFileName;
+	return false;
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////
 //FFT initialization and parameter setup function
 ///////////////////////////////////////////////////////////////////
-void CFft::SetFFTAve( qint32 ave)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::SetFFTAve( qint32 ave)
 {
 	if(m_AveSize != ave)
 	{
@@ -114,18 +242,17 @@ void CFft::SetFFTAve( qint32 ave)
 ///////////////////////////////////////////////////////////////////
 //FFT initialization and parameter setup function
 ///////////////////////////////////////////////////////////////////
-void CFft::SetFFTParams( qint32 size,
+template<typename T, class LOCK>
+void CFft<T, LOCK>::SetFFTParams( qint32 size,
 						 bool invert,
-						 TYPEREAL dBCompensation,
-						 TYPEREAL SampleFreq)
+						 T dBCompensation,
+						 T SampleFreq)
 {
 qint32 i;
 	if(size==0)
 		return;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	m_BinMin = 0;		//force recalculation of plot variables
 	m_BinMax = 0;
@@ -151,12 +278,12 @@ qint32 i;
 	{
 		m_LastFFTSize = m_FFTSize;
 		FreeMemory();
-		m_pWindowTbl = new TYPEREAL[m_FFTSize];
-		m_pSinCosTbl = new TYPEREAL[m_FFTSize/2];
-		m_pWorkArea = new qint32[ (qint32)MSQRT((TYPEREAL)m_FFTSize)+2];
-		m_pFFTPwrAveBuf = new TYPEREAL[m_FFTSize];
-		m_pFFTAveBuf = new TYPEREAL[m_FFTSize];
-		m_pFFTSumBuf = new TYPEREAL[m_FFTSize];
+		m_pWindowTbl = new T[m_FFTSize];
+		m_pSinCosTbl = new T[m_FFTSize/2];
+		m_pWorkArea = new qint32[ (qint32)TSQRT<T>((T)m_FFTSize)+2];
+		m_pFFTPwrAveBuf = new T[m_FFTSize];
+		m_pFFTAveBuf = new T[m_FFTSize];
+		m_pFFTSumBuf = new T[m_FFTSize];
 		for(i=0; i<m_FFTSize; i++)
 		{
 			m_pFFTPwrAveBuf[i] = 0.0;
@@ -164,11 +291,12 @@ qint32 i;
 			m_pFFTSumBuf[i] = 0.0;
 		}
 		m_pWorkArea[0] = 0;
-		m_pFFTInBuf = new TYPEREAL[m_FFTSize*2];
+		m_pFFTInBuf = new T[m_FFTSize*2];
 		m_pTranslateTbl = new qint32[m_FFTSize];
 		for(i=0; i<m_FFTSize*2; i++)
 			m_pFFTInBuf[i] = 0.0;
 		makewt(m_FFTSize/2, m_pWorkArea, m_pSinCosTbl);
+		CreatePlans();
 
 //////////////////////////////////////////////////////////////////////
 // A pure input sin wave ... Asin(wt)... will produce an fft output 
@@ -186,10 +314,10 @@ qint32 i;
 //		range of 0 to -120dB the stored value is 0.0 to -12.0
 //   so final constant K_B = -8.663833		
 ///////////////////////////////////////////////////////////////////////
-		m_K_B = m_dBCompensation - 20*MLOG10( (TYPEREAL)m_FFTSize*K_AMPMAX/2.0 );
-		m_K_C = MPOW( 10.0, (K_MINDB-m_K_B)/10.0 );
+		m_K_B = m_dBCompensation - 20*TLOG10<T>( (T)m_FFTSize*K_AMPMAX/2.0 );
+		m_K_C = TPOW<T>( 10.0, (K_MINDB-m_K_B)/10.0 );
 		m_K_B = m_K_B/10.0;
-TYPEREAL WindowGain;
+T WindowGain;
 #if 0
 		WindowGain = 1.0;
 		for(i=0; i<m_FFTSize; i++)	//Rectangle(no window)
@@ -198,53 +326,51 @@ TYPEREAL WindowGain;
 #if 0
 		WindowGain = 2.0;
 		for(i=0; i<m_FFTSize; i++)	//Hann
-			m_pWindowTbl[i] = WindowGain*(.5  - .5 *MCOS( (K_2PI*i)/(m_FFTSize-1) ));
+			m_pWindowTbl[i] = WindowGain*(.5  - .5 *TCOS<T>( (K_2PI*i)/(m_FFTSize-1) ));
 #endif
 #if 0
 		WindowGain = 1.852;
 		for(i=0; i<m_FFTSize; i++)	//Hamming
-			m_pWindowTbl[i] = WindowGain*(.54  - .46 *MCOS( (K_2PI*i)/(m_FFTSize-1) ));
+			m_pWindowTbl[i] = WindowGain*(.54  - .46 *TCOS<T>( (K_2PI*i)/(m_FFTSize-1) ));
 #endif
 #if 0
 		WindowGain = 2.8;
 		for(i=0; i<m_FFTSize; i++)	//Blackman-Nuttall
 			m_pWindowTbl[i] = WindowGain*(0.3635819
-				- 0.4891775*MCOS( (K_2PI*i)/(m_FFTSize-1) )
-				+ 0.1365995*MCOS( (2.0*K_2PI*i)/(m_FFTSize-1) )
-				- 0.0106411*MCOS( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
+				- 0.4891775*TCOS<T>( (K_2PI*i)/(m_FFTSize-1) )
+				+ 0.1365995*TCOS<T>( (2.0*K_2PI*i)/(m_FFTSize-1) )
+				- 0.0106411*TCOS<T>( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
 #endif
 #if 0
 		WindowGain = 2.82;
 		for(i=0; i<m_FFTSize; i++)	//Blackman-Harris
 			m_pWindowTbl[i] = WindowGain*(0.35875
-				- 0.48829*MCOS( (K_2PI*i)/(m_FFTSize-1) )
-				+ 0.14128*MCOS( (2.0*K_2PI*i)/(m_FFTSize-1) )
-				- 0.01168*MCOS( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
+				- 0.48829*TCOS<T>( (K_2PI*i)/(m_FFTSize-1) )
+				+ 0.14128*TCOS<T>( (2.0*K_2PI*i)/(m_FFTSize-1) )
+				- 0.01168*TCOS<T>( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
 #endif
 #if 1
 		WindowGain = 2.8;
 		for(i=0; i<m_FFTSize; i++)	//Nuttall
 			m_pWindowTbl[i] = WindowGain*(0.355768
-				- 0.487396*MCOS( (K_2PI*i)/(m_FFTSize-1) )
-				+ 0.144232*MCOS( (2.0*K_2PI*i)/(m_FFTSize-1) )
-				- 0.012604*MCOS( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
+				- 0.487396*TCOS<T>( (K_2PI*i)/(m_FFTSize-1) )
+				+ 0.144232*TCOS<T>( (2.0*K_2PI*i)/(m_FFTSize-1) )
+				- 0.012604*TCOS<T>( (3.0*K_2PI*i)/(m_FFTSize-1) ) );
 #endif
 #if 0
 		WindowGain = 1.0;
 		for(i=0; i<m_FFTSize; i++)	//Flat Top 4 term
 			m_pWindowTbl[i] = WindowGain*(1.0
-					- 1.942604  * MCOS( (K_2PI*i)/(m_FFTSize-1) )
-					+ 1.340318 * MCOS( (2.0*K_2PI*i)/(m_FFTSize-1) )
-					- 0.440811 * MCOS( (3.0*K_2PI*i)/(m_FFTSize-1) )
-					+ 0.043097  * MCOS( (4.0*K_2PI*i)/(m_FFTSize-1) )
+					- 1.942604  * TCOS<T>( (K_2PI*i)/(m_FFTSize-1) )
+					+ 1.340318 * TCOS<T>( (2.0*K_2PI*i)/(m_FFTSize-1) )
+					- 0.440811 * TCOS<T>( (3.0*K_2PI*i)/(m_FFTSize-1) )
+					+ 0.043097  * TCOS<T>( (4.0*K_2PI*i)/(m_FFTSize-1) )
 				);
 
 #endif
 	}
 
-#ifdef FMDSP_THREAD_SAFE
 	lock.unlock();
-#endif
 
 	ResetFFT();
 }
@@ -252,11 +378,10 @@ TYPEREAL WindowGain;
 ///////////////////////////////////////////////////////////////////
 //  Resets the FFT buffers and averaging variables.
 ///////////////////////////////////////////////////////////////////
-void CFft::ResetFFT()
+template<typename T, class LOCK>
+void CFft<T, LOCK>::ResetFFT()
 {
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	for(qint32 i=0; i<m_FFTSize;i++)
 	{
@@ -273,16 +398,15 @@ void CFft::ResetFFT()
 //	For real data there should be  m_FFTSize/2 InBuf data points
 //	For complex data there should be  m_FFTSize InBuf data points
 //////////////////////////////////////////////////////////////////////
-qint32 CFft::PutInDisplayFFT(qint32 n, TYPECPX* InBuf)
+template<typename T, class LOCK>
+qint32 CFft<T, LOCK>::PutInDisplayFFT(qint32 n, tComplex<T>* InBuf)
 {
 qint32 i;
 	m_Overload = false;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
-	TYPEREAL dtmp1;
+	T dtmp1;
 	for(i=0; i<n; i++)
 	{
 		// Determine overload
@@ -291,12 +415,12 @@ qint32 i;
 		dtmp1 = m_pWindowTbl[i];
 		//NOTE: For some reason I and Q are swapped(demod I/Q does not apear to be swapped)
 		//possibly an issue with the FFT ?
-		((TYPECPX*)m_pFFTInBuf)[i].im = dtmp1 * (InBuf[i].re);//window the I data
-		((TYPECPX*)m_pFFTInBuf)[i].re = dtmp1 * (InBuf[i].im);	//window the Q data
+		((tComplex<T>*)m_pFFTInBuf)[i].im = dtmp1 * (InBuf[i].re);//window the I data
+		((tComplex<T>*)m_pFFTInBuf)[i].re = dtmp1 * (InBuf[i].im);	//window the Q data
 	}
-	//Calculate the complex FFT
-	bitrv2(m_FFTSize*2, m_pWorkArea + 2, m_pFFTInBuf);
-	CpxFFT(m_FFTSize*2, m_pFFTInBuf, m_pSinCosTbl);
+	//Calculate the complex FFT and update the power averages
+	FwdFFT((tComplex<T>*)m_pFFTInBuf);
+	CalcPowerAve(m_FFTSize*2, m_pFFTInBuf);
 
 	return m_TotalCount;
 }
@@ -319,10 +443,11 @@ qint32 i;
 //		MindB = FFT dB level  corresponding to output value == MaxHeight
 //			must be >= to K_MINDB
 //////////////////////////////////////////////////////////////////////
-bool CFft::GetScreenIntegerFFTData(qint32 MaxHeight,
+template<typename T, class LOCK>
+bool CFft<T, LOCK>::GetScreenIntegerFFTData(qint32 MaxHeight,
 								qint32 MaxWidth,
-								TYPEREAL MaxdB,
-								TYPEREAL MindB,
+								T MaxdB,
+								T MindB,
 								qint32 StartFreq,
 								qint32 StopFreq,
 								qint32* OutBuf )
@@ -334,12 +459,10 @@ qint32 m;
 qint32 ymax = -10000;
 qint32 xprev = -1;
 qint32 maxbin;
-TYPEREAL dBmaxOffset = MaxdB/10.0;
-TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
+T dBmaxOffset = MaxdB/10.0;
+T dBGainFactor = -10.0/(MaxdB-MindB);
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	if( (m_StartFreq != StartFreq) ||
 		(m_StopFreq != StopFreq) ||
@@ -349,9 +472,9 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 		m_StopFreq = StopFreq;
 		m_PlotWidth = MaxWidth;
 		maxbin = m_FFTSize - 1;
-		m_BinMin = (qint32)((TYPEREAL)StartFreq*(TYPEREAL)m_FFTSize/m_SampleFreq);
+		m_BinMin = (qint32)((T)StartFreq*(T)m_FFTSize/m_SampleFreq);
 		m_BinMin += (m_FFTSize/2);
-		m_BinMax = (qint32)((TYPEREAL)StopFreq*(TYPEREAL)m_FFTSize/m_SampleFreq);
+		m_BinMax = (qint32)((T)StopFreq*(T)m_FFTSize/m_SampleFreq);
 		m_BinMax += (m_FFTSize/2);
 		if(m_BinMin < 0)	//don't allow these go outside the translate table
 			m_BinMin = 0;
@@ -382,9 +505,9 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 		for( i=m_BinMin; i<=m_BinMax; i++ )
 		{
 			if(m_Invert)
-				y = (qint32)((TYPEREAL)MaxHeight*dBGainFactor*(m_pFFTAveBuf[(m-i)] - dBmaxOffset));
+				y = (qint32)((T)MaxHeight*dBGainFactor*(m_pFFTAveBuf[(m-i)] - dBmaxOffset));
 			else
-				y = (qint32)((TYPEREAL)MaxHeight*dBGainFactor*(m_pFFTAveBuf[i] - dBmaxOffset));
+				y = (qint32)((T)MaxHeight*dBGainFactor*(m_pFFTAveBuf[i] - dBmaxOffset));
 			if(y<0)
 				y = 0;
 			if(y > MaxHeight)
@@ -413,9 +536,9 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 		{
 			i = m_pTranslateTbl[x];	//get plot to fft bin coordinate transform
 			if(m_Invert)
-				y = (qint32)((TYPEREAL)MaxHeight*dBGainFactor*(m_pFFTAveBuf[(m-i)] - dBmaxOffset));
+				y = (qint32)((T)MaxHeight*dBGainFactor*(m_pFFTAveBuf[(m-i)] - dBmaxOffset));
 			else
-				y = (qint32)((TYPEREAL)MaxHeight*dBGainFactor*(m_pFFTAveBuf[i] - dBmaxOffset));
+				y = (qint32)((T)MaxHeight*dBGainFactor*(m_pFFTAveBuf[i] - dBmaxOffset));
 			if(y<0)
 				y = 0;
 			if(y > MaxHeight)
@@ -431,16 +554,36 @@ TYPEREAL dBGainFactor = -10.0/(MaxdB-MindB);
 //Interface for doing fast convolution filters.  Takes complex data
 // in pInOutBuf and does fwd or rev FFT and places back in same buffer.
 ///////////////////////////////////////////////////////////////////
-void CFft::FwdFFT( TYPECPX* pInOutBuf)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::FwdFFT( tComplex<T>* pInOutBuf)
 {
-	bitrv2(m_FFTSize*2, m_pWorkArea + 2, (TYPEREAL*)pInOutBuf);
-	CpxFFT(m_FFTSize*2, (TYPEREAL*)pInOutBuf, m_pSinCosTbl);
+#ifdef FMDSP_USE_FFTW
+	if(m_Engine == FFT_ENGINE_FFTW)
+	{
+		FMDSP_FFTW(complex)* pBuf = reinterpret_cast<FMDSP_FFTW(complex)*>(pInOutBuf);
+		bool aligned = (FMDSP_FFTW(alignment_of)((tSReal*)pInOutBuf) == 0);
+		FMDSP_FFTW(execute_dft)(m_FwdPlan[aligned ? 1 : 0], pBuf, pBuf);
+		return;
+	}
+#endif
+	bitrv2(m_FFTSize*2, m_pWorkArea + 2, (T*)pInOutBuf);
+	cftfsub(m_FFTSize*2, (T*)pInOutBuf, m_pSinCosTbl);
 }
 
-void CFft::RevFFT( TYPECPX* pInOutBuf)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::RevFFT( tComplex<T>* pInOutBuf)
 {
-	bitrv2conj(m_FFTSize*2, m_pWorkArea + 2, (TYPEREAL*)pInOutBuf);
-	cftbsub(m_FFTSize*2, (TYPEREAL*)pInOutBuf, m_pSinCosTbl);
+#ifdef FMDSP_USE_FFTW
+	if(m_Engine == FFT_ENGINE_FFTW)
+	{
+		FMDSP_FFTW(complex)* pBuf = reinterpret_cast<FMDSP_FFTW(complex)*>(pInOutBuf);
+		bool aligned = (FMDSP_FFTW(alignment_of)((tSReal*)pInOutBuf) == 0);
+		FMDSP_FFTW(execute_dft)(m_RevPlan[aligned ? 1 : 0], pBuf, pBuf);
+		return;
+	}
+#endif
+	bitrv2conj(m_FFTSize*2, m_pWorkArea + 2, (T*)pInOutBuf);
+	cftbsub(m_FFTSize*2, (T*)pInOutBuf, m_pSinCosTbl);
 }
 
 
@@ -448,10 +591,11 @@ void CFft::RevFFT( TYPECPX* pInOutBuf)
 // Nitty gritty fft routines by Takuya OOURA(Updated to his new version 4-18-02)
 // Routine calculates real FFT
 ///////////////////////////////////////////////////////////////////
-void CFft::rftfsub(qint32 n, TYPEREAL *a, qint32 nc, TYPEREAL *c)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::rftfsub(qint32 n, T *a, qint32 nc, T *c)
 {
 qint32 j, k, kk, ks, m;
-TYPEREAL wkr, wki, xr, xi, yr, yi;
+T wkr, wki, xr, xi, yr, yi;
 
 	m_TotalCount++;
  	if(m_AveCount < m_AveSize)
@@ -490,11 +634,11 @@ TYPEREAL wkr, wki, xr, xi, yr, yi;
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] - m_pFFTPwrAveBuf[j] + xi;
 			m_pFFTSumBuf[k] = m_pFFTSumBuf[k] - m_pFFTPwrAveBuf[k] + xr;
 		}
-		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(TYPEREAL)m_AveCount;
-		m_pFFTPwrAveBuf[k] = m_pFFTSumBuf[k]/(TYPEREAL)m_AveCount;
+		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(T)m_AveCount;
+		m_pFFTPwrAveBuf[k] = m_pFFTSumBuf[k]/(T)m_AveCount;
 
-		m_pFFTAveBuf[j] = MLOG10(m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
-		m_pFFTAveBuf[k] = MLOG10(m_pFFTPwrAveBuf[k] + m_K_C) + m_K_B;
+		m_pFFTAveBuf[j] = TLOG10<T>(m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
+		m_pFFTAveBuf[k] = TLOG10<T>(m_pFFTPwrAveBuf[k] + m_K_C) + m_K_B;
 
 	}
 
@@ -513,68 +657,29 @@ TYPEREAL wkr, wki, xr, xi, yr, yi;
 		m_pFFTSumBuf[0] = m_pFFTSumBuf[0] - m_pFFTPwrAveBuf[0] + a[0];
 		m_pFFTSumBuf[n/2] = m_pFFTSumBuf[n/2] - m_pFFTPwrAveBuf[n/2] + xr;
 	}
-	m_pFFTPwrAveBuf[0] = m_pFFTSumBuf[0]/(TYPEREAL)m_AveCount;
-	m_pFFTPwrAveBuf[n/2] = m_pFFTSumBuf[n/2]/(TYPEREAL)m_AveCount;
+	m_pFFTPwrAveBuf[0] = m_pFFTSumBuf[0]/(T)m_AveCount;
+	m_pFFTPwrAveBuf[n/2] = m_pFFTSumBuf[n/2]/(T)m_AveCount;
 
-	m_pFFTAveBuf[0] = MLOG10(m_pFFTPwrAveBuf[0] + m_K_C) + m_K_B;
-	m_pFFTAveBuf[n/2] = MLOG10(m_pFFTPwrAveBuf[n/2] + m_K_C) + m_K_B;
+	m_pFFTAveBuf[0] = TLOG10<T>(m_pFFTPwrAveBuf[0] + m_K_C) + m_K_B;
+	m_pFFTAveBuf[n/2] = TLOG10<T>(m_pFFTPwrAveBuf[n/2] + m_K_C) + m_K_B;
 
 }
 
 
 ///////////////////////////////////////////////////////////////////
-// Routine calculates complex FFT
+// Routine updates the display power averages from the complex FFT
+// output in a[] (n = 2*FFTSIZE)
 ///////////////////////////////////////////////////////////////////
-void CFft::CpxFFT(qint32 n, TYPEREAL *a, TYPEREAL *w)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::CalcPowerAve(qint32 n, T *a)
 {
-qint32 j, j1, j2, j3, l;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
-    
+qint32 j, l;
+T x0r;
+
 	m_TotalCount++;
  	if(m_AveCount < m_AveSize)
 		m_AveCount++;
-    l = 2;
-    if (n > 8) {
-        cft1st(n, a, w);
-        l = 8;
-        while ((l << 2) < n) {
-            cftmdl(n, l, a, w);
-            l <<= 2;
-        }
-    }
-    if ((l << 2) == n) {
-        for (j = 0; j < l; j += 2) {
-            j1 = j + l;
-            j2 = j1 + l;
-            j3 = j2 + l;
-            x0r = a[j] + a[j1];
-            x0i = a[j + 1] + a[j1 + 1];
-            x1r = a[j] - a[j1];
-            x1i = a[j + 1] - a[j1 + 1];
-            x2r = a[j2] + a[j3];
-            x2i = a[j2 + 1] + a[j3 + 1];
-            x3r = a[j2] - a[j3];
-            x3i = a[j2 + 1] - a[j3 + 1];
-            a[j] = x0r + x2r;
-            a[j + 1] = x0i + x2i;
-            a[j2] = x0r - x2r;
-            a[j2 + 1] = x0i - x2i;
-            a[j1] = x1r - x3i;
-            a[j1 + 1] = x1i + x3r;
-            a[j3] = x1r + x3i;
-            a[j3 + 1] = x1i - x3r;
-        }
-    } else {
-        for (j = 0; j < l; j += 2) {
-            j1 = j + l;
-            x0r = a[j] - a[j1];
-            x0i = a[j + 1] - a[j1 + 1];
-            a[j] += a[j1];
-            a[j + 1] += a[j1 + 1];
-            a[j1] = x0r;
-            a[j1 + 1] = x0i;
-        }
-    }
+
 	//n = 2*FFTSIZE 
 	n = n>>1;
 	//now n = FFTSIZE
@@ -589,8 +694,8 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] + x0r;
 		else
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] - m_pFFTPwrAveBuf[j] + x0r;
-		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(TYPEREAL)m_AveCount;
-		m_pFFTAveBuf[j] = MLOG10( m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
+		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(T)m_AveCount;
+		m_pFFTAveBuf[j] = TLOG10<T>( m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
 	}
 	// FFT output index N/2 to N-1  (times 2 since complex samples)
 	// is frequency output -Fs/2 to 0  
@@ -602,8 +707,8 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] + x0r;
 		else
 			m_pFFTSumBuf[j] = m_pFFTSumBuf[j] - m_pFFTPwrAveBuf[j] + x0r;
-		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(TYPEREAL)m_AveCount;
-		m_pFFTAveBuf[j] = MLOG10( m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
+		m_pFFTPwrAveBuf[j] = m_pFFTSumBuf[j]/(T)m_AveCount;
+		m_pFFTAveBuf[j] = TLOG10<T>( m_pFFTPwrAveBuf[j] + m_K_C) + m_K_B;
 	}
 
 }
@@ -611,24 +716,25 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 ///////////////////////////////////////////////////////////////////
 /* -------- initializing routines -------- */
 ///////////////////////////////////////////////////////////////////
-void CFft::makewt(qint32 nw, qint32 *ip, TYPEREAL *w)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::makewt(qint32 nw, qint32 *ip, T *w)
 {
 qint32 j, nwh;
-TYPEREAL delta, x, y;
+T delta, x, y;
     
     ip[0] = nw;
     ip[1] = 1;
     if (nw > 2) {
         nwh = nw >> 1;
-		delta = MATAN(1.0) / nwh;
+		delta = TATAN<T>(1.0) / nwh;
         w[0] = 1;
         w[1] = 0;
-		w[nwh] = MCOS(delta * nwh);
+		w[nwh] = TCOS<T>(delta * nwh);
         w[nwh + 1] = w[nwh];
         if (nwh > 2) {
             for (j = 2; j < nwh; j += 2) {
-				x = MCOS(delta * j);
-				y = MSIN(delta * j);
+				x = TCOS<T>(delta * j);
+				y = TSIN<T>(delta * j);
                 w[j] = x;
                 w[j + 1] = y;
                 w[nw - j] = y;
@@ -640,20 +746,21 @@ TYPEREAL delta, x, y;
 }
 
 ///////////////////////////////////////////////////////////////////
-void CFft::makect(qint32 nc, qint32 *ip, TYPEREAL *c)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::makect(qint32 nc, qint32 *ip, T *c)
 {
 qint32 j, nch;
-TYPEREAL delta;
+T delta;
     
 	ip[1] = nc;
     if (nc > 1) {
         nch = nc >> 1;
-		delta = MATAN(1.0) / nch;
-		c[0] = MCOS(delta * nch);
+		delta = TATAN<T>(1.0) / nch;
+		c[0] = TCOS<T>(delta * nch);
         c[nch] = 0.5 * c[0];
         for (j = 1; j < nch; j++) {
-			c[j] = 0.5 * MCOS(delta * j);
-			c[nc - j] = 0.5 * MSIN(delta * j);
+			c[j] = 0.5 * TCOS<T>(delta * j);
+			c[nc - j] = 0.5 * TSIN<T>(delta * j);
         }
     }
 }
@@ -661,10 +768,11 @@ TYPEREAL delta;
 ///////////////////////////////////////////////////////////////////
 /* -------- child routines -------- */
 ///////////////////////////////////////////////////////////////////
-void CFft::bitrv2(qint32 n, qint32 *ip, TYPEREAL *a)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::bitrv2(qint32 n, qint32 *ip, T *a)
 {
 qint32 j, j1, k, k1, l, m, m2;
-TYPEREAL xr, xi, yr, yi;
+T xr, xi, yr, yi;
     
     ip[0] = 0;
     l = n;
@@ -761,10 +869,11 @@ TYPEREAL xr, xi, yr, yi;
 }
 
 ///////////////////////////////////////////////////////////////////
-void CFft::cftfsub(qint32 n, TYPEREAL *a, TYPEREAL *w)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::cftfsub(qint32 n, T *a, T *w)
 {
 qint32 j, j1, j2, j3, l;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
     l = 2;
     if (n > 8) {
@@ -811,11 +920,12 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 }
 
 ///////////////////////////////////////////////////////////////////
-void CFft::cft1st(qint32 n, TYPEREAL *a, TYPEREAL *w)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::cft1st(qint32 n, T *a, T *w)
 {
 qint32 j, k1, k2;
-TYPEREAL wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+T wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
     x0r = a[0] + a[2];
     x0i = a[1] + a[3];
@@ -916,11 +1026,12 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 }
 
 ///////////////////////////////////////////////////////////////////
-void CFft::cftmdl(qint32 n, qint32 l, TYPEREAL *a, TYPEREAL *w)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::cftmdl(qint32 n, qint32 l, T *a, T *w)
 {
 qint32 j, j1, j2, j3, k, k1, k2, m, m2;
-TYPEREAL wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
-TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+T wk1r, wk1i, wk2r, wk2i, wk3r, wk3i;
+T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     
     m = l << 2;
     for (j = 0; j < l; j += 2) {
@@ -1042,10 +1153,11 @@ TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
     }
 }
 
-void CFft::bitrv2conj(int n, int *ip, TYPEREAL *a)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::bitrv2conj(int n, int *ip, T *a)
 {
 	int j, j1, k, k1, l, m, m2;
-	TYPEREAL xr, xi, yr, yi;
+	T xr, xi, yr, yi;
 
 	ip[0] = 0;
 	l = n;
@@ -1150,10 +1262,11 @@ void CFft::bitrv2conj(int n, int *ip, TYPEREAL *a)
 	}
 }
 
-void CFft::cftbsub(int n, TYPEREAL *a, TYPEREAL *w)
+template<typename T, class LOCK>
+void CFft<T, LOCK>::cftbsub(int n, T *a, T *w)
 {
 	int j, j1, j2, j3, l;
-	TYPEREAL x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
+	T x0r, x0i, x1r, x1i, x2r, x2i, x3r, x3i;
 
 	l = 2;
 	if (n > 8) {
@@ -1199,4 +1312,10 @@ void CFft::cftbsub(int n, TYPEREAL *a, TYPEREAL *w)
 	}
 }
 
-
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types and locking policies
+//////////////////////////////////////////////////////////////////////
+template class CFft<tSReal, CNoLock>;
+template class CFft<tSReal, CMutexLock>;
+template class CFft<tDReal, CNoLock>;
+template class CFft<tDReal, CMutexLock>;
@@ -19,44 +19,68 @@
 
 #include <mutex>
 
+#ifdef FMDSP_USE_FFTW
+#include <fftw3.h>
+
+//FFTW API names; only the single precision library (fftw3f) is built
+//and linked, so double precision samples have to use the Ooura FFT
+#define FMDSP_FFTW(name) fftwf_##name
+#endif
+
 #define MAX_FFT_SIZE 65536
 #define MIN_FFT_SIZE 512
 
+template<typename T = TYPEREAL, class LOCK = CNoLock>
 class CFft
 {
 public:
+	//FFT implementations that can perform the transforms
+	enum eFftEngine
+	{
+		FFT_ENGINE_OOURA,	//built-in Ooura radix 4 FFT
+		FFT_ENGINE_FFTW		//FFTW plans (requires FMDSP_USE_FFTW and single precision)
+	};
+
 	CFft();
+	CFft(eFftEngine Engine);
 	virtual ~CFft();
+	eFftEngine GetEngine() const { return m_Engine; }
+	static const char* GetEngineName(eFftEngine Engine);
+	//Methods to load and save the process-wide FFTW planner wisdom
+	static bool ImportWisdom(const char* pFileName);
+	static bool ExportWisdom(const char* pFileName);
 	void SetFFTParams( qint32 size,
 						bool invert,
-						TYPEREAL dBCompensation,
-						TYPEREAL SampleFreq);
+						T dBCompensation,
+						T SampleFreq);
 	//Methods to obtain spectrum formated power vs frequency
 	void SetFFTAve( qint32 ave);
 	void ResetFFT();
 	bool GetScreenIntegerFFTData(qint32 MaxHeight, qint32 MaxWidth,
-									TYPEREAL MaxdB, TYPEREAL MindB,
+									T MaxdB, T MindB,
 									qint32 StartFreq, qint32 StopFreq,
 									qint32* OutBuf );
-	qint32 PutInDisplayFFT(qint32 n, TYPECPX* InBuf);
+	qint32 PutInDisplayFFT(qint32 n, tComplex<T>* InBuf);
 
 	//Methods for doing Fast convolutions using forward and reverse FFT
-	void FwdFFT( TYPECPX* pInOutBuf);
-	void RevFFT( TYPECPX* pInOutBuf);
+	void FwdFFT( tComplex<T>* pInOutBuf);
+	void RevFFT( tComplex<T>* pInOutBuf);
 
 private:
 	void FreeMemory();
-	void makewt(qint32 nw, qint32 *ip, TYPEREAL *w);
-	void makect(qint32 nc, qint32 *ip, TYPEREAL *c);
-	void bitrv2(qint32 n, qint32 *ip, TYPEREAL *a);
-	void cftfsub(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void rftfsub(qint32 n, TYPEREAL *a, qint32 nc, TYPEREAL *c);
-	void CpxFFT(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void cft1st(qint32 n, TYPEREAL *a, TYPEREAL *w);
-	void cftmdl(qint32 n, qint32 l, TYPEREAL *a, TYPEREAL *w);
-	void bitrv2conj(int n, int *ip, TYPEREAL *a);
-	void cftbsub(int n, TYPEREAL *a, TYPEREAL *w);
+	void CreatePlans();
+	void CalcPowerAve(qint32 n, T *a);
+	void makewt(qint32 nw, qint32 *ip, T *w);
+	void makect(qint32 nc, qint32 *ip, T *c);
+	void bitrv2(qint32 n, qint32 *ip, T *a);
+	void cftfsub(qint32 n, T *a, T *w);
+	void rftfsub(qint32 n, T *a, qint32 nc, T *c);
+	void cft1st(qint32 n, T *a, T *w);
+	void cftmdl(qint32 n, qint32 l, T *a, T *w);
+	void bitrv2conj(int n, int *ip, T *a);
+	void cftbsub(int n, T *a, T *w);
 
+	eFftEngine m_Engine;
 	bool m_Overload;
 	bool m_Invert;
 	qint32 m_AveCount;
@@ -70,21 +94,23 @@ private:
 	qint32 m_BinMax;
 	qint32 m_PlotWidth;
 
-	TYPEREAL m_K_C;
-	TYPEREAL m_K_B;
-	TYPEREAL m_dBCompensation;
-	TYPEREAL m_SampleFreq;
+	T m_K_C;
+	T m_K_B;
+	T m_dBCompensation;
+	T m_SampleFreq;
 	qint32* m_pWorkArea;
 	qint32* m_pTranslateTbl;
-	TYPEREAL* m_pSinCosTbl;
-	TYPEREAL* m_pWindowTbl;
-	TYPEREAL* m_pFFTPwrAveBuf;
-	TYPEREAL* m_pFFTAveBuf;
-	TYPEREAL* m_pFFTSumBuf;
-	TYPEREAL* m_pFFTInBuf;
-#ifdef FMDSP_THREAD_SAFE
-	mutable std::mutex m_Mutex;		//for keeping threads from stomping on each other
+	T* m_pSinCosTbl;
+	T* m_pWindowTbl;
+	T* m_pFFTPwrAveBuf;
+	T* m_pFFTAveBuf;
+	T* m_pFFTSumBuf;
+	T* m_pFFTInBuf;
+#ifdef FMDSP_USE_FFTW
+	FMDSP_FFTW(plan) m_FwdPlan[2];	//forward plans [unaligned, aligned]
+	FMDSP_FFTW(plan) m_RevPlan[2];	//reverse plans [unaligned, aligned]
 #endif
+	mutable LOCK m_Mutex;		//for keeping threads from stomping on each other
 };
 
 #endif // FFT_H
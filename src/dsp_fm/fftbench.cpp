@@ -0,0 +1,162 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------------
+// fftbench
+//
+// Microbenchmark comparing the CFft engines; times a forward and reverse
+// transform pair and the display FFT path for each supported FFT size, and
+// reports the largest difference between the engine outputs
+//
+// Usage: fftbench [iterations]
+
+#include "fft.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#pragma warning(push, 4)
+
+// timefunc (local)
+//
+// Measures the average duration of a function in nanoseconds
+template<typename _func>
+static double timefunc(int iterations, _func const& func)
+{
+  func(); // Warm up
+
+  auto start = std::chrono::steady_clock::now();
+  for (int index = 0; index < iterations; index++)
+    func();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+// maxerror (local)
+//
+// Computes the largest difference between two complex vectors relative to the peak magnitude
+static double maxerror(std::vector<TYPECPX> const& lhs, std::vector<TYPECPX> const& rhs)
+{
+  double error = 0.0;
+  double peak = 0.0;
+
+  for (size_t index = 0; index < lhs.size(); index++)
+  {
+
+    error = std::max(error, static_cast<double>(MFABS(lhs[index].re - rhs[index].re)));
+    error = std::max(error, static_cast<double>(MFABS(lhs[index].im - rhs[index].im)));
+    peak = std::max(peak, static_cast<double>(MFABS(lhs[index].re)));
+    peak = std::max(peak, static_cast<double>(MFABS(lhs[index].im)));
+  }
+
+  return (peak > 0.0) ? error / peak : error;
+}
+
+//---------------------------------------------------------------------------
+// main
+//
+// Application entry point
+//
+// Arguments:
+//
+//	argc		- Number of command line arguments
+//	argv		- Command line arguments
+
+int main(int argc, char** argv)
+{
+  int iterations = (argc > 1) ? atoi(argv[1]) : 1000;
+  if (iterations <= 0)
+    iterations = 1000;
+
+  CFft<>::eFftEngine const engines[] = {CFft<>::FFT_ENGINE_OOURA, CFft<>::FFT_ENGINE_FFTW};
+
+  std::mt19937 engine(0);
+  std::uniform_real_distribution<float> distribution(-32767.0f, 32767.0f);
+
+  printf("%-8s %-8s %14s %14s\n", "size", "engine", "fwd+rev (ns)", "display (ns)");
+
+  for (qint32 size = MIN_FFT_SIZE; size <= MAX_FFT_SIZE; size <<= 1)
+  {
+
+    std::vector<TYPECPX> input(size);
+    for (TYPECPX& sample : input)
+    {
+
+      sample.re = distribution(engine);
+      sample.im = distribution(engine);
+    }
+
+    std::vector<TYPECPX> outputs[2];
+
+    for (int index = 0; index < 2; index++)
+    {
+
+      CFft<> fft(engines[index]);
+      fft.SetFFTParams(size, false, 0.0, 1000000.0);
+
+      // The engine reverts to Ooura if FFTW is not compiled in or the plans could not be created
+      if (fft.GetEngine() != engines[index])
+      {
+
+        printf("%-8d %-8s %14s %14s\n", size, CFft<>::GetEngineName(engines[index]), "n/a", "n/a");
+        continue;
+      }
+
+      // Capture the forward transform output for the comparison between the engines
+      outputs[index] = input;
+      fft.FwdFFT(outputs[index].data());
+
+      std::vector<TYPECPX> buffer(input);
+      double transform = timefunc(iterations, [&]() -> void {
+        fft.FwdFFT(buffer.data());
+        fft.RevFFT(buffer.data());
+        for (TYPECPX& sample : buffer)
+        {
+
+          sample.re /= size;
+          sample.im /= size;
+        }
+      });
+
+      double display =
+          timefunc(iterations, [&]() -> void { fft.PutInDisplayFFT(size, input.data()); });
+
+      printf("%-8d %-8s %14.0f %14.0f\n", size, CFft<>::GetEngineName(engines[index]), transform,
+             display);
+    }
+
+    if (!outputs[0].empty() && !outputs[1].empty())
+      printf("%-8d %-8s %14.2e\n", size, "error", maxerror(outputs[0], outputs[1]));
+  }
+
+  return 0;
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
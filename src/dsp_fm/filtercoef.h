@@ -58,9 +58,11 @@
 ////////////////////////////////////////////////////////////////////
 //  The following coefficients were designed with
 // MatLab for best alias rejection at -140dB
+// Each table is a template on the sample type, ie HB11TAP_H<T>
 ////////////////////////////////////////////////////////////////////
 #define HB11TAP_LENGTH 11
-const TYPEREAL HB11TAP_H[HB11TAP_LENGTH] =
+template<typename T>
+const T HB11TAP_H[HB11TAP_LENGTH] =
 {
    0.0060431029837374152,
    0.0,
@@ -76,7 +78,8 @@ const TYPEREAL HB11TAP_H[HB11TAP_LENGTH] =
 };
 
 #define HB15TAP_LENGTH 15
-const TYPEREAL HB15TAP_H[HB15TAP_LENGTH] =
+template<typename T>
+const T HB15TAP_H[HB15TAP_LENGTH] =
 {
 	-0.001442203300285281,
 	0.0,
@@ -96,7 +99,8 @@ const TYPEREAL HB15TAP_H[HB15TAP_LENGTH] =
 };
 
 #define HB19TAP_LENGTH 19
-const TYPEREAL HB19TAP_H[HB19TAP_LENGTH] =
+template<typename T>
+const T HB19TAP_H[HB19TAP_LENGTH] =
 {
 	0.00042366527106480427,
 	0.0,
@@ -120,7 +124,8 @@ const TYPEREAL HB19TAP_H[HB19TAP_LENGTH] =
 };
 
 #define HB23TAP_LENGTH 23
-const TYPEREAL HB23TAP_H[HB23TAP_LENGTH] =
+template<typename T>
+const T HB23TAP_H[HB23TAP_LENGTH] =
 {
 	-0.00014987651418332164,
 	0.0,
@@ -147,7 +152,8 @@ const TYPEREAL HB23TAP_H[HB23TAP_LENGTH] =
 	-0.00014987651418332164
 };
 #define HB27TAP_LENGTH 27
-const TYPEREAL HB27TAP_H[HB27TAP_LENGTH] =
+template<typename T>
+const T HB27TAP_H[HB27TAP_LENGTH] =
 {
 	0.000063730426952664685,
 	0.0,
@@ -179,7 +185,8 @@ const TYPEREAL HB27TAP_H[HB27TAP_LENGTH] =
 };
 
 #define HB31TAP_LENGTH 31
-const TYPEREAL HB31TAP_H[HB31TAP_LENGTH] =
+template<typename T>
+const T HB31TAP_H[HB31TAP_LENGTH] =
 {
 	-0.000030957335326552226,
 	0.0,
@@ -214,7 +221,8 @@ const TYPEREAL HB31TAP_H[HB31TAP_LENGTH] =
 	-0.000030957335326552226
 };
 #define HB35TAP_LENGTH 35
-const TYPEREAL HB35TAP_H[HB35TAP_LENGTH] =
+template<typename T>
+const T HB35TAP_H[HB35TAP_LENGTH] =
 {
 	0.000017017718072971716,
 	0.0,
@@ -253,7 +261,8 @@ const TYPEREAL HB35TAP_H[HB35TAP_LENGTH] =
 	0.000017017718072971716
 };
 #define HB39TAP_LENGTH 39
-const TYPEREAL HB39TAP_H[HB39TAP_LENGTH] =
+template<typename T>
+const T HB39TAP_H[HB39TAP_LENGTH] =
 {
 	-0.000010175082832074367,
 	0.0,
@@ -296,7 +305,8 @@ const TYPEREAL HB39TAP_H[HB39TAP_LENGTH] =
 	-0.000010175082832074367
 };
 #define HB43TAP_LENGTH 43
-const TYPEREAL HB43TAP_H[HB43TAP_LENGTH] =
+template<typename T>
+const T HB43TAP_H[HB43TAP_LENGTH] =
 {
 	0.0000067666739082756387,
 	0.0,
@@ -343,7 +353,8 @@ const TYPEREAL HB43TAP_H[HB43TAP_LENGTH] =
 	0.0000067666739082756387
 };
 #define HB47TAP_LENGTH 47
-const TYPEREAL HB47TAP_H[HB47TAP_LENGTH] =
+template<typename T>
+const T HB47TAP_H[HB47TAP_LENGTH] =
 {
 	-0.0000045298314172004251,
 	0.0,
@@ -394,7 +405,8 @@ const TYPEREAL HB47TAP_H[HB47TAP_LENGTH] =
 	-0.0000045298314172004251
 };
 #define HB51TAP_LENGTH 51
-const TYPEREAL HB51TAP_H[HB51TAP_LENGTH] =
+template<typename T>
+const T HB51TAP_H[HB51TAP_LENGTH] =
 {
 	0.0000033359253688981639,
 	0.0,
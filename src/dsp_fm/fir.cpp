@@ -54,7 +54,8 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct CFir object
 /////////////////////////////////////////////////////////////////////////////////
-CFir::CFir()
+template<typename T, class LOCK>
+CFir<T, LOCK>::CFir()
 {
 	m_NumTaps = 1;
 	m_State = 0;
@@ -69,15 +70,14 @@ CFir::CFir()
 //   {21, -43, 15, 21, -43, 15 }
 //REAL version
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
+template<typename T, class LOCK>
+void CFir<T, LOCK>::ProcessFilter(int InLength, T* InBuf, T* OutBuf)
 {
-TYPEREAL acc;
-TYPEREAL* Zptr;
-const TYPEREAL* Hptr;
+T acc;
+T* Zptr;
+const T* Hptr;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	for(int i=0; i<InLength; i++)
 	{
@@ -101,16 +101,15 @@ const TYPEREAL* Hptr;
 //   {21, -43, 15, 21, -43, 15 }
 //COMPLEX version
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
+template<typename T, class LOCK>
+void CFir<T, LOCK>::ProcessFilter(int InLength, tComplex<T>* InBuf, tComplex<T>* OutBuf)
 {
-TYPECPX acc;
-TYPECPX* Zptr;
-TYPEREAL* HIptr;
-TYPEREAL* HQptr;
+tComplex<T> acc;
+tComplex<T>* Zptr;
+T* HIptr;
+T* HQptr;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	for(int i=0; i<InLength; i++)
 	{
@@ -140,16 +139,15 @@ TYPEREAL* HQptr;
 //   {21, -43, 15, 21, -43, 15 }
 //REAL in COMPLEX out version (for Hilbert filter pair)
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPECPX* OutBuf)
+template<typename T, class LOCK>
+void CFir<T, LOCK>::ProcessFilter(int InLength, T* InBuf, tComplex<T>* OutBuf)
 {
-TYPECPX acc;
-TYPECPX* Zptr;
-TYPEREAL* HIptr;
-TYPEREAL* HQptr;
+tComplex<T> acc;
+tComplex<T>* Zptr;
+T* HIptr;
+T* HQptr;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	for(int i=0; i<InLength; i++)
 	{
@@ -175,11 +173,10 @@ TYPEREAL* HQptr;
 //  Initializes a pre-designed FIR filter with fixed coefficients
 //	Iniitalize FIR variables and clear out buffers.
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate)
+template<typename T, class LOCK>
+void CFir<T, LOCK>::InitConstFir( int NumTaps, const T* pCoef, T Fsamprate)
 {
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	m_SampleRate = Fsamprate;
 	if(NumTaps>MAX_NUMCOEF)
@@ -204,11 +201,10 @@ void CFir::InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate)
 //  Initializes a pre-designed complex FIR filter with fixed coefficients
 //	Iniitalize FIR variables and clear out buffers.
 /////////////////////////////////////////////////////////////////////////////////
-void CFir::InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQCoef, TYPEREAL Fsamprate)
+template<typename T, class LOCK>
+void CFir<T, LOCK>::InitConstFir( int NumTaps, const T* pICoef, const T* pQCoef, T Fsamprate)
 {
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	m_SampleRate = Fsamprate;
 	if(NumTaps>MAX_NUMCOEF)
@@ -249,20 +245,19 @@ void CFir::InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQ
 //                    Fpass   Fstop
 //
 ////////////////////////////////////////////////////////////////////
-int CFir::InitLPFilter(int NumTaps, TYPEREAL Scale, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop, TYPEREAL Fsamprate)
+template<typename T, class LOCK>
+int CFir<T, LOCK>::InitLPFilter(int NumTaps, T Scale, T Astop, T Fpass, T Fstop, T Fsamprate)
 {
 int n;
-TYPEREAL Beta;
+T Beta;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	m_SampleRate = Fsamprate;
 	//create normalized frequency parameters
-	TYPEREAL normFpass = Fpass/Fsamprate;
-	TYPEREAL normFstop = Fstop/Fsamprate;
-	TYPEREAL normFcut = (normFstop + normFpass)/2.0;	//low pass filter 6dB cutoff
+	T normFpass = Fpass/Fsamprate;
+	T normFstop = Fstop/Fsamprate;
+	T normFcut = (normFstop + normFpass)/2.0;	//low pass filter 6dB cutoff
 
 	//calculate Kaiser-Bessel window shape factor, Beta, from stopband attenuation
 	if(Astop < 20.96)
@@ -270,7 +265,7 @@ TYPEREAL Beta;
 	else if(Astop >= 50.0)
 		Beta = .1102 * (Astop - 8.71);
 	else
-		Beta = .5842 * MPOW( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
+		Beta = .5842 * TPOW<T>( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
 
 	//Now Estimate number of filter taps required based on filter specs
 	m_NumTaps = static_cast<int>((Astop - 8.0) / (2.285*K_2PI*(normFstop - normFpass) ) + 1);
@@ -284,20 +279,20 @@ TYPEREAL Beta;
 	if(NumTaps)	//if need to force to to a number of taps
 		m_NumTaps = NumTaps;
 
-	TYPEREAL fCenter = .5*(TYPEREAL)(m_NumTaps-1);
-	TYPEREAL izb = Izero(Beta);		//precalculate denominator since is same for all points
+	T fCenter = .5*(T)(m_NumTaps-1);
+	T izb = Izero(Beta);		//precalculate denominator since is same for all points
 	for( n=0; n < m_NumTaps; n++)
 	{
-		TYPEREAL x = (TYPEREAL)n - fCenter;
-		TYPEREAL c;
+		T x = (T)n - fCenter;
+		T c;
 		// create ideal Sinc() LP filter with normFcut
-		if( (TYPEREAL)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
+		if( (T)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
 			c = 2.0 * normFcut;
 		else
-			c = MSIN(K_2PI*x*normFcut)/(K_PI*x);
+			c = TSIN<T>(K_2PI*x*normFcut)/(K_PI*x);
 		//calculate Kaiser window and multiply to get coefficient
-		x = ((TYPEREAL)n - ((TYPEREAL)m_NumTaps-1.0)/2.0 ) / (((TYPEREAL)m_NumTaps-1.0)/2.0);
-		m_Coef[n] = Scale * c * Izero( Beta * MSQRT(1 - (x*x) ) )  / izb;
+		x = ((T)n - ((T)m_NumTaps-1.0)/2.0 ) / (((T)m_NumTaps-1.0)/2.0);
+		m_Coef[n] = Scale * c * Izero( Beta * TSQRT<T>(1 - (x*x) ) )  / izb;
 	}
 
 	//make a 2x length array for FIR flat calculation efficiency
@@ -340,20 +335,19 @@ TYPEREAL Beta;
 //  Astop ---------
 //            Fstop   Fpass
 ////////////////////////////////////////////////////////////////////
-int CFir::InitHPFilter(int NumTaps, TYPEREAL Scale, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop, TYPEREAL Fsamprate)
+template<typename T, class LOCK>
+int CFir<T, LOCK>::InitHPFilter(int NumTaps, T Scale, T Astop, T Fpass, T Fstop, T Fsamprate)
 {
 int n;
-TYPEREAL Beta;
+T Beta;
 
-#ifdef FMDSP_THREAD_SAFE
-	std::unique_lock<std::mutex> lock(m_Mutex);
-#endif
+	std::unique_lock<LOCK> lock(m_Mutex);
 
 	m_SampleRate = Fsamprate;
 	//create normalized frequency parameters
-	TYPEREAL normFpass = Fpass/Fsamprate;
-	TYPEREAL normFstop = Fstop/Fsamprate;
-	TYPEREAL normFcut = (normFstop + normFpass)/2.0;	//high pass filter 6dB cutoff
+	T normFpass = Fpass/Fsamprate;
+	T normFstop = Fstop/Fsamprate;
+	T normFcut = (normFstop + normFpass)/2.0;	//high pass filter 6dB cutoff
 
 	//calculate Kaiser-Bessel window shape factor, Beta, from stopband attenuation
 	if(Astop < 20.96)
@@ -361,7 +355,7 @@ TYPEREAL Beta;
 	else if(Astop >= 50.0)
 		Beta = .1102 * (Astop - 8.71);
 	else
-		Beta = .5842 * MPOW( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
+		Beta = .5842 * TPOW<T>( (Astop-20.96), 0.4) + .07886 * (Astop - 20.96);
 
 	//Now Estimate number of filter taps required based on filter specs
 	m_NumTaps = static_cast<int>((Astop - 8.0) / (2.285*K_2PI*(normFpass - normFstop ) ) + 1);
@@ -377,21 +371,21 @@ TYPEREAL Beta;
 	if(NumTaps)	//if need to force to to a number of taps
 		m_NumTaps = NumTaps;
 
-	TYPEREAL izb = Izero(Beta);		//precalculate denominator since is same for all points
-	TYPEREAL fCenter = .5*(TYPEREAL)(m_NumTaps-1);
+	T izb = Izero(Beta);		//precalculate denominator since is same for all points
+	T fCenter = .5*(T)(m_NumTaps-1);
 	for( n=0; n < m_NumTaps; n++)
 	{
-		TYPEREAL x = (TYPEREAL)n - (TYPEREAL)(m_NumTaps-1)/2.0;
-		TYPEREAL c;
+		T x = (T)n - (T)(m_NumTaps-1)/2.0;
+		T c;
 		// create ideal Sinc() HP filter with normFcut
-		if( (TYPEREAL)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
+		if( (T)n == fCenter )	//deal with odd size filter singularity where sin(0)/0==1
 			c = 1.0 - 2.0 * normFcut;
 		else
-			c = MSIN(K_PI*x)/(K_PI*x) - MSIN(K_2PI*x*normFcut)/(K_PI*x);
+			c = TSIN<T>(K_PI*x)/(K_PI*x) - TSIN<T>(K_2PI*x*normFcut)/(K_PI*x);
 
 		//calculate Kaiser window and multiply to get coefficient
-		x = ((TYPEREAL)n - ((TYPEREAL)m_NumTaps-1.0)/2.0 ) / (((TYPEREAL)m_NumTaps-1.0)/2.0);
-		m_Coef[n] = Scale * c * Izero( Beta * MSQRT(1 - (x*x) ) )  / izb;
+		x = ((T)n - ((T)m_NumTaps-1.0)/2.0 ) / (((T)m_NumTaps-1.0)/2.0);
+		m_Coef[n] = Scale * c * Izero( Beta * TSQRT<T>(1 - (x*x) ) )  / izb;
 	}
 
 	//make a 2x length array for FIR flat calculation efficiency
@@ -422,14 +416,15 @@ TYPEREAL Beta;
 // filter coefficients.
 // Hbpreal(n)= 2*Hlp(n)*cos( 2PI*FreqOffset*(n-(N-1)/2)/samplerate );
 // Hbpimaj(n)= 2*Hlp(n)*sin( 2PI*FreqOffset*(n-(N-1)/2)/samplerate );
-void CFir::GenerateHBFilter( TYPEREAL FreqOffset)
+template<typename T, class LOCK>
+void CFir<T, LOCK>::GenerateHBFilter( T FreqOffset)
 {
 int n;
 	for(n=0; n<m_NumTaps; n++)
 	{
 		// apply complex frequency shift transform to low pass filter coefficients
-		m_ICoef[n] = 2.0 * m_Coef[n] * MCOS( (K_2PI*FreqOffset/m_SampleRate)*((TYPEREAL)n - ( (TYPEREAL)(m_NumTaps-1)/2.0 ) ) );
-		m_QCoef[n] = 2.0 * m_Coef[n] * MSIN( (K_2PI*FreqOffset/m_SampleRate)*((TYPEREAL)n - ( (TYPEREAL)(m_NumTaps-1)/2.0 ) ) );
+		m_ICoef[n] = 2.0 * m_Coef[n] * TCOS<T>( (K_2PI*FreqOffset/m_SampleRate)*((T)n - ( (T)(m_NumTaps-1)/2.0 ) ) );
+		m_QCoef[n] = 2.0 * m_Coef[n] * TSIN<T>( (K_2PI*FreqOffset/m_SampleRate)*((T)n - ( (T)(m_NumTaps-1)/2.0 ) ) );
 	}
 	//make a 2x length array for FIR flat calculation efficiency
 	for (n = 0; n < m_NumTaps; n++)
@@ -444,14 +439,15 @@ int n;
 //     using a series approximation.
 // I0(x) = 1.0 + { sum from k=1 to infinity ---->  [(x/2)^k / k!]^2 }
 ///////////////////////////////////////////////////////////////////////////
-TYPEREAL CFir::Izero(TYPEREAL x)
+template<typename T, class LOCK>
+T CFir<T, LOCK>::Izero(T x)
 {
-TYPEREAL x2 = x/2.0;
-TYPEREAL sum = 1.0;
-TYPEREAL ds = 1.0;
-TYPEREAL di = 1.0;
-TYPEREAL errorlimit = 1e-9;
-TYPEREAL tmp;
+T x2 = x/2.0;
+T sum = 1.0;
+T ds = 1.0;
+T di = 1.0;
+T errorlimit = 1e-9;
+T tmp;
 	do
 	{
 		tmp = x2/di;
@@ -472,13 +468,14 @@ TYPEREAL tmp;
 //////////////////////////////////////////////////////////////////////
 //Decimate by 2 Halfband filter class implementation
 //////////////////////////////////////////////////////////////////////
-CDecimateBy2::CDecimateBy2(int len,const TYPEREAL* pCoef )
+template<typename T>
+CDecimateBy2<T>::CDecimateBy2(int len,const T* pCoef )
 	: m_FirLength(len), m_pCoef(pCoef)
 {
 	//create buffer for FIR implementation
-	m_pHBFirRBuf = new TYPEREAL[MAX_HALF_BAND_BUFSIZE];
-	m_pHBFirCBuf = new TYPECPX[MAX_HALF_BAND_BUFSIZE];
-	TYPECPX CPXZERO = {0.0,0.0};
+	m_pHBFirRBuf = new T[MAX_HALF_BAND_BUFSIZE];
+	m_pHBFirCBuf = new tComplex<T>[MAX_HALF_BAND_BUFSIZE];
+	tComplex<T> CPXZERO = {0.0,0.0};
 	for(int i=0; i<MAX_HALF_BAND_BUFSIZE ;i++)
 	{
 		m_pHBFirRBuf[i] = 0.0;
@@ -493,7 +490,8 @@ CDecimateBy2::CDecimateBy2(int len,const TYPEREAL* pCoef )
 // InLength must be an even number
 //Mono version
 //////////////////////////////////////////////////////////////////////
-int CDecimateBy2::DecBy2(int InLength, TYPEREAL* pInData, TYPEREAL* pOutData)
+template<typename T>
+int CDecimateBy2<T>::DecBy2(int InLength, T* pInData, T* pOutData)
 {
 int i;
 int j;
@@ -508,7 +506,7 @@ int numoutsamples = 0;
 	//perform decimation FIR filter on even samples
 	for(i=0; i<InLength; i+=2)
 	{
-		TYPEREAL acc;
+		T acc;
 		acc = ( m_pHBFirRBuf[i] * m_pCoef[0] );
 		for(j=2; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
 			acc += ( m_pHBFirRBuf[i+j] * m_pCoef[j] );
@@ -530,7 +528,8 @@ int numoutsamples = 0;
 // InLength must be an even number  ~37nS
 // complex or stereo version
 //////////////////////////////////////////////////////////////////////
-int CDecimateBy2::DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template<typename T>
+int CDecimateBy2<T>::DecBy2(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData)
 {
 int i;
 int j;
@@ -545,7 +544,7 @@ int numoutsamples = 0;
 	//perform decimation FIR filter on even samples
 	for(i=0; i<InLength; i+=2)
 	{
-		TYPECPX acc;
+		tComplex<T> acc;
 		acc.re = ( m_pHBFirCBuf[i].re * m_pCoef[0] );
 		acc.im = ( m_pHBFirCBuf[i].im * m_pCoef[0] );
 		for(j=2; j<m_FirLength; j+=2)	//only use even coefficients since odd are zero(except center point)
@@ -565,3 +564,13 @@ int numoutsamples = 0;
 		m_pHBFirCBuf[i] = pInData[j++];
 	return numoutsamples;
 }
+
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types and locking policies
+//////////////////////////////////////////////////////////////////////
+template class CFir<tSReal, CNoLock>;
+template class CFir<tSReal, CMutexLock>;
+template class CFir<tDReal, CNoLock>;
+template class CFir<tDReal, CMutexLock>;
+template class CDecimateBy2<tSReal>;
+template class CDecimateBy2<tDReal>;
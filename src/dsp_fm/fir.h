@@ -52,49 +52,49 @@
 ////////////
 //class for FIR Filters
 ////////////
+template<typename T = TYPEREAL, class LOCK = CNoLock>
 class CFir
 {
 public:
     CFir();
 
-	void InitConstFir( int NumTaps, const TYPEREAL* pCoef, TYPEREAL Fsamprate);
-	void InitConstFir( int NumTaps, const TYPEREAL* pICoef, const TYPEREAL* pQCoef, TYPEREAL Fsamprate);
-	int InitLPFilter(int NumTaps, TYPEREAL Scale, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop, TYPEREAL Fsamprate);
-	int InitHPFilter(int NumTaps, TYPEREAL Scale, TYPEREAL Astop, TYPEREAL Fpass, TYPEREAL Fstop, TYPEREAL Fsamprate);
-	void GenerateHBFilter( TYPEREAL FreqOffset);
-	void ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf);
-	void ProcessFilter(int InLength, TYPEREAL* InBuf, TYPECPX* OutBuf);
-	void ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
+	void InitConstFir( int NumTaps, const T* pCoef, T Fsamprate);
+	void InitConstFir( int NumTaps, const T* pICoef, const T* pQCoef, T Fsamprate);
+	int InitLPFilter(int NumTaps, T Scale, T Astop, T Fpass, T Fstop, T Fsamprate);
+	int InitHPFilter(int NumTaps, T Scale, T Astop, T Fpass, T Fstop, T Fsamprate);
+	void GenerateHBFilter( T FreqOffset);
+	void ProcessFilter(int InLength, T* InBuf, T* OutBuf);
+	void ProcessFilter(int InLength, T* InBuf, tComplex<T>* OutBuf);
+	void ProcessFilter(int InLength, tComplex<T>* InBuf, tComplex<T>* OutBuf);
 
 private:
-	TYPEREAL Izero(TYPEREAL x);
-	TYPEREAL m_SampleRate;
+	T Izero(T x);
+	T m_SampleRate;
 	int m_NumTaps;
 	int m_State;
-	TYPEREAL m_Coef[MAX_NUMCOEF*2];
-	TYPEREAL m_ICoef[MAX_NUMCOEF*2];
-	TYPEREAL m_QCoef[MAX_NUMCOEF*2];
-	TYPEREAL m_rZBuf[MAX_NUMCOEF];
-	TYPECPX m_cZBuf[MAX_NUMCOEF];
-#ifdef FMDSP_THREAD_SAFE
-	mutable std::mutex m_Mutex;		//for keeping threads from stomping on each other
-#endif
+	T m_Coef[MAX_NUMCOEF*2];
+	T m_ICoef[MAX_NUMCOEF*2];
+	T m_QCoef[MAX_NUMCOEF*2];
+	T m_rZBuf[MAX_NUMCOEF];
+	tComplex<T> m_cZBuf[MAX_NUMCOEF];
+	mutable LOCK m_Mutex;		//for keeping threads from stomping on each other
 };
 
 ////////////
 //class for the Half Band decimate by 2 FIR filters
 ////////////
+template<typename T = TYPEREAL>
 class CDecimateBy2
 {
 public:
-	CDecimateBy2(int len, const TYPEREAL* pCoef);
+	CDecimateBy2(int len, const T* pCoef);
 	~CDecimateBy2(){if(m_pHBFirRBuf) delete m_pHBFirRBuf; if(m_pHBFirCBuf) delete m_pHBFirCBuf;}
-	int DecBy2(int InLength, TYPEREAL* pInData, TYPEREAL* pOutData);
-	int DecBy2(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-	TYPEREAL* m_pHBFirRBuf;
-	TYPECPX* m_pHBFirCBuf;
+	int DecBy2(int InLength, T* pInData, T* pOutData);
+	int DecBy2(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData);
+	T* m_pHBFirRBuf;
+	tComplex<T>* m_pHBFirCBuf;
 	int m_FirLength;
-	const TYPEREAL* m_pCoef;
+	const T* m_pCoef;
 };
 
 #endif // FIR_H
@@ -61,7 +61,8 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct FM demod object
 /////////////////////////////////////////////////////////////////////////////////
-CFmDemod::CFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
+template<typename T>
+CFmDemod<T>::CFmDemod(T samplerate) : m_SampleRate(samplerate)
 {
 	m_FreqErrorDC = 0.0;
 	m_NcoPhase = 0.0;
@@ -74,11 +75,12 @@ CFmDemod::CFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
 /////////////////////////////////////////////////////////////////////////////////
 // Sets sample rate and adjusts any parameters that are affected.
 /////////////////////////////////////////////////////////////////////////////////
-void CFmDemod::SetSampleRate(TYPEREAL samplerate)
+template<typename T>
+void CFmDemod<T>::SetSampleRate(T samplerate)
 {
 	m_SampleRate = samplerate;
 
-	TYPEREAL norm = K_2PI/m_SampleRate;	//to normalize Hz to radians
+	T norm = K_2PI/m_SampleRate;	//to normalize Hz to radians
 
 	//initialize the PLL
 	m_NcoLLimit = -FMPLL_RANGE * norm;		//clamp FM PLL NCO
@@ -89,15 +91,15 @@ void CFmDemod::SetSampleRate(TYPEREAL samplerate)
 	m_OutGain = MAX_FMOUT/m_NcoHLimit;	//audio output level gain value
 
 	//DC removal filter time constant
-	m_DcAlpha = (1.0 - MEXP(-1.0/(m_SampleRate*FMDC_ALPHA)) );
+	m_DcAlpha = (1.0 - TEXP<T>(-1.0/(m_SampleRate*FMDC_ALPHA)) );
 
 	//initialize some noise squelch items
 	m_SquelchHPFreq = VOICE_BANDWIDTH;
 	m_SquelchAve = 0.0;
 	m_SquelchState = true;
-	m_SquelchAlpha = (1.0-MEXP(-1.0/(m_SampleRate*SQUELCHAVE_TIMECONST)) );
+	m_SquelchAlpha = (1.0-TEXP<T>(-1.0/(m_SampleRate*SQUELCHAVE_TIMECONST)) );
 
-	m_DeemphasisAlpha = (1.0-MEXP(-1.0/(m_SampleRate*DEMPHASIS_TIME)) );
+	m_DeemphasisAlpha = (1.0-TEXP<T>(-1.0/(m_SampleRate*DEMPHASIS_TIME)) );
 	m_DeemphasisAve = 0.0;
 
 	//m_LpFir.InitLPFilter(0, 1.0, 50.0, VOICE_BANDWIDTH, 1.6 * VOICE_BANDWIDTH, m_SampleRate);
@@ -110,16 +112,18 @@ void CFmDemod::SetSampleRate(TYPEREAL samplerate)
 /////////////////////////////////////////////////////////////////////////////////
 // Sets squelch threshold based on 'Value' which goes from -160 to 0.
 /////////////////////////////////////////////////////////////////////////////////
-void CFmDemod::SetSquelch(int Value)
+template<typename T>
+void CFmDemod<T>::SetSquelch(int Value)
 {
-	m_SquelchThreshold = (SQUELCH_MAX*(TYPEREAL)Value)/-160.0;
+	m_SquelchThreshold = (SQUELCH_MAX*(T)Value)/-160.0;
 }
 
 
 /////////////////////////////////////////////////////////////////////////////////
 // Sets up Highpass noise filter parameters based on input filter BW
 /////////////////////////////////////////////////////////////////////////////////
-void CFmDemod::InitNoiseSquelch()
+template<typename T>
+void CFmDemod<T>::InitNoiseSquelch()
 {
 	//m_HpFir.InitHPFilter(0, 1.0, 50.0, m_SquelchHPFreq*.8, m_SquelchHPFreq*.65, m_SampleRate);
 	m_HpFir.InitHPFilter(0, 1.0, 50.0, VOICE_BANDWIDTH*2.0, VOICE_BANDWIDTH, m_SampleRate);
@@ -129,16 +133,17 @@ void CFmDemod::InitNoiseSquelch()
 /////////////////////////////////////////////////////////////////////////////////
 // Performs noise squelch by reading the noise power above the voice frequencies
 /////////////////////////////////////////////////////////////////////////////////
-void CFmDemod::PerformNoiseSquelch(int InLength, TYPEREAL* pOutData)
+template<typename T>
+void CFmDemod<T>::PerformNoiseSquelch(int InLength, T* pOutData)
 {
 	if(InLength>MAX_SQBUF_SIZE)
 		return;
-	TYPEREAL sqbuf[MAX_SQBUF_SIZE];
+	T sqbuf[MAX_SQBUF_SIZE];
 	//high pass filter to get the high frequency noise above the voice
 	m_HpFir.ProcessFilter(InLength, pOutData, sqbuf);
 	for(int i=0; i<InLength; i++)
 	{
-		TYPEREAL mag = MFABS( sqbuf[i] );	//get magnitude of High pass filtered data
+		T mag = TFABS<T>( sqbuf[i] );	//get magnitude of High pass filtered data
 		// exponential filter squelch magnitude
 		m_SquelchAve = (1.0-m_SquelchAlpha)*m_SquelchAve + m_SquelchAlpha*mag;
 	}
@@ -173,9 +178,10 @@ void CFmDemod::PerformNoiseSquelch(int InLength, TYPEREAL* pOutData)
 /////////////////////////////////////////////////////////////////////////////////
 //	Process FM demod MONO version
 /////////////////////////////////////////////////////////////////////////////////
-int CFmDemod::ProcessData(int InLength, TYPEREAL FmBW, TYPECPX* pInData, TYPEREAL* pOutData)
+template<typename T>
+int CFmDemod<T>::ProcessData(int InLength, T FmBW, tComplex<T>* pInData, T* pOutData)
 {
-TYPECPX tmp;
+tComplex<T> tmp;
 	if(m_SquelchHPFreq != FmBW)
 	{	//update squelch HP filter cutoff from main filter BW
 		m_SquelchHPFreq = FmBW;
@@ -183,13 +189,13 @@ TYPECPX tmp;
 	}
 	for(int i=0; i<InLength; i++)
 	{
-		TYPEREAL Sin = MSIN(m_NcoPhase);
-		TYPEREAL Cos = MCOS(m_NcoPhase);
+		T Sin = TSIN<T>(m_NcoPhase);
+		T Cos = TCOS<T>(m_NcoPhase);
 		//complex multiply input sample by NCO's  sin and cos
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -MATAN2(tmp.im, tmp.re);
+		T phzerror = -TATAN2<T>(tmp.im, tmp.re);
 		//create new NCO frequency term
 		m_NcoFreq += (m_PllBeta * phzerror);		//  radians per sampletime
 		//clamp NCO frequency so doesn't get out of lock range
@@ -204,7 +210,7 @@ TYPECPX tmp;
 		//subtract out DC term to get FM audio
 		pOutData[i] = (m_NcoFreq-m_FreqErrorDC)*m_OutGain;
 	}
-	m_NcoPhase = MFMOD(m_NcoPhase, K_2PI);	//keep radian counter bounded
+	m_NcoPhase = TFMOD<T>(m_NcoPhase, K_2PI);	//keep radian counter bounded
 	PerformNoiseSquelch(InLength, pOutData);	//calculate squelch
 	return InLength;
 }
@@ -212,9 +218,10 @@ TYPECPX tmp;
 /////////////////////////////////////////////////////////////////////////////////
 //	Process FM demod STEREO version
 /////////////////////////////////////////////////////////////////////////////////
-int CFmDemod::ProcessData(int InLength, TYPEREAL FmBW, TYPECPX* pInData, TYPECPX* pOutData)
+template<typename T>
+int CFmDemod<T>::ProcessData(int InLength, T FmBW, tComplex<T>* pInData, tComplex<T>* pOutData)
 {
-TYPECPX tmp;
+tComplex<T> tmp;
 	if(m_SquelchHPFreq != FmBW)
 	{	//update Squelch HP filter cutoff from main filter BW
 		m_SquelchHPFreq = FmBW;
@@ -222,13 +229,13 @@ TYPECPX tmp;
 	}
 	for(int i=0; i<InLength; i++)
 	{
-		TYPEREAL Sin = MSIN(m_NcoPhase);
-		TYPEREAL Cos = MCOS(m_NcoPhase);
+		T Sin = TSIN<T>(m_NcoPhase);
+		T Cos = TCOS<T>(m_NcoPhase);
 		//complex multiply input sample by NCO's  sin and cos
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -MATAN2(tmp.im, tmp.re);
+		T phzerror = -TATAN2<T>(tmp.im, tmp.re);
 
 		m_NcoFreq += (m_PllBeta * phzerror);		//  radians per sampletime
 		//clamp NCO frequency so doesn't drift out of lock range
@@ -243,7 +250,7 @@ TYPECPX tmp;
 		//subtract out DC term to get FM audio
 		m_OutBuf[i] = (m_NcoFreq-m_FreqErrorDC)*m_OutGain;
 	}
-	m_NcoPhase = MFMOD(m_NcoPhase, K_2PI);	//keep radian counter bounded
+	m_NcoPhase = TFMOD<T>(m_NcoPhase, K_2PI);	//keep radian counter bounded
 	PerformNoiseSquelch(InLength, m_OutBuf);
 	for(int i=0; i<InLength; i++)
 	{	//copy audio stream into both output channels for stereo version
@@ -257,7 +264,8 @@ TYPECPX tmp;
 //	Process InLength InBuf[] samples and place in OutBuf[]
 //MONO version
 /////////////////////////////////////////////////////////////////////////////////
-void CFmDemod::ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
+template<typename T>
+void CFmDemod<T>::ProcessDeemphasisFilter(int InLength, T* InBuf, T* OutBuf)
 {
 	for(int i=0; i<InLength; i++)
 	{
@@ -266,3 +274,8 @@ void CFmDemod::ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL*
 	}
 }
 
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types
+//////////////////////////////////////////////////////////////////////
+template class CFmDemod<tSReal>;
+template class CFmDemod<tDReal>;
@@ -41,47 +41,48 @@
 
 #define MAX_SQBUF_SIZE 16384
 
+template<typename T = TYPEREAL>
 class CFmDemod
 {
 public:
-	CFmDemod(TYPEREAL samplerate);
+	CFmDemod(T samplerate);
 	//overloaded functions for mono and stereo
-	int ProcessData(int InLength, TYPEREAL FmBW, TYPECPX* pInData, TYPECPX* pOutData);
-	int ProcessData(int InLength, TYPEREAL FmBW, TYPECPX* pInData, TYPEREAL* pOutData);
+	int ProcessData(int InLength, T FmBW, tComplex<T>* pInData, tComplex<T>* pOutData);
+	int ProcessData(int InLength, T FmBW, tComplex<T>* pInData, T* pOutData);
 
-	void SetSampleRate(TYPEREAL samplerate);
+	void SetSampleRate(T samplerate);
 	void SetSquelch(int Value);		//call with range of -160 to 0 to set squelch threshold
 
 private:
 	
-	void PerformNoiseSquelch(int InLength, TYPEREAL* pOutData);
+	void PerformNoiseSquelch(int InLength, T* pOutData);
 	void InitNoiseSquelch();
-	void ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf);
+	void ProcessDeemphasisFilter(int InLength, T* InBuf, T* OutBuf);
 
 	bool m_SquelchState;
-	TYPEREAL m_SampleRate;
-	TYPEREAL m_SquelchHPFreq;
-	TYPEREAL m_OutGain;
-	TYPEREAL m_FreqErrorDC;
-	TYPEREAL m_DcAlpha;
-	TYPEREAL m_NcoPhase;
-	TYPEREAL m_NcoFreq;
-	TYPEREAL m_NcoLLimit;
-	TYPEREAL m_NcoHLimit;
-	TYPEREAL m_PllAlpha;
-	TYPEREAL m_PllBeta;
+	T m_SampleRate;
+	T m_SquelchHPFreq;
+	T m_OutGain;
+	T m_FreqErrorDC;
+	T m_DcAlpha;
+	T m_NcoPhase;
+	T m_NcoFreq;
+	T m_NcoLLimit;
+	T m_NcoHLimit;
+	T m_PllAlpha;
+	T m_PllBeta;
 
-	TYPEREAL m_SquelchThreshold;
-	TYPEREAL m_SquelchAve;
-	TYPEREAL m_SquelchAlpha;
+	T m_SquelchThreshold;
+	T m_SquelchAve;
+	T m_SquelchAlpha;
 
-	TYPEREAL m_OutBuf[MAX_SQBUF_SIZE];
+	T m_OutBuf[MAX_SQBUF_SIZE];
 
-	TYPEREAL m_DeemphasisAve;
-	TYPEREAL m_DeemphasisAlpha;
+	T m_DeemphasisAve;
+	T m_DeemphasisAlpha;
 
-	CFir m_HpFir;
-	CFir m_LpFir;
+	CFir<T> m_HpFir;
+	CFir<T> m_LpFir;
 
 };
 
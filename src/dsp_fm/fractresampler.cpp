@@ -3,7 +3,9 @@
 //
 //  This class implements a fractional resampler that can be used to
 //convert between different sample rates.  A windowes sinc interpolator
-// is used to create samples "in between" input samples.
+// is used to create samples "in between" input samples.  The sinc is
+// stored as a polyphase filterbank and the coefficients for each output
+// are interpolated between the two nearest phases.
 //
 // History:
 //	2010-09-15  Initial creation MSW
@@ -44,80 +46,197 @@
 
 #include <cstring>
 
+#include "../utils/simd.h"
+
 //////////////////////////////////////////////////////////////////////
 // Local defines
 //////////////////////////////////////////////////////////////////////
-#ifdef FMDSP_USE_DOUBLE_PRECISION
-#define SINC_PERIOD_PTS 10000	//number of points in sinc table between "zero crossings"
-								//smaller value increases noise floor
-#define SINC_PERIODS 28	//number of input sample periods("zero crossings"-1) in
-						//sinc function(should be even)
-						//decreasing reduces alias free bandwidth
-#else   //if using single precision math assume lightweight CPU and dont worry so much about resample quality
-#define SINC_PERIOD_PTS 1000
-#define SINC_PERIODS 10
-#endif
+#define MAX_SOUNDCARDVAL 32767.0
 
-#define SINC_LENGTH	( (SINC_PERIODS)*SINC_PERIOD_PTS + 1)//number of total points in sinc table
+//////////////////////////////////////////////////////////////////////
+// Dot product kernels
+//  Each kernel multiplies SINC_TAPS input samples by the phase
+//  coefficients h interpolated toward the next phase by the fraction a
+//  using the deltas d, and returns the sum.  The SIMD kernels are single
+//  precision overloads of the scalar kernels.
+//////////////////////////////////////////////////////////////////////
+#if defined(SIMD_X86)
+static inline tSComplex DotCpx(const tSComplex* x, const tSReal* h, const tSReal* d, tSReal a)
+{
+	__m128 va = _mm_set1_ps(a);
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	for(int k=0; k<CFractResampler<tSReal>::SINC_TAPS; k+=4)
+	{
+		__m128 c = _mm_add_ps(_mm_loadu_ps(h + k), _mm_mul_ps(va, _mm_loadu_ps(d + k)));
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_unpacklo_ps(c, c), _mm_loadu_ps((const float*)(x + k))));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_unpackhi_ps(c, c), _mm_loadu_ps((const float*)(x + k + 2))));
+	}
+	acc0 = _mm_add_ps(acc0, acc1);
+	acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+	tSComplex acc;
+	acc.re = _mm_cvtss_f32(acc0);
+	acc.im = _mm_cvtss_f32(_mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(1, 1, 1, 1)));
+	return acc;
+}
 
-#define MAX_SOUNDCARDVAL 32767.0
+static inline tSReal DotReal(const tSReal* x, const tSReal* h, const tSReal* d, tSReal a)
+{
+	__m128 va = _mm_set1_ps(a);
+	__m128 acc = _mm_setzero_ps();
+	for(int k=0; k<CFractResampler<tSReal>::SINC_TAPS; k+=4)
+	{
+		__m128 c = _mm_add_ps(_mm_loadu_ps(h + k), _mm_mul_ps(va, _mm_loadu_ps(d + k)));
+		acc = _mm_add_ps(acc, _mm_mul_ps(c, _mm_loadu_ps(x + k)));
+	}
+	acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+	acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+	return _mm_cvtss_f32(acc);
+}
+#elif defined(SIMD_NEON)
+static inline tSComplex DotCpx(const tSComplex* x, const tSReal* h, const tSReal* d, tSReal a)
+{
+	float32x4_t acc0 = vdupq_n_f32(0.0f);
+	float32x4_t acc1 = vdupq_n_f32(0.0f);
+	for(int k=0; k<CFractResampler<tSReal>::SINC_TAPS; k+=4)
+	{
+		float32x4_t c = vmlaq_n_f32(vld1q_f32(h + k), vld1q_f32(d + k), a);
+		float32x4x2_t cc = vzipq_f32(c, c);
+		acc0 = vmlaq_f32(acc0, cc.val[0], vld1q_f32((const float*)(x + k)));
+		acc1 = vmlaq_f32(acc1, cc.val[1], vld1q_f32((const float*)(x + k + 2)));
+	}
+	acc0 = vaddq_f32(acc0, acc1);
+	float32x2_t sum = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+	tSComplex acc;
+	acc.re = vget_lane_f32(sum, 0);
+	acc.im = vget_lane_f32(sum, 1);
+	return acc;
+}
+
+static inline tSReal DotReal(const tSReal* x, const tSReal* h, const tSReal* d, tSReal a)
+{
+	float32x4_t acc = vdupq_n_f32(0.0f);
+	for(int k=0; k<CFractResampler<tSReal>::SINC_TAPS; k+=4)
+	{
+		float32x4_t c = vmlaq_n_f32(vld1q_f32(h + k), vld1q_f32(d + k), a);
+		acc = vmlaq_f32(acc, c, vld1q_f32(x + k));
+	}
+	float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+	return vget_lane_f32(vpadd_f32(sum, sum), 0);
+}
+#endif
+
+template<typename T>
+static inline tComplex<T> DotCpx(const tComplex<T>* x, const T* h, const T* d, T a)
+{
+	tComplex<T> acc;
+	acc.re = 0.0; acc.im = 0.0;
+	for(int k=0; k<CFractResampler<T>::SINC_TAPS; k++)
+	{
+		T c = h[k] + (a * d[k]);
+		acc.re += (x[k].re * c);
+		acc.im += (x[k].im * c);
+	}
+	return acc;
+}
 
+template<typename T>
+static inline T DotReal(const T* x, const T* h, const T* d, T a)
+{
+	T acc = 0.0;
+	for(int k=0; k<CFractResampler<T>::SINC_TAPS; k++)
+		acc += (x[k] * (h[k] + (a * d[k])));
+	return acc;
+}
 
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
-CFractResampler::CFractResampler()
+template<typename T>
+CFractResampler<T>::CFractResampler()
 {
-	m_pSinc = NULL;
+	m_pPhases = NULL;
 	m_pInputBuf = NULL;
 
 }
 
-CFractResampler::~CFractResampler()
+template<typename T>
+CFractResampler<T>::~CFractResampler()
 {
-	if(m_pSinc)
-		delete[] m_pSinc;
+	if(m_pPhases)
+		delete[] m_pPhases;
 	if(m_pInputBuf)
 		delete[] m_pInputBuf;
 }
 
 //////////////////////////////////////////////////////////////////////
-// Initialize resampler memory and create windowed sinc table
+// Initialize resampler memory and create windowed sinc filterbank
 // MaxInputSize is the largest number of input samples expected to be processed
 //////////////////////////////////////////////////////////////////////
-void CFractResampler::Init(int MaxInputSize)
+template<typename T>
+void CFractResampler<T>::Init(int MaxInputSize)
 {
 int i;
-TYPEREAL fi;
-TYPEREAL window;
-	MaxInputSize += SINC_PERIODS;	//expand buffer size  to include wrap around
-	if(NULL == m_pSinc)
-		m_pSinc = new  TYPEREAL[SINC_LENGTH];
-	if(m_pInputBuf)
-		delete[] m_pInputBuf;
-	m_pInputBuf = new TYPECPX[MaxInputSize];
-	for(i=0; i<MaxInputSize; i++)
+int p;
+	MaxInputSize += SINC_TAPS + 1;	//expand buffer size  to include wrap around and padding
+	if(NULL == m_pPhases)
 	{
-		m_pInputBuf[i].re = 0.0;
-		m_pInputBuf[i].im = 0.0;
-	}
-	for(i=0; i<SINC_LENGTH; i++)
-	{	//calc Blackman-Harris window points
-		window = (0.35875
-				- 0.48829*MCOS( (K_2PI*i)/(SINC_LENGTH-1) )
-				+ 0.14128*MCOS( (2.0*K_2PI*i)/(SINC_LENGTH-1) )
-				- 0.01168*MCOS( (3.0*K_2PI*i)/(SINC_LENGTH-1) ) );
-		//calculate sin(x)/x    sinc point * window
-		fi = K_PI*(TYPEREAL)(i - SINC_LENGTH/2)/(TYPEREAL)SINC_PERIOD_PTS ;
-		if(i != SINC_LENGTH/2)
-			m_pSinc[i] = window * (TYPEREAL)MSIN( (TYPEREAL)fi )/(TYPEREAL)fi;
-		else
-			m_pSinc[i] = 1.0;
-
+		m_pPhases = new T[SINC_PHASES * SINC_PHASE_SIZE];
+		//phase p holds the taps for an output p/SINC_PHASES of an input sample period
+		//past the integer time, followed by the deltas to phase p+1
+		for(p=0; p<SINC_PHASES; p++)
+		{
+			T* pPhase = &m_pPhases[p * SINC_PHASE_SIZE];
+			for(i=0; i<SINC_TAPS; i++)
+			{
+				double h0 = Sinc((double)(i + 1) - ((double)p / SINC_PHASES));
+				double h1 = Sinc((double)(i + 1) - ((double)(p + 1) / SINC_PHASES));
+				pPhase[i] = (T)h0;
+				pPhase[SINC_TAPS + i] = (T)(h1 - h0);
+			}
+		}
 	}
+	if(m_pInputBuf)
+		delete[] m_pInputBuf;
+	m_pInputBuf = new tComplex<T>[MaxInputSize];
+	memset(m_pInputBuf, 0, sizeof(tComplex<T>) * MaxInputSize);
 	m_FloatTime = 0.0;		//init floating point time accumulator
 }
 
+//////////////////////////////////////////////////////////////////////
+// Calculates the Blackman-Harris windowed sinc at x input sample periods
+// from the start of the SINC_PERIODS wide window; zero outside of it
+//////////////////////////////////////////////////////////////////////
+template<typename T>
+double CFractResampler<T>::Sinc(double x)
+{
+	if( (x < 0.0) || (x > SINC_PERIODS) )
+		return 0.0;
+	double window = (0.35875
+			- 0.48829*cos( (K_2PI*x)/SINC_PERIODS )
+			+ 0.14128*cos( (2.0*K_2PI*x)/SINC_PERIODS )
+			- 0.01168*cos( (3.0*K_2PI*x)/SINC_PERIODS ) );
+	double fi = K_PI*(x - (SINC_PERIODS/2));
+	if(fi == 0.0)
+		return 1.0;
+	return window * sin(fi)/fi;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Gets the filterbank phase and interpolation fraction for the current
+// output fractional time position
+//////////////////////////////////////////////////////////////////////
+template<typename T>
+inline const T* CFractResampler<T>::GetPhase(int IntegerTime, T& Frac)
+{
+	T pos = (m_FloatTime - (T)IntegerTime) * (T)SINC_PHASES;
+	int p = (int)pos;
+	if(p >= SINC_PHASES)	//guard against rounding up to the next input sample
+		p = SINC_PHASES - 1;
+	Frac = pos - (T)p;
+	return &m_pPhases[p * SINC_PHASE_SIZE];
+}
+
 //////////////////////////////////////////////////////////////////////
 // Resample InLength samples in pInBuf and place into pOutBuf
 // using Rate = input rate / output rate
@@ -125,19 +244,16 @@ TYPEREAL window;
 //  the generated samples, especially if up converting  !!!!!
 // COMPLEX version
 //////////////////////////////////////////////////////////////////////
-int CFractResampler::Resample( int InLength, TYPEREAL Rate, TYPECPX* pInBuf, TYPECPX* pOutBuf)
+template<typename T>
+int CFractResampler<T>::Resample( int InLength, T Rate, tComplex<T>* pInBuf, tComplex<T>* pOutBuf)
 {
-int i;
-int j;
 int IntegerTime = (int)m_FloatTime;	//integer input time accumulator
-TYPEREAL dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
+T dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
 int outsamples = 0;
-TYPECPX acc;
+T frac;
 
 	//copy input samples into buffer starting at position SINC_PERIODS
-	j = SINC_PERIODS;
-	for(i=0; i<InLength; i++)
-		m_pInputBuf[j++] = pInBuf[i];
+	memcpy(&m_pInputBuf[SINC_PERIODS], pInBuf, sizeof(tComplex<T>) * InLength);
 	//now calculate output samples by looping until end of input buffer
 	// is reached.  The output position is incremented in fractional time
 	// of input sample time until all the possible input samples are
@@ -145,25 +261,16 @@ TYPECPX acc;
 	while(IntegerTime < InLength )
 	{	//convolve sinc function with input samples where sinc
 		//function is centered at the output fractional time position
-		acc.re = 0.0; acc.im = 0.0;
-		for(i=1; i<=SINC_PERIODS; i++)
-		{
-			j = IntegerTime + i;	//temp integer time position for convolution loop
-			int sindx =  (int)(( (TYPEREAL)j - m_FloatTime) * (TYPEREAL)SINC_PERIOD_PTS );
-			acc.re += (m_pInputBuf[j].re * m_pSinc[sindx] );
-			acc.im += (m_pInputBuf[j].im * m_pSinc[sindx] );
-		}
-		pOutBuf[outsamples++] = acc;
+		const T* h = GetPhase(IntegerTime, frac);
+		pOutBuf[outsamples++] = DotCpx(&m_pInputBuf[IntegerTime + 1], h, h + SINC_TAPS, frac);
 		m_FloatTime += dt;		//inc floating pt output time step
 		IntegerTime = (int)m_FloatTime;	//truncate to integer
 	}
-	m_FloatTime -= (TYPEREAL)InLength;	//move floating time position back for next call
+	m_FloatTime -= (T)InLength;	//move floating time position back for next call
 										//keeping leftover fraction
 	//need to copy last SINC_PERIODS input samples in buffer to beginning of buffer
-	// for FIR wrap around management. j points to last input sample processed
-	j = InLength;
-	for(i=0; i<SINC_PERIODS; i++)
-		m_pInputBuf[i] = m_pInputBuf[j++];
+	// for FIR wrap around management
+	memmove(m_pInputBuf, &m_pInputBuf[InLength], sizeof(tComplex<T>) * SINC_PERIODS);
 	return outsamples;		//return number of output samples processed
 }
 
@@ -175,21 +282,16 @@ TYPECPX acc;
 //  the generated samples, especially if up converting  !!!!!
 // stereo Integer version
 //////////////////////////////////////////////////////////////////////
-int CFractResampler::Resample( int InLength, TYPEREAL Rate, TYPECPX* pInBuf, TYPESTEREO16* pOutBuf, TYPEREAL gain)
+template<typename T>
+int CFractResampler<T>::Resample( int InLength, T Rate, tComplex<T>* pInBuf, TYPESTEREO16* pOutBuf, T gain)
 {
-int i;
-int j;
 int IntegerTime = (int)m_FloatTime;	//integer input time accumulator
-TYPEREAL dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
+T dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
 int outsamples = 0;
-TYPECPX acc;
+T frac;
 
 	//copy input samples into buffer starting at position SINC_PERIODS
-	j = SINC_PERIODS;
-	for(i=0; i<InLength; i++)
-	{
-		m_pInputBuf[j++] = pInBuf[i];
-	}
+	memcpy(&m_pInputBuf[SINC_PERIODS], pInBuf, sizeof(tComplex<T>) * InLength);
 	//now calculate output samples by looping until end of input buffer
 	// is reached.  The output position is incremented in fractional time
 	// of input sample time until all the possible input samples are
@@ -197,15 +299,9 @@ TYPECPX acc;
 	while(IntegerTime < InLength )
 	{	//convolve sinc function with input samples where sinc
 		//function is centered at the output fractional time position
-		acc.re = 0.0; acc.im = 0.0;
-		for(i=1; i<=SINC_PERIODS; i++)
-		{
-			j = IntegerTime + i;	//temp integer time position for convolution loop
-			int sindx =  (int)(( (TYPEREAL)j - m_FloatTime) * (TYPEREAL)SINC_PERIOD_PTS );
-			acc.re += (m_pInputBuf[j].re * m_pSinc[sindx] );
-			acc.im += (m_pInputBuf[j].im * m_pSinc[sindx] );
-		}
-		TYPECPX tmp;
+		const T* h = GetPhase(IntegerTime, frac);
+		tComplex<T> acc = DotCpx(&m_pInputBuf[IntegerTime + 1], h, h + SINC_TAPS, frac);
+		tComplex<T> tmp;
 		tmp.re = (acc.re * gain);;
 		tmp.im = (acc.im * gain);;
 		if(tmp.re > MAX_SOUNDCARDVAL)
@@ -222,13 +318,11 @@ TYPECPX acc;
 		m_FloatTime += dt;	//inc floating pt output time step
 		IntegerTime = (int)m_FloatTime;	//truncate to integer
 	}
-	m_FloatTime -= (TYPEREAL)InLength;	//move floating time position back for next call
+	m_FloatTime -= (T)InLength;	//move floating time position back for next call
 										//keeping leftover fraction
 	//need to copy last SINC_PERIODS input samples in buffer to beginning of buffer
-	// for FIR wrap around management. j points to last input sample processed
-	j = InLength;
-	for(i=0; i<SINC_PERIODS; i++)
-		m_pInputBuf[i] = m_pInputBuf[j++];
+	// for FIR wrap around management
+	memmove(m_pInputBuf, &m_pInputBuf[InLength], sizeof(tComplex<T>) * SINC_PERIODS);
 	return outsamples;		//return number of output samples processed
 }
 
@@ -238,20 +332,20 @@ TYPECPX acc;
 //   !!!! Make sure pOutBuf from caller is large enough to hold all
 //  the generated samples, especially if up converting  !!!!!
 // REAL version
+// The real versions keep their samples packed at the start of the
+// input buffer, so an instance should only be used for one data type
 //////////////////////////////////////////////////////////////////////
-int CFractResampler::Resample( int InLength, TYPEREAL Rate, TYPEREAL* pInBuf, TYPEREAL* pOutBuf)
+template<typename T>
+int CFractResampler<T>::Resample( int InLength, T Rate, T* pInBuf, T* pOutBuf)
 {
-int i;
-int j;
 int IntegerTime = (int)m_FloatTime;	//integer input time accumulator
-TYPEREAL dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
+T dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
 int outsamples = 0;
-TYPEREAL acc;
+T* pInputBuf = (T*)m_pInputBuf;
+T frac;
 
 	//copy input samples into buffer starting at position SINC_PERIODS
-	j = SINC_PERIODS;
-	for(i=0; i<InLength; i++)
-		m_pInputBuf[j++].re = pInBuf[i];
+	memcpy(&pInputBuf[SINC_PERIODS], pInBuf, sizeof(T) * InLength);
 	//now calculate output samples by looping until end of input buffer
 	// is reached.  The output position is incremented in fractional time
 	// of input sample time until all the possible input samples are
@@ -259,24 +353,16 @@ TYPEREAL acc;
 	while(IntegerTime < InLength )
 	{	//convolve sinc function with input samples where sinc
 		//function is centered at the output fractional time position
-		acc = 0.0;
-		for(i=1; i<=SINC_PERIODS; i++)
-		{
-			j = IntegerTime + i;	//temp integer time position for convolution loop
-			int sindx =  (int)(( (TYPEREAL)j - m_FloatTime) * (TYPEREAL)SINC_PERIOD_PTS );
-			acc += (m_pInputBuf[j].re * m_pSinc[sindx] );
-		}
-		pOutBuf[outsamples++] = acc;
+		const T* h = GetPhase(IntegerTime, frac);
+		pOutBuf[outsamples++] = DotReal(&pInputBuf[IntegerTime + 1], h, h + SINC_TAPS, frac);
 		m_FloatTime += dt;
 		IntegerTime = (int)m_FloatTime;
 	}
-	m_FloatTime -= (TYPEREAL)InLength;	//move floating time position back for next call
+	m_FloatTime -= (T)InLength;	//move floating time position back for next call
 										//keeping leftover fraction
 	//need to copy last SINC_PERIODS input samples in buffer to beginning of buffer
-	// for FIR wrap around management. j points to last input sample processed
-	j = InLength;
-	for(i=0; i<SINC_PERIODS; i++)
-		m_pInputBuf[i].re = m_pInputBuf[j++].re;
+	// for FIR wrap around management
+	memmove(pInputBuf, &pInputBuf[InLength], sizeof(T) * SINC_PERIODS);
 	return outsamples;
 }
 
@@ -287,19 +373,17 @@ TYPEREAL acc;
 //  the generated samples, especially if up converting  !!!!!
 // short Integer version
 //////////////////////////////////////////////////////////////////////
-int CFractResampler::Resample( int InLength, TYPEREAL Rate, TYPEREAL* pInBuf, TYPEMONO16* pOutBuf, TYPEREAL gain)
+template<typename T>
+int CFractResampler<T>::Resample( int InLength, T Rate, T* pInBuf, TYPEMONO16* pOutBuf, T gain)
 {
-int i;
-int j;
 int IntegerTime = (int)m_FloatTime;	//integer input time accumulator
-TYPEREAL dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
+T dt = Rate;	//output delta time as function of input sample time (input rate/output rate)
 int outsamples = 0;
-TYPEREAL acc;
+T* pInputBuf = (T*)m_pInputBuf;
+T frac;
 
 	//copy input samples into buffer starting at position SINC_PERIODS
-	j = SINC_PERIODS;
-	for(i=0; i<InLength; i++)
-		m_pInputBuf[j++].re = pInBuf[i];
+	memcpy(&pInputBuf[SINC_PERIODS], pInBuf, sizeof(T) * InLength);
 	//now calculate output samples by looping until end of input buffer
 	// is reached.  The output position is incremented in fractional time
 	// of input sample time until all the possible input samples are
@@ -307,15 +391,9 @@ TYPEREAL acc;
 	while(IntegerTime < InLength )
 	{	//convolve sinc function with input samples where sinc
 		//function is centered at the output fractional time position
-		acc = 0.0;
-		for(i=1; i<=SINC_PERIODS; i++)
-		{
-			j = IntegerTime + i;	//temp integer time position for convolution loop
-			int sindx =  (int)(( (TYPEREAL)j - m_FloatTime) * (TYPEREAL)SINC_PERIOD_PTS );
-			acc += (m_pInputBuf[j].re * m_pSinc[sindx] );
-		}
-		TYPEREAL tmp;
-		tmp = (acc * gain);;
+		const T* h = GetPhase(IntegerTime, frac);
+		T tmp;
+		tmp = (DotReal(&pInputBuf[IntegerTime + 1], h, h + SINC_TAPS, frac) * gain);
 		if(tmp > MAX_SOUNDCARDVAL)
 			tmp = MAX_SOUNDCARDVAL;
 		if(tmp < -MAX_SOUNDCARDVAL)
@@ -325,12 +403,16 @@ TYPEREAL acc;
 		m_FloatTime += dt;
 		IntegerTime = (int)m_FloatTime;
 	}
-	m_FloatTime -= (TYPEREAL)InLength;	//move floating time position back for next call
+	m_FloatTime -= (T)InLength;	//move floating time position back for next call
 										//keeping leftover fraction
 	//need to copy last SINC_PERIODS input samples in buffer to beginning of buffer
-	// for FIR wrap around management. j points to last input sample processed
-	j = InLength;
-	for(i=0; i<SINC_PERIODS; i++)
-		m_pInputBuf[i].re = m_pInputBuf[j++].re;
+	// for FIR wrap around management
+	memmove(pInputBuf, &pInputBuf[InLength], sizeof(T) * SINC_PERIODS);
 	return outsamples;
 }
+
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types
+//////////////////////////////////////////////////////////////////////
+template class CFractResampler<tSReal>;
+template class CFractResampler<tDReal>;
@@ -2,7 +2,8 @@
 // fractresampler.h: interface for the CFractResampler class.
 //
 //  This class implements a fractional resampler that can be used to
-//convert between different sample rates
+//convert between different sample rates, including arbitrary and
+//slowly varying ratios
 //
 // History:
 //	2010-09-15  Initial creation MSW
@@ -40,26 +41,38 @@
 #define FRACTRESAMPLER_H
 
 #include <mutex>
+#include <type_traits>
 
 #include "datatypes.h"
 
+template<typename T = TYPEREAL>
 class CFractResampler  
 {
 public:
 	CFractResampler();
 	virtual ~CFractResampler();
 
+	//sinc filterbank size; with single precision math assume a lightweight CPU
+	//and dont worry so much about resample quality
+	static constexpr int SINC_PHASES = std::is_same<T, tDReal>::value ? 1024 : 256;	//phases between input samples
+	static constexpr int SINC_PERIODS = std::is_same<T, tDReal>::value ? 28 : 10;	//input sample periods in the sinc
+	static constexpr int SINC_TAPS = (SINC_PERIODS + 3) & ~3;	//taps per phase, padded with zeros to a multiple of 4
+	static constexpr int SINC_PHASE_SIZE = SINC_TAPS * 2;		//coefficients followed by deltas to the next phase
+
 	void Init(int MaxInputSize);
 	//overloaded functions for processing different data types
-	int Resample( int InLength, TYPEREAL Rate, TYPEREAL* pInBuf, TYPEREAL* pOutBuf);
-	int Resample( int InLength, TYPEREAL Rate, TYPECPX* pInBuf, TYPECPX* pOutBuf);
-	int Resample( int InLength, TYPEREAL Rate, TYPEREAL* pInBuf, TYPEMONO16* pOutBuf, TYPEREAL gain);
-	int Resample( int InLength, TYPEREAL Rate, TYPECPX* pInBuf, TYPESTEREO16* pOutBuf, TYPEREAL gain);
+	int Resample( int InLength, T Rate, T* pInBuf, T* pOutBuf);
+	int Resample( int InLength, T Rate, tComplex<T>* pInBuf, tComplex<T>* pOutBuf);
+	int Resample( int InLength, T Rate, T* pInBuf, TYPEMONO16* pOutBuf, T gain);
+	int Resample( int InLength, T Rate, tComplex<T>* pInBuf, TYPESTEREO16* pOutBuf, T gain);
 
 private:
-	TYPEREAL m_FloatTime;	//floating pt output time accumulator
-	TYPEREAL* m_pSinc;	//ptr to sinc table
-	TYPECPX* m_pInputBuf;	//internal working input sample buffer
+	static double Sinc(double x);
+	inline const T* GetPhase(int IntegerTime, T& Frac);
+
+	T m_FloatTime;	//floating pt output time accumulator
+	T* m_pPhases;	//ptr to polyphase sinc filterbank
+	tComplex<T>* m_pInputBuf;	//internal working input sample buffer
 };
 
 #endif // FRACTRESAMPLER_H
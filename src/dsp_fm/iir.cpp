@@ -75,7 +75,8 @@
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct CIir object
 /////////////////////////////////////////////////////////////////////////////////
-CIir::CIir()
+template<typename T>
+CIir<T>::CIir()
 {
 	InitBR( 25000, 1000.0, 100000);
 }
@@ -84,15 +85,16 @@ CIir::CIir()
 //	Iniitalize IIR variables for Low Pass IIR filter.
 // analog prototype == H(s) = 1 / (s^2 + s/Q + 1)
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::InitLP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
+template<typename T>
+void CIir<T>::InitLP( T F0Freq, T FilterQ, T SampleRate)
 {
-	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
-	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
-	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
-	m_B0 = A*( (1.0 - MCOS(w0))/2.0);
-	m_B1 = A*( 1.0 - MCOS(w0));
-	m_B2 = A*( (1.0 - MCOS(w0))/2.0);
-	m_A1 = A*( -2.0*MCOS(w0));
+	T w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
+	T alpha = TSIN<T>(w0)/(2.0*FilterQ);
+	T A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
+	m_B0 = A*( (1.0 - TCOS<T>(w0))/2.0);
+	m_B1 = A*( 1.0 - TCOS<T>(w0));
+	m_B2 = A*( (1.0 - TCOS<T>(w0))/2.0);
+	m_A1 = A*( -2.0*TCOS<T>(w0));
 	m_A2 = A*( 1.0 - alpha);
 
 	m_w1a = 0.0;
@@ -106,15 +108,16 @@ void CIir::InitLP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 //	Iniitalize IIR variables for High Pass IIR filter.
 // analog prototype == H(s) = s^2 / (s^2 + s/Q + 1)
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::InitHP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
+template<typename T>
+void CIir<T>::InitHP( T F0Freq, T FilterQ, T SampleRate)
 {
-	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
-	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
-	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
-	m_B0 = A*( (1.0 + MCOS(w0))/2.0);
-	m_B1 = -A*( 1.0 + MCOS(w0));
-	m_B2 = A*( (1.0 + MCOS(w0))/2.0);
-	m_A1 = A*( -2.0*MCOS(w0));
+	T w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
+	T alpha = TSIN<T>(w0)/(2.0*FilterQ);
+	T A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
+	m_B0 = A*( (1.0 + TCOS<T>(w0))/2.0);
+	m_B1 = -A*( 1.0 + TCOS<T>(w0));
+	m_B2 = A*( (1.0 + TCOS<T>(w0))/2.0);
+	m_A1 = A*( -2.0*TCOS<T>(w0));
 	m_A2 = A*( 1.0 - alpha);
 
 	m_w1a = 0.0;
@@ -127,15 +130,16 @@ void CIir::InitHP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 //	Iniitalize IIR variables for Band Pass IIR filter.
 // analog prototype == H(s) = (s/Q) / (s^2 + s/Q + 1)
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::InitBP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
+template<typename T>
+void CIir<T>::InitBP( T F0Freq, T FilterQ, T SampleRate)
 {
-	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
-	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
-	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
+	T w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
+	T alpha = TSIN<T>(w0)/(2.0*FilterQ);
+	T A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
 	m_B0 = A * alpha;
 	m_B1 = 0.0;
 	m_B2 = A * -alpha;
-	m_A1 = A*( -2.0*MCOS(w0));
+	m_A1 = A*( -2.0*TCOS<T>(w0));
 	m_A2 = A*( 1.0 - alpha);
 
 	m_w1a = 0.0;
@@ -148,15 +152,16 @@ void CIir::InitBP( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 //	Iniitalize IIR variables for Band Reject(Notch) IIR filter.
 // analog prototype == H(s) = (s^2 + 1) / (s^2 + s/Q + 1)
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::InitBR( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
+template<typename T>
+void CIir<T>::InitBR( T F0Freq, T FilterQ, T SampleRate)
 {
-	TYPEREAL w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
-	TYPEREAL alpha = MSIN(w0)/(2.0*FilterQ);
-	TYPEREAL A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
+	T w0 = K_2PI * F0Freq/SampleRate;	//normalized corner frequency
+	T alpha = TSIN<T>(w0)/(2.0*FilterQ);
+	T A = 1.0/(1.0 + alpha);	//scale everything by 1/A0 for direct form 2
 	m_B0 = A*1.0;
-	m_B1 = A*( -2.0*MCOS(w0));
+	m_B1 = A*( -2.0*TCOS<T>(w0));
 	m_B2 = A*1.0;
-	m_A1 = A*( -2.0*MCOS(w0));
+	m_A1 = A*( -2.0*TCOS<T>(w0));
 	m_A2 = A*( 1.0 - alpha);
 
 	m_w1a = 0.0;
@@ -169,11 +174,12 @@ void CIir::InitBR( TYPEREAL F0Freq, TYPEREAL FilterQ, TYPEREAL SampleRate)
 //	Process InLength InBuf[] samples and place in OutBuf[]
 //REAL version
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
+template<typename T>
+void CIir<T>::ProcessFilter(int InLength, T* InBuf, T* OutBuf)
 {
 	for(int i=0; i<InLength; i++)
 	{
-		TYPEREAL w0 = InBuf[i] - m_A1*m_w1a - m_A2*m_w2a;
+		T w0 = InBuf[i] - m_A1*m_w1a - m_A2*m_w2a;
 		OutBuf[i] =m_B0*w0 + m_B1*m_w1a + m_B2*m_w2a;
 		m_w2a = m_w1a;
 		m_w1a = w0;
@@ -184,16 +190,17 @@ void CIir::ProcessFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
 //	Process InLength InBuf[] samples and place in OutBuf[]
 //Complex version
 /////////////////////////////////////////////////////////////////////////////////
-void CIir::ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
+template<typename T>
+void CIir<T>::ProcessFilter(int InLength, tComplex<T>* InBuf, tComplex<T>* OutBuf)
 {
 	for(int i=0; i<InLength; i++)
 	{
-		TYPEREAL w0a = InBuf[i].re - m_A1*m_w1a - m_A2*m_w2a;
+		T w0a = InBuf[i].re - m_A1*m_w1a - m_A2*m_w2a;
 		OutBuf[i].re =m_B0*w0a + m_B1*m_w1a + m_B2*m_w2a;
 		m_w2a = m_w1a;
 		m_w1a = w0a;
 
-		TYPEREAL w0b = InBuf[i].im - m_A1*m_w1b - m_A2*m_w2b;
+		T w0b = InBuf[i].im - m_A1*m_w1b - m_A2*m_w2b;
 		OutBuf[i].im =m_B0*w0b + m_B1*m_w1b + m_B2*m_w2b;
 		m_w2b = m_w1b;
 		m_w1b = w0b;
@@ -201,4 +208,8 @@ void CIir::ProcessFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
 	}
 }
 
-
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types
+//////////////////////////////////////////////////////////////////////
+template class CIir<tSReal>;
+template class CIir<tDReal>;
@@ -43,6 +43,8 @@
 #include "datatypes.h"
 #include "filtercoef.h"
 
+#include <type_traits>
+
 #define FMDEMOD_GAIN 8000.0
 
 #define PILOTPLL_RANGE 20.0	//maximum deviation limit of PLL
@@ -73,7 +75,8 @@
 #define BLOCK_ERROR_LIMIT 5		//number of bad blocks before trying to resync at the bit level
 
 #define HILB_LENGTH 61
-const TYPEREAL HILBLP_H[HILB_LENGTH] =
+template<typename T>
+const T HILBLP_H[HILB_LENGTH] =
 {	//LowPass filter prototype that is shifted and "hilbertized" to get 90 deg phase shift
 	//and convert to baseband complex domain.
 	//kaiser-Bessel alpha 1.4  cutoff 30Khz at sample rate of 250KHz
@@ -96,7 +99,8 @@ const TYPEREAL HILBLP_H[HILB_LENGTH] =
 };
 
 #if 0
-const TYPEREAL HILBLP_H[HILB_LENGTH] = {	//test wideband hilbert
+template<typename T>
+const T HILBLP_H[HILB_LENGTH] = {	//test wideband hilbert
 	0.000639403635f,
    -0.000876414761f,
 	0.000763344477f,
@@ -164,7 +168,8 @@ const TYPEREAL HILBLP_H[HILB_LENGTH] = {	//test wideband hilbert
 /////////////////////////////////////////////////////////////////////////////////
 //	Construct/destruct WFM demod object
 /////////////////////////////////////////////////////////////////////////////////
-CWFmDemod::CWFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
+template<typename T>
+CWFmDemod<T>::CWFmDemod(T samplerate) : m_SampleRate(samplerate)
 {
 	m_pDecBy2A = NULL;
 	m_pDecBy2B = NULL;
@@ -181,7 +186,8 @@ CWFmDemod::CWFmDemod(TYPEREAL samplerate) : m_SampleRate(samplerate)
 	m_BlockErrors = 0;
 }
 
-CWFmDemod::~CWFmDemod()
+template<typename T>
+CWFmDemod<T>::~CWFmDemod()
 {	//destroy resources
 	if(m_pDecBy2A)
 		delete m_pDecBy2A;
@@ -197,7 +203,8 @@ CWFmDemod::~CWFmDemod()
 // Input sample rate should be in the range 200 to 400Ksps
 // The output rate will be between 50KHz and 100KHz
 /////////////////////////////////////////////////////////////////////////////////
-TYPEREAL CWFmDemod::SetSampleRate(TYPEREAL samplerate, bool USver)
+template<typename T>
+T CWFmDemod<T>::SetSampleRate(T samplerate, bool USver)
 {
 	//delete any resources that may still exist
 	if(m_pDecBy2A)
@@ -215,17 +222,17 @@ TYPEREAL CWFmDemod::SetSampleRate(TYPEREAL samplerate, bool USver)
 	// try to get down to close to 50khz
 	if(m_SampleRate>400000)//need dec by 8
 	{
-		m_pDecBy2C = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
+		m_pDecBy2C = new CDecimateBy2<T>(HB47TAP_LENGTH, HB47TAP_H<T>);
 		m_OutRate /= 2.0;
 	}
 	if(m_SampleRate>200000)//need dec by 4
 	{
-		m_pDecBy2B = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
+		m_pDecBy2B = new CDecimateBy2<T>(HB47TAP_LENGTH, HB47TAP_H<T>);
 		m_OutRate /= 2.0;
 	}
 	if(m_SampleRate>100000)//need dec by 2
 	{
-		m_pDecBy2A = new CDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
+		m_pDecBy2A = new CDecimateBy2<T>(HB47TAP_LENGTH, HB47TAP_H<T>);
 		m_OutRate /= 2.0;
 	}
 
@@ -237,7 +244,7 @@ TYPEREAL CWFmDemod::SetSampleRate(TYPEREAL samplerate, bool USver)
 	m_MonoLPFilter.InitLP(75000, 1.0, m_SampleRate);
 
 	//create filters to create baseband complex data from real fmdemoulator output
-	m_HilbertFilter.InitConstFir(HILB_LENGTH, HILBLP_H, m_SampleRate);
+	m_HilbertFilter.InitConstFir(HILB_LENGTH, HILBLP_H<T>, m_SampleRate);
 	m_HilbertFilter.GenerateHBFilter(42000);	//shift +/-30KHz LP filter by 42KHz to make 12 to 72KHz bandpass
 
 	//Create narrow BP filter around 19KHz pilot tone with Q=500
@@ -273,18 +280,18 @@ TYPEREAL CWFmDemod::SetSampleRate(TYPEREAL samplerate, bool USver)
 //		pOutData == pointer to callers real(mono audio) output array
 //	returns number of samples placed in callers output array
 /////////////////////////////////////////////////////////////////////////////////
-int CWFmDemod::ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
+template<typename T>
+int CWFmDemod<T>::ProcessData(int InLength, tComplex<T>* pInData, T* pOutData)
 {
 	m_MonoLPFilter.ProcessFilter(InLength,pInData, pInData);
 
 	for(int i=0; i<InLength; i++)
 	{
 		m_D0 = pInData[i];
-	#ifdef FMDSP_USE_DOUBLE_PRECISION
-		pOutData[i] = FMDEMOD_GAIN*MATAN2( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
-	#else
-		pOutData[i] = FMDEMOD_GAIN*arctan2((m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
-	#endif
+		if(std::is_same<T, tDReal>::value)	//single precision uses the faster atan2 approximation
+			pOutData[i] = FMDEMOD_GAIN*TATAN2<T>( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
+		else
+			pOutData[i] = FMDEMOD_GAIN*arctan2((m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
 		m_D1 = m_D0;
 	}
 	//decimate down close to final audio rate by dividing by 2's
@@ -323,17 +330,17 @@ int CWFmDemod::ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData)
 //		pOutData == pointer to callers complex(stereo audio) output array
 //	returns number of samples placed in callers output array
 /////////////////////////////////////////////////////////////////////////////////
-int CWFmDemod::ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData)
+template<typename T>
+int CWFmDemod<T>::ProcessData(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData)
 {
-TYPEREAL LminusR;
+T LminusR;
 	for(int i=0; i<InLength; i++)
 	{
 		m_D0 = pInData[i];
-	#ifdef FMDSP_USE_DOUBLE_PRECISION
-		m_RawFm[i] = FMDEMOD_GAIN*MATAN2( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
-	#else
-		m_RawFm[i] = FMDEMOD_GAIN*arctan2( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
-	#endif
+		if(std::is_same<T, tDReal>::value)	//single precision uses the faster atan2 approximation
+			m_RawFm[i] = FMDEMOD_GAIN*TATAN2<T>( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
+		else
+			m_RawFm[i] = FMDEMOD_GAIN*arctan2( (m_D1.re*m_D0.im - m_D0.re*m_D1.im), (m_D1.re*m_D0.re + m_D1.im*m_D0.im));
 
 		m_D1 = m_D0;
 	}
@@ -346,10 +353,10 @@ TYPEREAL LminusR;
 	{	//if pilot tone present, do stereo demuxing
 		for(int i=0; i<InLength; i++)
 		{
-			TYPEREAL in = m_RawFm[i];
+			T in = m_RawFm[i];
 			//Left minus Right signal is created by multiplying by 38KHz recovered pilot
 			// scale by 2 since DSB amplitude is half of the Right plus Left signal
-			LminusR = 2.0 * in * MSIN( m_PilotPhase[i]*2.0);
+			LminusR = 2.0 * in * TSIN<T>( m_PilotPhase[i]*2.0);
 			pOutData[i].re = in + LminusR;		//extract left and right signals
 			pOutData[i].im = in - LminusR;
 		}
@@ -384,10 +391,10 @@ TYPEREAL LminusR;
 	//now loop through samples to determine where bit position is and extract binary digital data
 	for(int i=0; i<length; i++)
 	{
-		TYPEREAL Data = m_RdsData[i];
-		TYPEREAL SyncVal = m_RdsMag[i];
+		T Data = m_RdsData[i];
+		T SyncVal = m_RdsMag[i];
 		//the best bit sync position is at the positive peak of the sync sine wave
-		TYPEREAL Slope = SyncVal - m_RdsLastSync;	//current slope
+		T Slope = SyncVal - m_RdsLastSync;	//current slope
 		m_RdsLastSync = SyncVal;
 		//see if at the top of the sine wave
 		if( (Slope<0.0) && (m_RdsLastSyncSlope*Slope)<0.0 )
@@ -434,12 +441,13 @@ TYPEREAL LminusR;
 /////////////////////////////////////////////////////////////////////////////////
 //	Iniitalize variables for FM Pilot PLL
 /////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::InitPilotPll( TYPEREAL SampleRate )
+template<typename T>
+void CWFmDemod<T>::InitPilotPll( T SampleRate )
 {
 	m_PilotNcoPhase = 0.0;
 	m_PilotNcoFreq = -PILOTPLL_FREQ;	//freq offset to bring to baseband
 
-	TYPEREAL norm = K_2PI/SampleRate;	//to normalize Hz to radians
+	T norm = K_2PI/SampleRate;	//to normalize Hz to radians
 
 	//initialize the PLL
 	m_PilotNcoLLimit = (m_PilotNcoFreq-PILOTPLL_RANGE) * norm;		//clamp FM PLL NCO
@@ -447,27 +455,28 @@ void CWFmDemod::InitPilotPll( TYPEREAL SampleRate )
 	m_PilotPllAlpha = 2.0*PILOTPLL_ZETA*PILOTPLL_BW * norm;
 	m_PilotPllBeta = (m_PilotPllAlpha * m_PilotPllAlpha)/(4.0*PILOTPLL_ZETA*PILOTPLL_ZETA);
 	m_PhaseErrorMagAve = 0.0;
-	m_PhaseErrorMagAlpha = (1.0-MEXP(-1.0/(m_SampleRate*LOCK_TIMECONST)) );
+	m_PhaseErrorMagAlpha = (1.0-TEXP<T>(-1.0/(m_SampleRate*LOCK_TIMECONST)) );
 }
 
 /////////////////////////////////////////////////////////////////////////////////
 //	Process IQ wide FM data to lock Pilot PLL
 //returns true if Locked.  Fills m_PilotPhase[] with locked 19KHz NCO phase data
 /////////////////////////////////////////////////////////////////////////////////
-bool CWFmDemod::ProcessPilotPll( int InLength, TYPECPX* pInData )
+template<typename T>
+bool CWFmDemod<T>::ProcessPilotPll( int InLength, tComplex<T>* pInData )
 {
-TYPEREAL Sin;
-TYPEREAL Cos;
-TYPECPX tmp;
+T Sin;
+T Cos;
+tComplex<T> tmp;
 	for(int i=0; i<InLength; i++)	//175 nSec
 	{
-		Sin = MSIN(m_PilotNcoPhase);		//178ns for sin/cos calc
-		Cos = MCOS(m_PilotNcoPhase);
+		Sin = TSIN<T>(m_PilotNcoPhase);		//178ns for sin/cos calc
+		Cos = TCOS<T>(m_PilotNcoPhase);
 		//complex multiply input sample by NCO's  sin and cos
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -arctan2(tmp.im, tmp.re);
+		T phzerror = -arctan2(tmp.im, tmp.re);
 
 		//create new NCO frequency term
 		m_PilotNcoFreq += (m_PilotPllBeta * phzerror);		//  radians per sampletime
@@ -482,7 +491,7 @@ TYPECPX tmp;
 		//create long average of error magnitude for lock detection
 		m_PhaseErrorMagAve = (1.0-m_PhaseErrorMagAlpha)*m_PhaseErrorMagAve + m_PhaseErrorMagAlpha*phzerror*phzerror;
 	}
-	m_PilotNcoPhase = MFMOD(m_PilotNcoPhase, K_2PI);	//keep radian counter bounded
+	m_PilotNcoPhase = TFMOD<T>(m_PilotNcoPhase, K_2PI);	//keep radian counter bounded
 	if(m_PhaseErrorMagAve < LOCK_MAG_THRESHOLD)
         return true;
 	else
@@ -493,7 +502,8 @@ TYPECPX tmp;
 // Get present Stereo lock status and put in pPilotLock.
 // Returns true if lock status has changed since last call.
 /////////////////////////////////////////////////////////////////////////////////
-int CWFmDemod::GetStereoLock(int* pPilotLock)
+template<typename T>
+int CWFmDemod<T>::GetStereoLock(int* pPilotLock)
 {
 	if(pPilotLock)
 		*pPilotLock = m_PilotLocked;
@@ -509,9 +519,10 @@ int CWFmDemod::GetStereoLock(int* pPilotLock)
 /////////////////////////////////////////////////////////////////////////////////
 //	Iniitalize IIR variables for De-emphasis IIR filter.
 /////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::InitDeemphasis( TYPEREAL Time, TYPEREAL SampleRate)	//create De-emphasis LP filter
+template<typename T>
+void CWFmDemod<T>::InitDeemphasis( T Time, T SampleRate)	//create De-emphasis LP filter
 {
-	m_DeemphasisAlpha = (1.0-MEXP(-1.0/(SampleRate*Time)) );
+	m_DeemphasisAlpha = (1.0-TEXP<T>(-1.0/(SampleRate*Time)) );
 	m_DeemphasisAveRe = 0.0;
 	m_DeemphasisAveIm = 0.0;
 }
@@ -520,7 +531,8 @@ void CWFmDemod::InitDeemphasis( TYPEREAL Time, TYPEREAL SampleRate)	//create De-
 //	Process InLength InBuf[] samples and place in OutBuf[]
 //REAL version
 /////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf)
+template<typename T>
+void CWFmDemod<T>::ProcessDeemphasisFilter(int InLength, T* InBuf, T* OutBuf)
 {
 	for(int i=0; i<InLength; i++)
 	{
@@ -533,7 +545,8 @@ void CWFmDemod::ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL*
 //	Process InLength InBuf[] samples and place in OutBuf[]
 //complex (stereo) version
 /////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::ProcessDeemphasisFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf)
+template<typename T>
+void CWFmDemod<T>::ProcessDeemphasisFilter(int InLength, tComplex<T>* InBuf, tComplex<T>* OutBuf)
 {
 	for(int i=0; i<InLength; i++)
 	{
@@ -547,7 +560,8 @@ void CWFmDemod::ProcessDeemphasisFilter(int InLength, TYPECPX* InBuf, TYPECPX* O
 /////////////////////////////////////////////////////////////////////////////////
 //	Initialize variables for RDS PLL and matched filter
 /////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::InitRds( TYPEREAL SampleRate )
+template<typename T>
+void CWFmDemod<T>::InitRds( T SampleRate )
 {
 	m_RdsNcoPhase = 0.0;
 	m_RdsNcoFreq = 0.0;	//freq offset to bring to baseband
@@ -555,7 +569,7 @@ void CWFmDemod::InitRds( TYPEREAL SampleRate )
 	//Create complex LP filter of RDS signal with 2400Hz passband
 	m_RdsBPFilter.InitLPFilter(0, 1.0,40.0, 2400.0,1.3*2400.0, m_RdsOutputRate);
 
-	TYPEREAL norm = K_2PI/SampleRate;	//to normalize Hz to radians
+	T norm = K_2PI/SampleRate;	//to normalize Hz to radians
 	//initialize the PLL that is used to de-rotate the rds DSB signal
 	m_RdsNcoLLimit = (m_RdsNcoFreq-RDSPLL_RANGE) * norm;		//clamp RDS PLL NCO
 	m_RdsNcoHLimit = (m_RdsNcoFreq+RDSPLL_RANGE) * norm;
@@ -567,12 +581,12 @@ void CWFmDemod::InitRds( TYPEREAL SampleRate )
 	m_MatchCoefLength = static_cast<int>(SampleRate / RDS_BITRATE);
 	for(int i= 0; i<=m_MatchCoefLength; i++)
 	{
-		TYPEREAL t = (TYPEREAL)i/(SampleRate);
-		TYPEREAL x = t*RDS_BITRATE;
-		TYPEREAL x64 = 64.0*x;
-		m_RdsMatchCoef[i+m_MatchCoefLength] = .75*MCOS(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
+		T t = (T)i/(SampleRate);
+		T x = t*RDS_BITRATE;
+		T x64 = 64.0*x;
+		m_RdsMatchCoef[i+m_MatchCoefLength] = .75*TCOS<T>(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
 								(1.0/(9.0/x-x64)) );
-		m_RdsMatchCoef[m_MatchCoefLength-i] = -.75*MCOS(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
+		m_RdsMatchCoef[m_MatchCoefLength-i] = -.75*TCOS<T>(2.0*K_2PI*x)*( (1.0/(1.0/x-x64)) -
 								(1.0/(9.0/x-x64)) );
 	}
 	m_MatchCoefLength *= 2;
@@ -599,20 +613,21 @@ void CWFmDemod::InitRds( TYPEREAL SampleRate )
 /////////////////////////////////////////////////////////////////////////////////
 //	Process I/Q RDS baseband stream to lock PLL
 /////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::ProcessRdsPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData )
+template<typename T>
+void CWFmDemod<T>::ProcessRdsPll( int InLength, tComplex<T>* pInData, T* pOutData )
 {
-TYPEREAL Sin;
-TYPEREAL Cos;
-TYPECPX tmp;
+T Sin;
+T Cos;
+tComplex<T> tmp;
 	for(int i=0; i<InLength; i++)
 	{
-		Sin = MSIN(m_RdsNcoPhase);		//178ns for sin/cos calc
-		Cos = MCOS(m_RdsNcoPhase);
+		Sin = TSIN<T>(m_RdsNcoPhase);		//178ns for sin/cos calc
+		Cos = TCOS<T>(m_RdsNcoPhase);
 		//complex multiply input sample by NCO's  sin and cos
 		tmp.re = Cos * pInData[i].re - Sin * pInData[i].im;
 		tmp.im = Cos * pInData[i].im + Sin * pInData[i].re;
 		//find current sample phase after being shifted by NCO frequency
-		TYPEREAL phzerror = -arctan2(tmp.im, tmp.re);
+		T phzerror = -arctan2(tmp.im, tmp.re);
 		//create new NCO frequency term
 		m_RdsNcoFreq += (m_RdsPllBeta * phzerror);		//  radians per sampletime
 		//clamp NCO frequency so doesn't get out of lock range
@@ -624,7 +639,7 @@ TYPECPX tmp;
 		m_RdsNcoPhase += (m_RdsNcoFreq + m_RdsPllAlpha * phzerror);
 		pOutData[i] = tmp.im;
 	}
-	m_RdsNcoPhase = MFMOD(m_RdsNcoPhase, K_2PI);	//keep radian counter bounded
+	m_RdsNcoPhase = TFMOD<T>(m_RdsNcoPhase, K_2PI);	//keep radian counter bounded
 }
 
 
@@ -635,7 +650,8 @@ TYPECPX tmp;
 // each block, recovers good groups of 4 data blocks and places in data queue
 // for further upper level GUI processing depending on the application
 /////////////////////////////////////////////////////////////////////////////////
-void CWFmDemod::ProcessNewRdsBit(int bit)
+template<typename T>
+void CWFmDemod<T>::ProcessNewRdsBit(int bit)
 {
 	m_InBitStream =	(m_InBitStream<<1) | bit;	//shift in new bit
 	switch(m_DecodeState)
@@ -757,7 +773,8 @@ void CWFmDemod::ProcessNewRdsBit(int bit)
 // if UseFec is false then no FEC is done else correct up to 5 bits.
 // Returns zero if no remaining errors if FEC is specified.
 /////////////////////////////////////////////////////////////////////////////////
-quint32 CWFmDemod::CheckBlock(quint32 SyndromeOffset, int UseFec)
+template<typename T>
+quint32 CWFmDemod<T>::CheckBlock(quint32 SyndromeOffset, int UseFec)
 {
 	//First calculate syndrome for current 26 m_InBitStream bits
 	quint32 testblock = (0x3FFFFFF & m_InBitStream);	//isolate bottom 26 bits
@@ -808,7 +825,8 @@ quint32 CWFmDemod::CheckBlock(quint32 SyndromeOffset, int UseFec)
 // Get next group data from RDS data queue.
 // Returns zero if queue is empty or null pointer passed or data has not changed
 /////////////////////////////////////////////////////////////////////////////////
-bool CWFmDemod::GetNextRdsGroupData(tRDS_GROUPS* pGroupData)
+template<typename T>
+bool CWFmDemod<T>::GetNextRdsGroupData(tRDS_GROUPS* pGroupData)
 {
 	if( (m_RdsQHead == m_RdsQTail) || (NULL == pGroupData) )
 	{
@@ -837,17 +855,18 @@ bool CWFmDemod::GetNextRdsGroupData(tRDS_GROUPS* pGroupData)
 // |error| < 0.005
 // Useful for plls but not for main FM demod if best audio quality desired.
 /////////////////////////////////////////////////////////////////////////////////
-inline TYPEREAL CWFmDemod::arctan2(TYPEREAL y, TYPEREAL x)
+template<typename T>
+inline T CWFmDemod<T>::arctan2(T y, T x)
 {
-TYPEREAL angle;
+T angle;
 	if( x == 0.0 )
 	{	//avoid divide by zero and just return angle
 		if( y > 0.0 ) return K_PI2;
 		if( y == 0.0 ) return 0.0;
 		return -K_PI2;
 	}
-	TYPEREAL z = y/x;
-	if( MFABS( z ) < 1.0 )
+	T z = y/x;
+	if( TFABS<T>( z ) < 1.0 )
 	{
 		angle = z/(1.0 + 0.2854*z*z);
 		if( x < 0.0 )
@@ -865,3 +884,9 @@ TYPEREAL angle;
 	}
 	return angle;
 }
+
+//////////////////////////////////////////////////////////////////////
+// Explicit instantiations for the supported sample types
+//////////////////////////////////////////////////////////////////////
+template class CWFmDemod<tSReal>;
+template class CWFmDemod<tDReal>;
@@ -46,88 +46,89 @@
 
 #define RDS_Q_SIZE 100
 
+template<typename T = TYPEREAL>
 class CWFmDemod
 {
 public:
-	CWFmDemod(TYPEREAL samplerate);
+	CWFmDemod(T samplerate);
 	virtual ~CWFmDemod();
 
-	TYPEREAL SetSampleRate(TYPEREAL samplerate, bool USver);
+	T SetSampleRate(T samplerate, bool USver);
 	//overloaded functions for mono and stereo
-	int ProcessData(int InLength, TYPECPX* pInData, TYPECPX* pOutData);
-	int ProcessData(int InLength, TYPECPX* pInData, TYPEREAL* pOutData);
-	TYPEREAL GetDemodRate(){return m_OutRate;}
+	int ProcessData(int InLength, tComplex<T>* pInData, tComplex<T>* pOutData);
+	int ProcessData(int InLength, tComplex<T>* pInData, T* pOutData);
+	T GetDemodRate(){return m_OutRate;}
 
 	bool GetNextRdsGroupData(tRDS_GROUPS* pGroupData);
 	int GetStereoLock(int* pPilotLock);
 
 private:
-	void InitDeemphasis( TYPEREAL Time, TYPEREAL SampleRate);	//create De-emphasis LP filter
-	void ProcessDeemphasisFilter(int InLength, TYPEREAL* InBuf, TYPEREAL* OutBuf);
-	void ProcessDeemphasisFilter(int InLength, TYPECPX* InBuf, TYPECPX* OutBuf);
-	void InitPilotPll( TYPEREAL SampleRate );
-	bool ProcessPilotPll( int InLength, TYPECPX* pInData );
-	void InitRds( TYPEREAL SampleRate );
-	void ProcessRdsPll( int InLength, TYPECPX* pInData, TYPEREAL* pOutData );
-	inline TYPEREAL arctan2(TYPEREAL y, TYPEREAL x);
+	void InitDeemphasis( T Time, T SampleRate);	//create De-emphasis LP filter
+	void ProcessDeemphasisFilter(int InLength, T* InBuf, T* OutBuf);
+	void ProcessDeemphasisFilter(int InLength, tComplex<T>* InBuf, tComplex<T>* OutBuf);
+	void InitPilotPll( T SampleRate );
+	bool ProcessPilotPll( int InLength, tComplex<T>* pInData );
+	void InitRds( T SampleRate );
+	void ProcessRdsPll( int InLength, tComplex<T>* pInData, T* pOutData );
+	inline T arctan2(T y, T x);
 
 	void ProcessNewRdsBit(int bit);
 	quint32 CheckBlock(quint32 BlockOffset, int UseFec);
 
-	TYPEREAL m_SampleRate;
-	TYPEREAL m_OutRate;
-	TYPEREAL m_RawFm[PHZBUF_SIZE];
-	TYPECPX m_CpxRawFm[PHZBUF_SIZE];
-	CDecimateBy2* m_pDecBy2A;
-	CDecimateBy2* m_pDecBy2B;
-	CDecimateBy2* m_pDecBy2C;
+	T m_SampleRate;
+	T m_OutRate;
+	T m_RawFm[PHZBUF_SIZE];
+	tComplex<T> m_CpxRawFm[PHZBUF_SIZE];
+	CDecimateBy2<T>* m_pDecBy2A;
+	CDecimateBy2<T>* m_pDecBy2B;
+	CDecimateBy2<T>* m_pDecBy2C;
 
-	TYPECPX m_D0;		//complex delay line variables
-	TYPECPX m_D1;
+	tComplex<T> m_D0;		//complex delay line variables
+	tComplex<T> m_D1;
 
-	TYPEREAL m_DeemphasisAveRe;
-	TYPEREAL m_DeemphasisAveIm;
-	TYPEREAL m_DeemphasisAlpha;
+	T m_DeemphasisAveRe;
+	T m_DeemphasisAveIm;
+	T m_DeemphasisAlpha;
 
-	CIir m_MonoLPFilter;
-	CFir m_LPFilter;
-	CIir m_NotchFilter;
-	CIir m_PilotBPFilter;
-	CFir m_HilbertFilter;
+	CIir<T> m_MonoLPFilter;
+	CFir<T> m_LPFilter;
+	CIir<T> m_NotchFilter;
+	CIir<T> m_PilotBPFilter;
+	CFir<T> m_HilbertFilter;
 
 	int m_PilotLocked;				//variables for Pilot PLL
 	int m_LastPilotLocked;
-	TYPEREAL m_PilotNcoPhase;
-	TYPEREAL m_PilotNcoFreq;
-	TYPEREAL m_PilotNcoLLimit;
-	TYPEREAL m_PilotNcoHLimit;
-	TYPEREAL m_PilotPllAlpha;
-	TYPEREAL m_PilotPllBeta;
-	TYPEREAL m_PhaseErrorMagAve;
-	TYPEREAL m_PhaseErrorMagAlpha;
-	TYPEREAL m_PilotPhase[PHZBUF_SIZE];
-	TYPEREAL m_PilotPhaseAdjust;
-
-	TYPEREAL m_RdsNcoPhase;		//variables for RDS PLL
-	TYPEREAL m_RdsNcoFreq;
-	TYPEREAL m_RdsNcoLLimit;
-	TYPEREAL m_RdsNcoHLimit;
-	TYPEREAL m_RdsPllAlpha;
-	TYPEREAL m_RdsPllBeta;
-
-	TYPECPX m_RdsRaw[PHZBUF_SIZE];	//variables for RDS processing
-	TYPEREAL m_RdsMag[PHZBUF_SIZE];
-	TYPEREAL m_RdsData[PHZBUF_SIZE];
-	TYPEREAL m_RdsMatchCoef[PHZBUF_SIZE];
-	TYPEREAL m_RdsLastSync;
-	TYPEREAL m_RdsLastSyncSlope;
-	TYPEREAL m_RdsLastData;
+	T m_PilotNcoPhase;
+	T m_PilotNcoFreq;
+	T m_PilotNcoLLimit;
+	T m_PilotNcoHLimit;
+	T m_PilotPllAlpha;
+	T m_PilotPllBeta;
+	T m_PhaseErrorMagAve;
+	T m_PhaseErrorMagAlpha;
+	T m_PilotPhase[PHZBUF_SIZE];
+	T m_PilotPhaseAdjust;
+
+	T m_RdsNcoPhase;		//variables for RDS PLL
+	T m_RdsNcoFreq;
+	T m_RdsNcoLLimit;
+	T m_RdsNcoHLimit;
+	T m_RdsPllAlpha;
+	T m_RdsPllBeta;
+
+	tComplex<T> m_RdsRaw[PHZBUF_SIZE];	//variables for RDS processing
+	T m_RdsMag[PHZBUF_SIZE];
+	T m_RdsData[PHZBUF_SIZE];
+	T m_RdsMatchCoef[PHZBUF_SIZE];
+	T m_RdsLastSync;
+	T m_RdsLastSyncSlope;
+	T m_RdsLastData;
 	int m_MatchCoefLength;
-	CDownConvert m_RdsDownConvert;
-	CFir m_RdsBPFilter;
-	CFir m_RdsMatchedFilter;
-	CIir m_RdsBitSyncFilter;
-	TYPEREAL m_RdsOutputRate;
+	CDownConvert<T> m_RdsDownConvert;
+	CFir<T> m_RdsBPFilter;
+	CFir<T> m_RdsMatchedFilter;
+	CIir<T> m_RdsBitSyncFilter;
+	T m_RdsOutputRate;
 	int m_RdsLastBit;
 	tRDS_GROUPS m_RdsGroupQueue[RDS_Q_SIZE];
 	int m_RdsQHead;
@@ -15,6 +15,7 @@ static void nrsc5_init(nrsc5_t *st)
     st->closed = 0;
     st->mode = NRSC5_MODE_FM;
     st->callback = NULL;
+    st->program_mask = (1u << MAX_PROGRAMS) - 1;
 
     output_init(&st->output, st);
     input_init(&st->input, st, &st->output);
@@ -131,6 +132,11 @@ NRSC5_API void nrsc5_set_callback(nrsc5_t *st, nrsc5_callback_t callback, void *
     st->callback_opaque = opaque;
 }
 
+NRSC5_API void nrsc5_set_program_mask(nrsc5_t *st, unsigned int mask)
+{
+    st->program_mask = mask;
+}
+
 NRSC5_API int nrsc5_pipe_samples_cu8(nrsc5_t *st, uint8_t *samples, unsigned int length)
 {
     input_push_cu8(&st->input, samples, length);
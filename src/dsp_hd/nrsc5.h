@@ -423,6 +423,20 @@ int nrsc5_set_mode(nrsc5_t *, int mode);
  */
 void nrsc5_set_callback(nrsc5_t *st, nrsc5_callback_t callback, void *opaque);
 
+/**
+ * Select the programs to be decoded.
+ *
+ * Audio decoding and ID3/LOT assembly are skipped for any program that is
+ * not selected; HDC packets are still reported for every program.  All
+ * programs are selected by default.
+ *
+ * @param[in] st  pointer to an `nrsc5_t` session object
+ * @param[in] mask  bit mask of the programs to decode, bit 0 is program 0 (HD1)
+ * @return Nothing is returned.
+ *
+ */
+void nrsc5_set_program_mask(nrsc5_t *st, unsigned int mask);
+
 
 /**
  * Push an IQ array of 8-bit unsigned samples into the demodulator.
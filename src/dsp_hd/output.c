@@ -35,6 +35,9 @@ void output_push(output_t *st, uint8_t *pkt, unsigned int len, unsigned int prog
     if (stream_id != 0)
         return; // TODO: Process enhanced stream
 
+    if (!(st->radio->program_mask & (1u << program)))
+        return; // Program is not selected for decoding
+
 #ifdef USE_FAAD2
     void *buffer;
     NeAACDecFrameInfo info;
@@ -463,6 +466,24 @@ static aas_file_t *find_free_lot(aas_port_t *port)
     return file;
 }
 
+static int port_program(output_t *st, aas_port_t *port)
+{
+    // Find the audio program of the service that the port belongs to
+    for (int i = 0; i < MAX_SIG_SERVICES; i++)
+    {
+        sig_service_t *service = &st->services[i];
+        if (service->type != SIG_SERVICE_AUDIO || service->number != port->service_number)
+            continue;
+
+        for (int j = 0; j < MAX_SIG_COMPONENTS; j++)
+        {
+            if (service->component[j].type == SIG_COMPONENT_AUDIO)
+                return service->component[j].audio.port;
+        }
+    }
+    return -1;
+}
+
 static void process_port(output_t *st, uint16_t port_id, uint8_t *buf, unsigned int len)
 {
     static unsigned int counter = 1;
@@ -546,6 +567,10 @@ static void process_port(output_t *st, uint16_t port_id, uint8_t *buf, unsigned
     }
     case AAS_TYPE_LOT:
     {
+        int program = port_program(st, port);
+        if (program >= 0 && program < MAX_PROGRAMS && !(st->radio->program_mask & (1u << program)))
+            return; // Program is not selected for decoding
+
         if (len < 8)
         {
             log_warn("bad fragment (port %04X, len %d)", port_id, len);
@@ -661,7 +686,8 @@ void output_aas_push(output_t *st, uint8_t *buf, unsigned int len)
     if (port == 0x5100 || (port >= 0x5201 && port <= 0x5207))
     {
         // PSD ports
-        output_id3(st, port & 0x7, buf + 4, len - 4);
+        if (st->radio->program_mask & (1u << (port & 0x7)))
+            output_id3(st, port & 0x7, buf + 4, len - 4);
     }
     else if (port == 0x20)
     {
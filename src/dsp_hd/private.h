@@ -15,6 +15,7 @@ struct nrsc5_t
     int closed;
     nrsc5_callback_t callback;
     void *callback_opaque;
+    unsigned int program_mask;
 
     input_t input;
     output_t output;
@@ -20,19 +20,53 @@
 // SOFTWARE.
 //---------------------------------------------------------------------------
 
+// Raw captures are routinely larger than 2 GiB; use 64-bit file offsets on 32-bit platforms
+#ifndef _WINDOWS
+#define _FILE_OFFSET_BITS 64
+#endif
+
 #include "filedevice.h"
 
 #include "exception_control/string_exception.h"
 
+#include <algorithm>
 #include <assert.h>
-#include <chrono>
 #include <limits.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <thread>
 
+#ifdef _WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #pragma warning(push, 4)
 
+// filedevice::EOF_RETRY_INTERVAL_MS (static)
+//
+// Interval at which an asynchronous read at the end of the file is retried
+uint32_t const filedevice::EOF_RETRY_INTERVAL_MS = 100;
+
+// filedevice::SPEED_REALTIME (static)
+//
+// Speed value indicating that the file data should be paced at real-time
+uint32_t const filedevice::SPEED_REALTIME = 1;
+
+// filedevice::SPEED_UNPACED (static)
+//
+// Speed value indicating that the file data should not be paced
+uint32_t const filedevice::SPEED_UNPACED = 0;
+
+// filedevice::VIEW_SIZE (static)
+//
+// Size of the view of the file data that is mapped into memory at a time
+size_t const filedevice::VIEW_SIZE = (64 << 20);
+
 //---------------------------------------------------------------------------
 // filedevice Constructor (private)
 //
@@ -40,8 +74,10 @@
 //
 //	filename	- Target file name
 //	samplerate	- Target file sample rate
+//	speed		- Playback speed multiplier (SPEED_UNPACED for no pacing)
 
-filedevice::filedevice(char const* filename, uint32_t samplerate) : m_samplerate(samplerate)
+filedevice::filedevice(char const* filename, uint32_t samplerate, uint32_t speed)
+  : m_samplerate(samplerate), m_speed(speed)
 {
   if (filename == nullptr)
     throw std::invalid_argument("filename");
@@ -61,10 +97,49 @@ filedevice::filedevice(char const* filename, uint32_t samplerate) : m_samplerate
     throw std::invalid_argument("filename");
 #endif
 
-  // Attempt to open the target file in read-only binary mode
-  m_file = fopen(m_filename.c_str(), "rb");
-  if (m_file == nullptr)
-    throw string_exception(__func__, ": fopen() failed");
+  // Open the target file read-only; only a window of the file is mapped into memory at any
+  // one time so that captures larger than the process address space can be played back
+#ifdef _WINDOWS
+  m_file = CreateFileA(m_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (m_file == INVALID_HANDLE_VALUE)
+    throw string_exception(__func__, ": CreateFile() failed");
+
+  LARGE_INTEGER length = {};
+  if (!GetFileSizeEx(m_file, &length))
+  {
+
+    CloseHandle(m_file);
+    throw string_exception(__func__, ": GetFileSizeEx() failed");
+  }
+
+  m_length = static_cast<uint64_t>(length.QuadPart);
+
+  SYSTEM_INFO sysinfo = {};
+  GetSystemInfo(&sysinfo);
+  m_granularity = static_cast<size_t>(sysinfo.dwAllocationGranularity);
+
+  // If the mapping can't be created the file data is read into a buffer instead
+  if (m_length > 0)
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+#else
+  m_file = open(m_filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (m_file < 0)
+    throw string_exception(__func__, ": open() failed");
+
+  struct stat filestat = {};
+  if (fstat(m_file, &filestat) != 0)
+  {
+
+    close(m_file);
+    throw string_exception(__func__, ": fstat() failed");
+  }
+
+  m_length = static_cast<uint64_t>(filestat.st_size);
+  m_granularity = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+  posix_fadvise(m_file, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 }
 
 //---------------------------------------------------------------------------
@@ -72,9 +147,15 @@ filedevice::filedevice(char const* filename, uint32_t samplerate) : m_samplerate
 
 filedevice::~filedevice()
 {
-  if (m_file)
-    fclose(m_file);
-  m_file = nullptr;
+  unmap_view();
+
+#ifdef _WINDOWS
+  if (m_mapping != nullptr)
+    CloseHandle(m_mapping);
+  CloseHandle(m_file);
+#else
+  close(m_file);
+#endif
 }
 
 //---------------------------------------------------------------------------
@@ -121,7 +202,25 @@ void filedevice::cancel_async(void) const
 
 std::unique_ptr<filedevice> filedevice::create(char const* filename, uint32_t samplerate)
 {
-  return std::unique_ptr<filedevice>(new filedevice(filename, samplerate));
+  return create(filename, samplerate, SPEED_REALTIME);
+}
+
+//---------------------------------------------------------------------------
+// filedevice::create (static)
+//
+// Factory method, creates a new filedevice instance
+//
+// Arguments:
+//
+//	filename	- Target file name
+//	samplerate	- Target file sample rate
+//	speed		- Playback speed multiplier (SPEED_UNPACED for no pacing)
+
+std::unique_ptr<filedevice> filedevice::create(char const* filename,
+                                               uint32_t samplerate,
+                                               uint32_t speed)
+{
+  return std::unique_ptr<filedevice>(new filedevice(filename, samplerate, speed));
 }
 
 //---------------------------------------------------------------------------
@@ -151,6 +250,40 @@ void filedevice::get_valid_gains(std::vector<int>& /*dbs*/) const
 {
 }
 
+//---------------------------------------------------------------------------
+// filedevice::get_statistics
+//
+// Gets the data transfer statistics for the device
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void filedevice::get_statistics(struct device_statistics& stats) const
+{
+  stats.bytes = m_meter.bytes();
+  stats.bytespersecond = m_meter.bytespersecond();
+  stats.stalltime = m_meter.stalltime();
+  stats.longestgap = m_meter.longestgap();
+  stats.transfers = m_meter.transfers();
+  stats.droppedtransfers = m_meter.droppedtransfers();
+  stats.jitter = m_meter.jitter();
+}
+
+//---------------------------------------------------------------------------
+// filedevice::is_unpaced
+//
+// Determines if the device delivers data as fast as it can be consumed
+//
+// Arguments:
+//
+//	NONE
+
+bool filedevice::is_unpaced(void) const
+{
+  return (m_speed == SPEED_UNPACED);
+}
+
 //---------------------------------------------------------------------------
 // filedevice::read
 //
@@ -163,26 +296,17 @@ void filedevice::get_valid_gains(std::vector<int>& /*dbs*/) const
 
 size_t filedevice::read(uint8_t* buffer, size_t count) const
 {
-  assert(m_file != nullptr);
   assert(m_samplerate != 0);
 
-  auto start = std::chrono::steady_clock::now();
-
-  // Synchronously read the requested amount of data from the input file
-  size_t read = fread(buffer, sizeof(uint8_t), count, m_file);
-
+  // Copy the requested amount of data out of the mapped file
+  size_t read = static_cast<size_t>(std::min<uint64_t>(count, m_length - m_position));
   if (read > 0)
   {
 
-    // Determine how long this operation should take to execute to maintain sample rate
-    int duration = static_cast<int>(static_cast<double>(read) / ((m_samplerate * 2) / 1000000.0));
-    auto end = start + std::chrono::microseconds(duration);
+    memcpy(buffer, view(m_position, read), read);
+    m_position += read;
 
-    // Yield until the calculated duration has expired
-    while (std::chrono::steady_clock::now() < end)
-    {
-      std::this_thread::yield();
-    }
+    pace(read); // Maintain the sample rate
   }
 
   return read;
@@ -197,14 +321,18 @@ size_t filedevice::read(uint8_t* buffer, size_t count) const
 //
 //	callback		- Asynchronous read callback function
 //	bufferlength	- Output buffer length in bytes
+//	buffercount		- Number of output buffers (ignored)
 
-void filedevice::read_async(rtldevice::asynccallback const& callback, uint32_t bufferlength) const
+void filedevice::read_async(rtldevice::asynccallback const& callback,
+                            uint32_t bufferlength,
+                            uint32_t /*buffercount*/) const
 {
-  std::unique_ptr<uint8_t[]> buffer(new uint8_t[bufferlength]); // Input data buffer
-
   m_stop = false;
   m_stopped = false;
 
+  // I/Q samples are two bytes each; there is no nominal rate when unpaced
+  m_meter.start(static_cast<uint64_t>(m_samplerate) * 2 * m_speed, 0);
+
   try
   {
 
@@ -212,9 +340,29 @@ void filedevice::read_async(rtldevice::asynccallback const& callback, uint32_t b
     while (m_stop.test(true) == false)
     {
 
-      // Try to read enough data to fill the input buffer
-      size_t cb = read(&buffer[0], bufferlength);
-      callback(&buffer[0], cb);
+      size_t cb = static_cast<size_t>(std::min<uint64_t>(bufferlength, m_length - m_position));
+      if (cb > 0)
+      {
+
+        uint8_t const* buffer = view(m_position, cb);
+        m_position += cb;
+
+        // Ask for the next buffer to be paged in while this one is being paced and processed
+        prefetch(m_position, bufferlength);
+        pace(cb);
+
+        // The callback receives a pointer directly into the mapped view of the file data
+        m_meter.update(cb);
+        callback(buffer, cb);
+      }
+
+      // At the end of the file keep reporting that no data was returned, but don't spin
+      else
+      {
+
+        callback(nullptr, 0);
+        m_stop.wait_until_equals(true, EOF_RETRY_INTERVAL_MS);
+      }
     }
 
     m_stopped = true; // Operation has been stopped
@@ -228,6 +376,79 @@ void filedevice::read_async(rtldevice::asynccallback const& callback, uint32_t b
   }
 }
 
+//---------------------------------------------------------------------------
+// filedevice::pace (private)
+//
+// Waits until the specified number of bytes are due to have been delivered
+//
+// Arguments:
+//
+//	count		- Number of bytes being delivered
+
+void filedevice::pace(size_t count) const
+{
+  if (m_speed == SPEED_UNPACED)
+    return;
+
+  timepoint_t now = std::chrono::steady_clock::now();
+
+  // The pacing is based on the total amount of data delivered against a fixed start time,
+  // which prevents the rounding errors from accumulating across the individual reads
+  if (m_pacebytes == 0)
+    m_pacestart = now;
+  m_pacebytes += count;
+
+  double const bytespersecond = static_cast<double>(m_samplerate) * 2.0 * m_speed;
+  auto const elapsed = std::chrono::microseconds(
+      static_cast<int64_t>((static_cast<double>(m_pacebytes) * 1000000.0) / bytespersecond));
+  timepoint_t const due = m_pacestart + elapsed;
+
+  // If the reader has fallen more than a second behind don't try to catch up with a burst
+  // of data, start pacing again from the current time
+  if (now > (due + std::chrono::seconds(1)))
+  {
+
+    m_pacestart = now;
+    m_pacebytes = 0;
+    return;
+  }
+
+  std::this_thread::sleep_until(due);
+}
+
+//---------------------------------------------------------------------------
+// filedevice::prefetch (private)
+//
+// Advises the operating system that a range of the file will be accessed soon
+//
+// Arguments:
+//
+//	offset		- Offset into the file data
+//	count		- Number of bytes to be accessed
+
+void filedevice::prefetch(uint64_t offset, size_t count) const
+{
+  // Only the part of the range that falls within the current view can be prefetched; the
+  // view is moved forward when the reader gets there
+  if ((m_view == nullptr) || (offset < m_viewoffset) || (offset >= (m_viewoffset + m_viewlength)))
+    return;
+
+  size_t const position = static_cast<size_t>(offset - m_viewoffset);
+  count = std::min(count, m_viewlength - position);
+  if (count == 0)
+    return;
+
+#ifdef _WINDOWS
+  WIN32_MEMORY_RANGE_ENTRY range = {const_cast<uint8_t*>(&m_view[position]), count};
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+  // posix_madvise() requires a page-aligned address
+  size_t const aligned = position - (position % m_granularity);
+  posix_madvise(const_cast<uint8_t*>(&m_view[aligned]), count + (position - aligned),
+                POSIX_MADV_WILLNEED);
+#endif
+}
+
 //---------------------------------------------------------------------------
 // filedevice::set_automatic_gain_control
 //
@@ -310,6 +531,113 @@ void filedevice::set_test_mode(bool /*enable*/) const
 {
 }
 
+//---------------------------------------------------------------------------
+// filedevice::unmap_view (private)
+//
+// Unmaps the current view of the file data
+//
+// Arguments:
+//
+//	NONE
+
+void filedevice::unmap_view(void) const
+{
+  if (m_view == nullptr)
+    return;
+
+#ifdef _WINDOWS
+  UnmapViewOfFile(m_view);
+#else
+  munmap(const_cast<uint8_t*>(m_view), m_viewlength);
+#endif
+
+  m_view = nullptr;
+  m_viewoffset = 0;
+  m_viewlength = 0;
+}
+
+//---------------------------------------------------------------------------
+// filedevice::view (private)
+//
+// Gets a pointer to a range of the file data, moving the mapped view as necessary
+//
+// Arguments:
+//
+//	offset		- Offset into the file data
+//	count		- Number of bytes to be accessed
+
+uint8_t const* filedevice::view(uint64_t offset, size_t count) const
+{
+  assert((offset + count) <= m_length);
+
+  // The range is usually within the current view
+  if ((m_view != nullptr) && (offset >= m_viewoffset) &&
+      ((offset + count) <= (m_viewoffset + m_viewlength)))
+    return &m_view[offset - m_viewoffset];
+
+  unmap_view();
+
+  // The view has to start on an allocation boundary and is never mapped beyond the end of file
+  uint64_t const viewoffset = offset - (offset % m_granularity);
+  size_t const leading = static_cast<size_t>(offset - viewoffset);
+  size_t const viewlength = static_cast<size_t>(
+      std::min<uint64_t>(std::max(VIEW_SIZE, leading + count), m_length - viewoffset));
+
+#ifdef _WINDOWS
+  if (m_mapping != nullptr)
+    m_view = reinterpret_cast<uint8_t const*>(
+        MapViewOfFile(m_mapping, FILE_MAP_READ, static_cast<DWORD>(viewoffset >> 32),
+                      static_cast<DWORD>(viewoffset & 0xFFFFFFFF), viewlength));
+#else
+  void* mapped = mmap(nullptr, viewlength, PROT_READ, MAP_PRIVATE, m_file,
+                      static_cast<off_t>(viewoffset));
+  if (mapped != MAP_FAILED)
+  {
+
+    posix_madvise(mapped, viewlength, POSIX_MADV_SEQUENTIAL);
+    m_view = reinterpret_cast<uint8_t const*>(mapped);
+  }
+#endif
+
+  if (m_view != nullptr)
+  {
+
+    m_viewoffset = viewoffset;
+    m_viewlength = viewlength;
+    return &m_view[leading];
+  }
+
+  // The view couldn't be mapped (file system or address space limitation); fall back to
+  // reading the requested range of the file data into a buffer
+  if (m_buffer.size() < count)
+    m_buffer.resize(count);
+
+  uint8_t* data = m_buffer.data();
+  size_t remaining = count;
+  while (remaining > 0)
+  {
+
+#ifdef _WINDOWS
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+    DWORD read = 0;
+    if (!ReadFile(m_file, data, static_cast<DWORD>(remaining), &read, &overlapped) || (read == 0))
+      throw string_exception(__func__, ": unable to read file ", m_filename.c_str());
+#else
+    ssize_t read = pread(m_file, data, remaining, static_cast<off_t>(offset));
+    if (read <= 0)
+      throw string_exception(__func__, ": unable to read file ", m_filename.c_str());
+#endif
+
+    data += read;
+    offset += static_cast<uint64_t>(read);
+    remaining -= static_cast<size_t>(read);
+  }
+
+  return m_buffer.data();
+}
+
 //---------------------------------------------------------------------------
 
 #pragma warning(pop)
@@ -26,7 +26,9 @@
 
 #include "rtldevice.h"
 #include "utils/scalar_condition.h"
+#include "utils/transfermeter.h"
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -39,7 +41,9 @@
 // Implements a dummy device that reads the I/Q samples from a file.  This is
 // only intended for debugging purposes as there is no control over the
 // parameters like frequency, sample rate, etc; those will have been set at
-// the time when the file was captured
+// the time when the file was captured.  The file is memory-mapped through a
+// sliding view, and the data can be paced at real-time, at a multiple of
+// real-time, or not at all
 
 class filedevice : public rtldevice
 {
@@ -65,6 +69,9 @@ public:
   //
   // Factory method, creates a new filedevice instance
   static std::unique_ptr<filedevice> create(char const* filename, uint32_t samplerate);
+  static std::unique_ptr<filedevice> create(char const* filename,
+                                            uint32_t samplerate,
+                                            uint32_t speed);
 
   // get_device_name
   //
@@ -76,6 +83,16 @@ public:
   // Gets the valid tuner gain values for the device
   void get_valid_gains(std::vector<int>& dbs) const override;
 
+  // get_statistics
+  //
+  // Gets the data transfer statistics for the device
+  void get_statistics(struct device_statistics& stats) const override;
+
+  // is_unpaced
+  //
+  // Determines if the device delivers data as fast as it can be consumed
+  bool is_unpaced(void) const override;
+
   // read
   //
   // Reads data from the device
@@ -84,7 +101,9 @@ public:
   // read_async
   //
   // Asynchronously reads data from the device
-  void read_async(rtldevice::asynccallback const& callback, uint32_t bufferlength) const override;
+  void read_async(rtldevice::asynccallback const& callback,
+                  uint32_t bufferlength,
+                  uint32_t buffercount) const override;
 
   // set_automatic_gain_control
   //
@@ -116,25 +135,105 @@ public:
   // Enables/disables the test mode of the device
   void set_test_mode(bool enable) const override;
 
+  // SPEED_UNPACED
+  //
+  // Speed value indicating that the file data should not be paced
+  static uint32_t const SPEED_UNPACED;
+
+  // SPEED_REALTIME
+  //
+  // Speed value indicating that the file data should be paced at real-time
+  static uint32_t const SPEED_REALTIME;
+
 private:
   filedevice(filedevice const&) = delete;
   filedevice& operator=(filedevice const&) = delete;
 
+  // EOF_RETRY_INTERVAL_MS
+  //
+  // Interval at which an asynchronous read at the end of the file is retried
+  static uint32_t const EOF_RETRY_INTERVAL_MS;
+
+  // VIEW_SIZE
+  //
+  // Size of the view of the file data that is mapped into memory at a time
+  static size_t const VIEW_SIZE;
+
   // Instance Constructor
   //
-  filedevice(char const* filename, uint32_t samplerate);
+  filedevice(char const* filename, uint32_t samplerate, uint32_t speed);
+
+  //-----------------------------------------------------------------------
+  // Private Type Declarations
+
+  // file_t
+  //
+  // File handle type
+#ifdef _WINDOWS
+  using file_t = void*;
+#else
+  using file_t = int;
+#endif
+
+  // timepoint_t
+  //
+  // Defines a point in time based on steady_clock
+  using timepoint_t = std::chrono::time_point<std::chrono::steady_clock>;
+
+  //-----------------------------------------------------------------------
+  // Private Member Functions
+
+  // pace
+  //
+  // Waits until the specified number of bytes are due to have been delivered
+  void pace(size_t count) const;
+
+  // prefetch
+  //
+  // Advises the operating system that a range of the file will be accessed soon
+  void prefetch(uint64_t offset, size_t count) const;
+
+  // unmap_view
+  //
+  // Unmaps the current view of the file data
+  void unmap_view(void) const;
+
+  // view
+  //
+  // Gets a pointer to a range of the file data, moving the mapped view as necessary
+  uint8_t const* view(uint64_t offset, size_t count) const;
 
   //-----------------------------------------------------------------------
   // Member Variables
 
   std::string m_filename; // File name
   uint32_t const m_samplerate; // Sample rate
-  FILE* m_file = nullptr; // File handle
+  uint32_t const m_speed; // Playback speed multiplier
+  file_t m_file; // File handle
+#ifdef _WINDOWS
+  file_t m_mapping = nullptr; // File mapping handle
+#endif
+  uint64_t m_length = 0; // Length of the file data
+  size_t m_granularity = 0; // Alignment of a mapped view offset
+  mutable uint64_t m_position = 0; // Current position in the file data
+
+  // MAPPED VIEW
+  //
+  mutable uint8_t const* m_view = nullptr; // Mapped view of the file data
+  mutable uint64_t m_viewoffset = 0; // Offset of the mapped view
+  mutable size_t m_viewlength = 0; // Length of the mapped view
+  mutable std::vector<uint8_t> m_buffer; // Data read when a view can't be mapped
+
+  // PACING
+  //
+  mutable timepoint_t m_pacestart; // Pacing start time
+  mutable uint64_t m_pacebytes = 0; // Bytes delivered since pacing start
 
   // ASYNCHRONOUS SUPPORT
   //
   mutable scalar_condition<bool> m_stop{false}; // Flag to stop async
   mutable scalar_condition<bool> m_stopped{true}; // Async stopped condition
+  mutable transfermeter m_meter; // Data transfer meter
 };
 
 //-----------------------------------------------------------------------------
@@ -24,6 +24,7 @@
 
 #include "exception_control/string_exception.h"
 #include "utils/align.h"
+#include "utils/clockrecovery.h"
 #include "utils/value_size_defines.h"
 
 #include <algorithm>
@@ -32,10 +33,29 @@
 
 #pragma warning(push, 4)
 
-// fmstream::MAX_SAMPLE_QUEUE
+// fmstream::AUDIO_QUEUE_CAPACITY
 //
-// Maximum number of queued sample sets from the device
-size_t const fmstream::MAX_SAMPLE_QUEUE = 200; // ~2sec
+// Number of demodulated audio blocks that can be queued for the resampler; the output
+// latency is held in the packet queue, this only has to absorb scheduling jitter
+size_t const fmstream::AUDIO_QUEUE_CAPACITY = 10; // ~.1sec of demodulated audio
+
+// fmstream::MIN_DECIMATED_RATE
+//
+// Minimum effective sample rate after front-end decimation; the +/- 100KHz channel is tuned
+// (rate / 4) from the center and must stay inside the +/- (0.36 * rate) decimator passband
+uint32_t const fmstream::MIN_DECIMATED_RATE = 1000000; // 1MHz
+
+// fmstream::SAMPLE_BLOCK_DURATION
+//
+// Approximate duration of a block of samples or a demux packet, in milliseconds
+uint32_t const fmstream::SAMPLE_BLOCK_DURATION = 10; // Demodulator processes ~.01sec per block
+
+// fmstream::SAMPLE_QUEUE_CAPACITY
+//
+// Number of converted I/Q sample blocks that can be queued for the demodulator; the output
+// latency is held in the packet queue, this only has to absorb scheduling jitter and a few
+// multiple block device transfers arriving back to back
+size_t const fmstream::SAMPLE_QUEUE_CAPACITY = 20; // ~.2sec of I/Q samples
 
 // fmstream::STREAM_ID_AUDIO
 //
@@ -62,11 +82,19 @@ fmstream::fmstream(std::unique_ptr<rtldevice> device,
                    struct channelprops const& channelprops,
                    struct fmprops const& fmprops)
   : m_device(std::move(device)),
+    m_buffercount(tunerprops.buffercount),
+    m_bufferlength(tunerprops.bufferlength),
     m_decoderds(fmprops.decoderds),
     m_rdsdecoder(fmprops.isnorthamerica),
     m_muxname(generate_mux_name(channelprops)),
     m_pcmsamplerate(fmprops.outputrate),
-    m_pcmgain(MPOW(10.0, (fmprops.outputgain / 10.0)))
+    m_pcmgain(MPOW(10.0, (fmprops.outputgain / 10.0))),
+    m_freerun((fmprops.freerun) || (m_device->is_unpaced())),
+    m_latency(fmprops.outputlatency, fmprops.adaptivelatency, m_freerun),
+    m_queue(SAMPLE_QUEUE_CAPACITY),
+    m_audioqueue(AUDIO_QUEUE_CAPACITY),
+    m_packetpool((m_latency.limit() / SAMPLE_BLOCK_DURATION) + 2, 0),
+    m_packetqueue(m_latency.limit() / SAMPLE_BLOCK_DURATION)
 {
   // The sample rate must be within 900001Hz - 3200000Hz
   if ((fmprops.samplerate < 900001) || (fmprops.samplerate > 3200000))
@@ -81,6 +109,27 @@ fmstream::fmstream(std::unique_ptr<rtldevice> device,
   // Initialize the RTL-SDR device instance
   m_device->set_frequency_correction(tunerprops.freqcorrection + channelprops.freqcorrection);
   uint32_t samplerate = m_device->set_sample_rate(fmprops.samplerate);
+
+  // If front-end decimation is enabled, select the largest power of two decimation factor
+  // that keeps the effective sample rate at or above the minimum required by the demodulator
+  if (fmprops.decimate)
+  {
+
+    uint32_t factor = 1;
+    while ((factor < iqdecimator::MAX_FACTOR) &&
+           ((samplerate / (factor * 2)) >= MIN_DECIMATED_RATE))
+      factor *= 2;
+
+    if (factor > 1)
+    {
+
+      m_decimator = std::unique_ptr<iqdecimator>(new iqdecimator(factor));
+      samplerate /= factor;
+    }
+  }
+
+  // The DC offset applied to the center frequency is based on the effective sample rate so
+  // the channel falls within the passband of the front-end decimator, if one is present
   uint32_t frequency =
       m_device->set_center_frequency(channelprops.frequency + (samplerate / 4)); // DC offset
 
@@ -94,21 +143,38 @@ fmstream::fmstream(std::unique_ptr<rtldevice> device,
   demodinfo.WfmDownsampleQuality = static_cast<enum DownsampleQuality>(fmprops.downsamplequality);
 
   // Initialize the wideband FM demodulator
-  m_demodulator = std::unique_ptr<CDemodulator>(new CDemodulator());
+  m_demodulator = std::unique_ptr<CDemodulator<>>(new CDemodulator<>());
   m_demodulator->SetUSFmVersion(fmprops.isnorthamerica);
   m_demodulator->SetInputSampleRate(static_cast<TYPEREAL>(samplerate));
   m_demodulator->SetDemod(DEMOD_WFM, demodinfo);
   m_demodulator->SetDemodFreq(static_cast<TYPEREAL>(frequency - channelprops.frequency));
 
   // Initialize the output resampler
-  m_resampler = std::unique_ptr<CFractResampler>(new CFractResampler());
+  m_resampler = std::unique_ptr<CFractResampler<>>(new CFractResampler<>());
   m_resampler->Init(m_demodulator->GetInputBufferLimit());
 
+  // Allocate the pool of converted I/Q sample blocks; the blocks are demodulated in place and
+  // passed on to the resampler, so both queues can be filled with blocks with one more being
+  // filled by the device, one more being demodulated and one more being resampled
+  m_samplepool = std::unique_ptr<samplepool<TYPECPX>>(
+      new samplepool<TYPECPX>(m_queue.capacity() + m_audioqueue.capacity() + 3,
+                              m_demodulator->GetInputBufferLimit()));
+
   // Adjust the device gain as specified by the channel properties
   m_device->set_automatic_gain_control(channelprops.autogain);
   if (channelprops.autogain == false)
     m_device->set_gain(channelprops.manualgain);
 
+  // Create a worker thread on which to resample the demodulated audio into demux packets
+  scalar_condition<bool> resamplestarted{false};
+  m_resampleworker = std::thread(&fmstream::resample, this, std::ref(resamplestarted));
+  resamplestarted.wait_until_equals(true);
+
+  // Create a worker thread on which to demodulate the samples
+  scalar_condition<bool> demodstarted{false};
+  m_demodworker = std::thread(&fmstream::demodulate, this, std::ref(demodstarted));
+  demodstarted.wait_until_equals(true);
+
   // Create a worker thread on which to perform the transfer operations
   scalar_condition<bool> started{false};
   m_worker = std::thread(&fmstream::transfer, this, std::ref(started));
@@ -123,6 +189,20 @@ fmstream::~fmstream()
   close();
 }
 
+//---------------------------------------------------------------------------
+// fmstream::canpause
+//
+// Gets a flag indicating if the stream allows pause operations
+//
+// Arguments:
+//
+//	NONE
+
+bool fmstream::canpause(void) const
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // fmstream::canseek
 //
@@ -149,10 +229,26 @@ bool fmstream::canseek(void) const
 void fmstream::close(void)
 {
   m_stop = true; // Signal worker thread to stop
+  m_queue.notify(); // Unblock a transfer waiting for queue space
   if (m_device)
     m_device->cancel_async(); // Cancel any async read operations
   if (m_worker.joinable())
     m_worker.join(); // Wait for thread
+
+  // The demodulator thread stops once the transfer thread has stopped
+  m_stopped.store(true);
+  m_queue.notify();
+  m_audioqueue.notify();
+  if (m_demodworker.joinable())
+    m_demodworker.join(); // Wait for thread
+
+  // The resampler thread stops once the demodulator thread has stopped
+  m_demodstopped.store(true);
+  m_audioqueue.notify();
+  m_packetqueue.notify();
+  if (m_resampleworker.joinable())
+    m_resampleworker.join(); // Wait for thread
+
   m_device.reset(); // Release RTL-SDR device
 }
 
@@ -177,6 +273,91 @@ std::unique_ptr<fmstream> fmstream::create(std::unique_ptr<rtldevice> device,
       new fmstream(std::move(device), tunerprops, channelprops, fmprops));
 }
 
+//---------------------------------------------------------------------------
+// fmstream::demodulate (private)
+//
+// Worker thread procedure used to demodulate the samples
+//
+// Arguments:
+//
+//	started		- Condition variable to set when thread has started
+
+void fmstream::demodulate(scalar_condition<bool>& started)
+{
+  assert(m_demodulator);
+
+  bool resync = false; // Flag indicating that a resync block is pending
+  bool const unpaced = m_device->is_unpaced(); // Flag to wait for the resampler
+
+  started = true;
+
+  try
+  {
+    while (true)
+    {
+
+      // Wait for there to be a packet of samples available for processing; any samples
+      // still in the queue after the transfer thread has stopped are discarded
+      m_queue.wait([&]() -> bool { return m_stopped.load() == true; });
+      if (m_stopped.load() == true)
+        break;
+
+      sample_queue_item_t samples;
+      if (!m_queue.try_pop(samples))
+        continue;
+
+      int audiopackets = 0; // Number of demodulated audio samples
+
+      // If the packet of samples is null, the writer has indicated there was a problem;
+      // the null block is passed along so the resampler queues a STREAMCHANGE packet
+      if (samples)
+      {
+
+        // Process the I/Q data, the original samples buffer can be reused as it's processed
+        audiopackets = m_demodulator->ProcessData(m_demodulator->GetInputBufferLimit(),
+                                                  samples.get(), samples.get());
+
+        // Process any RDS group data that was collected during demodulation
+        tRDS_GROUPS rdsgroup = {};
+        while (m_demodulator->GetNextRdsGroupData(&rdsgroup))
+        {
+
+          std::unique_lock<std::mutex> rdslock(m_rdslock);
+          m_rdsdecoder.decode_rdsgroup(rdsgroup);
+        }
+      }
+
+      // An unpaced device delivers data as fast as it can be processed; instead of dropping
+      // audio when the queue is full, wait for the resampler to make room
+      if (unpaced)
+        m_audioqueue.wait_for_space(
+            [&]() -> bool
+            { return (m_stopped.load() == true) || (m_resamplestopped.load() == true); });
+
+      // If audio was previously dropped, a resync block (empty) has to be queued ahead
+      // of any new audio so the resampler knows that the input is discontinuous
+      if (resync)
+        resync = !m_audioqueue.push(audio_block_t{});
+
+      // Push the demodulated audio into the queue for resampling.  If there is insufficient
+      // space left in the queue, the audio isn't being resampled quickly enough to keep up;
+      // the audio is dropped, counted as an overrun, and a resync will be queued next time
+      if ((resync) || (!m_audioqueue.push(audio_block_t{std::move(samples), audiopackets})))
+        resync = true;
+    }
+  }
+
+  catch (...)
+  {
+    m_demod_exception = std::current_exception();
+  }
+
+  m_demodstopped.store(true); // Thread is stopped
+  m_audioqueue.notify(); // Unblock any waiters
+  m_packetqueue.notify(); // Unblock a resampler waiting for queue space
+  m_queue.notify(); // Unblock a transfer waiting for queue space
+}
+
 //---------------------------------------------------------------------------
 // fmstream::demuxabort
 //
@@ -214,9 +395,13 @@ void fmstream::demuxflush(void)
 
 DEMUX_PACKET* fmstream::demuxread(std::function<DEMUX_PACKET*(int)> const& allocator)
 {
-  // If there is an RDS UECP packet available, handle it before demodulating more audio
+  // If there is an RDS UECP packet available, handle it before returning more audio
   uecp_data_packet uecp_packet;
-  if (m_rdsdecoder.pop_uecp_data_packet(uecp_packet) && (!uecp_packet.empty()))
+  std::unique_lock<std::mutex> rdslock(m_rdslock);
+  bool haveuecp = m_rdsdecoder.pop_uecp_data_packet(uecp_packet);
+  rdslock.unlock();
+
+  if (haveuecp && (!uecp_packet.empty()))
   {
 
     // The user may have opted to disable RDS.  The packet from the decoder still
@@ -239,72 +424,55 @@ DEMUX_PACKET* fmstream::demuxread(std::function<DEMUX_PACKET*(int)> const& alloc
     }
   }
 
-  // Wait for there to be a packet of samples available for processing
-  std::unique_lock<std::mutex> lock(m_queuelock);
-  m_cv.wait(lock, [&]() -> bool { return ((m_queue.size() > 0) || m_stopped.load() == true); });
+  // Wait up to 50ms for there to be a demodulated packet available
+  m_packetqueue.wait_for(50, [&]() -> bool { return m_resamplestopped.load() == true; });
 
-  // If the worker thread was stopped, check for and re-throw any exception that occurred,
-  // otherwise assume it was stopped normally and return an empty demultiplexer packet
-  if (m_stopped.load() == true)
+  // If the resampler thread was stopped, check for and re-throw any exception that
+  // occurred, otherwise assume it was stopped normally and return an empty packet
+  if (m_resamplestopped.load() == true)
   {
 
-    if (m_worker_exception)
+    if (m_resample_exception)
+      std::rethrow_exception(m_resample_exception);
+    else if (m_demod_exception)
+      std::rethrow_exception(m_demod_exception);
+    else if (m_worker_exception)
       std::rethrow_exception(m_worker_exception);
     else
       return allocator(0);
   }
 
-  // Pop off the topmost packet of samples from the queue<> and release the lock
-  std::unique_ptr<TYPECPX[]> samples(std::move(m_queue.front()));
-  m_queue.pop();
-  lock.unlock();
-
-  // If the packet of samples is null, the writer has indicated there was a problem
-  if (!samples)
+  // Hold back the output while the packet queue fills up to the target latency; wait for
+  // roughly another packet to be queued before returning an empty demultiplexer packet
+  size_t const queued = m_packetqueue.size();
+  if (m_latency.buffering(queued > 0, static_cast<double>(queued * SAMPLE_BLOCK_DURATION)))
   {
 
-    m_dts = STREAM_TIME_BASE; // Reset the current decode time stamp
-
-    // Create a STREAMCHANGE packet that has no data
-    DEMUX_PACKET* packet = allocator(0);
-    if (packet)
-      packet->iStreamId = DEMUX_SPECIALID_STREAMCHANGE;
-
-    return packet; // Return the generated packet
+    if (queued > 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(SAMPLE_BLOCK_DURATION));
+    return allocator(0);
   }
 
-  // Process the I/Q data, the original samples buffer can be reused/overwritten as it's processed
-  int audiopackets = m_demodulator->ProcessData(m_demodulator->GetInputBufferLimit(), samples.get(),
-                                                samples.get());
-
-  // Process any RDS group data that was collected during demodulation
-  tRDS_GROUPS rdsgroup = {};
-  while (m_demodulator->GetNextRdsGroupData(&rdsgroup))
-    m_rdsdecoder.decode_rdsgroup(rdsgroup);
-
-  // Determine the size of the demultiplexer packet data and allocate it
-  int packetsize = audiopackets * sizeof(TYPESTEREO16);
-  DEMUX_PACKET* packet = allocator(packetsize);
-  if (packet == nullptr)
-    return nullptr;
-
-  // Resample the audio data directly into the allocated packet buffer
-  audiopackets = m_resampler->Resample(
-      audiopackets, (m_demodulator->GetOutputRate() / m_pcmsamplerate), samples.get(),
-      reinterpret_cast<TYPESTEREO16*>(packet->pData), m_pcmgain);
-
-  // Calculate the proper duration for the packet
-  double duration = (audiopackets / static_cast<double>(m_pcmsamplerate)) * STREAM_TIME_BASE;
+  // Pop off the topmost demodulated packet from the queue
+  packet_queue_item_t item;
+  if (!m_packetqueue.try_pop(item))
+    return allocator(0);
 
-  // Set up the demultiplexer packet with the proper size, duration and dts
-  packet->iStreamId = STREAM_ID_AUDIO;
-  packet->iSize = audiopackets * sizeof(TYPESTEREO16);
-  packet->duration = duration;
-  packet->dts = packet->pts = m_dts;
+  // Allocate and initialize the DEMUX_PACKET
+  DEMUX_PACKET* packet = allocator(item->size);
+  if (packet != nullptr)
+  {
 
-  // Increment the decode time stamp value based on the calculated duration
-  m_dts += duration;
+    packet->iStreamId = item->streamid;
+    packet->iSize = item->size;
+    packet->duration = item->duration;
+    packet->dts = item->dts;
+    packet->pts = item->pts;
+    if (item->size > 0)
+      memcpy(packet->pData, item->data.get(), item->size);
+  }
 
+  m_packetpool.release(std::move(item));
   return packet;
 }
 
@@ -335,6 +503,20 @@ std::string fmstream::devicename(void) const
   return std::string(m_device->get_device_name());
 }
 
+//---------------------------------------------------------------------------
+// fmstream::devicestatistics
+//
+// Gets the data transfer statistics for the device associated with the stream
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void fmstream::devicestatistics(struct rtldevice::device_statistics& stats) const
+{
+  m_device->get_statistics(stats);
+}
+
 //---------------------------------------------------------------------------
 // fmstream::enumproperties
 //
@@ -411,10 +593,26 @@ long long fmstream::length(void) const
 
 std::string fmstream::muxname(void) const
 {
+  std::unique_lock<std::mutex> lock(m_rdslock);
+
   // If the callsign for the station is known, use that with an -FM suffix, otherwise use the default
   return (m_rdsdecoder.has_rbds_callsign()) ? m_rdsdecoder.get_rbds_callsign() : m_muxname;
 }
 
+//---------------------------------------------------------------------------
+// fmstream::overruns
+//
+// Gets the number of times that data was dropped because the stream fell behind
+//
+// Arguments:
+//
+//	NONE
+
+uint64_t fmstream::overruns(void) const
+{
+  return m_queue.overruns() + m_audioqueue.overruns() + m_packetqueue.overruns();
+}
+
 //---------------------------------------------------------------------------
 // fmstream::position
 //
@@ -458,6 +656,138 @@ bool fmstream::realtime(void) const
   return true;
 }
 
+//---------------------------------------------------------------------------
+// fmstream::resample (private)
+//
+// Worker thread procedure used to resample and packetize the demodulated audio
+//
+// Arguments:
+//
+//	started		- Condition variable to set when thread has started
+
+void fmstream::resample(scalar_condition<bool>& started)
+{
+  assert(m_demodulator);
+  assert(m_resampler);
+
+  double dts = STREAM_TIME_BASE; // Current decode time stamp
+  bool resync = false; // Flag indicating that a resync packet is pending
+  bool const unpaced = m_device->is_unpaced(); // Flag to wait for the reader
+
+  // The output resampling rate is continuously trimmed to hold the packet queue at the target
+  // latency, compensating for the difference between the device and consumer clocks
+  clockrecovery clock(m_latency.target() / static_cast<double>(SAMPLE_BLOCK_DURATION), m_freerun);
+
+  // wait_for_space (local)
+  //
+  // An unpaced device delivers data as fast as it can be processed; instead of dropping
+  // packets when the output queue is full, wait for the demux reader to make room
+  auto wait_for_space = [&]() -> void
+  {
+    if (unpaced)
+      m_packetqueue.wait_for_space([&]() -> bool { return m_demodstopped.load() == true; });
+  };
+
+  // queue_packet (local)
+  //
+  // Stamps and pushes a finished packet into the output queue; if the queue is full the
+  // packet is dropped and counted as an overrun, and a resync will be queued next time
+  auto queue_packet = [&](packet_queue_item_t&& packet) -> void
+  {
+    // If packets were previously dropped, a STREAMCHANGE packet has to be queued ahead of
+    // any new packets and the decode time stamp starts over
+    if (resync)
+    {
+
+      wait_for_space();
+      packet_queue_item_t streamchange = m_packetpool.acquire(0);
+      streamchange->streamid = DEMUX_SPECIALID_STREAMCHANGE;
+      if (m_packetqueue.push(std::move(streamchange)))
+      {
+
+        dts = STREAM_TIME_BASE;
+        resync = false;
+        clock.reset();
+      }
+      else
+        m_packetpool.release(std::move(streamchange));
+    }
+
+    double const duration = packet->duration;
+    packet->dts = packet->pts = dts;
+
+    wait_for_space();
+    if ((resync) || (!m_packetqueue.push(std::move(packet))))
+    {
+
+      m_packetpool.release(std::move(packet));
+      resync = true;
+    }
+    else
+      dts += duration;
+  };
+
+  started = true;
+
+  try
+  {
+    while (true)
+    {
+
+      // Wait for there to be a block of demodulated audio available for processing; any audio
+      // still in the queue after the demodulator thread has stopped is discarded
+      m_audioqueue.wait([&]() -> bool { return m_demodstopped.load() == true; });
+      if (m_demodstopped.load() == true)
+        break;
+
+      audio_block_t audio;
+      if (!m_audioqueue.try_pop(audio))
+        continue;
+
+      // If the block of audio is null, the demodulator has indicated there was a problem;
+      // queue a STREAMCHANGE packet ahead of the next resampled packet
+      if (!audio.samples)
+      {
+
+        resync = true;
+        continue;
+      }
+
+      // Apply the current clock correction to the nominal resampling rate; the target
+      // latency can change while the stream is running
+      clock.target(m_latency.target() / static_cast<double>(SAMPLE_BLOCK_DURATION));
+      TYPEREAL const rate = (m_demodulator->GetOutputRate() / m_pcmsamplerate) *
+                            static_cast<TYPEREAL>(clock.update(m_packetqueue.size()));
+      int const maxaudiopackets = static_cast<int>(audio.count / rate) + 2;
+
+      // Resample the audio data directly into a pooled demux packet buffer
+      packet_queue_item_t packet = m_packetpool.acquire(maxaudiopackets * sizeof(TYPESTEREO16));
+      int const audiopackets =
+          m_resampler->Resample(audio.count, rate, audio.samples.get(),
+                                reinterpret_cast<TYPESTEREO16*>(packet->data.get()), m_pcmgain);
+
+      // The samples are no longer needed; return them to the pool as soon as possible
+      audio.samples.reset();
+
+      // Set up the demultiplexer packet with the proper size and duration
+      packet->streamid = STREAM_ID_AUDIO;
+      packet->size = static_cast<int>(audiopackets * sizeof(TYPESTEREO16));
+      packet->duration = (audiopackets / static_cast<double>(m_pcmsamplerate)) * STREAM_TIME_BASE;
+
+      queue_packet(std::move(packet));
+    }
+  }
+
+  catch (...)
+  {
+    m_resample_exception = std::current_exception();
+  }
+
+  m_resamplestopped.store(true); // Thread is stopped
+  m_packetqueue.notify(); // Unblock any waiters
+  m_audioqueue.notify(); // Unblock a demodulator waiting for queue space
+}
+
 //---------------------------------------------------------------------------
 // fmstream::seek
 //
@@ -473,6 +803,22 @@ long long fmstream::seek(long long /*position*/, int /*whence*/)
   return -1;
 }
 
+//---------------------------------------------------------------------------
+// fmstream::seektime
+//
+// Sets the stream pointer to a specific time
+//
+// Arguments:
+//
+//	time		- Time to seek to, in milliseconds
+//	backwards	- Flag indicating a backwards seek
+//	startpts	- On success, receives the PTS of the first packet after the seek
+
+bool fmstream::seektime(double /*time*/, bool /*backwards*/, double& /*startpts*/)
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // fmstream::servicename
 //
@@ -510,6 +856,20 @@ void fmstream::signalquality(int& quality, int& snr) const
   snr = std::max(0, std::min(100, static_cast<int>(100.0 * (demodsnr / 0.60))));
 }
 
+//---------------------------------------------------------------------------
+// fmstream::streamtimes
+//
+// Gets the time shift boundaries of the stream
+//
+// Arguments:
+//
+//	times		- Structure to receive the stream times
+
+bool fmstream::streamtimes(struct streamtimes& /*times*/) const
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // fmstream::transfer (private)
 //
@@ -524,56 +884,69 @@ void fmstream::transfer(scalar_condition<bool>& started)
   assert(m_demodulator);
   assert(m_device);
 
-  // The I/Q samples from the device come in as a pair of 8 bit unsigned integers
-  size_t const readsize = m_demodulator->GetInputBufferLimit() * 2;
+  // The I/Q samples from the device come in as a pair of 8 bit unsigned integers; if the
+  // front-end decimator is active each demodulator block requires proportionally more of them
+  size_t const factor = (m_decimator) ? m_decimator->factor() : 1;
+  size_t const blocksize = m_demodulator->GetInputBufferLimit() * 2 * factor;
+
+  // The tuner properties can request longer device transfers; these are rounded down to a
+  // whole number of demodulator blocks, and never less than one block, and split up below
+  size_t const readsize = std::max(m_bufferlength / blocksize, static_cast<size_t>(1)) * blocksize;
+
+  bool resync = false; // Flag indicating that a resync packet is pending
+  bool const unpaced = m_device->is_unpaced(); // Flag to wait for the demodulator
 
   // read_callback_func (local)
   //
   // Asynchronous read callback function for the RTL-SDR device
   auto read_callback_func = [&](uint8_t const* buffer, size_t count) -> void
   {
-    std::unique_ptr<TYPECPX[]> samples; // Array of I/Q samples to return
+    // A transfer of the wrong size is queued as a single empty block
+    size_t const blocks = (count == readsize) ? readsize / blocksize : 1;
 
-    // If the proper amount of data was returned by the callback, convert it into
-    // the floating-point I/Q sample data for the demodulator to process
-    if (count == readsize)
+    for (size_t index = 0; index < blocks; index++)
     {
 
-      samples = std::unique_ptr<TYPECPX[]>(new TYPECPX[readsize / 2]);
-      for (int index = 0; index < m_demodulator->GetInputBufferLimit(); index++)
+      sample_queue_item_t samples; // Block of I/Q samples to return
+
+      // An unpaced device delivers data as fast as it can be processed; instead of dropping
+      // samples when the queue is full, wait for the demodulator to make room.  The pool
+      // holds more blocks than the queue, so it can't be exhausted after waiting
+      if (unpaced)
+        m_queue.wait_for_space([&]() -> bool
+                               { return (m_stop.test(true)) || (m_demodstopped.load() == true); });
+
+      // If the proper amount of data was returned by the callback, convert it into
+      // the floating-point I/Q sample data for the demodulator to process.  If the
+      // pool has been exhausted the block will be empty and a resync will be queued
+      if (count == readsize)
+        samples = m_samplepool->acquire();
+
+      if (samples)
       {
 
         // The demodulator expects the I/Q samples in the range of -32767.0 through +32767.0
-        // (32767.0 / 127.5) = 256.9960784313725
-        samples[index] = {
-
-#ifdef FMDSP_USE_DOUBLE_PRECISION
-            (static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5) * 256.9960784313725, // I
-            (static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5) * 256.9960784313725, // Q
-#else
-            (static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5f) * 256.9960784313725f, // I
-            (static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5f) * 256.9960784313725f, // Q
-#endif
-        };
+        if (m_decimator)
+          m_decimator->decimate(&buffer[index * blocksize],
+                                reinterpret_cast<TYPEREAL*>(samples.get()),
+                                m_demodulator->GetInputBufferLimit() * factor, 256.9960784313725f);
+        else
+          m_converter.convert(&buffer[index * blocksize],
+                              reinterpret_cast<TYPEREAL*>(samples.get()),
+                              m_demodulator->GetInputBufferLimit());
       }
-    }
 
-    // Push the converted samples into the queue<> for processing.  If there is insufficient space
-    // left in the queue<>, the samples aren't being processed quickly enough to keep up with the rate
-    std::unique_lock<std::mutex> lock(m_queuelock);
-    if (m_queue.size() < MAX_SAMPLE_QUEUE)
-      m_queue.emplace(std::move(samples));
-    else
-    {
+      // If samples were previously dropped, a resync packet (empty) has to be queued ahead
+      // of any new samples so the demodulator knows that the input is discontinuous
+      if (resync)
+        resync = !m_queue.push(sample_queue_item_t());
 
-      m_queue = sample_queue_t(); // Replace the queue<>
-      m_queue.push(nullptr); // Push a resync packet (null)
-      if (samples)
-        m_queue.emplace(std::move(samples)); // Push samples
+      // Push the converted samples into the queue for processing.  If there is insufficient
+      // space left in the queue, the samples aren't being processed quickly enough to keep up;
+      // the samples are dropped, counted as an overrun, and a resync will be queued next time
+      if ((resync) || (!m_queue.push(std::move(samples))))
+        resync = true;
     }
-
-    // Notify any threads waiting on the lock that the queue<> has been updated
-    m_cv.notify_all();
   };
 
   // Begin streaming from the device and inform the caller that the thread is running
@@ -583,7 +956,7 @@ void fmstream::transfer(scalar_condition<bool>& started)
   // Continuously read data from the device until cancel_async() has been called
   try
   {
-    m_device->read_async(read_callback_func, static_cast<uint32_t>(readsize));
+    m_device->read_async(read_callback_func, static_cast<uint32_t>(readsize), m_buffercount);
   }
   catch (...)
   {
@@ -591,7 +964,7 @@ void fmstream::transfer(scalar_condition<bool>& started)
   }
 
   m_stopped.store(true); // Thread is stopped
-  m_cv.notify_all(); // Unblock any waiters
+  m_queue.notify(); // Unblock any waiters
 }
 
 //---------------------------------------------------------------------------
@@ -30,13 +30,17 @@
 #include "pvrstream.h"
 #include "rdsdecoder.h"
 #include "rtldevice.h"
+#include "utils/iqconverter.h"
+#include "utils/iqdecimator.h"
+#include "utils/latencycontrol.h"
+#include "utils/packetpool.h"
+#include "utils/samplepool.h"
 #include "utils/scalar_condition.h"
+#include "utils/spsc_queue.h"
 
 #include <atomic>
-#include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 
 #pragma warning(push, 4)
@@ -56,6 +60,11 @@ public:
   //-----------------------------------------------------------------------
   // Member Functions
 
+  // canpause
+  //
+  // Flag indicating if the stream allows pause operations
+  bool canpause(void) const override;
+
   // canseek
   //
   // Flag indicating if the stream allows seek operations
@@ -99,6 +108,11 @@ public:
   // Gets the device name associated with the stream
   std::string devicename(void) const override;
 
+  // devicestatistics
+  //
+  // Gets the data transfer statistics for the device associated with the stream
+  void devicestatistics(struct rtldevice::device_statistics& stats) const override;
+
   // enumproperties
   //
   // Enumerates the stream properties
@@ -115,6 +129,11 @@ public:
   // Gets the mux name associated with the stream
   std::string muxname(void) const override;
 
+  // overruns
+  //
+  // Gets the number of times that data was dropped because the stream fell behind
+  uint64_t overruns(void) const override;
+
   // position
   //
   // Gets the current position of the stream
@@ -135,6 +154,11 @@ public:
   // Sets the stream pointer to a specific position
   long long seek(long long position, int whence) override;
 
+  // seektime
+  //
+  // Sets the stream pointer to a specific time
+  bool seektime(double time, bool backwards, double& startpts) override;
+
   // servicename
   //
   // Gets the service name associated with the stream
@@ -145,14 +169,34 @@ public:
   // Gets the signal quality as percentages
   void signalquality(int& quality, int& snr) const override;
 
+  // streamtimes
+  //
+  // Gets the time shift boundaries of the stream
+  bool streamtimes(struct streamtimes& times) const override;
+
 private:
   fmstream(fmstream const&) = delete;
   fmstream& operator=(fmstream const&) = delete;
 
-  // MAX_SAMPLE_QUEUE
+  // AUDIO_QUEUE_CAPACITY
+  //
+  // Number of demodulated audio blocks that can be queued for the resampler
+  static size_t const AUDIO_QUEUE_CAPACITY;
+
+  // MIN_DECIMATED_RATE
+  //
+  // Minimum effective sample rate after front-end decimation
+  static uint32_t const MIN_DECIMATED_RATE;
+
+  // SAMPLE_BLOCK_DURATION
+  //
+  // Approximate duration of a block of samples or a demux packet, in milliseconds
+  static uint32_t const SAMPLE_BLOCK_DURATION;
+
+  // SAMPLE_QUEUE_CAPACITY
   //
-  // Maximum number of queued sample sets from device
-  static size_t const MAX_SAMPLE_QUEUE;
+  // Number of converted I/Q sample blocks that can be queued for the demodulator
+  static size_t const SAMPLE_QUEUE_CAPACITY;
 
   // STREAM_ID_AUDIO
   //
@@ -174,24 +218,59 @@ private:
   //-----------------------------------------------------------------------
   // Private Type Declarations
 
+  // audio_block_t
+  //
+  // Block of demodulated audio queued to the resampler thread
+  struct audio_block_t
+  {
+
+    samplepool<TYPECPX>::block samples; // Demodulated audio samples
+    int count; // Number of demodulated audio samples
+  };
+
+  // audio_queue_t
+  //
+  // Defines the type of the demodulated audio queue
+  using audio_queue_t = spsc_queue<audio_block_t>;
+
+  // packet_queue_item_t
+  //
+  // Defines the type of a single packet_queue_t entry
+  using packet_queue_item_t = packetpool::packet_ptr;
+
+  // packet_queue_t
+  //
+  // Defines the type of the output demux packet queue
+  using packet_queue_t = spsc_queue<packet_queue_item_t>;
+
   // sample_queue_item_t
   //
   // Defines the type of a single sample_queue_t entry
-  using sample_queue_item_t = std::unique_ptr<TYPECPX[]>;
+  using sample_queue_item_t = samplepool<TYPECPX>::block;
 
   // sample_queue_t
   //
   // Defines the type of the input sample queue
-  using sample_queue_t = std::queue<sample_queue_item_t>;
+  using sample_queue_t = spsc_queue<sample_queue_item_t>;
 
   //-----------------------------------------------------------------------
   // Private Member Functions
 
+  // demodulate
+  //
+  // Worker thread procedure used to demodulate the samples
+  void demodulate(scalar_condition<bool>& started);
+
   // generate_mux_name
   //
   // Generates the mux name to associate with the stream
   std::string generate_mux_name(struct channelprops const& channelprops) const;
 
+  // resample
+  //
+  // Worker thread procedure used to resample and packetize the demodulated audio
+  void resample(scalar_condition<bool>& started);
+
   // transfer
   //
   // Worker thread procedure used to transfer data into the ring buffer
@@ -201,25 +280,45 @@ private:
   // Member Variables
 
   std::unique_ptr<rtldevice> m_device; // RTL-SDR device instance
-  std::unique_ptr<CDemodulator> m_demodulator; // CuteSDR demodulator instance
-  std::unique_ptr<CFractResampler> m_resampler; // CuteSDR resampler instance
+  uint32_t const m_buffercount; // Device transfer buffer count
+  uint32_t const m_bufferlength; // Device transfer buffer length
+  std::unique_ptr<CDemodulator<>> m_demodulator; // CuteSDR demodulator instance
+  std::unique_ptr<CFractResampler<>> m_resampler; // CuteSDR resampler instance
   bool const m_decoderds; // Flag to send decoded RDS data
   rdsdecoder m_rdsdecoder; // RDS decoder instance
+  mutable std::mutex m_rdslock; // RDS decoder synchronization object
 
   std::string const m_muxname; // Default mux name for the stream
   uint32_t const m_pcmsamplerate; // Output sample rate
   TYPEREAL const m_pcmgain; // Output gain
-  double m_dts{STREAM_TIME_BASE}; // Current decode time stamp
+  bool const m_freerun; // Flag if the output is not paced by the player
+  latencycontrol m_latency; // Output latency control
 
   // STREAM CONTROL
   //
-  sample_queue_t m_queue; // queue<> of prepared samples
-  mutable std::mutex m_queuelock; // Synchronization object
-  std::condition_variable m_cv; // Transfer event condvar
+  iqconverter m_converter{127.5f, 256.9960784313725f}; // I/Q sample converter
+  std::unique_ptr<iqdecimator> m_decimator; // Front-end I/Q sample decimator
+  std::unique_ptr<samplepool<TYPECPX>> m_samplepool; // Pool of sample blocks
+  sample_queue_t m_queue; // Queue of prepared samples
   std::thread m_worker; // Data transfer thread
   std::exception_ptr m_worker_exception; // Exception on worker thread
   scalar_condition<bool> m_stop{false}; // Condition to stop data transfer
   std::atomic<bool> m_stopped{false}; // Data transfer stopped flag
+
+  // DEMODULATOR CONTROL
+  //
+  audio_queue_t m_audioqueue; // Queue of demodulated audio
+  std::thread m_demodworker; // Demodulator thread
+  std::exception_ptr m_demod_exception; // Exception on demodulator thread
+  std::atomic<bool> m_demodstopped{false}; // Demodulator stopped flag
+
+  // RESAMPLER CONTROL
+  //
+  packetpool m_packetpool; // Pool of demux packets
+  packet_queue_t m_packetqueue; // Queue of finished demux packets
+  std::thread m_resampleworker; // Resampler thread
+  std::exception_ptr m_resample_exception; // Exception on resampler thread
+  std::atomic<bool> m_resamplestopped{false}; // Resampler stopped flag
 };
 
 //-----------------------------------------------------------------------------
@@ -1132,7 +1132,7 @@ void channelsettings::worker(scalar_condition<bool>& started)
   // Continuously read data from the device until cancel_async() has been called
   try
   {
-    m_device->read_async(read_callback_func, static_cast<uint32_t>(32 KiB));
+    m_device->read_async(read_callback_func, static_cast<uint32_t>(32 KiB), 0);
   }
   catch (...)
   {
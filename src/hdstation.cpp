@@ -0,0 +1,438 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "hdstation.h"
+
+#include "exception_control/string_exception.h"
+#include "utils/value_size_defines.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#pragma warning(push, 4)
+
+// hdstation::MAX_PROGRAMS
+//
+// Maximum number of programs that can be multiplexed by a station
+uint32_t const hdstation::MAX_PROGRAMS = 8; // HD1-HD8
+
+// hdstation::SAMPLE_RATE
+//
+// Fixed device sample rate required for HD Radio
+uint32_t const hdstation::SAMPLE_RATE = 1488375;
+
+//---------------------------------------------------------------------------
+// hdstation Constructor (private)
+//
+// Arguments:
+//
+//	device			- RTL-SDR device instance
+//	tunerprops		- Tuner device properties
+//	channelprops	- Channel properties
+
+hdstation::hdstation(std::unique_ptr<rtldevice> device,
+                     struct tunerprops const& tunerprops,
+                     struct channelprops const& channelprops)
+  : m_device(std::move(device)),
+    m_buffercount(tunerprops.buffercount),
+    m_bufferlength(tunerprops.bufferlength),
+    m_frequency(channelprops.frequency),
+    m_unpaced(m_device->is_unpaced())
+{
+  // Initialize the RTL-SDR device instance
+  m_device->set_frequency_correction(tunerprops.freqcorrection + channelprops.freqcorrection);
+  m_device->set_sample_rate(SAMPLE_RATE);
+  m_device->set_center_frequency(channelprops.frequency);
+
+  // Adjust the device gain as specified by the channel properties
+  m_device->set_automatic_gain_control(channelprops.autogain);
+  if (channelprops.autogain == false)
+    m_device->set_gain(channelprops.manualgain);
+
+  // Initialize the HD Radio demodulator; no programs are decoded until subscribed to
+  nrsc5_open_pipe(&m_nrsc5);
+  nrsc5_set_mode(m_nrsc5, NRSC5_MODE_FM);
+  nrsc5_set_program_mask(m_nrsc5, 0);
+  nrsc5_set_callback(m_nrsc5, nrsc5_callback, this);
+
+  // Create a worker thread on which to perform demodulation
+  scalar_condition<bool> started{false};
+  m_worker = std::thread(&hdstation::worker, this, std::ref(started));
+  started.wait_until_equals(true);
+}
+
+//---------------------------------------------------------------------------
+// hdstation Destructor
+
+hdstation::~hdstation()
+{
+  close();
+}
+
+//---------------------------------------------------------------------------
+// hdstation::close
+//
+// Closes the station
+//
+// Arguments:
+//
+//	NONE
+
+void hdstation::close(void)
+{
+  m_stop = true; // Signal worker thread to stop
+  if (m_device)
+    m_device->cancel_async(); // Cancel any async read operations
+  if (m_worker.joinable())
+    m_worker.join(); // Wait for thread
+
+  nrsc5_close(m_nrsc5); // Close NRSC5
+  m_nrsc5 = nullptr; // Reset NRSC5 API handle
+
+  m_device.reset(); // Release RTL-SDR device
+}
+
+//---------------------------------------------------------------------------
+// hdstation::create (static)
+//
+// Factory method, creates a new hdstation instance
+//
+// Arguments:
+//
+//	device			- RTL-SDR device instance
+//	tunerprops		- Tunder device properties
+//	channelprops	- Channel properties
+
+std::shared_ptr<hdstation> hdstation::create(std::unique_ptr<rtldevice> device,
+                                             struct tunerprops const& tunerprops,
+                                             struct channelprops const& channelprops)
+{
+  return std::shared_ptr<hdstation>(new hdstation(std::move(device), tunerprops, channelprops));
+}
+
+//---------------------------------------------------------------------------
+// hdstation::devicename
+//
+// Gets the device name associated with the station
+//
+// Arguments:
+//
+//	NONE
+
+std::string hdstation::devicename(void) const
+{
+  return std::string(m_device->get_device_name());
+}
+
+//---------------------------------------------------------------------------
+// hdstation::devicestatistics
+//
+// Gets the data transfer statistics for the device associated with the station
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void hdstation::devicestatistics(struct rtldevice::device_statistics& stats) const
+{
+  m_device->get_statistics(stats);
+}
+
+//---------------------------------------------------------------------------
+// hdstation::frequency
+//
+// Gets the frequency of the station
+//
+// Arguments:
+//
+//	NONE
+
+uint32_t hdstation::frequency(void) const
+{
+  return m_frequency;
+}
+
+//---------------------------------------------------------------------------
+// hdstation::nrsc5_callback (private, static)
+//
+// NRSC5 library event callback function
+//
+// Arguments:
+//
+//	event	- NRSC5 event being raised
+//	arg		- Implementation-specific context pointer
+
+void hdstation::nrsc5_callback(nrsc5_event_t const* event, void* arg)
+{
+  assert(arg != nullptr);
+  reinterpret_cast<hdstation*>(arg)->nrsc5_callback(event);
+}
+
+//---------------------------------------------------------------------------
+// hdstation::nrsc5_callback (private)
+//
+// NRSC5 library event callback function
+//
+// Arguments:
+//
+//	event	- NRSC5 event being raised
+
+void hdstation::nrsc5_callback(nrsc5_event_t const* event)
+{
+  int program = -1; // Program the event applies to; -1 for all programs
+
+  // NRSC5_EVENT_BER
+  //
+  // Reporting the current bit error rate
+  if (event->event == NRSC5_EVENT_BER)
+  {
+
+    m_ber.store(event->ber.cber);
+    return;
+  }
+
+  // NRSC5_EVENT_MER
+  //
+  // Reporting the current modulatation error ratio
+  else if (event->event == NRSC5_EVENT_MER)
+  {
+
+    // Store the higher of the two values instead of the mean, some HD radio stations
+    // are allowed to transmit one sideband at a higher power than the other
+    m_mer.store(std::max(event->mer.lower, event->mer.upper));
+    return;
+  }
+
+  // Events that apply to a specific program are only distributed to the subscribers of that
+  // program; LOT items are distributed to all subscribers since the ID3 tags of any program
+  // may refer to them.  Any other events are not of interest to the subscribers
+  else if (event->event == NRSC5_EVENT_AUDIO)
+    program = static_cast<int>(event->audio.program);
+  else if (event->event == NRSC5_EVENT_HDC)
+    program = static_cast<int>(event->hdc.program);
+  else if (event->event == NRSC5_EVENT_ID3)
+    program = static_cast<int>(event->id3.program);
+  else if (event->event != NRSC5_EVENT_LOT)
+    return;
+
+  std::unique_lock<std::mutex> lock(m_subscriberslock);
+  for (auto const& iterator : m_subscribers)
+  {
+
+    if ((program < 0) || (iterator.second.program == static_cast<uint32_t>(program)))
+      iterator.second.onevent(event);
+  }
+}
+
+//---------------------------------------------------------------------------
+// hdstation::signalquality
+//
+// Gets the signal quality as percentages
+//
+// Arguments:
+//
+//	quality		- Signal quality percentage
+//	snr			- Signal-to-noise ratio percentage
+
+void hdstation::signalquality(int& quality, int& snr) const
+{
+  // For signal quality, use the NRSC5 Bit Error Rate (BER). A BER of zero
+  // implies ideal signal quality. I have no idea what the BER tolerance
+  // is for decoding HD Radio, but from observation a BER with a value
+  // higher than 0.1 is effectively undecodable so let's call that zero
+  float ber = m_ber.load();
+  ber = std::min(std::max(ber, 0.0f), 0.1f) * 100.0f;
+  quality = static_cast<int>(((ber - 100.0f) * 100.0f) / -100.0f);
+
+  // For signal-to-noise ratio, use the NRSC5 Modulation Error Ratio (MER).
+  // A MER of 14 is apparently the ideal for HD Radio, so for now use
+  // a linear scale from (0...13) to define the SNR percentage
+  float mer = m_mer.load();
+  mer = std::max(std::min(13.0f, mer), 0.0f);
+  snr = static_cast<int>((mer * 100.0f) / 13.0f);
+}
+
+//---------------------------------------------------------------------------
+// hdstation::stopped
+//
+// Gets a flag indicating if the station has stopped
+//
+// Arguments:
+//
+//	NONE
+
+bool hdstation::stopped(void) const
+{
+  return m_stopped.load();
+}
+
+//---------------------------------------------------------------------------
+// hdstation::subscribe
+//
+// Adds a subscriber to the events of a station program
+//
+// Arguments:
+//
+//	program		- Program number to subscribe to (zero-based)
+//	onevent		- Callback to invoke for each event raised for the program
+//	onstopped	- Callback to invoke when the station has stopped
+
+unsigned int hdstation::subscribe(uint32_t program,
+                                  event_callback const& onevent,
+                                  stopped_callback const& onstopped)
+{
+  if (program >= MAX_PROGRAMS)
+    throw string_exception(__func__, ": HD Radio program number ", program, " is out of range");
+
+  std::unique_lock<std::mutex> lock(m_subscriberslock);
+
+  unsigned int subscription = m_nextsubscription++;
+  m_subscribers[subscription] = {program, onevent, onstopped};
+  update_program_mask();
+
+  // If the station has already stopped, invoke the callback immediately
+  if (m_stopped.load())
+    onstopped(m_worker_exception);
+
+  return subscription;
+}
+
+//---------------------------------------------------------------------------
+// hdstation::subscribers
+//
+// Gets the number of active subscribers
+//
+// Arguments:
+//
+//	NONE
+
+size_t hdstation::subscribers(void) const
+{
+  std::unique_lock<std::mutex> lock(m_subscriberslock);
+  return m_subscribers.size();
+}
+
+//---------------------------------------------------------------------------
+// hdstation::unpaced
+//
+// Gets a flag indicating if the station input is delivered faster than real time
+//
+// Arguments:
+//
+//	NONE
+
+bool hdstation::unpaced(void) const
+{
+  return m_unpaced;
+}
+
+//---------------------------------------------------------------------------
+// hdstation::unsubscribe
+//
+// Removes a subscriber from the station
+//
+// Arguments:
+//
+//	subscription	- Subscription identifier returned from subscribe()
+
+void hdstation::unsubscribe(unsigned int subscription)
+{
+  std::unique_lock<std::mutex> lock(m_subscriberslock);
+
+  m_subscribers.erase(subscription);
+  update_program_mask();
+}
+
+//---------------------------------------------------------------------------
+// hdstation::update_program_mask (private)
+//
+// Updates the mask of programs to be decoded from the active subscribers
+//
+// Arguments:
+//
+//	NONE
+
+void hdstation::update_program_mask(void)
+{
+  unsigned int mask = 0;
+
+  // m_subscriberslock must be held by the caller
+  for (auto const& iterator : m_subscribers)
+    mask |= (1u << iterator.second.program);
+
+  // The mask is applied to the demodulator from the worker thread
+  m_programmask.store(mask);
+}
+
+//---------------------------------------------------------------------------
+// hdstation::worker (private)
+//
+// Worker thread procedure used to transfer data from the device
+//
+// Arguments:
+//
+//	started		- Condition variable to set when thread has started
+
+void hdstation::worker(scalar_condition<bool>& started)
+{
+  assert(m_device);
+  assert(m_nrsc5);
+
+  // read_callback_func (local)
+  //
+  // Asynchronous read callback function for the RTL-SDR device
+  auto read_callback_func = [&](uint8_t const* buffer, size_t count) -> void
+  {
+    // Apply the current program mask; NRSC5 isn't thread-safe so this has to be done here
+    nrsc5_set_program_mask(m_nrsc5, m_programmask.load());
+
+    // Pipe the samples into NRSC5, it will invoke the necessary callback(s)
+    nrsc5_pipe_samples_cu8(m_nrsc5, const_cast<uint8_t*>(buffer), static_cast<unsigned int>(count));
+  };
+
+  // Begin streaming from the device and inform the caller that the thread is running
+  m_device->begin_stream();
+  started = true;
+
+  // Continuously read data from the device until cancel_async() has been called
+  // 32 KiB = ~1/100 of a second of data, unless the tuner properties specify otherwise
+  try
+  {
+    m_device->read_async(read_callback_func, (m_bufferlength > 0) ? m_bufferlength : 32 KiB,
+                         m_buffercount);
+  }
+  catch (...)
+  {
+    m_worker_exception = std::current_exception();
+  }
+
+  // Worker thread is now stopped; inform all of the subscribers
+  std::unique_lock<std::mutex> lock(m_subscriberslock);
+  m_stopped.store(true);
+  for (auto const& iterator : m_subscribers)
+    iterator.second.onstopped(m_worker_exception);
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
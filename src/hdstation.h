@@ -0,0 +1,230 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __HDSTATION_H_
+#define __HDSTATION_H_
+#pragma once
+
+#include "dsp_hd/nrsc5.h"
+#include "props.h"
+#include "rtldevice.h"
+#include "utils/scalar_condition.h"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class hdstation
+//
+// Implements a shared HD Radio station receiver.  A single tuner device and
+// a single NRSC5 demodulator are maintained per tuned frequency and the
+// decoded events for each program (HD1-HD8) are distributed to the
+// subscribers of that program.  Audio decoding and ID3/LOT assembly are
+// only performed for programs that have at least one subscriber
+
+class hdstation
+{
+public:
+  // Destructor
+  //
+  ~hdstation();
+
+  //-----------------------------------------------------------------------
+  // Type Declarations
+
+  // event_callback
+  //
+  // Callback function invoked when an NRSC5 event has been raised for a subscribed program
+  using event_callback = std::function<void(nrsc5_event_t const* event)>;
+
+  // stopped_callback
+  //
+  // Callback function invoked when the station has stopped; the exception will be null if
+  // the station was stopped normally
+  using stopped_callback = std::function<void(std::exception_ptr const& ex)>;
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // close
+  //
+  // Closes the station
+  void close(void);
+
+  // create (static)
+  //
+  // Factory method, creates a new hdstation instance
+  static std::shared_ptr<hdstation> create(std::unique_ptr<rtldevice> device,
+                                           struct tunerprops const& tunerprops,
+                                           struct channelprops const& channelprops);
+
+  // devicename
+  //
+  // Gets the device name associated with the station
+  std::string devicename(void) const;
+
+  // devicestatistics
+  //
+  // Gets the data transfer statistics for the device associated with the station
+  void devicestatistics(struct rtldevice::device_statistics& stats) const;
+
+  // frequency
+  //
+  // Gets the frequency of the station
+  uint32_t frequency(void) const;
+
+  // signalquality
+  //
+  // Gets the signal quality as percentages
+  void signalquality(int& quality, int& snr) const;
+
+  // stopped
+  //
+  // Gets a flag indicating if the station has stopped
+  bool stopped(void) const;
+
+  // subscribe
+  //
+  // Adds a subscriber to the events of a station program
+  unsigned int subscribe(uint32_t program,
+                         event_callback const& onevent,
+                         stopped_callback const& onstopped);
+
+  // subscribers
+  //
+  // Gets the number of active subscribers
+  size_t subscribers(void) const;
+
+  // unpaced
+  //
+  // Gets a flag indicating if the station input is delivered faster than real time
+  bool unpaced(void) const;
+
+  // unsubscribe
+  //
+  // Removes a subscriber from the station
+  void unsubscribe(unsigned int subscription);
+
+private:
+  hdstation(hdstation const&) = delete;
+  hdstation& operator=(hdstation const&) = delete;
+
+  // MAX_PROGRAMS
+  //
+  // Maximum number of programs that can be multiplexed by a station
+  static uint32_t const MAX_PROGRAMS;
+
+  // SAMPLE_RATE
+  //
+  // Fixed device sample rate required for HD Radio
+  static uint32_t const SAMPLE_RATE;
+
+  // Instance Constructor
+  //
+  hdstation(std::unique_ptr<rtldevice> device,
+            struct tunerprops const& tunerprops,
+            struct channelprops const& channelprops);
+
+  //-----------------------------------------------------------------------
+  // Private Type Declarations
+
+  // subscriber_t
+  //
+  // Defines a program subscriber
+  struct subscriber_t
+  {
+
+    uint32_t program; // Subscribed program number (zero-based)
+    event_callback onevent; // Subscriber event callback
+    stopped_callback onstopped; // Subscriber stopped callback
+  };
+
+  // subscriber_map_t
+  //
+  // Defines the type of the subscriber map
+  using subscriber_map_t = std::map<unsigned int, subscriber_t>;
+
+  //-----------------------------------------------------------------------
+  // Private Member Functions
+
+  // nrsc5_callback (static)
+  //
+  // NRSC5 library event callback function
+  static void nrsc5_callback(nrsc5_event_t const* event, void* arg);
+
+  // nrsc5_callback
+  //
+  // NRSC5 library event callback function
+  void nrsc5_callback(nrsc5_event_t const* event);
+
+  // update_program_mask
+  //
+  // Updates the mask of programs to be decoded from the active subscribers
+  void update_program_mask(void);
+
+  // worker
+  //
+  // Worker thread procedure used to transfer data from the device
+  void worker(scalar_condition<bool>& started);
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  std::unique_ptr<rtldevice> m_device; // RTL-SDR device instance
+  uint32_t const m_buffercount; // Device transfer buffer count
+  uint32_t const m_bufferlength; // Device transfer buffer length
+  uint32_t const m_frequency; // Station frequency
+  bool const m_unpaced; // Flag if the device is unpaced
+  nrsc5_t* m_nrsc5; // NRSC5 demodulator handle
+
+  std::atomic<float> m_mer{0}; // Current modulation error ratio
+  std::atomic<float> m_ber{0}; // Current bit erorr rate
+
+  // SUBSCRIBERS
+  //
+  subscriber_map_t m_subscribers; // map<> of program subscribers
+  unsigned int m_nextsubscription{1}; // Next subscription identifier
+  std::atomic<unsigned int> m_programmask{0}; // Mask of programs to decode
+  mutable std::mutex m_subscriberslock; // Synchronization object
+
+  // WORKER THREAD
+  //
+  std::thread m_worker; // Data transfer thread
+  std::exception_ptr m_worker_exception; // Exception on worker thread
+  scalar_condition<bool> m_stop{false}; // Condition to stop data transfer
+  std::atomic<bool> m_stopped{false}; // Data transfer stopped flag
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __HDSTATION_H_
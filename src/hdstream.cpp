@@ -25,9 +25,7 @@
 #include "id3v2tag.h"
 #include "exception_control/string_exception.h"
 #include "utils/align.h"
-#include "utils/value_size_defines.h"
 
-#include <algorithm>
 #include <chrono>
 #include <memory.h>
 
@@ -36,15 +34,15 @@
 
 #pragma warning(push, 4)
 
-// hdstream::MAX_PACKET_QUEUE
+// hdstream::DEFAULT_PAYLOAD_SIZE
 //
-// Maximum number of queued demux packets
-size_t const hdstream::MAX_PACKET_QUEUE = 200; // ~2sec analog / ~10sec digital
+// Default length of a pooled demux packet payload buffer
+size_t const hdstream::DEFAULT_PAYLOAD_SIZE = 8192; // 2048 stereo 16-bit samples
 
-// hdstream::SAMPLE_RATE
+// hdstream::PACKET_POOL_SIZE
 //
-// Fixed device sample rate required for HD Radio
-uint32_t const hdstream::SAMPLE_RATE = 1488375;
+// Number of demux packets preallocated in the packet pool
+size_t const hdstream::PACKET_POOL_SIZE = 200; // ~2sec analog / ~10sec digital
 
 // hdstream::STREAM_ID_AUDIO
 //
@@ -61,41 +59,42 @@ int const hdstream::STREAM_ID_ID3TAG = 2;
 //
 // Arguments:
 //
-//	device			- RTL-SDR device instance
-//	tunerprops		- Tuner device properties
-//	channelprops	- Channel properties
+//	station			- Shared HD Radio station instance
 //	hdprops			- HD Radio digital signal processor properties
 //	subchannel		- Multiplex subchannel number
 
-hdstream::hdstream(std::unique_ptr<rtldevice> device,
-                   struct tunerprops const& tunerprops,
-                   struct channelprops const& channelprops,
+hdstream::hdstream(std::shared_ptr<hdstation> station,
                    struct hdprops const& hdprops,
                    uint32_t subchannel)
-  : m_device(std::move(device)),
+  : m_station(std::move(station)),
     m_subchannel((subchannel > 0) ? subchannel : 1),
+    m_unpaced(m_station->unpaced()),
+    m_freerun((hdprops.freerun) || (m_unpaced)),
     m_muxname(""),
-    m_pcmgain(powf(10.0f, hdprops.outputgain / 10.0f))
+    m_pcmgain(powf(10.0f, hdprops.outputgain / 10.0f)),
+    m_latency(hdprops.outputlatency, hdprops.adaptivelatency, m_freerun),
+    m_clock(m_latency.target(), m_freerun),
+    m_packetpool(PACKET_POOL_SIZE, DEFAULT_PAYLOAD_SIZE)
 {
-  // Initialize the RTL-SDR device instance
-  m_device->set_frequency_correction(tunerprops.freqcorrection + channelprops.freqcorrection);
-  m_device->set_sample_rate(SAMPLE_RATE);
-  m_device->set_center_frequency(channelprops.frequency);
-
-  // Adjust the device gain as specified by the channel properties
-  m_device->set_automatic_gain_control(channelprops.autogain);
-  if (channelprops.autogain == false)
-    m_device->set_gain(channelprops.manualgain);
-
-  // Initialize the HD Radio demodulator
-  nrsc5_open_pipe(&m_nrsc5);
-  nrsc5_set_mode(m_nrsc5, NRSC5_MODE_FM);
-  nrsc5_set_callback(m_nrsc5, nrsc5_callback, this);
-
-  // Create a worker thread on which to perform demodulation
-  scalar_condition<bool> started{false};
-  m_worker = std::thread(&hdstream::worker, this, std::ref(started));
-  started.wait_until_equals(true);
+  assert(m_station);
+
+  m_consumed.reserve(PACKET_POOL_SIZE);
+
+  // onstopped (local)
+  //
+  // Invoked when the station has stopped, either normally or due to an exception
+  auto onstopped = [&](std::exception_ptr const& ex) -> void
+  {
+    std::unique_lock<std::mutex> lock(m_queuelock);
+    m_station_exception = ex;
+    m_stopped.store(true);
+    m_cv.notify_all(); // Unblock any waiters
+  };
+
+  // Subscribe to the events for the program from the station; HD1 is program zero
+  m_subscription = m_station->subscribe(
+      m_subchannel - 1, [&](nrsc5_event_t const* event) -> void { nrsc5_callback(event); },
+      onstopped);
 }
 
 //---------------------------------------------------------------------------
@@ -106,6 +105,20 @@ hdstream::~hdstream()
   close();
 }
 
+//---------------------------------------------------------------------------
+// hdstream::canpause
+//
+// Gets a flag indicating if the stream allows pause operations
+//
+// Arguments:
+//
+//	NONE
+
+bool hdstream::canpause(void) const
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // hdstream::canseek
 //
@@ -131,16 +144,18 @@ bool hdstream::canseek(void) const
 
 void hdstream::close(void)
 {
-  m_stop = true; // Signal worker thread to stop
-  if (m_device)
-    m_device->cancel_async(); // Cancel any async read operations
-  if (m_worker.joinable())
-    m_worker.join(); // Wait for thread
-
-  nrsc5_close(m_nrsc5); // Close NRSC5
-  m_nrsc5 = nullptr; // Reset NRSC5 API handle
+  // Release a station event callback waiting for demux queue space, it has to be able
+  // to return before the subscriber can be removed
+  std::unique_lock<std::mutex> lock(m_queuelock);
+  m_stopped.store(true);
+  m_cv.notify_all();
+  lock.unlock();
 
-  m_device.reset(); // Release RTL-SDR device
+  // Unsubscribe from the station and release it; the station will be closed
+  // when the last of the subscribers that share it has been released
+  if (m_station)
+    m_station->unsubscribe(m_subscription);
+  m_station.reset();
 }
 
 //---------------------------------------------------------------------------
@@ -150,20 +165,15 @@ void hdstream::close(void)
 //
 // Arguments:
 //
-//	device			- RTL-SDR device instance
-//	tunerprops		- Tunder device properties
-//	channelprops	- Channel properties
+//	station			- Shared HD Radio station instance
 //	hdprops			- HD Radio digital signal processor properties
 //	subchannel		- Multiplex subchannel number
 
-std::unique_ptr<hdstream> hdstream::create(std::unique_ptr<rtldevice> device,
-                                           struct tunerprops const& tunerprops,
-                                           struct channelprops const& channelprops,
+std::unique_ptr<hdstream> hdstream::create(std::shared_ptr<hdstation> station,
                                            struct hdprops const& hdprops,
                                            uint32_t subchannel)
 {
-  return std::unique_ptr<hdstream>(
-      new hdstream(std::move(device), tunerprops, channelprops, hdprops, subchannel));
+  return std::unique_ptr<hdstream>(new hdstream(std::move(station), hdprops, subchannel));
 }
 
 //---------------------------------------------------------------------------
@@ -203,35 +213,72 @@ void hdstream::demuxflush(void)
 
 DEMUX_PACKET* hdstream::demuxread(std::function<DEMUX_PACKET*(int)> const& allocator)
 {
-  // Wait up to 100ms for there to be a packet available for processing, don't use
-  // an unconditional wait here; unlike analog radio there may not be data until
-  // the digitial signal has been synchronized
-  std::unique_lock<std::mutex> lock(m_queuelock);
-  if (!m_cv.wait_for(lock, std::chrono::milliseconds(100),
-                     [&]() -> bool { return ((m_queue.size() > 0) || m_stopped.load() == true); }))
+  // Hold back the output while the queue fills up to the target latency; wait for up to
+  // 100ms for the station to stop before returning an empty demultiplexer packet
+  double const queuedms = queuelength();
+  if ((m_stopped.load() == false) && (m_latency.buffering(queuedms > 0.0, queuedms)))
+  {
+
+    std::unique_lock<std::mutex> lock(m_queuelock);
+    m_cv.wait_for(lock, std::chrono::milliseconds(100),
+                  [&]() -> bool { return m_stopped.load() == true; });
     return allocator(0);
+  }
 
-  // If the worker thread was stopped, check for and re-throw any exception that occurred,
-  // otherwise assume it was stopped normally and return an empty demultiplexer packet
-  if (m_stopped.load() == true)
+  // Packets are taken from the shared queue in batches; only when the current batch
+  // has been exhausted does the queue need to be locked again
+  if (m_readqueue.empty())
   {
 
-    if (m_worker_exception)
-      std::rethrow_exception(m_worker_exception);
-    else
+    // Return the packets consumed from the previous batch to the pool
+    m_packetpool.release(m_consumed.begin(), m_consumed.end());
+    m_consumed.clear();
+
+    // Wait up to 100ms for there to be a packet available for processing, don't use
+    // an unconditional wait here; unlike analog radio there may not be data until
+    // the digitial signal has been synchronized
+    std::unique_lock<std::mutex> lock(m_queuelock);
+    if (!m_cv.wait_for(lock, std::chrono::milliseconds(100),
+                       [&]() -> bool
+                       { return ((m_queue.size() > 0) || m_stopped.load() == true); }))
       return allocator(0);
+
+    // If the station was stopped, check for and re-throw any exception that occurred,
+    // otherwise assume it was stopped normally and return an empty demultiplexer packet
+    if (m_stopped.load() == true)
+    {
+
+      if (m_station_exception)
+        std::rethrow_exception(m_station_exception);
+      else
+        return allocator(0);
+    }
+
+    // Take everything that has been queued as the next batch
+    m_readqueue.swap(m_queue);
   }
 
-  // Pop off the topmost object from the queue<> and release the lock
-  std::unique_ptr<demux_packet_t> packet(std::move(m_queue.front()));
-  m_queue.pop();
-  lock.unlock();
+  // Pop off the topmost object from the batch; it's returned to the pool later
+  m_consumed.emplace_back(std::move(m_readqueue.front()));
+  m_readqueue.pop_front();
+  demux_packet_t const& packet = m_consumed.back();
 
   // The packet queue should never have a null packet in it
   assert(packet);
   if (!packet)
     return allocator(0);
 
+  // The packet is no longer part of the queued audio
+  m_queuedtime.fetch_sub(static_cast<int64_t>(packet->duration));
+
+  // Wake up a station event callback that is waiting for demux queue space
+  if (m_unpaced)
+  {
+
+    std::unique_lock<std::mutex> lock(m_queuelock);
+    m_cv.notify_all();
+  }
+
   // Allocate and initialize the DEMUX_PACKET
   DEMUX_PACKET* demuxpacket = allocator(packet->size);
   if (demuxpacket != nullptr)
@@ -273,7 +320,21 @@ void hdstream::demuxreset(void)
 
 std::string hdstream::devicename(void) const
 {
-  return std::string(m_device->get_device_name());
+  return m_station->devicename();
+}
+
+//---------------------------------------------------------------------------
+// hdstream::devicestatistics
+//
+// Gets the data transfer statistics for the device associated with the stream
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void hdstream::devicestatistics(struct rtldevice::device_statistics& stats) const
+{
+  m_station->devicestatistics(stats);
 }
 
 //---------------------------------------------------------------------------
@@ -336,19 +397,17 @@ std::string hdstream::muxname(void) const
 }
 
 //---------------------------------------------------------------------------
-// hdstream::nrsc5_callback (private, static)
+// hdstream::overruns
 //
-// NRSC5 library event callback function
+// Gets the number of times that data was dropped because the stream fell behind
 //
 // Arguments:
 //
-//	event	- NRSC5 event being raised
-//	arg		- Implementation-specific context pointer
+//	NONE
 
-void hdstream::nrsc5_callback(nrsc5_event_t const* event, void* arg)
+uint64_t hdstream::overruns(void) const
 {
-  assert(arg != nullptr);
-  reinterpret_cast<hdstream*>(arg)->nrsc5_callback(event);
+  return m_overruns.load();
 }
 
 //---------------------------------------------------------------------------
@@ -372,49 +431,45 @@ void hdstream::nrsc5_callback(nrsc5_event_t const* event)
   if (event->event == NRSC5_EVENT_AUDIO)
   {
 
-    // Filter out anything other than program zero for now
-    if (event->audio.program == (m_subchannel - 1))
+    // An unpaced input is decoded faster than real time; wait for the demux read function
+    // to make room in the queue instead of discarding the queued audio
+    if (m_unpaced)
     {
 
-      // Allocate an initialize a heap buffer and copy the audio data into it
-      size_t audiosize = event->audio.count * sizeof(int16_t);
-      std::unique_ptr<uint8_t[]> audiodata(new uint8_t[audiosize]);
-
-      // Apply the specified PCM output gain while copying the audio data into the packet buffer
-      int16_t* pcmdata = reinterpret_cast<int16_t*>(audiodata.get());
-      for (size_t index = 0; index < event->audio.count; index++)
-        pcmdata[index] = static_cast<int16_t>(event->audio.data[index] * m_pcmgain);
-
-      // Generate and queue the audio packet
-      std::unique_ptr<demux_packet_t> packet = std::make_unique<demux_packet_t>();
-      packet->streamid = STREAM_ID_AUDIO;
-      packet->size = static_cast<int>(audiosize);
-      packet->duration = (event->audio.count / 2.0 / 44100.0) * STREAM_TIME_BASE;
-      packet->dts = packet->pts = m_dts;
-      packet->data = std::move(audiodata);
+      m_cv.wait(lock, [&]() -> bool
+                { return (queuelength() < m_latency.limit()) || (m_stopped.load() == true); });
 
-      m_dts += packet->duration;
-
-      m_queue.emplace(std::move(packet));
-      queued = true;
+      if (m_stopped.load() == true)
+        return;
     }
-  }
 
-  // NRSC5_EVENT_BER
-  //
-  // Reporting the current bit error rate
-  else if (event->event == NRSC5_EVENT_BER)
-    m_ber.store(event->ber.cber);
-
-  // NRSC5_EVENT_MER
-  //
-  // Reporting the current modulatation error ratio
-  else if (event->event == NRSC5_EVENT_MER)
-  {
-
-    // Store the higher of the two values instead of the mean, some HD radio stations
-    // are allowed to transmit one sideband at a higher power than the other
-    m_mer.store(std::max(event->mer.lower, event->mer.upper));
+    // Trim the resampling rate to hold the amount of queued audio at the target latency,
+    // which compensates for the difference between the device and the consumer clocks
+    m_clock.target(m_latency.target());
+    double const rate = m_clock.update(queuelength());
+    size_t const frames = event->audio.count / 2;
+
+    // Acquire a pooled packet large enough to hold the resampled audio data; the station only
+    // raises audio events for the program that this stream has subscribed to
+    demux_packet_t packet =
+        m_packetpool.acquire(pcmresampler::maxoutput(frames, rate) * 2 * sizeof(int16_t));
+    int16_t* output = reinterpret_cast<int16_t*>(packet->data.get());
+
+    // Resample the audio data into the packet and apply the specified PCM output gain
+    size_t const outframes = m_resampler.resample(event->audio.data, frames, rate, output);
+    m_pcmgain.apply(output, outframes * 2);
+
+    // Stamp and queue the audio packet
+    packet->streamid = STREAM_ID_AUDIO;
+    packet->size = static_cast<int>(outframes * 2 * sizeof(int16_t));
+    packet->duration = (outframes / 44100.0) * STREAM_TIME_BASE;
+    packet->dts = packet->pts = m_dts;
+
+    m_dts += packet->duration;
+    m_queuedtime.fetch_add(static_cast<int64_t>(packet->duration));
+
+    m_queue.emplace_back(std::move(packet));
+    queued = true;
   }
 
 #ifdef KODI_HAS_ID3
@@ -424,58 +479,52 @@ void hdstream::nrsc5_callback(nrsc5_event_t const* event)
   else if (event->event == NRSC5_EVENT_ID3)
   {
 
-    // Filter out anything other than program zero for now
-    if (event->id3.program == 0)
-    {
+    size_t tagsize = 0; // Length of the ID3 tag
+    std::unique_ptr<uint8_t[]> tagdata; // ID3 tag data
 
-      size_t tagsize = 0; // Length of the ID3 tag
-      std::unique_ptr<uint8_t[]> tagdata; // ID3 tag data
+    // Check for a cached LOT data item that represents the primary image
+    if (event->id3.xhdr.mime == NRSC5_MIME_PRIMARY_IMAGE)
+    {
 
-      // Check for a cached LOT data item that represents the primary image
-      if (event->id3.xhdr.mime == NRSC5_MIME_PRIMARY_IMAGE)
+      auto const& lot = m_lots.find(event->id3.xhdr.lot);
+      if (lot != m_lots.end())
       {
 
-        auto const& lot = m_lots.find(event->id3.xhdr.lot);
-        if (lot != m_lots.end())
-        {
+        // Copy the raw ID3v2 tag data into an id3v2tag instance
+        std::unique_ptr<id3v2tag> newtag =
+            id3v2tag::create(event->id3.raw.data, event->id3.raw.size);
 
-          // Copy the raw ID3v2 tag data into an id3v2tag instance
-          std::unique_ptr<id3v2tag> newtag =
-              id3v2tag::create(event->id3.raw.data, event->id3.raw.size);
+        // Append an APIC cover art frame to the tag with the cached image and remove it from cache
+        newtag->coverart((lot->second.mime == NRSC5_MIME_JPEG) ? "image/jpeg" : "image/png",
+                         lot->second.data.get(), lot->second.size);
+        m_lots.erase(lot);
 
-          // Append an APIC cover art frame to the tag with the cached image and remove it from cache
-          newtag->coverart((lot->second.mime == NRSC5_MIME_JPEG) ? "image/jpeg" : "image/png",
-                           lot->second.data.get(), lot->second.size);
-          m_lots.erase(lot);
-
-          tagsize = newtag->size();
-          tagdata = std::unique_ptr<uint8_t[]>(new uint8_t[tagsize]);
-          if (!newtag->write(&tagdata[0], tagsize))
-            tagsize = 0;
-        }
+        tagsize = newtag->size();
+        tagdata = std::unique_ptr<uint8_t[]>(new uint8_t[tagsize]);
+        if (!newtag->write(&tagdata[0], tagsize))
+          tagsize = 0;
       }
+    }
 
-      // If a custom ID3 tag wasn't generated, use the raw ID3v2 tag data
-      if (!tagdata || (tagsize == 0))
-      {
+    // If a custom ID3 tag wasn't generated, use the raw ID3v2 tag data
+    if (!tagdata || (tagsize == 0))
+    {
 
-        tagsize = event->id3.raw.size;
-        tagdata = std::unique_ptr<uint8_t[]>(new uint8_t[tagsize]);
-        memcpy(&tagdata[0], event->id3.raw.data, event->id3.raw.size);
-      }
+      tagsize = event->id3.raw.size;
+      tagdata = std::unique_ptr<uint8_t[]>(new uint8_t[tagsize]);
+      memcpy(&tagdata[0], event->id3.raw.data, event->id3.raw.size);
+    }
 
-      // If the ID3 tag data was generated, queue it as a demux packet
-      if (tagdata && (tagsize > 0))
-      {
+    // If the ID3 tag data was generated, queue it as a demux packet
+    if (tagdata && (tagsize > 0))
+    {
 
-        std::unique_ptr<demux_packet_t> packet = std::make_unique<demux_packet_t>();
-        packet->streamid = 2;
-        packet->size = static_cast<int>(tagsize);
-        packet->data = std::move(tagdata);
+      demux_packet_t packet = m_packetpool.acquire(tagsize);
+      packet->streamid = 2;
+      memcpy(packet->data.get(), tagdata.get(), tagsize);
 
-        m_queue.emplace(std::move(packet));
-        queued = true;
-      }
+      m_queue.emplace_back(std::move(packet));
+      queued = true;
     }
   }
 
@@ -502,20 +551,26 @@ void hdstream::nrsc5_callback(nrsc5_event_t const* event)
   if (queued)
   {
 
-    // If the queue size has exceeded the maximum, the packets aren't
+    // If the queued audio has exceeded the latency limit, the packets aren't
     // being processed quickly enough by the demux read function
-    if (m_queue.size() > MAX_PACKET_QUEUE)
+    if (queuelength() >= m_latency.limit())
     {
 
-      m_queue = demux_queue_t(); // Replace the queue<>
+      for (auto const& item : m_queue)
+        m_queuedtime.fetch_sub(static_cast<int64_t>(item->duration));
+
+      m_packetpool.release(m_queue.begin(), m_queue.end());
+      m_queue.clear(); // Empty the deque<>
+      m_overruns.fetch_add(1); // Count the overrun
 
-      // Push a DEMUX_SPECIALID_STREAMCHANGE packet into the new queue
-      std::unique_ptr<demux_packet_t> packet = std::make_unique<demux_packet_t>();
+      // Push a DEMUX_SPECIALID_STREAMCHANGE packet into the emptied queue
+      demux_packet_t packet = m_packetpool.acquire(0);
       packet->streamid = DEMUX_SPECIALID_STREAMCHANGE;
-      m_queue.emplace(std::move(packet));
+      m_queue.emplace_back(std::move(packet));
 
-      // Reset the decode time stamp
+      // Reset the decode time stamp and the output clock recovery
       m_dts = STREAM_TIME_BASE;
+      m_clock.reset();
     }
 
     m_cv.notify_all(); // Notify queue was updated
@@ -536,6 +591,20 @@ long long hdstream::position(void) const
   return -1;
 }
 
+//---------------------------------------------------------------------------
+// hdstream::queuelength (private)
+//
+// Gets the duration of the audio in the demux queue, in milliseconds
+//
+// Arguments:
+//
+//	NONE
+
+double hdstream::queuelength(void) const
+{
+  return (m_queuedtime.load() * 1000.0) / STREAM_TIME_BASE;
+}
+
 //---------------------------------------------------------------------------
 // hdstream::read
 //
@@ -580,6 +649,22 @@ long long hdstream::seek(long long /*position*/, int /*whence*/)
   return -1;
 }
 
+//---------------------------------------------------------------------------
+// hdstream::seektime
+//
+// Sets the stream pointer to a specific time
+//
+// Arguments:
+//
+//	time		- Time to seek to, in milliseconds
+//	backwards	- Flag indicating a backwards seek
+//	startpts	- On success, receives the PTS of the first packet after the seek
+
+bool hdstream::seektime(double /*time*/, bool /*backwards*/, double& /*startpts*/)
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // hdstream::servicename
 //
@@ -605,62 +690,21 @@ std::string hdstream::servicename(void) const
 
 void hdstream::signalquality(int& quality, int& snr) const
 {
-  // For signal quality, use the NRSC5 Bit Error Rate (BER). A BER of zero
-  // implies ideal signal quality. I have no idea what the BER tolerance
-  // is for decoding HD Radio, but from observation a BER with a value
-  // higher than 0.1 is effectively undecodable so let's call that zero
-  float ber = m_ber.load();
-  ber = std::min(std::max(ber, 0.0f), 0.1f) * 100.0f;
-  quality = static_cast<int>(((ber - 100.0f) * 100.0f) / -100.0f);
-
-  // For signal-to-noise ratio, use the NRSC5 Modulation Error Ratio (MER).
-  // A MER of 14 is apparently the ideal for HD Radio, so for now use
-  // a linear scale from (0...13) to define the SNR percentage
-  float mer = m_mer.load();
-  mer = std::max(std::min(13.0f, mer), 0.0f);
-  snr = static_cast<int>((mer * 100.0f) / 13.0f);
+  m_station->signalquality(quality, snr);
 }
 
 //---------------------------------------------------------------------------
-// hdstream::worker (private)
+// hdstream::streamtimes
 //
-// Worker thread procedure used to transfer data from the device
+// Gets the time shift boundaries of the stream
 //
 // Arguments:
 //
-//	started		- Condition variable to set when thread has started
+//	times		- Structure to receive the stream times
 
-void hdstream::worker(scalar_condition<bool>& started)
+bool hdstream::streamtimes(struct streamtimes& /*times*/) const
 {
-  assert(m_device);
-  assert(m_nrsc5);
-
-  // read_callback_func (local)
-  //
-  // Asynchronous read callback function for the RTL-SDR device
-  auto read_callback_func = [&](uint8_t const* buffer, size_t count) -> void
-  {
-    // Pipe the samples into NRSC5, it will invoke the necessary callback(s)
-    nrsc5_pipe_samples_cu8(m_nrsc5, const_cast<uint8_t*>(buffer), static_cast<unsigned int>(count));
-  };
-
-  // Begin streaming from the device and inform the caller that the thread is running
-  m_device->begin_stream();
-  started = true;
-
-  // Continuously read data from the device until cancel_async() has been called
-  // 32 KiB = ~1/100 of a second of data
-  try
-  {
-    m_device->read_async(read_callback_func, 32 KiB);
-  }
-  catch (...)
-  {
-    m_worker_exception = std::current_exception();
-  }
-
-  m_stopped.store(true); // Thread is stopped
-  m_cv.notify_all(); // Unblock any waiters
+  return false;
 }
 
 //---------------------------------------------------------------------------
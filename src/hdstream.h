@@ -24,26 +24,30 @@
 #define __HDSTREAM_H_
 #pragma once
 
-#include "dsp_hd/nrsc5.h"
+#include "hdstation.h"
+#include "pcmresampler.h"
 #include "props.h"
 #include "pvrstream.h"
-#include "rtldevice.h"
-#include "utils/scalar_condition.h"
+#include "utils/clockrecovery.h"
+#include "utils/latencycontrol.h"
+#include "utils/packetpool.h"
+#include "utils/pcmgain.h"
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <exception>
 #include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
-#include <thread>
+#include <vector>
 
 #pragma warning(push, 4)
 
 //---------------------------------------------------------------------------
 // Class hdstream
 //
-// Implements an HD Radio stream
+// Implements an HD Radio stream as a subscriber to a shared HD Radio station
 
 class hdstream : public pvrstream
 {
@@ -55,6 +59,11 @@ public:
   //-----------------------------------------------------------------------
   // Member Functions
 
+  // canpause
+  //
+  // Flag indicating if the stream allows pause operations
+  bool canpause(void) const override;
+
   // canseek
   //
   // Flag indicating if the stream allows seek operations
@@ -68,9 +77,7 @@ public:
   // create (static)
   //
   // Factory method, creates a new hdstream instance
-  static std::unique_ptr<hdstream> create(std::unique_ptr<rtldevice> device,
-                                          struct tunerprops const& tunerprops,
-                                          struct channelprops const& channelprops,
+  static std::unique_ptr<hdstream> create(std::shared_ptr<hdstation> station,
                                           struct hdprops const& hdprops,
                                           uint32_t subchannel);
 
@@ -99,6 +106,11 @@ public:
   // Gets the device name associated with the stream
   std::string devicename(void) const override;
 
+  // devicestatistics
+  //
+  // Gets the data transfer statistics for the device associated with the stream
+  void devicestatistics(struct rtldevice::device_statistics& stats) const override;
+
   // enumproperties
   //
   // Enumerates the stream properties
@@ -115,6 +127,11 @@ public:
   // Gets the mux name associated with the stream
   std::string muxname(void) const override;
 
+  // overruns
+  //
+  // Gets the number of times that data was dropped because the stream fell behind
+  uint64_t overruns(void) const override;
+
   // position
   //
   // Gets the current position of the stream
@@ -135,6 +152,11 @@ public:
   // Sets the stream pointer to a specific position
   long long seek(long long position, int whence) override;
 
+  // seektime
+  //
+  // Sets the stream pointer to a specific time
+  bool seektime(double time, bool backwards, double& startpts) override;
+
   // servicename
   //
   // Gets the service name associated with the stream
@@ -145,19 +167,24 @@ public:
   // Gets the signal quality as percentages
   void signalquality(int& quality, int& snr) const override;
 
+  // streamtimes
+  //
+  // Gets the time shift boundaries of the stream
+  bool streamtimes(struct streamtimes& times) const override;
+
 private:
   hdstream(hdstream const&) = delete;
   hdstream& operator=(hdstream const&) = delete;
 
-  // MAX_PACKET_QUEUE
+  // DEFAULT_PAYLOAD_SIZE
   //
-  // Maximum number of queued demux packets
-  static size_t const MAX_PACKET_QUEUE;
+  // Default length of a pooled demux packet payload buffer
+  static size_t const DEFAULT_PAYLOAD_SIZE;
 
-  // SAMPLE_RATE
+  // PACKET_POOL_SIZE
   //
-  // Fixed device sample rate required for HD Radio
-  static uint32_t const SAMPLE_RATE;
+  // Number of demux packets preallocated in the packet pool
+  static size_t const PACKET_POOL_SIZE;
 
   // STREAM_ID_AUDIO
   //
@@ -171,33 +198,20 @@ private:
 
   // Instance Constructor
   //
-  hdstream(std::unique_ptr<rtldevice> device,
-           struct tunerprops const& tunerprops,
-           struct channelprops const& channelprops,
-           struct hdprops const& hdprops,
-           uint32_t subchannel);
+  hdstream(std::shared_ptr<hdstation> station, struct hdprops const& hdprops, uint32_t subchannel);
 
   //-----------------------------------------------------------------------
   // Private Type Declarations
 
   // demux_packet_t
   //
-  // Defines the conents of a queued demux packet
-  struct demux_packet_t
-  {
-
-    int streamid = 0;
-    int size = 0;
-    double duration = 0;
-    double dts = 0;
-    double pts = 0;
-    std::unique_ptr<uint8_t[]> data;
-  };
+  // Defines the type of a queued demux packet
+  using demux_packet_t = packetpool::packet_ptr;
 
   // demux_queue_t
   //
   // Defines the type of the demux queue
-  using demux_queue_t = std::queue<std::unique_ptr<demux_packet_t>>;
+  using demux_queue_t = std::deque<demux_packet_t>;
 
   // lot_item_t
   //
@@ -218,44 +232,45 @@ private:
   //-----------------------------------------------------------------------
   // Private Member Functions
 
-  // nrsc5_callback (static)
-  //
-  // NRSC5 library event callback function
-  static void nrsc5_callback(nrsc5_event_t const* event, void* arg);
-
   // nrsc5_callback
   //
   // NRSC5 library event callback function
   void nrsc5_callback(nrsc5_event_t const* event);
 
-  // worker
+  // queuelength
   //
-  // Worker thread procedure used to transfer data from the device
-  void worker(scalar_condition<bool>& started);
+  // Gets the duration of the audio in the demux queue, in milliseconds
+  double queuelength(void) const;
 
   //-----------------------------------------------------------------------
   // Member Variables
 
-  std::unique_ptr<rtldevice> m_device; // RTL-SDR device instance
-  nrsc5_t* m_nrsc5; // NRSC5 demodulator handle
+  std::shared_ptr<hdstation> m_station; // Shared HD Radio station instance
+  unsigned int m_subscription{0}; // Station subscription identifier
 
   uint32_t const m_subchannel; // Multiplex subchannel number
+  bool const m_unpaced; // Flag to wait for demux queue space
+  bool const m_freerun; // Flag if the output is not paced by the player
   std::string m_muxname; // Generated mux name
-  float const m_pcmgain; // Output gain
+  pcmgain const m_pcmgain; // Output gain
   double m_dts{STREAM_TIME_BASE}; // Current decode time stamp
-  std::atomic<float> m_mer{0}; // Current modulation error ratio
-  std::atomic<float> m_ber{0}; // Current bit erorr rate
+  latencycontrol m_latency; // Output latency control
+  pcmresampler m_resampler; // Output clock resampler
+  clockrecovery m_clock; // Output clock recovery
   lot_map_t m_lots; // Cached LOT item data
 
   // STREAM CONTROL
   //
-  demux_queue_t m_queue; // queue<> of demux objects
+  packetpool m_packetpool; // Pool of recycled demux packets
+  demux_queue_t m_queue; // deque<> of demux objects
   mutable std::mutex m_queuelock; // Synchronization object
   std::condition_variable m_cv; // Transfer event condvar
-  std::thread m_worker; // Data transfer thread
-  std::exception_ptr m_worker_exception; // Exception on worker thread
-  scalar_condition<bool> m_stop{false}; // Condition to stop data transfer
-  std::atomic<bool> m_stopped{false}; // Data transfer stopped flag
+  demux_queue_t m_readqueue; // Batch of demux objects being read
+  std::vector<demux_packet_t> m_consumed; // Demux objects to return to the pool
+  std::atomic<int64_t> m_queuedtime{0}; // Duration of the queued demux objects
+  std::exception_ptr m_station_exception; // Exception that stopped the station
+  std::atomic<bool> m_stopped{false}; // Station stopped flag
+  std::atomic<uint64_t> m_overruns{0}; // Number of demux queue overruns
 };
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+
+#include "pcmresampler.h"
+
+#include <algorithm>
+#include <assert.h>
+
+#pragma warning(push, 4)
+
+// pcmresampler::MAX_INPUT_FRAMES (static)
+//
+// Maximum number of input frames processed by the resampler at once
+size_t const pcmresampler::MAX_INPUT_FRAMES = 4096;
+
+//---------------------------------------------------------------------------
+// pcmresampler Constructor
+//
+// Arguments:
+//
+//	NONE
+
+pcmresampler::pcmresampler() : m_input(new TYPECPX[MAX_INPUT_FRAMES])
+{
+  m_resampler.Init(static_cast<int>(MAX_INPUT_FRAMES));
+}
+
+//---------------------------------------------------------------------------
+// pcmresampler::maxoutput (static)
+//
+// Gets the maximum number of output frames that can be generated for the input
+//
+// Arguments:
+//
+//	frames		- Number of input frames
+//	rate		- Resampling rate (input rate / output rate)
+
+size_t pcmresampler::maxoutput(size_t frames, double rate)
+{
+  assert(rate > 0.0);
+
+  // Each chunk of input can generate one fractional frame more than the ratio suggests
+  size_t const chunks = (frames + MAX_INPUT_FRAMES - 1) / MAX_INPUT_FRAMES;
+  return static_cast<size_t>(frames / rate) + chunks + 1;
+}
+
+//---------------------------------------------------------------------------
+// pcmresampler::reset
+//
+// Resets the resampler state after a discontinuity in the input
+//
+// Arguments:
+//
+//	NONE
+
+void pcmresampler::reset(void)
+{
+  m_resampler.Init(static_cast<int>(MAX_INPUT_FRAMES));
+}
+
+//---------------------------------------------------------------------------
+// pcmresampler::resample
+//
+// Resamples stereo frames at the specified rate (input rate / output rate)
+//
+// Arguments:
+//
+//	input		- Interleaved 16-bit stereo input frames
+//	frames		- Number of input frames
+//	rate		- Resampling rate (input rate / output rate)
+//	output		- Output buffer, must be at least maxoutput() frames in length
+
+size_t pcmresampler::resample(int16_t const* input, size_t frames, double rate, int16_t* output)
+{
+  assert((input != nullptr) && (output != nullptr));
+
+  size_t outframes = 0; // Number of generated output frames
+
+  while (frames > 0)
+  {
+
+    // Convert the next chunk of input frames into the resampler input format
+    size_t const count = std::min(frames, MAX_INPUT_FRAMES);
+    for (size_t index = 0; index < count; index++)
+    {
+
+      m_input[index].re = static_cast<TYPEREAL>(input[(index * 2)]);
+      m_input[index].im = static_cast<TYPEREAL>(input[(index * 2) + 1]);
+    }
+
+    outframes += m_resampler.Resample(static_cast<int>(count), static_cast<TYPEREAL>(rate),
+                                      m_input.get(),
+                                      reinterpret_cast<TYPESTEREO16*>(output + (outframes * 2)),
+                                      1.0);
+
+    input += (count * 2);
+    frames -= count;
+  }
+
+  return outframes;
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
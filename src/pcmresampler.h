@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __PCMRESAMPLER_H_
+#define __PCMRESAMPLER_H_
+#pragma once
+
+#include "dsp_fm/fractresampler.h"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class pcmresampler
+//
+// Resamples interleaved 16-bit stereo PCM audio at an arbitrary and continuously
+// variable ratio; used to apply the output clock correction to decoded audio that
+// doesn't otherwise pass through a resampler
+
+class pcmresampler
+{
+public:
+  // Instance Constructor
+  //
+  pcmresampler();
+
+  // Destructor
+  //
+  ~pcmresampler() = default;
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // maxoutput (static)
+  //
+  // Gets the maximum number of output frames that can be generated for the input
+  static size_t maxoutput(size_t frames, double rate);
+
+  // reset
+  //
+  // Resets the resampler state after a discontinuity in the input
+  void reset(void);
+
+  // resample
+  //
+  // Resamples stereo frames at the specified rate (input rate / output rate)
+  size_t resample(int16_t const* input, size_t frames, double rate, int16_t* output);
+
+private:
+  pcmresampler(pcmresampler const&) = delete;
+  pcmresampler& operator=(pcmresampler const&) = delete;
+
+  // MAX_INPUT_FRAMES
+  //
+  // Maximum number of input frames processed by the resampler at once
+  static size_t const MAX_INPUT_FRAMES;
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  CFractResampler<> m_resampler; // CuteSDR resampler instance
+  std::unique_ptr<TYPECPX[]> m_input; // Converted input frames
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __PCMRESAMPLER_H_
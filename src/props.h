@@ -55,6 +55,10 @@ struct dabprops
   float outputgain; // Output gain in Decibels
   bool coarse_corrector; // Flage for coarse corrector (for receivers with >1kHz error)
   int coarse_corrector_type; // Coarse corrector frequency sync method
+  bool passthrough; // Flag to output undecoded MP2/AAC audio
+  uint32_t outputlatency; // Output latency in milliseconds
+  bool adaptivelatency; // Flag to adapt the output latency to underruns
+  bool freerun; // Flag if the output is drained by a timeshift buffer
 };
 
 // fmprops
@@ -64,11 +68,15 @@ struct fmprops
 {
 
   bool decoderds; // Flag if RDS should be decoded or not
+  bool decimate; // Flag if I/Q samples should be decimated
   bool isnorthamerica; // Flag if region is North America
   uint32_t samplerate; // Input sample rate in Hertz
   int downsamplequality; // Downsample quality setting
   uint32_t outputrate; // Output sample rate in Hertz
   float outputgain; // Output gain in Decibels
+  uint32_t outputlatency; // Output latency in milliseconds
+  bool adaptivelatency; // Flag to adapt the output latency to underruns
+  bool freerun; // Flag if the output is drained by a timeshift buffer
 };
 
 // hdprops
@@ -78,6 +86,9 @@ struct hdprops
 {
 
   float outputgain; // Output gain in Decibels
+  uint32_t outputlatency; // Output latency in milliseconds
+  bool adaptivelatency; // Flag to adapt the output latency to underruns
+  bool freerun; // Flag if the output is drained by a timeshift buffer
 };
 
 // modulation
@@ -143,6 +154,17 @@ struct streamprops
   int bitspersample; // Stream bits per sample
 };
 
+// streamtimes
+//
+// Defines the time shift boundaries of a stream
+struct streamtimes
+{
+
+  double ptsstart; // PTS of the start of the stream
+  double ptsbegin; // PTS of the earliest available packet
+  double ptsend; // PTS of the latest available packet
+};
+
 // subchannelprops
 //
 // Defines properties for a radio subchannel
@@ -161,6 +183,8 @@ struct tunerprops
 {
 
   int freqcorrection; // Frequency correction (PPM)
+  uint32_t buffercount; // Number of device transfer buffers (0 = default)
+  uint32_t bufferlength; // Length of each device transfer buffer (0 = default)
 };
 
 // wxprops
@@ -169,9 +193,13 @@ struct tunerprops
 struct wxprops
 {
 
+  bool decimate; // Flag if I/Q samples should be decimated
   uint32_t samplerate; // Input sample rate in Hertz
   uint32_t outputrate; // Output sample rate in Hertz
   float outputgain; // Output gain in Decibels
+  uint32_t outputlatency; // Output latency in milliseconds
+  bool adaptivelatency; // Flag to adapt the output latency to underruns
+  bool freerun; // Flag if the output is drained by a timeshift buffer
 };
 
 //-----------------------------------------------------------------------------
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "props.h"
+#include "rtldevice.h"
 
 #include <functional>
 #include <kodi/addon-instance/PVR.h>
@@ -48,6 +49,11 @@ public:
   //-----------------------------------------------------------------------
   // Member Functions
 
+  // canpause
+  //
+  // Flag indicating if the stream allows pause operations
+  virtual bool canpause(void) const = 0;
+
   // canseek
   //
   // Flag indicating if the stream allows seek operations
@@ -83,6 +89,11 @@ public:
   // Gets the device name associated with the stream
   virtual std::string devicename(void) const = 0;
 
+  // devicestatistics
+  //
+  // Gets the data transfer statistics for the device associated with the stream
+  virtual void devicestatistics(struct rtldevice::device_statistics& stats) const = 0;
+
   // enumproperties
   //
   // Enumerates the stream properties
@@ -99,6 +110,11 @@ public:
   // Gets the mux name associated with the stream
   virtual std::string muxname(void) const = 0;
 
+  // overruns
+  //
+  // Gets the number of times that data was dropped because the stream fell behind
+  virtual uint64_t overruns(void) const = 0;
+
   // position
   //
   // Gets the current position of the stream
@@ -119,6 +135,11 @@ public:
   // Sets the stream pointer to a specific position
   virtual long long seek(long long position, int whence) = 0;
 
+  // seektime
+  //
+  // Sets the stream pointer to a specific time
+  virtual bool seektime(double time, bool backwards, double& startpts) = 0;
+
   // servicename
   //
   // Gets the service name associated with the stream
@@ -129,6 +150,11 @@ public:
   // Gets the signal quality as percentages
   virtual void signalquality(int& quality, int& snr) const = 0;
 
+  // streamtimes
+  //
+  // Gets the time shift boundaries of the stream
+  virtual bool streamtimes(struct streamtimes& times) const = 0;
+
 private:
   pvrstream(pvrstream const&) = delete;
   pvrstream& operator=(pvrstream const&) = delete;
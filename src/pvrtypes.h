@@ -68,6 +68,17 @@ enum downsample_quality
   maximum = 2, // Optimize for quality
 };
 
+// streaming_profile
+//
+// Defines the device data transfer buffer profile
+enum streaming_profile
+{
+
+  lowlatency = 0, // Fewer, smaller buffers
+  balanced = 1, // Default buffers
+  robust = 2, // More, larger buffers
+};
+
 // settings
 //
 // Defines all of the configurable addon settings
@@ -94,6 +105,31 @@ struct settings
   // Frequency correction calibration value for the device
   int device_frequency_correction;
 
+  // device_streaming_profile
+  //
+  // Device data transfer buffer profile
+  enum streaming_profile device_streaming_profile;
+
+  // device_stream_cache_period
+  //
+  // Number of seconds to keep a DAB/HD Radio pipeline running after the stream is closed
+  int device_stream_cache_period;
+
+  // device_capture_enable
+  //
+  // Flag to capture the raw I/Q samples to disk during live playback
+  bool device_capture_enable;
+
+  // device_capture_folder
+  //
+  // Folder in which to create the raw I/Q sample capture files
+  std::string device_capture_folder;
+
+  // device_rawfile_speed
+  //
+  // Playback speed of a raw I/Q sample file as a multiple of real time; zero is unpaced
+  int device_rawfile_speed;
+
   // device_connection_tcp_port
   //
   // The port number of the rtl_tcp host to connect to
@@ -119,6 +155,11 @@ struct settings
   // Sample rate value for the FM DSP
   int fmradio_sample_rate;
 
+  // fmradio_frontend_decimation
+  //
+  // Flag to decimate the I/Q samples ahead of the FM DSP
+  bool fmradio_frontend_decimation;
+
   // fmradio_downsample_quality
   //
   // Specifies the FM DSP downsample quality factor
@@ -134,6 +175,16 @@ struct settings
   // Specifies the output gain for the FM DSP
   float fmradio_output_gain;
 
+  // fmradio_output_latency
+  //
+  // Specifies the output buffer latency for the FM DSP in milliseconds
+  int fmradio_output_latency;
+
+  // fmradio_adaptive_latency
+  //
+  // Flag to adapt the output buffer latency of the FM DSP to underruns
+  bool fmradio_adaptive_latency;
+
   // hdradio_enable
   //
   // Enables the HD Radio DSP
@@ -149,6 +200,16 @@ struct settings
   // Specifies the output gain for the HD DSP
   float hdradio_output_gain;
 
+  // hdradio_output_latency
+  //
+  // Specifies the output buffer latency for the HD DSP in milliseconds
+  int hdradio_output_latency;
+
+  // hdradio_adaptive_latency
+  //
+  // Flag to adapt the output buffer latency of the HD DSP to underruns
+  bool hdradio_adaptive_latency;
+
   // dabradio_enable
   //
   // Enables/disables the DAB DSP
@@ -169,6 +230,21 @@ struct settings
   // Coarse corrector frequency sync method
   int dabradio_coarse_corrector_type;
 
+  // dabradio_passthrough
+  //
+  // Flag to output undecoded MP2/AAC audio from the DAB DSP
+  bool dabradio_passthrough;
+
+  // dabradio_output_latency
+  //
+  // Specifies the output buffer latency for the DAB DSP in milliseconds
+  int dabradio_output_latency;
+
+  // dabradio_adaptive_latency
+  //
+  // Flag to adapt the output buffer latency of the DAB DSP to underruns
+  bool dabradio_adaptive_latency;
+
   // wxradio_enable
   //
   // Enables the WX DSP
@@ -179,6 +255,11 @@ struct settings
   // Sample rate value for the WX DSP
   int wxradio_sample_rate;
 
+  // wxradio_frontend_decimation
+  //
+  // Flag to decimate the I/Q samples ahead of the WX DSP
+  bool wxradio_frontend_decimation;
+
   // wxradio_output_samplerate
   //
   // Specifies the output sample rate for the WX DSP
@@ -188,6 +269,31 @@ struct settings
   //
   // Specified the output gain for the WX DSP
   float wxradio_output_gain;
+
+  // wxradio_output_latency
+  //
+  // Specifies the output buffer latency for the WX DSP in milliseconds
+  int wxradio_output_latency;
+
+  // wxradio_adaptive_latency
+  //
+  // Flag to adapt the output buffer latency of the WX DSP to underruns
+  bool wxradio_adaptive_latency;
+
+  // timeshift_enable
+  //
+  // Flag to buffer live streams to disk to allow pause and rewind
+  bool timeshift_enable;
+
+  // timeshift_folder
+  //
+  // Folder in which to create the timeshift buffer files
+  std::string timeshift_folder;
+
+  // timeshift_buffer_size
+  //
+  // Size of the timeshift buffer file in megabytes
+  int timeshift_buffer_size;
 };
 
 //---------------------------------------------------------------------------
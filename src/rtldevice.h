@@ -43,6 +43,23 @@ public:
   // Callback function passed to readasync
   using asynccallback = std::function<void(uint8_t const*, size_t)>;
 
+  // device_statistics
+  //
+  // Structure used to report the data transfer statistics of the device
+  struct device_statistics
+  {
+
+    uint64_t bytes; // Total number of bytes transferred
+    uint64_t bytespersecond; // Average transfer rate
+    uint64_t stalltime; // Time that transfers were late, in milliseconds
+    uint64_t longestgap; // Longest gap between transfers, in milliseconds
+    uint64_t transfers; // Total number of transfers
+    uint64_t droppedtransfers; // Number of transfers presumed lost by the device
+    uint64_t jitter; // Mean transfer arrival time deviation, in microseconds
+    uint64_t capturedbytes; // Number of bytes written to a capture file
+    uint64_t capturedropped; // Number of bytes left out of a capture file
+  };
+
   // Constructor / Destructor
   //
   rtldevice() {}
@@ -71,6 +88,17 @@ public:
   // Gets the valid tuner gain values for the device
   virtual void get_valid_gains(std::vector<int>& dbs) const = 0;
 
+  // get_statistics
+  //
+  // Gets the data transfer statistics for the device
+  virtual void get_statistics(struct device_statistics& stats) const = 0;
+
+  // is_unpaced
+  //
+  // Determines if the device delivers data as fast as it can be consumed; asynchronous read
+  // callbacks should wait for room to process the data instead of dropping it
+  virtual bool is_unpaced(void) const = 0;
+
   // read
   //
   // Reads data from the device
@@ -78,8 +106,10 @@ public:
 
   // read_async
   //
-  // Asynchronously reads data from the device
-  virtual void read_async(asynccallback const& callback, uint32_t bufferlength) const = 0;
+  // Asynchronously reads data from the device; a buffer count of zero uses the device default
+  virtual void read_async(asynccallback const& callback,
+                          uint32_t bufferlength,
+                          uint32_t buffercount) const = 0;
 
   // set_automatic_gain_control
   //
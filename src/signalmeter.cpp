@@ -184,27 +184,16 @@ void signalmeter::processsamples(void)
     for (size_t iterations = 0; iterations < (available / m_fftsize); iterations++)
     {
 
-      // Convert the raw 8-bit I/Q samples into scaled complex I/Q samples
-      for (size_t index = 0; index < m_fftsize; index++)
-      {
-
-        // The FFT expects the I/Q samples in the range of -32767.0 through +32767.0
-        // (32767.0 / 127.5) = 256.9960784313725
-        samples[index] = {
-
-#ifdef FMDSP_USE_DOUBLE_PRECISION
-            (static_cast<TYPEREAL>(m_buffer[m_tail]) - 127.5) * 256.9960784313725, // I
-            (static_cast<TYPEREAL>(m_buffer[m_tail + 1]) - 127.5) * 256.9960784313725, // Q
-#else
-            (static_cast<TYPEREAL>(m_buffer[m_tail]) - 127.5f) * 256.9960784313725f, // I
-            (static_cast<TYPEREAL>(m_buffer[m_tail + 1]) - 127.5f) * 256.9960784313725f, // Q
-#endif
-        };
-
-        m_tail += 2;
-        if (m_tail >= RING_BUFFER_SIZE)
-          m_tail = 0;
-      }
+      // Convert the raw 8-bit I/Q samples into scaled complex I/Q samples; the FFT expects the
+      // I/Q samples in the range of -32767.0 through +32767.0.  If the samples wrap around the
+      // end of the ring buffer they need to be converted in two pieces
+      size_t contiguous = std::min(m_fftsize, (RING_BUFFER_SIZE - m_tail) / 2);
+      m_converter.convert(&m_buffer[m_tail], reinterpret_cast<TYPEREAL*>(&samples[0]), contiguous);
+      if (contiguous < m_fftsize)
+        m_converter.convert(&m_buffer[0], reinterpret_cast<TYPEREAL*>(&samples[contiguous]),
+                            m_fftsize - contiguous);
+
+      m_tail = (m_tail + (m_fftsize * 2)) % RING_BUFFER_SIZE;
 
       size_t numsamples = m_fftsize;
 
@@ -27,6 +27,7 @@
 #include "dsp_fm/fastfir.h"
 #include "dsp_fm/fft.h"
 #include "props.h"
+#include "utils/iqconverter.h"
 
 #include <functional>
 #include <memory>
@@ -128,9 +129,10 @@ private:
 
   // FFT
   //
-  CFastFIR m_fir; // Finite impulse response filter
+  // The meter keeps the locking DSP instances, unlike the streaming path
+  CFastFIR<TYPEREAL, CMutexLock> m_fir; // Finite impulse response filter
   size_t m_fftsize{DEFAULT_FFT_SIZE}; // FFT size (bins)
-  CFft m_fft; // FFT instance
+  CFft<TYPEREAL, CMutexLock> m_fft; // FFT instance
   size_t m_fftminbytes{0}; // Number of bytes required to process
   float m_avgpower{NAN}; // Average power level
   float m_avgnoise{NAN}; // Average noise level
@@ -138,6 +140,7 @@ private:
   // RING BUFFER
   //
   std::unique_ptr<uint8_t[]> m_buffer; // Input ring buffer
+  iqconverter m_converter{127.5f, 256.9960784313725f}; // I/Q sample converter
   size_t m_head{0}; // Ring buffer head position
   size_t m_tail{0}; // Ring buffer tail position
 };
@@ -0,0 +1,194 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "streamcache.h"
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// streamcache Destructor
+
+streamcache::~streamcache()
+{
+  clear();
+}
+
+//---------------------------------------------------------------------------
+// streamcache::acquire
+//
+// Cancels the grace period of the cached pipeline and determines if it can be
+// reused for the specified key; a pipeline that cannot be reused is released
+//
+// Arguments:
+//
+//	key			- Key of the live stream being opened
+
+bool streamcache::acquire(struct key const& key)
+{
+  std::shared_ptr<void> pipeline; // Pipeline to be released
+
+  cancel(); // Stop the grace period timer
+
+  std::unique_lock<std::mutex> lock(m_lock);
+
+  if (!m_pipeline)
+    return false;
+
+  // Keep the cached pipeline if it matches the device, frequency, modulation and audio output
+  if ((m_key.device == key.device) && (m_key.frequency == key.frequency) &&
+      (m_key.modulation == key.modulation) && (m_key.passthrough == key.passthrough))
+    return true;
+
+  // The pipeline has to be released before a new device can be opened; do that
+  // outside of the lock since it will wait for the pipeline threads to stop
+  pipeline = std::move(m_pipeline);
+  lock.unlock();
+
+  return false;
+}
+
+//---------------------------------------------------------------------------
+// streamcache::attach
+//
+// Attaches the pipeline of a newly opened live stream to the cache
+//
+// Arguments:
+//
+//	key			- Key of the live stream that was opened
+//	pipeline	- Pipeline of the live stream that was opened
+
+void streamcache::attach(struct key const& key, std::shared_ptr<void> pipeline)
+{
+  std::shared_ptr<void> previous; // Pipeline to be released
+
+  cancel(); // Stop the grace period timer
+
+  std::unique_lock<std::mutex> lock(m_lock);
+
+  previous = std::move(m_pipeline);
+  m_key = key;
+  m_pipeline = std::move(pipeline);
+}
+
+//---------------------------------------------------------------------------
+// streamcache::cancel (private)
+//
+// Cancels the grace period timer, if it is running
+//
+// Arguments:
+//
+//	NONE
+
+void streamcache::cancel(void)
+{
+  std::unique_lock<std::mutex> lock(m_timerlock);
+
+  if (m_timer.joinable())
+  {
+
+    m_cancel = true; // Signal the timer to stop
+    m_timer.join(); // Wait for the thread
+    m_cancel = false; // Reset the cancellation condition
+  }
+}
+
+//---------------------------------------------------------------------------
+// streamcache::clear
+//
+// Releases the cached pipeline
+//
+// Arguments:
+//
+//	NONE
+
+void streamcache::clear(void)
+{
+  std::shared_ptr<void> pipeline; // Pipeline to be released
+
+  cancel(); // Stop the grace period timer
+
+  std::unique_lock<std::mutex> lock(m_lock);
+  pipeline = std::move(m_pipeline);
+  lock.unlock();
+}
+
+//---------------------------------------------------------------------------
+// streamcache::detach
+//
+// Detaches the pipeline of a closed live stream; the pipeline is released once
+// the grace period has elapsed unless acquire() has been called in the meantime.
+// Returns true if a pipeline is being kept for the grace period
+//
+// Arguments:
+//
+//	graceperiodms	- Grace period in milliseconds
+
+bool streamcache::detach(uint32_t graceperiodms)
+{
+  cancel(); // Stop any previous grace period timer
+
+  // Release the pipeline immediately if there is no grace period
+  if (graceperiodms == 0)
+  {
+
+    clear();
+    return false;
+  }
+
+  // There is nothing to do if there is no cached pipeline
+  std::unique_lock<std::mutex> lock(m_lock);
+  if (!m_pipeline)
+    return false;
+  lock.unlock();
+
+  std::unique_lock<std::mutex> timerlock(m_timerlock);
+  m_timer = std::thread(&streamcache::timer, this, graceperiodms);
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// streamcache::timer (private)
+//
+// Grace period timer thread procedure
+//
+// Arguments:
+//
+//	graceperiodms	- Grace period in milliseconds
+
+void streamcache::timer(uint32_t graceperiodms)
+{
+  std::shared_ptr<void> pipeline; // Pipeline to be released
+
+  // Wait for the grace period to elapse; if the timer is cancelled the pipeline is kept
+  if (m_cancel.wait_until_equals(true, graceperiodms))
+    return;
+
+  std::unique_lock<std::mutex> lock(m_lock);
+  pipeline = std::move(m_pipeline);
+  lock.unlock();
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __STREAMCACHE_H_
+#define __STREAMCACHE_H_
+#pragma once
+
+#include "props.h"
+#include "utils/scalar_condition.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class streamcache
+//
+// Keeps the shared receiver pipeline (DAB ensemble, HD Radio station) of the
+// most recently closed live stream running for a grace period, so that the
+// next stream opened against the same device, frequency and modulation (and
+// audio output) can attach to it without having to reacquire synchronization
+
+class streamcache
+{
+public:
+  // Instance Constructor
+  //
+  streamcache() = default;
+
+  // Destructor
+  //
+  ~streamcache();
+
+  //-----------------------------------------------------------------------
+  // Type Declarations
+
+  // key
+  //
+  // Identifies a cached pipeline
+  struct key
+  {
+
+    std::string device; // Device connection
+    uint32_t frequency; // Tuned frequency
+    enum modulation modulation; // Modulation type
+    bool passthrough; // Undecoded audio output (DAB)
+  };
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // acquire
+  //
+  // Cancels the grace period of the cached pipeline and determines if it can be
+  // reused for the specified key; a pipeline that cannot be reused is released
+  bool acquire(struct key const& key);
+
+  // attach
+  //
+  // Attaches the pipeline of a newly opened live stream to the cache
+  void attach(struct key const& key, std::shared_ptr<void> pipeline);
+
+  // clear
+  //
+  // Releases the cached pipeline
+  void clear(void);
+
+  // detach
+  //
+  // Detaches the pipeline of a closed live stream; the pipeline is released once
+  // the grace period has elapsed unless acquire() has been called in the meantime
+  bool detach(uint32_t graceperiodms);
+
+private:
+  streamcache(streamcache const&) = delete;
+  streamcache& operator=(streamcache const&) = delete;
+
+  //-----------------------------------------------------------------------
+  // Private Member Functions
+
+  // cancel
+  //
+  // Cancels the grace period timer, if it is running
+  void cancel(void);
+
+  // timer
+  //
+  // Grace period timer thread procedure
+  void timer(uint32_t graceperiodms);
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  struct key m_key = {}; // Cached pipeline key
+  std::shared_ptr<void> m_pipeline; // Cached pipeline
+  std::mutex m_lock; // Synchronization object
+
+  std::thread m_timer; // Grace period timer thread
+  std::mutex m_timerlock; // Timer synchronization object
+  scalar_condition<bool> m_cancel{false}; // Condition to cancel the timer
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __STREAMCACHE_H_
@@ -40,10 +40,24 @@
 #include "exception_control/string_exception.h"
 #include "utils/align.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
+#include <thread>
 
 #pragma warning(push, 4)
 
+// tcpdevice::ASYNC_BUFFER_COUNT (static)
+//
+// Default number of buffers used to receive asynchronous data
+size_t const tcpdevice::ASYNC_BUFFER_COUNT = 4;
+
+// tcpdevice::RECEIVE_BUFFER_MS (static)
+//
+// Amount of data the socket receive buffer should hold, in milliseconds
+uint32_t const tcpdevice::RECEIVE_BUFFER_MS = 500;
+
 // tcpdevice::s_gaintable_e4k
 //
 std::vector<int> const tcpdevice::s_gaintable_e4k{-10, 15,  40,  65,  90,  115, 140,
@@ -142,6 +156,8 @@ tcpdevice::tcpdevice(char const* host, uint16_t port)
 
       // TCP_NODELAY
       //
+      // Send the 5-byte device commands immediately rather than letting Nagle's algorithm
+      // hold them back; this is set once for the connection, see also SO_RCVBUF
       int nodelay = 1;
       result = setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY,
                           reinterpret_cast<char const*>(&nodelay), sizeof(int));
@@ -368,6 +384,40 @@ void tcpdevice::get_valid_gains(std::vector<int>& dbs) const
   }
 }
 
+//---------------------------------------------------------------------------
+// tcpdevice::get_statistics
+//
+// Gets the data transfer statistics for the device
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void tcpdevice::get_statistics(struct device_statistics& stats) const
+{
+  stats.bytes = m_meter.bytes();
+  stats.bytespersecond = m_meter.bytespersecond();
+  stats.stalltime = m_meter.stalltime();
+  stats.longestgap = m_meter.longestgap();
+  stats.transfers = m_meter.transfers();
+  stats.droppedtransfers = m_meter.droppedtransfers();
+  stats.jitter = m_meter.jitter();
+}
+
+//---------------------------------------------------------------------------
+// tcpdevice::is_unpaced
+//
+// Determines if the device delivers data as fast as it can be consumed
+//
+// Arguments:
+//
+//	NONE
+
+bool tcpdevice::is_unpaced(void) const
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // tcpdevice::read
 //
@@ -398,43 +448,161 @@ size_t tcpdevice::read(uint8_t* buffer, size_t count) const
 //
 //	callback		- Asynchronous read callback function
 //	bufferlength	- Output buffer length in bytes
+//	buffercount		- Number of output buffers
 
-void tcpdevice::read_async(rtldevice::asynccallback const& callback, uint32_t bufferlength) const
+void tcpdevice::read_async(rtldevice::asynccallback const& callback,
+                           uint32_t bufferlength,
+                           uint32_t buffercount) const
 {
-  std::unique_ptr<uint8_t[]> buffer(new uint8_t[bufferlength]); // Input data buffer
-  size_t offset = 0; // Buffer offset
+  // Allocate all of the receive buffers in one shot; the receiver thread fills the buffers in
+  // rotation while this thread invokes the callback, which allows the data to continue to be
+  // drained from the socket while the callback is busy processing the previous buffer
+  size_t const numbuffers = (buffercount > 0) ? buffercount : ASYNC_BUFFER_COUNT;
+  std::unique_ptr<uint8_t[]> buffers(new uint8_t[numbuffers * bufferlength]);
+
+  std::mutex lock; // Buffer synchronization object
+  std::condition_variable cv; // Buffer state condition variable
+  size_t filled = 0; // Number of filled buffers (producer)
+  size_t consumed = 0; // Number of consumed buffers (consumer)
+  bool finished = false; // Flag indicating receiver thread has finished
+  std::atomic<bool> stop{false}; // Flag to stop the receiver thread
+  std::exception_ptr exception; // Exception from the receiver thread
 
   m_stop = false;
   m_stopped = false;
 
+  // I/Q samples are two bytes each; TCP holds back the data rather than losing it when the
+  // buffers are full, so the meter only reports the stall time and gaps, not lost transfers
+  m_meter.start(static_cast<uint64_t>(m_samplerate) * 2, 0);
+
+  // receiver (local)
+  //
+  // Receiver thread procedure
+  auto receiver = [&]() -> void
+  {
+    try
+    {
+
+      while (stop.load() == false)
+      {
+
+        // Wait for there to be a free buffer to receive into
+        std::unique_lock<std::mutex> critsec(lock);
+        cv.wait(critsec, [&]() -> bool
+                { return ((filled - consumed) < numbuffers) || (stop.load() == true); });
+        if (stop.load() == true)
+          break;
+
+        uint8_t* buffer = &buffers[(filled % numbuffers) * bufferlength];
+        critsec.unlock();
+
+        // Receive the entire buffer's worth of data
+        size_t offset = 0;
+        while ((offset < bufferlength) && (stop.load() == false))
+          offset += receive(&buffer[offset], bufferlength - offset);
+
+        if (offset < bufferlength)
+          break;
+
+        critsec.lock();
+        ++filled;
+        cv.notify_all();
+      }
+    }
+
+    catch (...)
+    {
+      exception = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> critsec(lock);
+    finished = true;
+    cv.notify_all();
+  };
+
+  std::thread receiverthread(receiver);
+
   try
   {
 
-    // Continuously read data from the device until the stop condition is set
+    // Continuously process data from the receiver thread until the stop condition is set
     while (m_stop.test(true) == false)
     {
 
-      // Try to read enough data to fill the input buffer
-      offset += read(&buffer[offset], bufferlength - offset);
-      if (offset == bufferlength)
+      // Wait for there to be a filled buffer; check the stop condition periodically
+      std::unique_lock<std::mutex> critsec(lock);
+      cv.wait_for(critsec, std::chrono::milliseconds(100),
+                  [&]() -> bool { return (filled != consumed) || (finished == true); });
+
+      if (filled == consumed)
       {
 
-        callback(&buffer[0], offset); // Buffer is full, invoke callback
-        offset = 0; // Reset buffer offset
+        if (finished)
+          break;
+        continue;
       }
+
+      uint8_t const* buffer = &buffers[(consumed % numbuffers) * bufferlength];
+      critsec.unlock();
+
+      m_meter.update(bufferlength);
+      callback(buffer, bufferlength); // Buffer is full, invoke callback
+
+      critsec.lock();
+      ++consumed;
+      cv.notify_all();
     }
 
+    // Stop the receiver thread and wait for it to complete
+    stop.store(true);
+    cv.notify_all();
+    receiverthread.join();
+
     m_stopped = true; // Operation has been stopped
+
+    // Propagate any exception that occurred on the receiver thread
+    if (exception)
+      std::rethrow_exception(exception);
   }
 
-  // Ensure that the stopped condition is set on an exception
+  // Ensure that the receiver thread is stopped and the stopped condition is set on an exception
   catch (...)
   {
+    stop.store(true);
+    cv.notify_all();
+    if (receiverthread.joinable())
+      receiverthread.join();
+
     m_stopped = true;
     throw;
   }
 }
 
+//---------------------------------------------------------------------------
+// tcpdevice::receive (private)
+//
+// Receives the specified amount of data from the device
+//
+// Arguments:
+//
+//	buffer		- Buffer to receive the data
+//	count		- Amount of data to receive, specified in bytes
+
+size_t tcpdevice::receive(uint8_t* buffer, size_t count) const
+{
+  assert(m_socket != -1);
+
+  // MSG_WAITALL receives the whole buffer in a single call unless the receive timeout
+  // expires, in which case whatever was received before the timeout is returned
+  int read = recv(m_socket, reinterpret_cast<char*>(buffer), static_cast<int>(count), MSG_WAITALL);
+  if (read == -1)
+    throw socket_exception(__func__, ": recv() failed");
+  if (read == 0)
+    throw string_exception(__func__, ": connection closed by host");
+
+  return static_cast<size_t>(read);
+}
+
 //---------------------------------------------------------------------------
 // tcpdevice::set_automatic_gain_control
 //
@@ -558,6 +726,19 @@ uint32_t tcpdevice::set_sample_rate(uint32_t hz) const
   if (result != sizeof(struct device_command))
     throw socket_exception(__func__, ": send() failed");
 
+  // SO_RCVBUF
+  //
+  // Size the socket receive buffer to hold RECEIVE_BUFFER_MS worth of I/Q samples (2 bytes each)
+  // to ride out short stalls on the link; the operating system may limit the actual size.  The
+  // buffer depends on the sample rate so it's set here; TCP_NODELAY was set at connect()
+  int rcvbuf = static_cast<int>((static_cast<uint64_t>(hz) * 2 * RECEIVE_BUFFER_MS) / 1000);
+  result = setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char const*>(&rcvbuf),
+                      sizeof(int));
+  if (result == -1)
+    throw socket_exception(__func__, ": setsockopt(SO_RCVBUF) failed");
+
+  m_samplerate = hz;
+
   return hz;
 }
 
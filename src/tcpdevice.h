@@ -26,6 +26,7 @@
 
 #include "rtldevice.h"
 #include "utils/scalar_condition.h"
+#include "utils/transfermeter.h"
 
 #include <memory>
 #include <string>
@@ -98,6 +99,16 @@ public:
   // Gets the valid tuner gain values for the device
   void get_valid_gains(std::vector<int>& dbs) const override;
 
+  // get_statistics
+  //
+  // Gets the data transfer statistics for the device
+  void get_statistics(struct device_statistics& stats) const override;
+
+  // is_unpaced
+  //
+  // Determines if the device delivers data as fast as it can be consumed
+  bool is_unpaced(void) const override;
+
   // read
   //
   // Reads data from the device
@@ -106,7 +117,9 @@ public:
   // read_async
   //
   // Asynchronously reads data from the device
-  void read_async(rtldevice::asynccallback const& callback, uint32_t bufferlength) const override;
+  void read_async(rtldevice::asynccallback const& callback,
+                  uint32_t bufferlength,
+                  uint32_t buffercount) const override;
 
   // set_automatic_gain_control
   //
@@ -142,6 +155,16 @@ private:
   tcpdevice(tcpdevice const&) = delete;
   tcpdevice& operator=(tcpdevice const&) = delete;
 
+  // ASYNC_BUFFER_COUNT
+  //
+  // Default number of buffers used to receive asynchronous data
+  static size_t const ASYNC_BUFFER_COUNT;
+
+  // RECEIVE_BUFFER_MS
+  //
+  // Amount of data the socket receive buffer should hold, in milliseconds
+  static uint32_t const RECEIVE_BUFFER_MS;
+
   // Instance Constructor
   //
   tcpdevice(char const* host, uint16_t port);
@@ -193,17 +216,24 @@ private:
   // Closes an open socket, implementation specific
   static void close_socket(int socket);
 
+  // receive
+  //
+  // Receives the specified amount of data from the device
+  size_t receive(uint8_t* buffer, size_t count) const;
+
   //-----------------------------------------------------------------------
   // Member Variables
 
   int m_socket = -1; // TCP/IP socket
   rtlsdr_tuner m_tunertype = RTLSDR_TUNER_UNKNOWN; // Tuner type
   std::string m_name; // Device name
+  mutable uint32_t m_samplerate = 0; // Current sample rate
 
   // ASYNCHRONOUS SUPPORT
   //
   mutable scalar_condition<bool> m_stop{false}; // Flag to stop async
   mutable scalar_condition<bool> m_stopped{true}; // Async stopped condition
+  mutable transfermeter m_meter; // Data transfer meter
 
   static std::vector<int> const s_gaintable_e4k; // RTLSDR_TUNER_E4000
   static std::vector<int> const s_gaintable_fc0012; // RTLSDR_TUNER_FC0012
@@ -0,0 +1,840 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "timeshiftstream.h"
+
+#include "exception_control/string_exception.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <type_traits>
+#include <vector>
+
+#ifdef _WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#pragma warning(push, 4)
+
+// timeshiftstream::REALTIME_THRESHOLD (static)
+//
+// Distance from the live position at which the stream is considered real-time
+double const timeshiftstream::REALTIME_THRESHOLD = 10.0 * STREAM_TIME_BASE;
+
+//---------------------------------------------------------------------------
+// timeshiftstream Constructor (private)
+//
+// Arguments:
+//
+//	stream		- Stream instance to be wrapped
+//	folder		- Folder in which to create the buffer file
+//	capacity	- Capacity of the buffer file in bytes
+
+timeshiftstream::timeshiftstream(std::unique_ptr<pvrstream> stream,
+                                 char const* folder,
+                                 uint64_t capacity)
+  : m_stream(std::move(stream)), m_capacity(capacity), m_file(open_file(folder))
+{
+  assert(m_stream);
+
+  // Create a worker thread on which to drain the wrapped stream
+  scalar_condition<bool> started{false};
+  m_worker = std::thread(&timeshiftstream::worker, this, std::ref(started));
+  started.wait_until_equals(true);
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream Destructor
+
+timeshiftstream::~timeshiftstream()
+{
+  close();
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::canpause
+//
+// Gets a flag indicating if the stream allows pause operations
+//
+// Arguments:
+//
+//	NONE
+
+bool timeshiftstream::canpause(void) const
+{
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::canseek
+//
+// Gets a flag indicating if the stream allows seek operations
+//
+// Arguments:
+//
+//	NONE
+
+bool timeshiftstream::canseek(void) const
+{
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::close
+//
+// Closes the stream
+//
+// Arguments:
+//
+//	NONE
+
+void timeshiftstream::close(void)
+{
+  // The wrapped stream continues to produce packets until it has been closed, so the
+  // worker thread will notice the stop flag and exit before the stream is closed
+  m_stop.store(true);
+  if (m_worker.joinable())
+    m_worker.join();
+
+  if (m_stream)
+    m_stream->close();
+
+  if (m_fileopen)
+    close_file(m_file);
+  m_fileopen = false;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::close_file (private, static)
+//
+// Closes the buffer file
+//
+// Arguments:
+//
+//	file		- Buffer file handle
+
+void timeshiftstream::close_file(file_t file)
+{
+  // The buffer file was marked for deletion when it was created
+#ifdef _WINDOWS
+  CloseHandle(file);
+#else
+  ::close(file);
+#endif
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::create (static)
+//
+// Factory method, creates a new timeshiftstream instance
+//
+// Arguments:
+//
+//	stream		- Stream instance to be wrapped
+//	folder		- Folder in which to create the buffer file
+//	capacity	- Capacity of the buffer file in bytes
+
+std::unique_ptr<timeshiftstream> timeshiftstream::create(std::unique_ptr<pvrstream> stream,
+                                                         char const* folder,
+                                                         uint64_t capacity)
+{
+  if (!stream)
+    throw std::invalid_argument("stream");
+
+  if (capacity == 0)
+    throw std::invalid_argument("capacity");
+
+  return std::unique_ptr<timeshiftstream>(
+      new timeshiftstream(std::move(stream), folder, capacity));
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::demuxabort
+//
+// Aborts the demultiplexer
+//
+// Arguments:
+//
+//	NONE
+
+void timeshiftstream::demuxabort(void)
+{
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::demuxflush
+//
+// Flushes the demultiplexer
+//
+// Arguments:
+//
+//	NONE
+
+void timeshiftstream::demuxflush(void)
+{
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::demuxread
+//
+// Reads the next packet from the demultiplexer
+//
+// Arguments:
+//
+//	allocator		- DemuxPacket allocation function
+
+DEMUX_PACKET* timeshiftstream::demuxread(std::function<DEMUX_PACKET*(int)> const& allocator)
+{
+  std::unique_lock<std::mutex> lock(m_indexlock);
+
+  // Wait up to 50ms for there to be a packet available for processing
+  if (!m_indexcv.wait_for(lock, std::chrono::milliseconds(50),
+                          [&]() -> bool {
+                            return ((m_readpacket < m_firstpacket + m_index.size()) ||
+                                    m_stopped.load() == true);
+                          }))
+    return allocator(0);
+
+  // If the worker thread was stopped and all of the buffered packets have been read, check
+  // for and re-throw any exception that occurred, otherwise return an empty packet
+  if (m_readpacket == m_firstpacket + m_index.size())
+  {
+
+    if (m_worker_exception)
+      std::rethrow_exception(m_worker_exception);
+    else
+      return allocator(0);
+  }
+
+  // If the worker thread evicts a packet while its data is being read the data may have been
+  // overwritten; skip ahead to the next packet that is still in the index
+  while (m_readpacket < m_firstpacket + m_index.size())
+  {
+
+    // Copy the index entry for the next packet and release the lock to read the data
+    uint64_t const sequence = m_readpacket++;
+    struct packet_t const packet = m_index[static_cast<size_t>(sequence - m_firstpacket)];
+    m_readpts = packet.seekpts;
+    lock.unlock();
+
+    // The data is read into a staging buffer first; a DEMUX_PACKET can't be given back to the
+    // allocator if the packet turns out to have been evicted
+    m_readbuffer.resize(static_cast<size_t>(packet.size));
+    if ((packet.size > 0) && (!read_file(packet.offset, m_readbuffer.data(), packet.size)))
+      throw string_exception(__func__, ": unable to read from the timeshift buffer file");
+
+    lock.lock();
+    if (sequence < m_firstpacket)
+      continue;
+    lock.unlock();
+
+    // Allocate and initialize the DEMUX_PACKET
+    DEMUX_PACKET* demuxpacket = allocator(packet.size);
+    if (demuxpacket != nullptr)
+    {
+
+      demuxpacket->iStreamId = packet.streamid;
+      demuxpacket->iSize = packet.size;
+      demuxpacket->duration = packet.duration;
+      demuxpacket->dts = packet.dts;
+      demuxpacket->pts = packet.pts;
+      if (packet.size > 0)
+        memcpy(demuxpacket->pData, m_readbuffer.data(), packet.size);
+    }
+
+    return demuxpacket;
+  }
+
+  // Every remaining packet was evicted before it could be read
+  return allocator(0);
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::demuxreset
+//
+// Resets the demultiplexer
+//
+// Arguments:
+//
+//	NONE
+
+void timeshiftstream::demuxreset(void)
+{
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::devicename
+//
+// Gets the device name associated with the stream
+//
+// Arguments:
+//
+//	NONE
+
+std::string timeshiftstream::devicename(void) const
+{
+  std::unique_lock<std::mutex> lock(m_streamlock);
+  return m_stream->devicename();
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::devicestatistics
+//
+// Gets the data transfer statistics for the device associated with the stream
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void timeshiftstream::devicestatistics(struct rtldevice::device_statistics& stats) const
+{
+  std::unique_lock<std::mutex> lock(m_streamlock);
+  m_stream->devicestatistics(stats);
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::enumproperties
+//
+// Enumerates the stream properties
+//
+// Arguments:
+//
+//	callback		- Callback to invoke for each stream
+
+void timeshiftstream::enumproperties(
+    std::function<void(struct streamprops const& props)> const& callback)
+{
+  std::unique_lock<std::mutex> lock(m_streamlock);
+  m_stream->enumproperties(callback);
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::length
+//
+// Gets the length of the stream; this is the amount of buffered data
+//
+// Arguments:
+//
+//	NONE
+
+long long timeshiftstream::length(void) const
+{
+  std::unique_lock<std::mutex> lock(m_indexlock);
+
+  if (m_index.empty())
+    return 0;
+
+  return static_cast<long long>(m_writeoffset - m_index.front().offset);
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::muxname
+//
+// Gets the mux name associated with the stream
+//
+// Arguments:
+//
+//	NONE
+
+std::string timeshiftstream::muxname(void) const
+{
+  std::unique_lock<std::mutex> lock(m_streamlock);
+  return m_stream->muxname();
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::open_file (private, static)
+//
+// Creates the buffer file in the specified folder
+//
+// Arguments:
+//
+//	folder		- Folder in which to create the buffer file
+
+timeshiftstream::file_t timeshiftstream::open_file(char const* folder)
+{
+  time_t now = time(nullptr);
+  struct tm local = {};
+  char timestamp[32] = {'\0'};
+
+#ifdef _WINDOWS
+  localtime_s(&local, &now);
+#else
+  localtime_r(&now, &local);
+#endif
+  strftime(timestamp, std::extent<decltype(timestamp)>::value, "%Y%m%d-%H%M%S", &local);
+
+  std::string filename((folder != nullptr) ? folder : "");
+  if ((!filename.empty()) && (filename.back() != '/') && (filename.back() != '\\'))
+    filename.push_back('/');
+  filename.append("rtlradio-timeshift-").append(timestamp).append(".tsb");
+
+  // The buffer file is only used for the lifetime of the stream; have the operating system
+  // delete it when it's closed so that nothing is left behind if the process terminates
+#ifdef _WINDOWS
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                            CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    throw string_exception(__func__, ": CreateFile() failed for ", filename.c_str());
+#else
+  int file = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (file == -1)
+    throw string_exception(__func__, ": open() failed for ", filename.c_str());
+
+  unlink(filename.c_str());
+#endif
+
+  return file;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::overruns
+//
+// Gets the number of times that data was dropped because the stream fell behind
+//
+// Arguments:
+//
+//	NONE
+
+uint64_t timeshiftstream::overruns(void) const
+{
+  std::unique_lock<std::mutex> lock(m_streamlock);
+  return m_stream->overruns();
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::position
+//
+// Gets the current position of the stream; this is relative to the buffered data
+//
+// Arguments:
+//
+//	NONE
+
+long long timeshiftstream::position(void) const
+{
+  std::unique_lock<std::mutex> lock(m_indexlock);
+
+  if (m_index.empty())
+    return 0;
+
+  uint64_t offset = m_writeoffset;
+  if (m_readpacket < m_firstpacket + m_index.size())
+    offset = m_index[static_cast<size_t>(m_readpacket - m_firstpacket)].offset;
+
+  return static_cast<long long>(offset - m_index.front().offset);
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::read
+//
+// Reads data from the live stream
+//
+// Arguments:
+//
+//	buffer		- Buffer to receive the live stream data
+//	count		- Size of the destination buffer in bytes
+
+size_t timeshiftstream::read(uint8_t* /*buffer*/, size_t /*count*/)
+{
+  return 0;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::read_file (private)
+//
+// Reads packet data from the buffer file
+//
+// Arguments:
+//
+//	offset		- Logical offset of the packet data
+//	data		- Buffer to receive the packet data
+//	length		- Length of the packet data
+
+bool timeshiftstream::read_file(uint64_t offset, uint8_t* data, size_t length) const
+{
+  while (length > 0)
+  {
+
+    // Packet data wraps around to the beginning of the file when it reaches the end
+    uint64_t const position = offset % m_capacity;
+    size_t const count = static_cast<size_t>(std::min<uint64_t>(length, m_capacity - position));
+
+#ifdef _WINDOWS
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+    DWORD read = 0;
+    if (!ReadFile(m_file, data, static_cast<DWORD>(count), &read, &overlapped) || (read == 0))
+      return false;
+#else
+    ssize_t read = pread(m_file, data, count, static_cast<off_t>(position));
+    if (read <= 0)
+      return false;
+#endif
+
+    data += read;
+    offset += static_cast<uint64_t>(read);
+    length -= static_cast<size_t>(read);
+  }
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::realtime
+//
+// Gets a flag indicating if the stream is real-time
+//
+// Arguments:
+//
+//	NONE
+
+bool timeshiftstream::realtime(void) const
+{
+  std::unique_lock<std::mutex> lock(m_indexlock);
+
+  // The stream is only real-time while playback is at (or very near) the live position
+  if (m_index.empty())
+    return true;
+
+  return ((m_index.back().seekpts - m_readpts) < REALTIME_THRESHOLD);
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::seek
+//
+// Sets the stream pointer to a specific position
+//
+// Arguments:
+//
+//	position	- Delta within the stream to seek, relative to whence
+//	whence		- Starting position from which to apply the delta
+
+long long timeshiftstream::seek(long long position, int whence)
+{
+  std::unique_lock<std::mutex> lock(m_indexlock);
+
+  if (m_index.empty())
+    return -1;
+
+  // Positions are relative to the first packet that remains in the buffer
+  long long const first = static_cast<long long>(m_index.front().offset);
+  long long const last = static_cast<long long>(m_writeoffset);
+  long long current = last;
+  if (m_readpacket < m_firstpacket + m_index.size())
+  {
+
+    size_t const index = static_cast<size_t>(m_readpacket - m_firstpacket);
+    current = static_cast<long long>(m_index[index].offset);
+  }
+
+  long long target = 0;
+  if (whence == SEEK_SET)
+    target = first + position;
+  else if (whence == SEEK_CUR)
+    target = current + position;
+  else if (whence == SEEK_END)
+    target = last + position;
+  else
+    return -1;
+
+  target = std::max(first, std::min(last, target));
+
+  // Locate the packet that contains the target position
+  auto found = std::upper_bound(m_index.begin(), m_index.end(), static_cast<uint64_t>(target),
+                                [](uint64_t const& offset, struct packet_t const& packet) -> bool
+                                { return offset < packet.offset; });
+  if (found != m_index.begin())
+    --found;
+
+  m_readpacket = m_firstpacket + static_cast<uint64_t>(found - m_index.begin());
+  m_readpts = found->seekpts;
+
+  return static_cast<long long>(found->offset) - first;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::seektime
+//
+// Sets the stream pointer to a specific time
+//
+// Arguments:
+//
+//	time		- Time to seek to, in milliseconds
+//	backwards	- Flag indicating a backwards seek
+//	startpts	- On success, receives the PTS of the first packet after the seek
+
+bool timeshiftstream::seektime(double time, bool backwards, double& startpts)
+{
+  double const target = time * (STREAM_TIME_BASE / 1000);
+
+  std::unique_lock<std::mutex> lock(m_indexlock);
+
+  if (m_index.empty())
+    return false;
+
+  // The seek time stamps never decrease, so the index can be binary searched; a backwards
+  // seek lands on the packet at or before the target rather than the one after it
+  auto found =
+      std::lower_bound(m_index.begin(), m_index.end(), target,
+                       [](struct packet_t const& packet, double const& value) -> bool
+                       { return packet.seekpts < value; });
+
+  if (found == m_index.end())
+    --found;
+  else if ((backwards) && (found->seekpts > target) && (found != m_index.begin()))
+    --found;
+
+  m_readpacket = m_firstpacket + static_cast<uint64_t>(found - m_index.begin());
+  m_readpts = found->seekpts;
+  startpts = found->seekpts;
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::servicename
+//
+// Gets the service name associated with the stream
+//
+// Arguments:
+//
+//	NONE
+
+std::string timeshiftstream::servicename(void) const
+{
+  std::unique_lock<std::mutex> lock(m_streamlock);
+  return m_stream->servicename();
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::signalquality
+//
+// Gets the signal quality as percentages
+//
+// Arguments:
+//
+//	quality			- Signal quality percentage
+//	snr				- Signal to noise ratio percentage
+
+void timeshiftstream::signalquality(int& quality, int& snr) const
+{
+  std::unique_lock<std::mutex> lock(m_streamlock);
+  m_stream->signalquality(quality, snr);
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::streamtimes
+//
+// Gets the time shift boundaries of the stream
+//
+// Arguments:
+//
+//	times		- Structure to receive the stream times
+
+bool timeshiftstream::streamtimes(struct streamtimes& times) const
+{
+  std::unique_lock<std::mutex> lock(m_indexlock);
+
+  if (m_index.empty())
+    return false;
+
+  times.ptsstart = 0;
+  times.ptsbegin = m_index.front().seekpts;
+  times.ptsend = m_index.back().seekpts + m_index.back().duration;
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::worker (private)
+//
+// Worker thread procedure used to drain the wrapped stream into the buffer
+//
+// Arguments:
+//
+//	started		- Condition variable to set when thread has started
+
+void timeshiftstream::worker(scalar_condition<bool>& started)
+{
+  std::vector<uint8_t> data; // Packet data buffer
+  DEMUX_PACKET packet = {}; // Packet read from the wrapped stream
+  double ptsoffset = 0; // Offset applied to the wrapped stream time stamps
+  double ptsend = 0; // End time stamp of the last packet
+  double seekpts = 0; // Seek time stamp of the last packet
+
+  // allocator (local)
+  //
+  // Allocates the DEMUX_PACKET for the wrapped stream
+  auto allocator = [&](int size) -> DEMUX_PACKET*
+  {
+    data.resize(static_cast<size_t>(std::max(size, 0)));
+
+    packet = {};
+    packet.pData = data.data();
+    packet.iSize = size;
+    packet.iStreamId = -1;
+    packet.pts = packet.dts = STREAM_NOPTS_VALUE;
+
+    return &packet;
+  };
+
+  started = true; // Inform the caller that the thread is running
+
+  try
+  {
+    while (m_stop.load() == false)
+    {
+
+      // The stream lock isn't held while waiting for the next packet; the wrapped streams
+      // serve their accessors alongside demuxread() and the status queries can't stall here
+      DEMUX_PACKET* demuxpacket = m_stream->demuxread(allocator);
+
+      // Empty packets are only stored if they are special (STREAMCHANGE, for example)
+      if ((demuxpacket == nullptr) ||
+          ((demuxpacket->iSize <= 0) && (demuxpacket->iStreamId != DEMUX_SPECIALID_STREAMCHANGE)))
+        continue;
+
+      // The buffer file cannot hold a packet that is larger than the buffer itself
+      uint64_t const size = static_cast<uint64_t>(std::max(demuxpacket->iSize, 0));
+      if (size > m_capacity)
+        continue;
+
+      // The wrapped stream time stamps start over when the stream changes, rebase them so
+      // that the time stamps in the buffer continue to increase and can be searched
+      if (demuxpacket->pts != STREAM_NOPTS_VALUE)
+      {
+
+        if (demuxpacket->pts + ptsoffset < ptsend)
+          ptsoffset = ptsend - demuxpacket->pts;
+
+        demuxpacket->pts += ptsoffset;
+        if (demuxpacket->dts != STREAM_NOPTS_VALUE)
+          demuxpacket->dts += ptsoffset;
+
+        seekpts = demuxpacket->pts;
+        ptsend = demuxpacket->pts + demuxpacket->duration;
+      }
+
+      struct packet_t entry = {};
+      entry.offset = m_writeoffset;
+      entry.size = static_cast<int>(size);
+      entry.streamid = demuxpacket->iStreamId;
+      entry.duration = demuxpacket->duration;
+      entry.dts = demuxpacket->dts;
+      entry.pts = demuxpacket->pts;
+      entry.seekpts = seekpts;
+
+      // Evict the packets whose data is going to be overwritten from the index; this has to
+      // be done before the data is written so that the reader can detect the eviction
+      std::unique_lock<std::mutex> indexlock(m_indexlock);
+      while ((!m_index.empty()) && (m_index.front().offset + m_capacity < entry.offset + size))
+      {
+
+        m_index.pop_front();
+        m_firstpacket++;
+      }
+
+      if (m_readpacket < m_firstpacket)
+        m_readpacket = m_firstpacket;
+      indexlock.unlock();
+
+      // Write the packet data into the buffer file outside of the lock
+      if ((size > 0) && (!write_file(entry.offset, demuxpacket->pData, static_cast<size_t>(size))))
+        throw string_exception(__func__, ": unable to write to the timeshift buffer file");
+
+      // Add the packet to the index and wake up the reader
+      indexlock.lock();
+      m_index.push_back(entry);
+      m_writeoffset += size;
+      m_indexcv.notify_all();
+    }
+  }
+
+  catch (...)
+  {
+    m_worker_exception = std::current_exception();
+  }
+
+  // Worker thread is now stopped; wake up the reader
+  std::unique_lock<std::mutex> indexlock(m_indexlock);
+  m_stopped.store(true);
+  m_indexcv.notify_all();
+}
+
+//---------------------------------------------------------------------------
+// timeshiftstream::write_file (private)
+//
+// Writes packet data into the buffer file
+//
+// Arguments:
+//
+//	offset		- Logical offset of the packet data
+//	data		- Packet data to be written
+//	length		- Length of the packet data
+
+bool timeshiftstream::write_file(uint64_t offset, uint8_t const* data, size_t length) const
+{
+  while (length > 0)
+  {
+
+    // Packet data wraps around to the beginning of the file when it reaches the end
+    uint64_t const position = offset % m_capacity;
+    size_t const count = static_cast<size_t>(std::min<uint64_t>(length, m_capacity - position));
+
+#ifdef _WINDOWS
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(position & 0xFFFFFFFF);
+    overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+    DWORD written = 0;
+    if (!WriteFile(m_file, data, static_cast<DWORD>(count), &written, &overlapped) ||
+        (written == 0))
+      return false;
+#else
+    ssize_t written = pwrite(m_file, data, count, static_cast<off_t>(position));
+    if (written <= 0)
+      return false;
+#endif
+
+    data += written;
+    offset += static_cast<uint64_t>(written);
+    length -= static_cast<size_t>(written);
+  }
+
+  return true;
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
@@ -0,0 +1,277 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __TIMESHIFTSTREAM_H_
+#define __TIMESHIFTSTREAM_H_
+#pragma once
+
+#include "props.h"
+#include "pvrstream.h"
+#include "rtldevice.h"
+#include "utils/scalar_condition.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class timeshiftstream
+//
+// Implements a stream that wraps another stream and records the demultiplexer
+// packets it generates into a fixed-size ring buffer file.  A background thread
+// continually drains the wrapped stream so it never falls behind while playback
+// is paused; the packets are indexed by their presentation time stamp to allow
+// the application to pause, rewind and catch up within the buffered period
+
+class timeshiftstream : public pvrstream
+{
+public:
+  // Destructor
+  //
+  virtual ~timeshiftstream();
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // canpause
+  //
+  // Flag indicating if the stream allows pause operations
+  bool canpause(void) const override;
+
+  // canseek
+  //
+  // Flag indicating if the stream allows seek operations
+  bool canseek(void) const override;
+
+  // close
+  //
+  // Closes the stream
+  void close(void) override;
+
+  // create (static)
+  //
+  // Factory method, creates a new timeshiftstream instance
+  static std::unique_ptr<timeshiftstream> create(std::unique_ptr<pvrstream> stream,
+                                                 char const* folder,
+                                                 uint64_t capacity);
+
+  // demuxabort
+  //
+  // Aborts the demultiplexer
+  void demuxabort(void) override;
+
+  // demuxflush
+  //
+  // Flushes the demultiplexer
+  void demuxflush(void) override;
+
+  // demuxread
+  //
+  // Reads the next packet from the demultiplexer
+  DEMUX_PACKET* demuxread(std::function<DEMUX_PACKET*(int)> const& allocator) override;
+
+  // demuxreset
+  //
+  // Resets the demultiplexer
+  void demuxreset(void) override;
+
+  // devicename
+  //
+  // Gets the device name associated with the stream
+  std::string devicename(void) const override;
+
+  // devicestatistics
+  //
+  // Gets the data transfer statistics for the device associated with the stream
+  void devicestatistics(struct rtldevice::device_statistics& stats) const override;
+
+  // enumproperties
+  //
+  // Enumerates the stream properties
+  void enumproperties(
+      std::function<void(struct streamprops const& props)> const& callback) override;
+
+  // length
+  //
+  // Gets the length of the stream
+  long long length(void) const override;
+
+  // muxname
+  //
+  // Gets the mux name associated with the stream
+  std::string muxname(void) const override;
+
+  // overruns
+  //
+  // Gets the number of times that data was dropped because the stream fell behind
+  uint64_t overruns(void) const override;
+
+  // position
+  //
+  // Gets the current position of the stream
+  long long position(void) const override;
+
+  // read
+  //
+  // Reads available data from the stream
+  size_t read(uint8_t* buffer, size_t count) override;
+
+  // realtime
+  //
+  // Gets a flag indicating if the stream is real-time
+  bool realtime(void) const override;
+
+  // seek
+  //
+  // Sets the stream pointer to a specific position
+  long long seek(long long position, int whence) override;
+
+  // seektime
+  //
+  // Sets the stream pointer to a specific time
+  bool seektime(double time, bool backwards, double& startpts) override;
+
+  // servicename
+  //
+  // Gets the service name associated with the stream
+  std::string servicename(void) const override;
+
+  // signalquality
+  //
+  // Gets the signal quality as percentages
+  void signalquality(int& quality, int& snr) const override;
+
+  // streamtimes
+  //
+  // Gets the time shift boundaries of the stream
+  bool streamtimes(struct streamtimes& times) const override;
+
+private:
+  timeshiftstream(timeshiftstream const&) = delete;
+  timeshiftstream& operator=(timeshiftstream const&) = delete;
+
+  // REALTIME_THRESHOLD
+  //
+  // Distance from the live position at which the stream is considered real-time
+  static double const REALTIME_THRESHOLD;
+
+  // Instance Constructor
+  //
+  timeshiftstream(std::unique_ptr<pvrstream> stream, char const* folder, uint64_t capacity);
+
+  //-----------------------------------------------------------------------
+  // Private Type Declarations
+
+  // file_t
+  //
+  // Buffer file handle type
+#ifdef _WINDOWS
+  using file_t = void*;
+#else
+  using file_t = int;
+#endif
+
+  // packet_t
+  //
+  // Index entry for a packet stored in the buffer file
+  struct packet_t
+  {
+
+    uint64_t offset; // Logical offset of the packet data
+    int size; // Size of the packet data
+    int streamid; // Stream identifier
+    double duration; // Packet duration
+    double dts; // Decode time stamp
+    double pts; // Presentation time stamp
+    double seekpts; // Presentation time stamp used for seeking
+  };
+
+  //-----------------------------------------------------------------------
+  // Private Member Functions
+
+  // close_file (static)
+  //
+  // Closes the buffer file
+  static void close_file(file_t file);
+
+  // open_file (static)
+  //
+  // Creates the buffer file in the specified folder
+  static file_t open_file(char const* folder);
+
+  // read_file
+  //
+  // Reads packet data from the buffer file
+  bool read_file(uint64_t offset, uint8_t* data, size_t length) const;
+
+  // worker
+  //
+  // Worker thread procedure used to drain the wrapped stream into the buffer
+  void worker(scalar_condition<bool>& started);
+
+  // write_file
+  //
+  // Writes packet data into the buffer file
+  bool write_file(uint64_t offset, uint8_t const* data, size_t length) const;
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  std::unique_ptr<pvrstream> m_stream; // Wrapped stream instance
+  mutable std::mutex m_streamlock; // Wrapped stream accessor synchronization object
+  uint64_t const m_capacity; // Capacity of the buffer file
+  file_t m_file; // Buffer file handle
+  bool m_fileopen{true}; // Flag indicating that the buffer file is open
+
+  // PACKET INDEX
+  //
+  std::deque<struct packet_t> m_index; // Index of the buffered packets
+  uint64_t m_firstpacket{0}; // Sequence number of the first indexed packet
+  uint64_t m_readpacket{0}; // Sequence number of the next packet to read
+  uint64_t m_writeoffset{0}; // Logical offset of the next packet data
+  double m_readpts{0}; // Seek time stamp of the last packet read
+  std::vector<uint8_t> m_readbuffer; // Packet data read from the buffer file
+  mutable std::mutex m_indexlock; // Synchronization object
+  std::condition_variable m_indexcv; // Event condition variable
+
+  // WORKER THREAD
+  //
+  std::thread m_worker; // Buffer worker thread
+  std::exception_ptr m_worker_exception; // Exception on worker thread
+  std::atomic<bool> m_stop{false}; // Flag to stop the worker thread
+  std::atomic<bool> m_stopped{false}; // Flag indicating that the worker has stopped
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __TIMESHIFTSTREAM_H_
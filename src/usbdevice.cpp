@@ -42,6 +42,11 @@
 // Default device index value
 uint32_t const usbdevice::DEFAULT_DEVICE_INDEX = 0;
 
+// usbdevice::DEFAULT_BUFFER_COUNT (static)
+//
+// Default number of asynchronous transfer buffers (same as librtlsdr)
+uint32_t const usbdevice::DEFAULT_BUFFER_COUNT = 15;
+
 //---------------------------------------------------------------------------
 // usbdevice Constructor (private)
 //
@@ -329,6 +334,40 @@ void usbdevice::get_valid_gains(std::vector<int>& dbs) const
     throw string_exception(__func__, ": size mismatch reading valid tuner gain values");
 }
 
+//---------------------------------------------------------------------------
+// usbdevice::get_statistics
+//
+// Gets the data transfer statistics for the device
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void usbdevice::get_statistics(struct device_statistics& stats) const
+{
+  stats.bytes = m_meter.bytes();
+  stats.bytespersecond = m_meter.bytespersecond();
+  stats.stalltime = m_meter.stalltime();
+  stats.longestgap = m_meter.longestgap();
+  stats.transfers = m_meter.transfers();
+  stats.droppedtransfers = m_meter.droppedtransfers();
+  stats.jitter = m_meter.jitter();
+}
+
+//---------------------------------------------------------------------------
+// usbdevice::is_unpaced
+//
+// Determines if the device delivers data as fast as it can be consumed
+//
+// Arguments:
+//
+//	NONE
+
+bool usbdevice::is_unpaced(void) const
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // usbdevice::read
 //
@@ -362,8 +401,11 @@ size_t usbdevice::read(uint8_t* buffer, size_t count) const
 //
 //	callback		- Asynchronous read callback function
 //	bufferlength	- Output buffer length in bytes
+//	buffercount		- Number of output buffers
 
-void usbdevice::read_async(rtldevice::asynccallback const& callback, uint32_t bufferlength) const
+void usbdevice::read_async(rtldevice::asynccallback const& callback,
+                           uint32_t bufferlength,
+                           uint32_t buffercount) const
 {
   assert(m_device != nullptr);
 
@@ -375,12 +417,27 @@ void usbdevice::read_async(rtldevice::asynccallback const& callback, uint32_t bu
       (*func)(reinterpret_cast<uint8_t const*>(buf), static_cast<size_t>(len));
   };
 
+  // Wrap the caller's callback to update the transfer meter ahead of invoking it
+  asynccallback metercallback = [&](uint8_t const* buffer, size_t count) -> void
+  {
+    m_meter.update(count);
+    callback(buffer, count);
+  };
+
   // Get the address of the callback std::function<> to pass as a context pointer
-  void const* pcallback = std::addressof(callback);
+  void const* pcallback = std::addressof(metercallback);
+
+  // Each buffer is submitted to libusb as a separate bulk transfer; more transfers in flight
+  // allow the device to ride out longer scheduling delays before samples are lost
+  if (buffercount == 0)
+    buffercount = DEFAULT_BUFFER_COUNT;
+
+  // I/Q samples are two bytes each
+  m_meter.start(static_cast<uint64_t>(rtlsdr_get_sample_rate(m_device)) * 2, buffercount);
 
   // rtlsdr_read_async returns the underlying libusb error code when it fails
-  int result =
-      rtlsdr_read_async(m_device, callreadfunc, const_cast<void*>(pcallback), 0, bufferlength);
+  int result = rtlsdr_read_async(m_device, callreadfunc, const_cast<void*>(pcallback), buffercount,
+                                 bufferlength);
   if (result < 0)
     throw string_exception(__func__, ": ", libusb_exception(result).what());
 }
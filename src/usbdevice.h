@@ -25,6 +25,7 @@
 #pragma once
 
 #include "rtldevice.h"
+#include "utils/transfermeter.h"
 
 #include <functional>
 #include <memory>
@@ -115,6 +116,16 @@ public:
   // Gets the valid tuner gain values for the device
   void get_valid_gains(std::vector<int>& dbs) const override;
 
+  // get_statistics
+  //
+  // Gets the data transfer statistics for the device
+  void get_statistics(struct device_statistics& stats) const override;
+
+  // is_unpaced
+  //
+  // Determines if the device delivers data as fast as it can be consumed
+  bool is_unpaced(void) const override;
+
   // read
   //
   // Reads data from the device
@@ -123,7 +134,9 @@ public:
   // read_async
   //
   // Asynchronously reads data from the device
-  void read_async(rtldevice::asynccallback const& callback, uint32_t bufferlength) const override;
+  void read_async(rtldevice::asynccallback const& callback,
+                  uint32_t bufferlength,
+                  uint32_t buffercount) const override;
 
   // set_automatic_gain_control
   //
@@ -159,6 +172,11 @@ private:
   usbdevice(usbdevice const&) = delete;
   usbdevice& operator=(usbdevice const&) = delete;
 
+  // DEFAULT_BUFFER_COUNT
+  //
+  // Default number of asynchronous transfer buffers
+  static uint32_t const DEFAULT_BUFFER_COUNT;
+
   // Instance Constructor
   //
   usbdevice(uint32_t index);
@@ -167,6 +185,7 @@ private:
   // Member Variables
 
   rtlsdr_dev_t* m_device = nullptr; // Device instance
+  mutable transfermeter m_meter; // Data transfer meter
 
   std::string m_name; // Device name
   std::string m_manufacturer; // Device manufacturer
@@ -0,0 +1,145 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __CLOCKRECOVERY_H_
+#define __CLOCKRECOVERY_H_
+#pragma once
+
+#include <algorithm>
+
+#pragma warning(push, 4)
+
+//-----------------------------------------------------------------------------
+// clockrecovery
+//
+// Tracks the fill level of an output queue and generates a fine correction for
+// the output resampling ratio. The device crystal and the consumer's audio clock
+// are never exactly the same rate, so without a correction the queue slowly fills
+// up or drains until it overruns. The correction is the ratio to multiply the
+// nominal resampling rate (input rate / output rate) by; a value above 1.0 means
+// fewer output samples are generated and the queue drains. A free running queue
+// is drained as fast as it's filled (timeshift buffer, unpaced input), its fill
+// level says nothing about the consumer clock and the correction stays at 1.0
+
+class clockrecovery
+{
+public:
+  // MAX_CORRECTION
+  //
+  // Maximum deviation of the correction from 1.0 (1000 PPM)
+  static constexpr double MAX_CORRECTION = 0.001;
+
+  // Instance Constructor
+  //
+  clockrecovery(double target, bool freerun)
+    : m_freerun(freerun), m_target(std::max(target, 1.0)), m_average(m_target)
+  {
+  }
+
+  // Destructor
+  //
+  ~clockrecovery() = default;
+
+  //-------------------------------------------------------------------------
+  // Member Functions
+
+  // correction
+  //
+  // Gets the current rate correction
+  double correction(void) const { return m_correction; }
+
+  // reset
+  //
+  // Resets the controller after a discontinuity in the output
+  void reset(void)
+  {
+    m_average = m_target;
+    m_integral = 0.0;
+    m_correction = 1.0;
+  }
+
+  // target
+  //
+  // Changes the target fill level
+  void target(double target) { m_target = std::max(target, 1.0); }
+
+  // update
+  //
+  // Updates the controller with the current fill level and returns the new rate correction;
+  // the fill level and the target can be in any unit as long as they are the same
+  double update(double fill)
+  {
+    if (m_freerun)
+      return 1.0;
+
+    // Smooth the fill level; it's sampled once per packet and is very noisy in the short term
+    m_average += (std::max(fill, 0.0) - m_average) * SMOOTHING;
+
+    // The error is the normalized distance from the target fill level
+    double const error = std::min(std::max((m_average - m_target) / m_target, -1.0), 1.0);
+
+    // The integral term tracks the steady-state clock difference; the proportional term
+    // pulls the fill level back to the target after a disturbance
+    m_integral = std::min(std::max(m_integral + (error * INTEGRAL_GAIN), -MAX_CORRECTION),
+                          MAX_CORRECTION);
+    m_correction = 1.0 + std::min(std::max((error * PROPORTIONAL_GAIN) + m_integral,
+                                           -MAX_CORRECTION),
+                                  MAX_CORRECTION);
+
+    return m_correction;
+  }
+
+private:
+  clockrecovery(clockrecovery const&) = delete;
+  clockrecovery& operator=(clockrecovery const&) = delete;
+
+  // INTEGRAL_GAIN
+  //
+  // Integral gain applied to the error on each update
+  static constexpr double INTEGRAL_GAIN = 0.0000001;
+
+  // PROPORTIONAL_GAIN
+  //
+  // Proportional gain applied to the error
+  static constexpr double PROPORTIONAL_GAIN = 0.0005;
+
+  // SMOOTHING
+  //
+  // Smoothing factor applied to the fill level
+  static constexpr double SMOOTHING = 0.01;
+
+  //-------------------------------------------------------------------------
+  // Member Variables
+
+  bool const m_freerun; // Flag to bypass the correction
+  double m_target; // Target fill level
+  double m_average; // Smoothed fill level
+  double m_integral = 0.0; // Integral term
+  double m_correction = 1.0; // Current rate correction
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __CLOCKRECOVERY_H_
@@ -0,0 +1,353 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+#include "iqconverter.h"
+
+#include "simd.h"
+
+#include <assert.h>
+
+#pragma warning(push, 4)
+
+// iqconverter::DC_ALPHA (static)
+//
+// Smoothing factor applied to the per-block DC offset estimate
+float const iqconverter::DC_ALPHA = 0.05f;
+
+// kernel_t
+//
+// Defines the signature of a SIMD conversion kernel; the kernels convert as many
+// samples as possible and return the number of samples that were converted
+using kernel_t = size_t (*)(uint8_t const*, float*, size_t, float, float, float);
+
+//---------------------------------------------------------------------------
+// SIMD KERNELS
+//
+// Each kernel computes (sample * scale) + bias, where the bias has been
+// precalculated as -(offset * scale) independently for the I and Q channels
+
+#ifdef SIMD_X86
+
+// convert_sse2 (local)
+//
+// SSE2 conversion kernel, 8 I/Q samples per iteration
+static size_t convert_sse2(
+    uint8_t const* input, float* output, size_t count, float scale, float ibias, float qbias)
+{
+  __m128i const zero = _mm_setzero_si128();
+  __m128 const vscale = _mm_set1_ps(scale);
+  __m128 const vbias = _mm_setr_ps(ibias, qbias, ibias, qbias);
+
+  size_t const blocks = count / 8;
+  for (size_t block = 0; block < blocks; block++)
+  {
+
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input));
+    __m128i lo16 = _mm_unpacklo_epi8(bytes, zero);
+    __m128i hi16 = _mm_unpackhi_epi8(bytes, zero);
+
+    __m128 f0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo16, zero));
+    __m128 f1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo16, zero));
+    __m128 f2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi16, zero));
+    __m128 f3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi16, zero));
+
+    _mm_storeu_ps(output + 0, _mm_add_ps(_mm_mul_ps(f0, vscale), vbias));
+    _mm_storeu_ps(output + 4, _mm_add_ps(_mm_mul_ps(f1, vscale), vbias));
+    _mm_storeu_ps(output + 8, _mm_add_ps(_mm_mul_ps(f2, vscale), vbias));
+    _mm_storeu_ps(output + 12, _mm_add_ps(_mm_mul_ps(f3, vscale), vbias));
+
+    input += 16;
+    output += 16;
+  }
+
+  return blocks * 8;
+}
+
+// convert_avx2 (local)
+//
+// AVX2 conversion kernel, 16 I/Q samples per iteration
+SIMD_TARGET_AVX2 static size_t convert_avx2(
+    uint8_t const* input, float* output, size_t count, float scale, float ibias, float qbias)
+{
+  __m256 const vscale = _mm256_set1_ps(scale);
+  __m256 const vbias = _mm256_setr_ps(ibias, qbias, ibias, qbias, ibias, qbias, ibias, qbias);
+
+  size_t const blocks = count / 16;
+  for (size_t block = 0; block < blocks; block++)
+  {
+
+    for (int group = 0; group < 4; group++)
+    {
+
+      __m128i bytes = _mm_loadl_epi64(reinterpret_cast<__m128i const*>(input + (group * 8)));
+      __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+      _mm256_storeu_ps(output + (group * 8), _mm256_add_ps(_mm256_mul_ps(values, vscale), vbias));
+    }
+
+    input += 32;
+    output += 32;
+  }
+
+  return blocks * 16;
+}
+
+#endif // SIMD_X86
+
+#ifdef SIMD_NEON
+
+// convert_neon (local)
+//
+// NEON conversion kernel, 8 I/Q samples per iteration
+static size_t convert_neon(
+    uint8_t const* input, float* output, size_t count, float scale, float ibias, float qbias)
+{
+  float const bias[4] = {ibias, qbias, ibias, qbias};
+  float32x4_t const vbias = vld1q_f32(bias);
+
+  size_t const blocks = count / 8;
+  for (size_t block = 0; block < blocks; block++)
+  {
+
+    uint8x16_t bytes = vld1q_u8(input);
+    uint16x8_t lo16 = vmovl_u8(vget_low_u8(bytes));
+    uint16x8_t hi16 = vmovl_u8(vget_high_u8(bytes));
+
+    vst1q_f32(output + 0, vmlaq_n_f32(vbias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo16))), scale));
+    vst1q_f32(output + 4, vmlaq_n_f32(vbias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo16))), scale));
+    vst1q_f32(output + 8, vmlaq_n_f32(vbias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi16))), scale));
+    vst1q_f32(output + 12,
+              vmlaq_n_f32(vbias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi16))), scale));
+
+    input += 16;
+    output += 16;
+  }
+
+  return blocks * 8;
+}
+
+#endif // SIMD_NEON
+
+// select_kernel (local)
+//
+// Selects the fastest available conversion kernel for this system
+static kernel_t select_kernel(char const** name)
+{
+#if defined(SIMD_X86)
+  if (simd::has_avx2())
+  {
+    *name = "avx2";
+    return convert_avx2;
+  }
+  *name = "sse2";
+  return convert_sse2;
+#elif defined(SIMD_NEON)
+  *name = "neon";
+  return convert_neon;
+#else
+  *name = "lut";
+  return nullptr;
+#endif
+}
+
+// s_kernelname
+//
+// Name of the selected conversion kernel
+static char const* s_kernelname = "lut";
+
+// s_kernel
+//
+// Selected conversion kernel, or nullptr if only the lookup table is available
+static kernel_t const s_kernel = select_kernel(&s_kernelname);
+
+//---------------------------------------------------------------------------
+// iqconverter Constructor
+//
+// Arguments:
+//
+//	offset		- Value to subtract from each raw sample
+//	scale		- Value to multiply each offset sample by
+
+iqconverter::iqconverter(float offset, float scale) : iqconverter(offset, scale, false)
+{
+}
+
+//---------------------------------------------------------------------------
+// iqconverter Constructor
+//
+// Arguments:
+//
+//	offset		- Value to subtract from each raw sample
+//	scale		- Value to multiply each offset sample by
+//	removedc	- Flag to track and remove the DC offset of the input
+
+iqconverter::iqconverter(float offset, float scale, bool removedc)
+  : m_offset(offset), m_scale(scale), m_removedc(removedc)
+{
+  reset();
+}
+
+//---------------------------------------------------------------------------
+// iqconverter::convert
+//
+// Converts raw 8-bit I/Q samples into interleaved floating-point I/Q samples
+//
+// Arguments:
+//
+//	input		- Raw 8-bit I/Q samples
+//	output		- Interleaved floating-point I/Q output samples
+//	count		- Number of I/Q samples (not bytes) to convert
+
+void iqconverter::convert(uint8_t const* input, float* output, size_t count)
+{
+  assert((input != nullptr) && (output != nullptr));
+
+  if (m_removedc)
+    update_dc(input, count);
+
+  // Convert as many samples as possible with the SIMD kernel, if one is available
+  size_t converted = 0;
+  if (s_kernel != nullptr)
+    converted = s_kernel(input, output, count, m_scale, -(m_dci * m_scale), -(m_dcq * m_scale));
+
+  if (converted == count)
+    return;
+
+  // Rebuild the lookup table if the DC offset has changed since it was generated
+  if ((m_lutdci != m_dci) || (m_lutdcq != m_dcq))
+  {
+
+    for (int index = 0; index < 256; index++)
+    {
+
+      m_lut[0][index] = (static_cast<float>(index) - m_dci) * m_scale;
+      m_lut[1][index] = (static_cast<float>(index) - m_dcq) * m_scale;
+    }
+
+    m_lutdci = m_dci;
+    m_lutdcq = m_dcq;
+  }
+
+  // Convert the remaining samples via the lookup table
+  for (size_t index = converted; index < count; index++)
+  {
+
+    output[(index * 2)] = m_lut[0][input[(index * 2)]]; // I
+    output[(index * 2) + 1] = m_lut[1][input[(index * 2) + 1]]; // Q
+  }
+}
+
+//---------------------------------------------------------------------------
+// iqconverter::convert
+//
+// Converts raw 8-bit I/Q samples into interleaved floating-point I/Q samples
+//
+// Arguments:
+//
+//	input		- Raw 8-bit I/Q samples
+//	output		- Interleaved floating-point I/Q output samples
+//	count		- Number of I/Q samples (not bytes) to convert
+
+void iqconverter::convert(uint8_t const* input, double* output, size_t count)
+{
+  assert((input != nullptr) && (output != nullptr));
+
+  if (m_removedc)
+    update_dc(input, count);
+
+  double const scale = static_cast<double>(m_scale);
+  double const dci = static_cast<double>(m_dci);
+  double const dcq = static_cast<double>(m_dcq);
+
+  for (size_t index = 0; index < count; index++)
+  {
+
+    output[(index * 2)] = (static_cast<double>(input[(index * 2)]) - dci) * scale; // I
+    output[(index * 2) + 1] = (static_cast<double>(input[(index * 2) + 1]) - dcq) * scale; // Q
+  }
+}
+
+//---------------------------------------------------------------------------
+// iqconverter::implementation (static)
+//
+// Gets the name of the implementation selected for this system
+//
+// Arguments:
+//
+//	NONE
+
+char const* iqconverter::implementation(void)
+{
+  return s_kernelname;
+}
+
+//---------------------------------------------------------------------------
+// iqconverter::reset
+//
+// Resets the DC offset estimate back to the nominal offset
+//
+// Arguments:
+//
+//	NONE
+
+void iqconverter::reset(void)
+{
+  m_dci = m_dcq = m_offset;
+
+  // Force the lookup table to be regenerated on the next conversion
+  m_lutdci = m_lutdcq = -1.0f;
+}
+
+//---------------------------------------------------------------------------
+// iqconverter::update_dc (private)
+//
+// Updates the running DC offset estimate from a block of input samples
+//
+// Arguments:
+//
+//	input		- Raw 8-bit I/Q samples
+//	count		- Number of I/Q samples (not bytes) in the block
+
+void iqconverter::update_dc(uint8_t const* input, size_t count)
+{
+  if (count == 0)
+    return;
+
+  uint64_t isum = 0; // Sum of the I channel samples
+  uint64_t qsum = 0; // Sum of the Q channel samples
+
+  for (size_t index = 0; index < count; index++)
+  {
+
+    isum += input[(index * 2)];
+    qsum += input[(index * 2) + 1];
+  }
+
+  // Smooth the block mean into the running estimate for each channel
+  float imean = static_cast<float>(static_cast<double>(isum) / count);
+  float qmean = static_cast<float>(static_cast<double>(qsum) / count);
+  m_dci += (imean - m_dci) * DC_ALPHA;
+  m_dcq += (qmean - m_dcq) * DC_ALPHA;
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
@@ -0,0 +1,107 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef __IQCONVERTER_H_
+#define __IQCONVERTER_H_
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class iqconverter
+//
+// Converts raw unsigned 8-bit I/Q samples from the device into interleaved
+// floating-point I/Q samples, computed as (sample - offset) * scale. The
+// fastest available SIMD implementation is selected at runtime, with a
+// lookup table implementation used as the fallback
+
+class iqconverter
+{
+public:
+  // Instance Constructors
+  //
+  iqconverter(float offset, float scale);
+  iqconverter(float offset, float scale, bool removedc);
+
+  // Destructor
+  //
+  ~iqconverter() = default;
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // convert
+  //
+  // Converts raw 8-bit I/Q samples into interleaved floating-point I/Q samples
+  void convert(uint8_t const* input, float* output, size_t count);
+  void convert(uint8_t const* input, double* output, size_t count);
+
+  // implementation (static)
+  //
+  // Gets the name of the implementation selected for this system
+  static char const* implementation(void);
+
+  // reset
+  //
+  // Resets the DC offset estimate back to the nominal offset
+  void reset(void);
+
+private:
+  iqconverter(iqconverter const&) = delete;
+  iqconverter& operator=(iqconverter const&) = delete;
+
+  // DC_ALPHA
+  //
+  // Smoothing factor applied to the per-block DC offset estimate
+  static float const DC_ALPHA;
+
+  //-----------------------------------------------------------------------
+  // Private Member Functions
+
+  // update_dc
+  //
+  // Updates the running DC offset estimate from a block of input samples
+  void update_dc(uint8_t const* input, size_t count);
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  float const m_offset; // Nominal input offset
+  float const m_scale; // Output scale factor
+  bool const m_removedc; // Flag to remove DC offset
+
+  float m_dci; // Current I channel offset
+  float m_dcq; // Current Q channel offset
+
+  float m_lut[2][256]; // Fallback lookup table (I/Q)
+  float m_lutdci; // I channel offset used to build the table
+  float m_lutdcq; // Q channel offset used to build the table
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __IQCONVERTER_H_
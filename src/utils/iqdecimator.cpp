@@ -0,0 +1,257 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+
+#include "iqdecimator.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdexcept>
+#include <string.h>
+
+#pragma warning(push, 4)
+
+// iqdecimator::CHUNK_SIZE (static)
+//
+// Number of input I/Q samples processed at a time
+size_t const iqdecimator::CHUNK_SIZE = 4096;
+
+// iqdecimator::HISTORY (static)
+//
+// Number of I/Q samples of history retained by each filter stage
+size_t const iqdecimator::HISTORY = 30;
+
+// iqdecimator::MAX_FACTOR (static)
+//
+// Maximum decimation factor
+uint32_t const iqdecimator::MAX_FACTOR = 64;
+
+// iqdecimator::s_coefficients (static)
+//
+// 31-tap Kaiser windowed half-band filter (beta = 8) in Q15; the center tap is 0.5 and
+// every even tap other than the center is zero.  Passband ripple is < 0.05dB to 0.18fs
+// and stopband attenuation is > 46dB from 0.32fs and > 79dB from 0.344fs
+int32_t const iqdecimator::s_coefficients[] = {10258, -2989, 1361, -630, 263, -90, 21, -2};
+
+//---------------------------------------------------------------------------
+// iqdecimator Constructor
+//
+// Arguments:
+//
+//	factor		- Decimation factor; must be a power of two up to MAX_FACTOR
+
+iqdecimator::iqdecimator(uint32_t factor) : m_factor(factor)
+{
+  if ((factor == 0) || (factor > MAX_FACTOR) || ((factor & (factor - 1)) != 0))
+    throw std::invalid_argument("factor");
+
+  // Each stage buffer holds the filter history followed by a chunk of input samples
+  for (uint32_t stage = factor; stage > 1; stage >>= 1)
+    m_stages.emplace_back(new int16_t[(HISTORY + CHUNK_SIZE) * 2]);
+
+  m_output.reset(new int16_t[(CHUNK_SIZE / factor) * 2]);
+
+  reset();
+}
+
+//---------------------------------------------------------------------------
+// iqdecimator::decimate
+//
+// Decimates and converts raw 8-bit I/Q samples into interleaved floating-point I/Q samples
+//
+// Arguments:
+//
+//	input		- Raw 8-bit I/Q samples
+//	output		- Interleaved floating-point I/Q output samples
+//	count		- Number of input I/Q samples (not bytes); must be a multiple of the factor
+//	scale		- Value to multiply each offset output sample by
+
+size_t iqdecimator::decimate(uint8_t const* input, float* output, size_t count, float scale)
+{
+  assert((input != nullptr) && (output != nullptr));
+  assert((count % m_factor) == 0);
+
+  // The filter stages each have a gain of two and the input stage doubles the samples
+  float const outscale = scale / static_cast<float>(m_factor * 2);
+  size_t outcount = 0;
+
+  for (size_t offset = 0; offset < count; offset += CHUNK_SIZE)
+  {
+
+    size_t const decimated = process(&input[offset * 2], std::min(count - offset, CHUNK_SIZE));
+    for (size_t index = 0; index < decimated * 2; index++)
+      output[(outcount * 2) + index] = static_cast<float>(m_output[index]) * outscale;
+
+    outcount += decimated;
+  }
+
+  return outcount;
+}
+
+//---------------------------------------------------------------------------
+// iqdecimator::decimate
+//
+// Decimates and converts raw 8-bit I/Q samples into interleaved floating-point I/Q samples
+//
+// Arguments:
+//
+//	input		- Raw 8-bit I/Q samples
+//	output		- Interleaved floating-point I/Q output samples
+//	count		- Number of input I/Q samples (not bytes); must be a multiple of the factor
+//	scale		- Value to multiply each offset output sample by
+
+size_t iqdecimator::decimate(uint8_t const* input, double* output, size_t count, double scale)
+{
+  assert((input != nullptr) && (output != nullptr));
+  assert((count % m_factor) == 0);
+
+  // The filter stages each have a gain of two and the input stage doubles the samples
+  double const outscale = scale / static_cast<double>(m_factor * 2);
+  size_t outcount = 0;
+
+  for (size_t offset = 0; offset < count; offset += CHUNK_SIZE)
+  {
+
+    size_t const decimated = process(&input[offset * 2], std::min(count - offset, CHUNK_SIZE));
+    for (size_t index = 0; index < decimated * 2; index++)
+      output[(outcount * 2) + index] = static_cast<double>(m_output[index]) * outscale;
+
+    outcount += decimated;
+  }
+
+  return outcount;
+}
+
+//---------------------------------------------------------------------------
+// iqdecimator::factor
+//
+// Gets the decimation factor
+//
+// Arguments:
+//
+//	NONE
+
+uint32_t iqdecimator::factor(void) const
+{
+  return m_factor;
+}
+
+//---------------------------------------------------------------------------
+// iqdecimator::filter (private, static)
+//
+// Applies a half-band filter stage, decimating by two
+//
+// Arguments:
+//
+//	buffer		- Stage buffer; HISTORY samples followed by the input samples
+//	count		- Number of input I/Q samples in the buffer after the history
+//	output		- Interleaved I/Q output samples (count / 2)
+
+void iqdecimator::filter(int16_t* buffer, size_t count, int16_t* output)
+{
+  size_t const center = HISTORY / 2;
+
+  // Only every other output sample is computed (polyphase), and only the odd taps
+  // and the center tap are non-zero; the symmetric taps are pre-added in pairs
+  for (size_t index = 0; index < count / 2; index++)
+  {
+
+    int16_t const* x = &buffer[index * 4];
+
+    int32_t i = static_cast<int32_t>(x[center * 2]) << 14;
+    int32_t q = static_cast<int32_t>(x[(center * 2) + 1]) << 14;
+
+    for (size_t tap = 0; tap < (center + 1) / 2; tap++)
+    {
+
+      size_t const before = (center - ((tap * 2) + 1)) * 2;
+      size_t const after = (center + ((tap * 2) + 1)) * 2;
+
+      i += s_coefficients[tap] * (static_cast<int32_t>(x[before]) + x[after]);
+      q += s_coefficients[tap] * (static_cast<int32_t>(x[before + 1]) + x[after + 1]);
+    }
+
+    // Q15 coefficients shifted by 14 bits give the stage a gain of two
+    i = std::min(std::max((i + (1 << 13)) >> 14, INT16_MIN), INT16_MAX);
+    q = std::min(std::max((q + (1 << 13)) >> 14, INT16_MIN), INT16_MAX);
+
+    output[(index * 2)] = static_cast<int16_t>(i);
+    output[(index * 2) + 1] = static_cast<int16_t>(q);
+  }
+
+  // Retain the most recent samples as the history for the next chunk
+  memmove(buffer, &buffer[count * 2], HISTORY * 2 * sizeof(int16_t));
+}
+
+//---------------------------------------------------------------------------
+// iqdecimator::process (private)
+//
+// Decimates a chunk of input samples into the output buffer
+//
+// Arguments:
+//
+//	input		- Raw 8-bit I/Q samples
+//	count		- Number of input I/Q samples (not bytes), up to CHUNK_SIZE
+
+size_t iqdecimator::process(uint8_t const* input, size_t count)
+{
+  assert(count <= CHUNK_SIZE);
+
+  // Convert the raw samples into signed values centered on zero; (2 * sample) - 255
+  // is exact and symmetric around the nominal 127.5 offset of the device samples
+  int16_t* first = (m_stages.empty()) ? m_output.get() : &m_stages[0][HISTORY * 2];
+  for (size_t index = 0; index < count * 2; index++)
+    first[index] = static_cast<int16_t>((static_cast<int16_t>(input[index]) * 2) - 255);
+
+  // Run each of the half-band stages; the output of each stage is written after the
+  // history in the next stage's buffer, and the final stage writes the output buffer
+  for (size_t stage = 0; stage < m_stages.size(); stage++)
+  {
+
+    int16_t* output =
+        (stage + 1 < m_stages.size()) ? &m_stages[stage + 1][HISTORY * 2] : m_output.get();
+
+    filter(m_stages[stage].get(), count, output);
+    count /= 2;
+  }
+
+  return count;
+}
+
+//---------------------------------------------------------------------------
+// iqdecimator::reset
+//
+// Resets the filter history
+//
+// Arguments:
+//
+//	NONE
+
+void iqdecimator::reset(void)
+{
+  for (auto& stage : m_stages)
+    memset(stage.get(), 0, HISTORY * 2 * sizeof(int16_t));
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
@@ -0,0 +1,126 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+
+#ifndef __IQDECIMATOR_H_
+#define __IQDECIMATOR_H_
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class iqdecimator
+//
+// Decimates raw unsigned 8-bit I/Q samples from the device by a power of two
+// ahead of the floating-point conversion.  The decimation is performed in the
+// integer domain by a cascade of polyphase half-band filters, each of which
+// halves the sample rate; only the decimated samples are converted into
+// interleaved floating-point I/Q samples, computed as (sample - 127.5) * scale.
+// Each half-band stage is flat to 0.18 of its input rate and rejects aliases by
+// more than 46dB, so the signal of interest must lie within +/- (0.36 * output
+// rate) of the center; the outer edges of the decimated band are not usable
+
+class iqdecimator
+{
+public:
+  // Instance Constructor
+  //
+  iqdecimator(uint32_t factor);
+
+  // Destructor
+  //
+  ~iqdecimator() = default;
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // decimate
+  //
+  // Decimates and converts raw 8-bit I/Q samples into interleaved floating-point I/Q samples
+  size_t decimate(uint8_t const* input, float* output, size_t count, float scale);
+  size_t decimate(uint8_t const* input, double* output, size_t count, double scale);
+
+  // factor
+  //
+  // Gets the decimation factor
+  uint32_t factor(void) const;
+
+  // reset
+  //
+  // Resets the filter history
+  void reset(void);
+
+  // MAX_FACTOR
+  //
+  // Maximum decimation factor
+  static uint32_t const MAX_FACTOR;
+
+private:
+  iqdecimator(iqdecimator const&) = delete;
+  iqdecimator& operator=(iqdecimator const&) = delete;
+
+  // CHUNK_SIZE
+  //
+  // Number of input I/Q samples processed at a time
+  static size_t const CHUNK_SIZE;
+
+  // HISTORY
+  //
+  // Number of I/Q samples of history retained by each filter stage
+  static size_t const HISTORY;
+
+  // s_coefficients
+  //
+  // Half-band filter coefficients for the odd taps either side of the center tap
+  static int32_t const s_coefficients[];
+
+  //-----------------------------------------------------------------------
+  // Private Member Functions
+
+  // filter
+  //
+  // Applies a half-band filter stage, decimating by two
+  static void filter(int16_t* buffer, size_t count, int16_t* output);
+
+  // process
+  //
+  // Decimates a chunk of input samples into the output buffer
+  size_t process(uint8_t const* input, size_t count);
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  uint32_t const m_factor; // Decimation factor
+  std::vector<std::unique_ptr<int16_t[]>> m_stages; // Filter stage buffers
+  std::unique_ptr<int16_t[]> m_output; // Decimated output buffer
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __IQDECIMATOR_H_
@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __LATENCYCONTROL_H_
+#define __LATENCYCONTROL_H_
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+#pragma warning(push, 4)
+
+//-----------------------------------------------------------------------------
+// latencycontrol
+//
+// Manages the amount of audio, in milliseconds, that a stream holds in its output
+// queue. Output is held back at startup and after an underrun until the queue has
+// been filled to the target latency. In adaptive mode each underrun also grows the
+// target, which is shrunk back towards the configured latency after a period of
+// stable playback; the stream's clock recovery then drains the excess gradually.
+// A free running queue (timeshift buffer, unpaced input) is never held back; its
+// reader is not the player, so an empty queue is not an underrun
+
+class latencycontrol
+{
+public:
+  // MAX_LATENCY
+  //
+  // Maximum target latency, in milliseconds
+  static constexpr uint32_t MAX_LATENCY = 10000;
+
+  // MIN_LATENCY
+  //
+  // Minimum target latency, in milliseconds
+  static constexpr uint32_t MIN_LATENCY = 100;
+
+  // Instance Constructor
+  //
+  latencycontrol(uint32_t latency, bool adaptive, bool freerun)
+    : m_minimum(std::min(std::max(latency, MIN_LATENCY), MAX_LATENCY)),
+      m_maximum((adaptive && !freerun) ? std::min(m_minimum * MAX_GROWTH, MAX_LATENCY)
+                                       : m_minimum),
+      m_freerun(freerun), m_target(m_minimum), m_buffering(!freerun),
+      m_lastavailable(std::chrono::steady_clock::now()), m_laststable(m_lastavailable)
+  {
+  }
+
+  // Destructor
+  //
+  ~latencycontrol() = default;
+
+  //-------------------------------------------------------------------------
+  // Member Functions
+
+  // buffering (consumer)
+  //
+  // Updates the controller with the state of the queue at a read; returns true if the
+  // reader should hold back output to allow the queue to fill up to the target latency
+  bool buffering(bool available, double queued)
+  {
+    if (m_freerun)
+      return false;
+
+    auto const now = std::chrono::steady_clock::now();
+
+    if (available)
+      m_lastavailable = now;
+
+    // While buffering, output is held until the queue has filled to the target latency
+    if (m_buffering)
+    {
+
+      if (queued < m_target.load())
+        return true;
+
+      m_buffering = false;
+      m_laststable = now;
+      return false;
+    }
+
+    // The queue running dry for longer than the underrun threshold indicates the producer
+    // can't keep up with the consumer; grow the target (adaptive only) and start buffering
+    if ((!available) &&
+        ((now - m_lastavailable) >= std::chrono::milliseconds(UNDERRUN_THRESHOLD)))
+    {
+
+      m_target.store(std::min((m_target.load() * 3) / 2, m_maximum));
+      m_buffering = true;
+      return true;
+    }
+
+    // After a period of stable playback, shrink the target back towards the minimum
+    if ((now - m_laststable) >= std::chrono::milliseconds(STABLE_PERIOD))
+    {
+
+      m_target.store(std::max((m_target.load() * 3) / 4, m_minimum));
+      m_laststable = now;
+    }
+
+    return false;
+  }
+
+  // limit
+  //
+  // Gets the maximum amount of audio the output queue should be able to hold
+  uint32_t limit(void) const { return m_maximum * 2; }
+
+  // target
+  //
+  // Gets the current target latency
+  uint32_t target(void) const { return m_target.load(); }
+
+private:
+  latencycontrol(latencycontrol const&) = delete;
+  latencycontrol& operator=(latencycontrol const&) = delete;
+
+  // MAX_GROWTH
+  //
+  // Maximum growth of the target latency in adaptive mode
+  static constexpr uint32_t MAX_GROWTH = 4;
+
+  // STABLE_PERIOD
+  //
+  // Period of playback without an underrun before the target is shrunk, in milliseconds
+  static constexpr uint32_t STABLE_PERIOD = 60000;
+
+  // UNDERRUN_THRESHOLD
+  //
+  // Length of time the queue must be empty to be considered an underrun, in milliseconds
+  static constexpr uint32_t UNDERRUN_THRESHOLD = 250;
+
+  //-------------------------------------------------------------------------
+  // Member Variables
+
+  uint32_t const m_minimum; // Minimum (configured) target latency
+  uint32_t const m_maximum; // Maximum target latency
+  bool const m_freerun; // Flag to never hold back output
+  std::atomic<uint32_t> m_target; // Current target latency
+
+  bool m_buffering; // Flag if output is being held
+  std::chrono::steady_clock::time_point m_lastavailable; // Time data was last available
+  std::chrono::steady_clock::time_point m_laststable; // Start of the stable period
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __LATENCYCONTROL_H_
@@ -0,0 +1,177 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __PACKETPOOL_H_
+#define __PACKETPOOL_H_
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+#pragma warning(push, 4)
+
+//-----------------------------------------------------------------------------
+// packetpool
+//
+// Implements a pool of recycled demux packets. Each packet owns a payload buffer
+// that is kept when the packet is returned to the pool, so steady-state streams
+// fill the same buffers over and over instead of allocating a new packet and a new
+// payload for every audio frame. A payload is only reallocated when a packet has
+// to hold more data than it has ever held before
+
+class packetpool
+{
+public:
+  //-------------------------------------------------------------------------
+  // packet
+  //
+  // Defines the contents of a pooled demux packet
+
+  struct packet
+  {
+
+    int streamid = 0; // Stream identifier
+    int size = 0; // Length of the payload data
+    double duration = 0; // Packet duration
+    double dts = 0; // Decode time stamp
+    double pts = 0; // Presentation time stamp
+    size_t capacity = 0; // Allocated length of the payload buffer
+    std::unique_ptr<uint8_t[]> data; // Payload buffer
+  };
+
+  // packet_ptr
+  //
+  // Defines the type of a pooled packet handle
+  using packet_ptr = std::unique_ptr<packet>;
+
+  // Instance Constructor
+  //
+  packetpool(size_t maxpackets, size_t payloadsize) : m_maxpackets(maxpackets)
+  {
+    if (maxpackets == 0)
+      throw std::invalid_argument("maxpackets");
+
+    // Preallocate all of the packets and their payload buffers up front
+    m_free.reserve(maxpackets);
+    for (size_t index = 0; index < maxpackets; index++)
+    {
+
+      packet_ptr item = std::make_unique<packet>();
+      if (payloadsize > 0)
+      {
+
+        item->data = std::unique_ptr<uint8_t[]>(new uint8_t[payloadsize]);
+        item->capacity = payloadsize;
+      }
+
+      m_free.push_back(std::move(item));
+    }
+  }
+
+  // Destructor
+  //
+  ~packetpool() = default;
+
+  //-------------------------------------------------------------------------
+  // Member Functions
+
+  // acquire
+  //
+  // Acquires a packet with a payload buffer of at least the specified length; a new
+  // packet is allocated if the pool has been exhausted
+  packet_ptr acquire(size_t size)
+  {
+    packet_ptr item;
+
+    {
+      std::unique_lock<std::mutex> lock(m_lock);
+      if (!m_free.empty())
+      {
+
+        item = std::move(m_free.back());
+        m_free.pop_back();
+      }
+    }
+
+    if (!item)
+      item = std::make_unique<packet>();
+
+    // Grow the payload buffer if it's not large enough to hold the requested data
+    if (item->capacity < size)
+    {
+
+      item->data = std::unique_ptr<uint8_t[]>(new uint8_t[size]);
+      item->capacity = size;
+    }
+
+    item->streamid = 0;
+    item->size = static_cast<int>(size);
+    item->duration = item->dts = item->pts = 0;
+
+    return item;
+  }
+
+  // release
+  //
+  // Returns a packet or a range of packets to the pool; packets in excess of the
+  // maximum pool size are destroyed
+  void release(packet_ptr&& item)
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (item && (m_free.size() < m_maxpackets))
+      m_free.push_back(std::move(item));
+    item.reset();
+  }
+
+  template<typename _iterator> void release(_iterator first, _iterator last)
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (; first != last; ++first)
+    {
+
+      if (*first && (m_free.size() < m_maxpackets))
+        m_free.push_back(std::move(*first));
+      first->reset();
+    }
+  }
+
+private:
+  packetpool(packetpool const&) = delete;
+  packetpool& operator=(packetpool const&) = delete;
+
+  //-------------------------------------------------------------------------
+  // Member Variables
+
+  size_t const m_maxpackets; // Maximum number of pooled packets
+  std::vector<packet_ptr> m_free; // Available packets
+  mutable std::mutex m_lock; // Synchronization object
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __PACKETPOOL_H_
@@ -0,0 +1,392 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#include "pcmgain.h"
+
+#include "simd.h"
+
+#include <assert.h>
+#include <string.h>
+
+#pragma warning(push, 4)
+
+// int16_kernel_t
+//
+// Defines the signature of a SIMD 16-bit integer gain kernel; the kernels process as
+// many samples as possible and return the number of samples that were processed
+using int16_kernel_t = size_t (*)(int16_t const*, int16_t*, size_t, float);
+
+// float_kernel_t
+//
+// Defines the signature of a SIMD floating-point gain kernel
+using float_kernel_t = size_t (*)(float const*, float*, size_t, float);
+
+//---------------------------------------------------------------------------
+// SIMD KERNELS
+//
+// Each kernel computes (sample * gain) clamped to the range of the sample type; the
+// input and output buffers may be the same buffer
+
+#ifdef SIMD_X86
+
+// gain_int16_sse2 (local)
+//
+// SSE2 16-bit integer gain kernel, 8 samples per iteration
+static size_t gain_int16_sse2(int16_t const* input, int16_t* output, size_t count, float gain)
+{
+  __m128 const vgain = _mm_set1_ps(gain);
+  __m128 const vmin = _mm_set1_ps(-32768.0f);
+  __m128 const vmax = _mm_set1_ps(32767.0f);
+
+  size_t const blocks = count / 8;
+  for (size_t block = 0; block < blocks; block++)
+  {
+
+    __m128i samples = _mm_loadu_si128(reinterpret_cast<__m128i const*>(input));
+
+    // Sign-extend into two vectors of 32-bit integers and convert to floating point
+    __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16));
+    __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16));
+
+    // Apply the gain and clamp before converting back; the pack saturates as well
+    lo = _mm_max_ps(_mm_min_ps(_mm_mul_ps(lo, vgain), vmax), vmin);
+    hi = _mm_max_ps(_mm_min_ps(_mm_mul_ps(hi, vgain), vmax), vmin);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                     _mm_packs_epi32(_mm_cvttps_epi32(lo), _mm_cvttps_epi32(hi)));
+
+    input += 8;
+    output += 8;
+  }
+
+  return blocks * 8;
+}
+
+// gain_int16_avx2 (local)
+//
+// AVX2 16-bit integer gain kernel, 16 samples per iteration
+SIMD_TARGET_AVX2 static size_t gain_int16_avx2(int16_t const* input,
+                                               int16_t* output,
+                                               size_t count,
+                                               float gain)
+{
+  __m256 const vgain = _mm256_set1_ps(gain);
+  __m256 const vmin = _mm256_set1_ps(-32768.0f);
+  __m256 const vmax = _mm256_set1_ps(32767.0f);
+
+  size_t const blocks = count / 16;
+  for (size_t block = 0; block < blocks; block++)
+  {
+
+    __m256 lo = _mm256_cvtepi32_ps(
+        _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input))));
+    __m256 hi = _mm256_cvtepi32_ps(
+        _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(input + 8))));
+
+    lo = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(lo, vgain), vmax), vmin);
+    hi = _mm256_max_ps(_mm256_min_ps(_mm256_mul_ps(hi, vgain), vmax), vmin);
+
+    // The 256-bit pack operates on each 128-bit lane separately; restore the sample order
+    __m256i packed = _mm256_packs_epi32(_mm256_cvttps_epi32(lo), _mm256_cvttps_epi32(hi));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output),
+                        _mm256_permute4x64_epi64(packed, 0xD8));
+
+    input += 16;
+    output += 16;
+  }
+
+  return blocks * 16;
+}
+
+// gain_float_sse (local)
+//
+// SSE floating-point gain kernel, 8 samples per iteration
+static size_t gain_float_sse(float const* input, float* output, size_t count, float gain)
+{
+  __m128 const vgain = _mm_set1_ps(gain);
+  __m128 const vmin = _mm_set1_ps(-1.0f);
+  __m128 const vmax = _mm_set1_ps(1.0f);
+
+  size_t const blocks = count / 8;
+  for (size_t block = 0; block < blocks; block++)
+  {
+
+    __m128 lo = _mm_mul_ps(_mm_loadu_ps(input), vgain);
+    __m128 hi = _mm_mul_ps(_mm_loadu_ps(input + 4), vgain);
+    _mm_storeu_ps(output, _mm_max_ps(_mm_min_ps(lo, vmax), vmin));
+    _mm_storeu_ps(output + 4, _mm_max_ps(_mm_min_ps(hi, vmax), vmin));
+
+    input += 8;
+    output += 8;
+  }
+
+  return blocks * 8;
+}
+
+#endif // SIMD_X86
+
+#ifdef SIMD_NEON
+
+// gain_int16_neon (local)
+//
+// NEON 16-bit integer gain kernel, 8 samples per iteration
+static size_t gain_int16_neon(int16_t const* input, int16_t* output, size_t count, float gain)
+{
+  float32x4_t const vmin = vdupq_n_f32(-32768.0f);
+  float32x4_t const vmax = vdupq_n_f32(32767.0f);
+
+  size_t const blocks = count / 8;
+  for (size_t block = 0; block < blocks; block++)
+  {
+
+    int16x8_t samples = vld1q_s16(input);
+    float32x4_t lo = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), gain);
+    float32x4_t hi = vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), gain);
+
+    lo = vmaxq_f32(vminq_f32(lo, vmax), vmin);
+    hi = vmaxq_f32(vminq_f32(hi, vmax), vmin);
+    vst1q_s16(output,
+              vcombine_s16(vqmovn_s32(vcvtq_s32_f32(lo)), vqmovn_s32(vcvtq_s32_f32(hi))));
+
+    input += 8;
+    output += 8;
+  }
+
+  return blocks * 8;
+}
+
+// gain_float_neon (local)
+//
+// NEON floating-point gain kernel, 8 samples per iteration
+static size_t gain_float_neon(float const* input, float* output, size_t count, float gain)
+{
+  float32x4_t const vmin = vdupq_n_f32(-1.0f);
+  float32x4_t const vmax = vdupq_n_f32(1.0f);
+
+  size_t const blocks = count / 8;
+  for (size_t block = 0; block < blocks; block++)
+  {
+
+    float32x4_t lo = vmulq_n_f32(vld1q_f32(input), gain);
+    float32x4_t hi = vmulq_n_f32(vld1q_f32(input + 4), gain);
+    vst1q_f32(output, vmaxq_f32(vminq_f32(lo, vmax), vmin));
+    vst1q_f32(output + 4, vmaxq_f32(vminq_f32(hi, vmax), vmin));
+
+    input += 8;
+    output += 8;
+  }
+
+  return blocks * 8;
+}
+
+#endif // SIMD_NEON
+
+// select_int16_kernel (local)
+//
+// Selects the fastest available 16-bit integer gain kernel for this system
+static int16_kernel_t select_int16_kernel(char const** name)
+{
+#if defined(SIMD_X86)
+  if (simd::has_avx2())
+  {
+    *name = "avx2";
+    return gain_int16_avx2;
+  }
+  *name = "sse2";
+  return gain_int16_sse2;
+#elif defined(SIMD_NEON)
+  *name = "neon";
+  return gain_int16_neon;
+#else
+  *name = "scalar";
+  return nullptr;
+#endif
+}
+
+// select_float_kernel (local)
+//
+// Selects the fastest available floating-point gain kernel for this system
+static float_kernel_t select_float_kernel(void)
+{
+#if defined(SIMD_X86)
+  return gain_float_sse;
+#elif defined(SIMD_NEON)
+  return gain_float_neon;
+#else
+  return nullptr;
+#endif
+}
+
+// s_kernelname
+//
+// Name of the selected 16-bit integer gain kernel
+static char const* s_kernelname = "scalar";
+
+// s_int16_kernel
+//
+// Selected 16-bit integer gain kernel, or nullptr if only the scalar code is available
+static int16_kernel_t const s_int16_kernel = select_int16_kernel(&s_kernelname);
+
+// s_float_kernel
+//
+// Selected floating-point gain kernel, or nullptr if only the scalar code is available
+static float_kernel_t const s_float_kernel = select_float_kernel();
+
+//---------------------------------------------------------------------------
+// pcmgain Constructor
+//
+// Arguments:
+//
+//	gain		- Linear gain factor to apply to the samples
+
+pcmgain::pcmgain(float gain) : m_gain(gain), m_unity(gain == 1.0f)
+{
+}
+
+//---------------------------------------------------------------------------
+// pcmgain::apply
+//
+// Applies the gain to a buffer of samples in place
+//
+// Arguments:
+//
+//	samples		- 16-bit PCM samples
+//	count		- Number of samples (not frames)
+
+void pcmgain::apply(int16_t* samples, size_t count) const
+{
+  if (m_unity)
+    return;
+
+  apply(samples, samples, count);
+}
+
+//---------------------------------------------------------------------------
+// pcmgain::apply
+//
+// Applies the gain to a buffer of samples, writing the results to an output buffer
+//
+// Arguments:
+//
+//	input		- 16-bit PCM input samples
+//	output		- 16-bit PCM output samples; may be the same as input
+//	count		- Number of samples (not frames)
+
+void pcmgain::apply(int16_t const* input, int16_t* output, size_t count) const
+{
+  assert((input != nullptr) && (output != nullptr));
+
+  // With a gain of 0dB the samples only need to be copied, if at all
+  if (m_unity)
+  {
+
+    if (input != output)
+      memcpy(output, input, count * sizeof(int16_t));
+    return;
+  }
+
+  // Process as many samples as possible with the SIMD kernel, if one is available
+  size_t processed = 0;
+  if (s_int16_kernel != nullptr)
+    processed = s_int16_kernel(input, output, count, m_gain);
+
+  // Process the remaining samples individually
+  for (size_t index = processed; index < count; index++)
+  {
+
+    float value = input[index] * m_gain;
+    if (value > 32767.0f)
+      value = 32767.0f;
+    else if (value < -32768.0f)
+      value = -32768.0f;
+
+    output[index] = static_cast<int16_t>(value);
+  }
+}
+
+//---------------------------------------------------------------------------
+// pcmgain::apply
+//
+// Applies the gain to a buffer of normalized floating-point samples in place
+//
+// Arguments:
+//
+//	samples		- Floating-point PCM samples in the range [-1.0, 1.0]
+//	count		- Number of samples (not frames)
+
+void pcmgain::apply(float* samples, size_t count) const
+{
+  assert(samples != nullptr);
+
+  if (m_unity)
+    return;
+
+  // Process as many samples as possible with the SIMD kernel, if one is available
+  size_t processed = 0;
+  if (s_float_kernel != nullptr)
+    processed = s_float_kernel(samples, samples, count, m_gain);
+
+  // Process the remaining samples individually
+  for (size_t index = processed; index < count; index++)
+  {
+
+    float value = samples[index] * m_gain;
+    if (value > 1.0f)
+      value = 1.0f;
+    else if (value < -1.0f)
+      value = -1.0f;
+
+    samples[index] = value;
+  }
+}
+
+//---------------------------------------------------------------------------
+// pcmgain::gain
+//
+// Gets the linear gain factor
+//
+// Arguments:
+//
+//	NONE
+
+float pcmgain::gain(void) const
+{
+  return m_gain;
+}
+
+//---------------------------------------------------------------------------
+// pcmgain::implementation (static)
+//
+// Gets the name of the implementation selected for this system
+//
+// Arguments:
+//
+//	NONE
+
+char const* pcmgain::implementation(void)
+{
+  return s_kernelname;
+}
+
+//---------------------------------------------------------------------------
+
+#pragma warning(pop)
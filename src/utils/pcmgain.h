@@ -0,0 +1,87 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __PCMGAIN_H_
+#define __PCMGAIN_H_
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#pragma warning(push, 4)
+
+//---------------------------------------------------------------------------
+// Class pcmgain
+//
+// Applies a fixed output gain to PCM audio samples, saturating the results to
+// the range of the sample type rather than allowing them to wrap around. The
+// fastest available SIMD implementation is selected at runtime, and a gain of
+// exactly 0dB leaves the samples untouched
+
+class pcmgain
+{
+public:
+  // Instance Constructor
+  //
+  pcmgain(float gain);
+
+  // Destructor
+  //
+  ~pcmgain() = default;
+
+  //-----------------------------------------------------------------------
+  // Member Functions
+
+  // apply
+  //
+  // Applies the gain to a buffer of samples, either in place or into an output buffer
+  void apply(int16_t* samples, size_t count) const;
+  void apply(int16_t const* input, int16_t* output, size_t count) const;
+  void apply(float* samples, size_t count) const;
+
+  // gain
+  //
+  // Gets the linear gain factor
+  float gain(void) const;
+
+  // implementation (static)
+  //
+  // Gets the name of the implementation selected for this system
+  static char const* implementation(void);
+
+private:
+  pcmgain(pcmgain const&) = delete;
+  pcmgain& operator=(pcmgain const&) = delete;
+
+  //-----------------------------------------------------------------------
+  // Member Variables
+
+  float const m_gain; // Linear gain factor
+  bool const m_unity; // Flag if the gain is exactly 0dB
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __PCMGAIN_H_
@@ -0,0 +1,321 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef __SAMPLEPOOL_H_
+#define __SAMPLEPOOL_H_
+#pragma once
+
+#include "align.h"
+
+#include <assert.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+#pragma warning(push, 4)
+
+//-----------------------------------------------------------------------------
+// samplepool
+//
+// Implements a pool of reference-counted, cache-line aligned sample blocks. The
+// initial blocks are allocated when the pool is constructed; the acquire/release
+// operations only touch the heap when an exhausted pool is allowed to grow towards
+// its maximum size, which allows the pool to be used from the device callbacks
+// without introducing allocator churn
+
+template<typename _type>
+class samplepool
+{
+  static_assert(std::is_trivially_copyable<_type>::value,
+                "samplepool element type must be trivially copyable");
+
+public:
+  // ALIGNMENT
+  //
+  // Alignment of each block in the pool, in bytes
+  static unsigned int const ALIGNMENT = 64;
+
+  //-------------------------------------------------------------------------
+  // block
+  //
+  // Reference-counted handle to a single block in the pool; the block is
+  // returned to the pool when the last handle referencing it is released
+
+  class block
+  {
+  public:
+    // Instance Constructors
+    //
+    block() = default;
+    block(block const& rhs) : m_pool(rhs.m_pool), m_index(rhs.m_index)
+    {
+      if (m_pool)
+        m_pool->addref(m_index);
+    }
+    block(block&& rhs) noexcept : m_pool(rhs.m_pool), m_index(rhs.m_index)
+    {
+      rhs.m_pool = nullptr;
+    }
+
+    // Destructor
+    //
+    ~block() { reset(); }
+
+    // assignment operators
+    //
+    block& operator=(block const& rhs)
+    {
+      if (this != &rhs)
+      {
+        block copy(rhs);
+        *this = std::move(copy);
+      }
+      return *this;
+    }
+    block& operator=(block&& rhs) noexcept
+    {
+      if (this != &rhs)
+      {
+        reset();
+        m_pool = rhs.m_pool;
+        m_index = rhs.m_index;
+        rhs.m_pool = nullptr;
+      }
+      return *this;
+    }
+
+    // bool conversion operator
+    //
+    explicit operator bool() const { return m_pool != nullptr; }
+
+    // array subscript operator
+    //
+    _type& operator[](size_t index) const
+    {
+      assert(m_pool && (index < m_pool->m_blocksize));
+      return get()[index];
+    }
+
+    //-----------------------------------------------------------------------
+    // Member Functions
+
+    // get
+    //
+    // Gets the address of the block data
+    _type* get(void) const { return (m_pool) ? m_pool->address(m_index) : nullptr; }
+
+    // reset
+    //
+    // Releases the reference held against the block
+    void reset(void)
+    {
+      if (m_pool)
+        m_pool->release(m_index);
+      m_pool = nullptr;
+    }
+
+    // size
+    //
+    // Gets the length of the block, specified in elements
+    size_t size(void) const { return (m_pool) ? m_pool->m_blocksize : 0; }
+
+  private:
+    friend class samplepool;
+
+    // Instance Constructor (private)
+    //
+    block(samplepool* pool, size_t index) : m_pool(pool), m_index(index) {}
+
+    //-----------------------------------------------------------------------
+    // Member Variables
+
+    samplepool* m_pool = nullptr; // Owning pool instance
+    size_t m_index = 0; // Index of the block in the pool
+  };
+
+  // Instance Constructors
+  //
+  samplepool(size_t blockcount, size_t blocksize) : samplepool(blockcount, blocksize, blockcount)
+  {
+  }
+  samplepool(size_t blockcount, size_t blocksize, size_t maxblockcount)
+    : m_blockcount(blockcount),
+      m_maxblockcount(maxblockcount),
+      m_blocksize(blocksize),
+      m_stride(align::up(blocksize * sizeof(_type), ALIGNMENT)),
+      m_blocks(new uint8_t*[maxblockcount]),
+      m_refcounts(new std::atomic<int>[maxblockcount])
+  {
+    if (blockcount == 0)
+      throw std::invalid_argument("blockcount");
+    if (blocksize == 0)
+      throw std::invalid_argument("blocksize");
+    if (maxblockcount < blockcount)
+      throw std::invalid_argument("maxblockcount");
+
+    // Allocate the backing storage for all of the initial blocks in one shot; the extra
+    // ALIGNMENT bytes allow for the base address to be aligned up
+    m_storage = std::unique_ptr<uint8_t[]>(new uint8_t[(m_stride * blockcount) + ALIGNMENT]);
+    uint8_t* base = align::up(m_storage.get(), ALIGNMENT);
+
+    // Reserve enough space to track every block the pool can grow to, the vectors must not
+    // need to reallocate when a block is added to the pool
+    m_free.reserve(maxblockcount);
+    m_growth.reserve(maxblockcount - blockcount);
+
+    // Every block starts out unreferenced and in the free list
+    for (size_t index = 0; index < blockcount; index++)
+    {
+
+      m_blocks[index] = base + (index * m_stride);
+      m_refcounts[index].store(0);
+      m_free.push_back(blockcount - index - 1);
+    }
+  }
+
+  // Destructor
+  //
+  ~samplepool() = default;
+
+  //-------------------------------------------------------------------------
+  // Member Functions
+
+  // acquire
+  //
+  // Acquires a block from the pool; the returned block will be empty if the pool is exhausted
+  block acquire(void)
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (m_free.empty())
+      return grow();
+
+    size_t index = m_free.back();
+    m_free.pop_back();
+
+    assert(m_refcounts[index].load() == 0);
+    m_refcounts[index].store(1);
+
+    return block(this, index);
+  }
+
+  // available
+  //
+  // Gets the number of blocks that are available to be acquired
+  size_t available(void) const
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_free.size();
+  }
+
+  // blockcount
+  //
+  // Gets the total number of blocks in the pool
+  size_t blockcount(void) const
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+    return m_blockcount;
+  }
+
+  // blocksize
+  //
+  // Gets the length of each block in the pool, specified in elements
+  size_t blocksize(void) const { return m_blocksize; }
+
+private:
+  samplepool(samplepool const&) = delete;
+  samplepool& operator=(samplepool const&) = delete;
+
+  //-------------------------------------------------------------------------
+  // Private Member Functions
+
+  // addref
+  //
+  // Increments the reference count of a block
+  void addref(size_t index) { m_refcounts[index].fetch_add(1, std::memory_order_relaxed); }
+
+  // address
+  //
+  // Gets the address of a block
+  _type* address(size_t index) const { return reinterpret_cast<_type*>(m_blocks[index]); }
+
+  // grow
+  //
+  // Adds a new block to an exhausted pool and acquires it; m_lock must be held by the caller
+  block grow(void)
+  {
+    if (m_blockcount >= m_maxblockcount)
+      return block();
+
+    // A failed allocation is treated the same as an exhausted pool; the extra ALIGNMENT
+    // bytes allow for the block address to be aligned up
+    std::unique_ptr<uint8_t[]> storage(new (std::nothrow) uint8_t[m_stride + ALIGNMENT]);
+    if (!storage)
+      return block();
+
+    size_t index = m_blockcount++;
+    m_blocks[index] = align::up(storage.get(), ALIGNMENT);
+    m_growth.push_back(std::move(storage));
+
+    m_refcounts[index].store(1);
+
+    return block(this, index);
+  }
+
+  // release
+  //
+  // Decrements the reference count of a block and returns it to the pool if unreferenced
+  void release(size_t index)
+  {
+    if (m_refcounts[index].fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+
+      std::unique_lock<std::mutex> lock(m_lock);
+      m_free.push_back(index);
+    }
+  }
+
+  //-------------------------------------------------------------------------
+  // Member Variables
+
+  size_t m_blockcount; // Number of blocks
+  size_t const m_maxblockcount; // Maximum number of blocks
+  size_t const m_blocksize; // Elements per block
+  size_t const m_stride; // Bytes per block
+  std::unique_ptr<uint8_t[]> m_storage; // Initial block storage
+  std::vector<std::unique_ptr<uint8_t[]>> m_growth; // Added block storage
+  std::unique_ptr<uint8_t*[]> m_blocks; // Aligned block addresses
+  std::unique_ptr<std::atomic<int>[]> m_refcounts; // Block reference counts
+  std::vector<size_t> m_free; // Free block indexes
+  mutable std::mutex m_lock; // Synchronization object
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __SAMPLEPOOL_H_
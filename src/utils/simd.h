@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+
+#ifndef __SIMD_H_
+#define __SIMD_H_
+#pragma once
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#pragma warning(push, 4)
+
+// SIMD_TARGET_AVX2
+//
+// Marks a function as being compiled for AVX2; callers must check simd::has_avx2() first
+#if defined(SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_AVX2
+#endif
+
+// simd
+//
+// Namespace declarations for runtime SIMD feature detection
+namespace simd
+{
+
+#ifdef SIMD_X86
+
+// simd::has_avx2
+//
+// Determines if the processor and operating system support AVX2
+inline bool has_avx2(void)
+{
+#if defined(_MSC_VER)
+  int info[4] = {};
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+
+  // OSXSAVE and AVX must be present, and the OS must be saving the YMM state
+  __cpuid(info, 1);
+  if (((info[2] & (1 << 27)) == 0) || ((info[2] & (1 << 28)) == 0))
+    return false;
+  if ((_xgetbv(0) & 0x6) != 0x6)
+    return false;
+
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#elif defined(__GNUC__) || defined(__clang__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") != 0;
+#else
+  return false;
+#endif
+}
+
+#endif // SIMD_X86
+
+}; // namespace simd
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __SIMD_H_
@@ -0,0 +1,253 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//-----------------------------------------------------------------------------
+
+#ifndef __SPSC_QUEUE_H_
+#define __SPSC_QUEUE_H_
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stdint.h>
+
+#pragma warning(push, 4)
+
+//-----------------------------------------------------------------------------
+// spsc_queue
+//
+// Implements a bounded single-producer/single-consumer queue. push() and
+// try_pop() are wait-free; the consumer can block in wait() and the producer
+// only touches the mutex/condition variable when the consumer is actually
+// waiting. A push against a full queue fails and is counted as an overrun; a
+// producer that must not lose data can block in wait_for_space() first
+
+template<typename _type>
+class spsc_queue
+{
+public:
+  // Instance Constructor
+  //
+  spsc_queue(size_t capacity) : m_slotcount(capacity + 1), m_slots(new _type[capacity + 1])
+  {
+    if (capacity == 0)
+      throw std::invalid_argument("capacity");
+  }
+
+  // Destructor
+  //
+  ~spsc_queue() = default;
+
+  //-------------------------------------------------------------------------
+  // Member Functions
+
+  // capacity
+  //
+  // Gets the maximum number of items that can be held in the queue
+  size_t capacity(void) const { return m_slotcount - 1; }
+
+  // clear (consumer)
+  //
+  // Removes all items from the queue
+  void clear(void)
+  {
+    _type item;
+    while (try_pop(item))
+      item = _type();
+  }
+
+  // empty
+  //
+  // Determines if the queue is empty
+  bool empty(void) const { return m_head.load() == m_tail.load(); }
+
+  // full
+  //
+  // Determines if the queue is full
+  bool full(void) const
+  {
+    size_t const tail = m_tail.load();
+    return ((tail + 1 == m_slotcount) ? 0 : tail + 1) == m_head.load();
+  }
+
+  // notify
+  //
+  // Unconditionally wakes the consumer and producer, used to signal a change in the
+  // wait() or wait_for_space() predicate
+  void notify(void)
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_cv.notify_all();
+    m_spacecv.notify_all();
+  }
+
+  // overruns
+  //
+  // Gets the number of items that were rejected because the queue was full
+  uint64_t overruns(void) const { return m_overruns.load(std::memory_order_relaxed); }
+
+  // push (producer)
+  //
+  // Pushes an item into the queue; returns false if the queue was full
+  bool push(_type&& item)
+  {
+    size_t const tail = m_tail.load(std::memory_order_relaxed);
+    size_t const next = (tail + 1 == m_slotcount) ? 0 : tail + 1;
+
+    if (next == m_head.load(std::memory_order_acquire))
+    {
+
+      m_overruns.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    m_slots[tail] = std::move(item);
+    m_tail.store(next); // seq_cst; must be ordered before the m_waiting load
+
+    // Only take the lock and signal the condition if the consumer is waiting for data
+    if (m_waiting.load())
+    {
+
+      std::unique_lock<std::mutex> lock(m_lock);
+      m_cv.notify_one();
+    }
+
+    return true;
+  }
+
+  // size
+  //
+  // Gets the number of items in the queue; only accurate from the consumer or producer
+  size_t size(void) const
+  {
+    size_t const head = m_head.load();
+    size_t const tail = m_tail.load();
+    return (tail >= head) ? tail - head : (m_slotcount - head) + tail;
+  }
+
+  // try_pop (consumer)
+  //
+  // Pops an item from the queue; returns false if the queue was empty
+  bool try_pop(_type& item)
+  {
+    size_t const head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire))
+      return false;
+
+    item = std::move(m_slots[head]);
+    // seq_cst; must be ordered before the m_spacewaiting load
+    m_head.store((head + 1 == m_slotcount) ? 0 : head + 1);
+
+    // Only take the lock and signal the condition if the producer is waiting for space
+    if (m_spacewaiting.load())
+    {
+
+      std::unique_lock<std::mutex> lock(m_lock);
+      m_spacecv.notify_one();
+    }
+
+    return true;
+  }
+
+  // wait (consumer)
+  //
+  // Waits until the queue is not empty or the predicate has been satisfied
+  template<typename _predicate>
+  void wait(_predicate const& predicate)
+  {
+    if (!empty() || predicate())
+      return;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    m_waiting.store(true); // seq_cst; must be ordered before the m_tail load
+    m_cv.wait(lock, [&]() -> bool { return !empty() || predicate(); });
+    m_waiting.store(false);
+  }
+
+  // wait_for (consumer)
+  //
+  // Waits until the queue is not empty, the predicate has been satisfied, or the timeout expires
+  template<typename _predicate>
+  bool wait_for(uint32_t timeoutms, _predicate const& predicate)
+  {
+    if (!empty() || predicate())
+      return true;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    m_waiting.store(true); // seq_cst; must be ordered before the m_tail load
+    bool result = m_cv.wait_for(lock, std::chrono::milliseconds(timeoutms),
+                                [&]() -> bool { return !empty() || predicate(); });
+    m_waiting.store(false);
+
+    return result;
+  }
+
+  // wait_for_space (producer)
+  //
+  // Waits until the queue is not full or the predicate has been satisfied
+  template<typename _predicate>
+  void wait_for_space(_predicate const& predicate)
+  {
+    if (!full() || predicate())
+      return;
+
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    m_spacewaiting.store(true); // seq_cst; must be ordered before the m_head load
+    m_spacecv.wait(lock, [&]() -> bool { return !full() || predicate(); });
+    m_spacewaiting.store(false);
+  }
+
+private:
+  spsc_queue(spsc_queue const&) = delete;
+  spsc_queue& operator=(spsc_queue const&) = delete;
+
+  //-------------------------------------------------------------------------
+  // Member Variables
+
+  size_t const m_slotcount; // Number of slots (capacity + 1)
+  std::unique_ptr<_type[]> m_slots; // Queue slots
+
+  // The producer and consumer positions are padded onto separate cache lines to prevent
+  // false sharing; alignas() is avoided so the owning classes don't become over-aligned
+  std::atomic<size_t> m_head{0}; // Consumer position
+  uint8_t m_headpad[64 - sizeof(std::atomic<size_t>)] = {};
+  std::atomic<size_t> m_tail{0}; // Producer position
+  uint8_t m_tailpad[64 - sizeof(std::atomic<size_t>)] = {};
+  std::atomic<bool> m_waiting{false}; // Consumer waiting flag
+  std::atomic<bool> m_spacewaiting{false}; // Producer waiting flag
+  std::atomic<uint64_t> m_overruns{0}; // Number of rejected pushes
+
+  std::mutex m_lock; // Synchronization object
+  std::condition_variable m_cv; // Consumer wakeup condition
+  std::condition_variable m_spacecv; // Producer wakeup condition
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __SPSC_QUEUE_H_
@@ -0,0 +1,207 @@
+//---------------------------------------------------------------------------
+// Copyright (c) 2020-2022 Michael G. Brehm
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//---------------------------------------------------------------------------
+
+
+#ifndef __TRANSFERMETER_H_
+#define __TRANSFERMETER_H_
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+#pragma warning(push, 4)
+
+//-----------------------------------------------------------------------------
+// transfermeter
+//
+// Tracks the throughput and timing of the data transfers from a device. The
+// meter is updated from the device thread and can be read from any thread
+
+class transfermeter
+{
+public:
+  // Instance Constructor
+  //
+  transfermeter() = default;
+
+  // Destructor
+  //
+  ~transfermeter() = default;
+
+  //-------------------------------------------------------------------------
+  // Member Functions
+
+  // bytes
+  //
+  // Gets the total number of bytes that have been transferred
+  uint64_t bytes(void) const { return m_bytes.load(std::memory_order_relaxed); }
+
+  // bytespersecond
+  //
+  // Gets the average transfer rate since the meter was started
+  uint64_t bytespersecond(void) const
+  {
+    uint64_t elapsedus = m_elapsedus.load(std::memory_order_relaxed);
+    return (elapsedus > 0) ? (bytes() * 1000000) / elapsedus : 0;
+  }
+
+  // droppedtransfers
+  //
+  // Gets the number of transfers that are presumed to have been lost by the device
+  uint64_t droppedtransfers(void) const { return m_dropped.load(std::memory_order_relaxed); }
+
+  // jitter
+  //
+  // Gets the mean deviation of the transfer arrival times from nominal, in microseconds
+  uint64_t jitter(void) const
+  {
+    uint64_t intervals = m_intervals.load(std::memory_order_relaxed);
+    return (intervals > 0) ? m_deviationus.load(std::memory_order_relaxed) / intervals : 0;
+  }
+
+  // longestgap
+  //
+  // Gets the longest gap between two transfers, in milliseconds
+  uint64_t longestgap(void) const { return m_longestgapus.load(std::memory_order_relaxed) / 1000; }
+
+  // stalltime
+  //
+  // Gets the total amount of time that transfers were late, in milliseconds
+  uint64_t stalltime(void) const { return m_stallus.load(std::memory_order_relaxed) / 1000; }
+
+  // start
+  //
+  // Resets the meter; the nominal rate is used to determine when a transfer is late and
+  // the number of buffers the device has in flight determines when one must have been lost
+  void start(uint64_t nominalbytespersecond, size_t buffercount)
+  {
+    m_nominal = nominalbytespersecond;
+    m_buffercount = buffercount;
+    m_started = false;
+
+    m_bytes.store(0, std::memory_order_relaxed);
+    m_transfers.store(0, std::memory_order_relaxed);
+    m_intervals.store(0, std::memory_order_relaxed);
+    m_deviationus.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_elapsedus.store(0, std::memory_order_relaxed);
+    m_longestgapus.store(0, std::memory_order_relaxed);
+    m_stallus.store(0, std::memory_order_relaxed);
+  }
+
+  // transfers
+  //
+  // Gets the total number of transfers that have been completed
+  uint64_t transfers(void) const { return m_transfers.load(std::memory_order_relaxed); }
+
+  // update
+  //
+  // Records a transfer of the specified number of bytes
+  void update(size_t count)
+  {
+    timepoint_t now = std::chrono::steady_clock::now();
+
+    // The first transfer establishes the start time; the time spent waiting
+    // for it is connection setup rather than a gap in the data
+    bool const first = !m_started;
+    if (first)
+    {
+
+      m_start = m_last = now;
+      m_started = true;
+    }
+
+    uint64_t gapus = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - m_last).count());
+    m_last = now;
+
+    if (gapus > m_longestgapus.load(std::memory_order_relaxed))
+      m_longestgapus.store(gapus, std::memory_order_relaxed);
+
+    // A transfer is considered to have stalled if it took more than twice as long to
+    // arrive as the amount of data it carried represents; only the excess is counted
+    if (m_nominal > 0)
+    {
+
+      uint64_t expectedus = (static_cast<uint64_t>(count) * 1000000) / m_nominal;
+      if (gapus > (expectedus * 2))
+        m_stallus.fetch_add(gapus - expectedus, std::memory_order_relaxed);
+
+      // The jitter is the deviation of the arrival time from when the transfer was expected
+      if (!first)
+      {
+
+        m_deviationus.fetch_add((gapus > expectedus) ? gapus - expectedus : expectedus - gapus,
+                                std::memory_order_relaxed);
+        m_intervals.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      // If the gap was longer than every buffer the device had in flight could cover, the
+      // device had nowhere to put the data in the meantime and the excess has been lost
+      uint64_t const poolus = expectedus * m_buffercount;
+      if ((poolus > 0) && (gapus > poolus))
+        m_dropped.fetch_add(((gapus - poolus) + (expectedus - 1)) / expectedus,
+                            std::memory_order_relaxed);
+    }
+
+    uint64_t elapsedus = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - m_start).count());
+
+    m_bytes.fetch_add(count, std::memory_order_relaxed);
+    m_transfers.fetch_add(1, std::memory_order_relaxed);
+    m_elapsedus.store(elapsedus, std::memory_order_relaxed);
+  }
+
+private:
+  transfermeter(transfermeter const&) = delete;
+  transfermeter& operator=(transfermeter const&) = delete;
+
+  // timepoint_t
+  //
+  // Defines a point in time based on steady_clock
+  using timepoint_t = std::chrono::time_point<std::chrono::steady_clock>;
+
+  //-------------------------------------------------------------------------
+  // Member Variables
+
+  uint64_t m_nominal = 0; // Nominal transfer rate (bytes/sec)
+  size_t m_buffercount = 0; // Number of device buffers in flight
+  bool m_started = false; // Flag if the first transfer has been seen
+  timepoint_t m_start; // Time of the first transfer
+  timepoint_t m_last; // Time of the previous transfer
+
+  std::atomic<uint64_t> m_bytes{0}; // Total bytes transferred
+  std::atomic<uint64_t> m_elapsedus{0}; // Time from first to last transfer
+  std::atomic<uint64_t> m_longestgapus{0}; // Longest gap between transfers
+  std::atomic<uint64_t> m_stallus{0}; // Total stall time
+  std::atomic<uint64_t> m_transfers{0}; // Total transfers
+  std::atomic<uint64_t> m_intervals{0}; // Number of measured intervals
+  std::atomic<uint64_t> m_deviationus{0}; // Total arrival time deviation
+  std::atomic<uint64_t> m_dropped{0}; // Number of presumed lost transfers
+};
+
+//-----------------------------------------------------------------------------
+
+#pragma warning(pop)
+
+#endif // __TRANSFERMETER_H_
@@ -32,10 +32,15 @@
 
 #pragma warning(push, 4)
 
-// wxstream::MAX_SAMPLE_QUEUE
+// wxstream::MIN_DECIMATED_RATE
 //
-// Maximum number of queued sample sets from the device
-size_t const wxstream::MAX_SAMPLE_QUEUE = 200; // ~2sec
+// Minimum effective sample rate after front-end decimation
+uint32_t const wxstream::MIN_DECIMATED_RATE = 200000; // 200KHz
+
+// wxstream::SAMPLE_BLOCK_DURATION
+//
+// Approximate duration of a block of samples, in milliseconds
+uint32_t const wxstream::SAMPLE_BLOCK_DURATION = 10; // Demodulator processes ~.01sec per block
 
 // wxstream::STREAM_ID_AUDIO
 //
@@ -57,9 +62,15 @@ wxstream::wxstream(std::unique_ptr<rtldevice> device,
                    struct channelprops const& channelprops,
                    struct wxprops const& wxprops)
   : m_device(std::move(device)),
+    m_buffercount(tunerprops.buffercount),
+    m_bufferlength(tunerprops.bufferlength),
     m_muxname(generate_mux_name(channelprops)),
     m_pcmsamplerate(wxprops.outputrate),
-    m_pcmgain(MPOW(10.0, (wxprops.outputgain / 10.0)))
+    m_pcmgain(MPOW(10.0, (wxprops.outputgain / 10.0))),
+    m_freerun((wxprops.freerun) || (m_device->is_unpaced())),
+    m_latency(wxprops.outputlatency, wxprops.adaptivelatency, m_freerun),
+    m_clock(m_latency.target() / static_cast<double>(SAMPLE_BLOCK_DURATION), m_freerun),
+    m_queue(m_latency.limit() / SAMPLE_BLOCK_DURATION)
 {
   // The sample rate must be within 900001Hz - 3200000Hz
   if ((wxprops.samplerate < 900001) || (wxprops.samplerate > 3200000))
@@ -74,6 +85,27 @@ wxstream::wxstream(std::unique_ptr<rtldevice> device,
   // Initialize the RTL-SDR device instance
   m_device->set_frequency_correction(tunerprops.freqcorrection + channelprops.freqcorrection);
   uint32_t samplerate = m_device->set_sample_rate(wxprops.samplerate);
+
+  // If front-end decimation is enabled, select the largest power of two decimation factor
+  // that keeps the effective sample rate at or above the minimum required by the demodulator
+  if (wxprops.decimate)
+  {
+
+    uint32_t factor = 1;
+    while ((factor < iqdecimator::MAX_FACTOR) &&
+           ((samplerate / (factor * 2)) >= MIN_DECIMATED_RATE))
+      factor *= 2;
+
+    if (factor > 1)
+    {
+
+      m_decimator = std::unique_ptr<iqdecimator>(new iqdecimator(factor));
+      samplerate /= factor;
+    }
+  }
+
+  // The DC offset applied to the center frequency is based on the effective sample rate so
+  // the channel falls within the passband of the front-end decimator, if one is present
   uint32_t frequency =
       m_device->set_center_frequency(channelprops.frequency + (samplerate / 4)); // DC offset
 
@@ -87,15 +119,26 @@ wxstream::wxstream(std::unique_ptr<rtldevice> device,
   demodinfo.SquelchValue = -160;
 
   // Initialize the narrowband FM demodulator
-  m_demodulator = std::unique_ptr<CDemodulator>(new CDemodulator());
+  m_demodulator = std::unique_ptr<CDemodulator<>>(new CDemodulator<>());
   m_demodulator->SetInputSampleRate(static_cast<TYPEREAL>(samplerate));
   m_demodulator->SetDemod(DEMOD_FM, demodinfo);
   m_demodulator->SetDemodFreq(static_cast<TYPEREAL>(frequency - channelprops.frequency));
 
   // Initialize the output resampler
-  m_resampler = std::unique_ptr<CFractResampler>(new CFractResampler());
+  m_resampler = std::unique_ptr<CFractResampler<>>(new CFractResampler<>());
   m_resampler->Init(m_demodulator->GetInputBufferLimit());
 
+  // Allocate the pool of converted I/Q sample blocks; the queue is held at the target latency
+  // so only that many blocks are allocated up front, with one more being filled by the device
+  // and one more being demodulated.  The pool grows on demand when the target is increased,
+  // up to enough blocks to fill the queue to the latency limit
+  m_samplepool = std::unique_ptr<samplepool<TYPECPX>>(
+      new samplepool<TYPECPX>((m_latency.target() / SAMPLE_BLOCK_DURATION) + 2,
+                              m_demodulator->GetInputBufferLimit(), m_queue.capacity() + 2));
+
+  // Allocate the demodulator output buffer
+  m_outsamples = std::unique_ptr<TYPEREAL[]>(new TYPEREAL[m_demodulator->GetInputBufferLimit()]);
+
   // Adjust the device gain as specified by the channel properties
   m_device->set_automatic_gain_control(channelprops.autogain);
   if (channelprops.autogain == false)
@@ -115,6 +158,20 @@ wxstream::~wxstream()
   close();
 }
 
+//---------------------------------------------------------------------------
+// wxstream::canpause
+//
+// Gets a flag indicating if the stream allows pause operations
+//
+// Arguments:
+//
+//	NONE
+
+bool wxstream::canpause(void) const
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // wxstream::canseek
 //
@@ -141,6 +198,7 @@ bool wxstream::canseek(void) const
 void wxstream::close(void)
 {
   m_stop = true; // Signal worker thread to stop
+  m_queue.notify(); // Unblock a transfer waiting for queue space
   if (m_device)
     m_device->cancel_async(); // Cancel any async read operations
   if (m_worker.joinable())
@@ -206,9 +264,8 @@ void wxstream::demuxflush(void)
 
 DEMUX_PACKET* wxstream::demuxread(std::function<DEMUX_PACKET*(int)> const& allocator)
 {
-  // Wait for there to be a packet of samples available for processing
-  std::unique_lock<std::mutex> lock(m_queuelock);
-  m_cv.wait(lock, [&]() -> bool { return ((m_queue.size() > 0) || m_stopped.load() == true); });
+  // Wait up to 50ms for there to be a packet of samples available for processing
+  m_queue.wait_for(50, [&]() -> bool { return m_stopped.load() == true; });
 
   // If the worker thread was stopped, check for and re-throw any exception that occurred,
   // otherwise assume it was stopped normally and return an empty demultiplexer packet
@@ -221,16 +278,28 @@ DEMUX_PACKET* wxstream::demuxread(std::function<DEMUX_PACKET*(int)> const& alloc
       return allocator(0);
   }
 
-  // Pop off the topmost packet of samples from the queue<> and release the lock
-  std::unique_ptr<TYPECPX[]> insamples(std::move(m_queue.front()));
-  m_queue.pop();
-  lock.unlock();
+  // Hold back the output while the sample queue fills up to the target latency; wait for
+  // roughly another block of samples to be queued before returning an empty packet
+  size_t const queued = m_queue.size();
+  if (m_latency.buffering(queued > 0, static_cast<double>(queued * SAMPLE_BLOCK_DURATION)))
+  {
+
+    if (queued > 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(SAMPLE_BLOCK_DURATION));
+    return allocator(0);
+  }
+
+  // Pop off the topmost packet of samples from the queue
+  sample_queue_item_t insamples;
+  if (!m_queue.try_pop(insamples))
+    return allocator(0);
 
   // If the packet of samples is null, the writer has indicated there was a problem
   if (!insamples)
   {
 
     m_dts = STREAM_TIME_BASE; // Reset the current decode time stamp
+    m_clock.reset(); // Reset the output clock recovery
 
     // Create a STREAMCHANGE packet that has no data
     DEMUX_PACKET* packet = allocator(0);
@@ -241,20 +310,24 @@ DEMUX_PACKET* wxstream::demuxread(std::function<DEMUX_PACKET*(int)> const& alloc
   }
 
   // Process the I/Q data
-  std::unique_ptr<TYPEREAL[]> outsamples(new TYPEREAL[m_demodulator->GetInputBufferLimit()]);
   int audiopackets = m_demodulator->ProcessData(m_demodulator->GetInputBufferLimit(),
-                                                insamples.get(), outsamples.get());
+                                                insamples.get(), m_outsamples.get());
 
-  // Determine the size of the demultiplexer packet data and allocate it
-  int packetsize = audiopackets * sizeof(TYPEMONO16);
+  // Apply the current clock correction to the nominal resampling rate; the correction holds
+  // the sample queue at the target latency to compensate for the device and consumer clocks
+  m_clock.target(m_latency.target() / static_cast<double>(SAMPLE_BLOCK_DURATION));
+  TYPEREAL const rate = (m_demodulator->GetOutputRate() / m_pcmsamplerate) *
+                        static_cast<TYPEREAL>(m_clock.update(m_queue.size()));
+
+  // Determine the maximum size of the demultiplexer packet data and allocate it
+  int packetsize = (static_cast<int>(audiopackets / rate) + 2) * sizeof(TYPEMONO16);
   DEMUX_PACKET* packet = allocator(packetsize);
   if (packet == nullptr)
     return nullptr;
 
   // Resample the audio data directly into the allocated packet buffer
-  audiopackets = m_resampler->Resample(
-      audiopackets, (m_demodulator->GetOutputRate() / m_pcmsamplerate), outsamples.get(),
-      reinterpret_cast<TYPEMONO16*>(packet->pData), m_pcmgain);
+  audiopackets = m_resampler->Resample(audiopackets, rate, m_outsamples.get(),
+                                       reinterpret_cast<TYPEMONO16*>(packet->pData), m_pcmgain);
 
   // Calculate the proper duration for the packet
   double duration = (audiopackets / static_cast<double>(m_pcmsamplerate)) * STREAM_TIME_BASE;
@@ -298,6 +371,20 @@ std::string wxstream::devicename(void) const
   return std::string(m_device->get_device_name());
 }
 
+//---------------------------------------------------------------------------
+// wxstream::devicestatistics
+//
+// Gets the data transfer statistics for the device associated with the stream
+//
+// Arguments:
+//
+//	stats		- Structure to receive the statistics
+
+void wxstream::devicestatistics(struct rtldevice::device_statistics& stats) const
+{
+  m_device->get_statistics(stats);
+}
+
 //---------------------------------------------------------------------------
 // wxstream::enumproperties
 //
@@ -382,6 +469,20 @@ std::string wxstream::muxname(void) const
   return m_muxname;
 }
 
+//---------------------------------------------------------------------------
+// wxstream::overruns
+//
+// Gets the number of times that data was dropped because the stream fell behind
+//
+// Arguments:
+//
+//	NONE
+
+uint64_t wxstream::overruns(void) const
+{
+  return m_queue.overruns();
+}
+
 //---------------------------------------------------------------------------
 // wxstream::position
 //
@@ -440,6 +541,22 @@ long long wxstream::seek(long long /*position*/, int /*whence*/)
   return -1;
 }
 
+//---------------------------------------------------------------------------
+// wxstream::seektime
+//
+// Sets the stream pointer to a specific time
+//
+// Arguments:
+//
+//	time		- Time to seek to, in milliseconds
+//	backwards	- Flag indicating a backwards seek
+//	startpts	- On success, receives the PTS of the first packet after the seek
+
+bool wxstream::seektime(double /*time*/, bool /*backwards*/, double& /*startpts*/)
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // wxstream::servicename
 //
@@ -475,6 +592,20 @@ void wxstream::signalquality(int& quality, int& snr) const
   snr = std::max(0, std::min(100, static_cast<int>(100.0 * demodsnr)));
 }
 
+//---------------------------------------------------------------------------
+// wxstream::streamtimes
+//
+// Gets the time shift boundaries of the stream
+//
+// Arguments:
+//
+//	times		- Structure to receive the stream times
+
+bool wxstream::streamtimes(struct streamtimes& /*times*/) const
+{
+  return false;
+}
+
 //---------------------------------------------------------------------------
 // wxstream::transfer (private)
 //
@@ -489,56 +620,68 @@ void wxstream::transfer(scalar_condition<bool>& started)
   assert(m_demodulator);
   assert(m_device);
 
-  // The I/Q samples from the device come in as a pair of 8 bit unsigned integers
-  size_t const readsize = m_demodulator->GetInputBufferLimit() * 2;
+  // The I/Q samples from the device come in as a pair of 8 bit unsigned integers; if the
+  // front-end decimator is active each demodulator block requires proportionally more of them
+  size_t const factor = (m_decimator) ? m_decimator->factor() : 1;
+  size_t const blocksize = m_demodulator->GetInputBufferLimit() * 2 * factor;
+
+  // The tuner properties can request longer device transfers; these are rounded down to a
+  // whole number of demodulator blocks, and never less than one block, and split up below
+  size_t const readsize = std::max(m_bufferlength / blocksize, static_cast<size_t>(1)) * blocksize;
+
+  bool resync = false; // Flag indicating that a resync packet is pending
+  bool const unpaced = m_device->is_unpaced(); // Flag to wait for the demux reader
 
   // read_callback_func (local)
   //
   // Asynchronous read callback function for the RTL-SDR device
   auto read_callback_func = [&](uint8_t const* buffer, size_t count) -> void
   {
-    std::unique_ptr<TYPECPX[]> samples; // Array of I/Q samples to return
+    // A transfer of the wrong size is queued as a single empty block
+    size_t const blocks = (count == readsize) ? readsize / blocksize : 1;
 
-    // If the proper amount of data was returned by the callback, convert it into
-    // the floating-point I/Q sample data for the demodulator to process
-    if (count == readsize)
+    for (size_t index = 0; index < blocks; index++)
     {
 
-      samples = std::unique_ptr<TYPECPX[]>(new TYPECPX[readsize]);
-      for (int index = 0; index < m_demodulator->GetInputBufferLimit(); index++)
+      sample_queue_item_t samples; // Block of I/Q samples to return
+
+      // An unpaced device delivers data as fast as it can be processed; instead of dropping
+      // samples when the queue is full, wait for the demux reader to make room.  The pool
+      // can grow to more blocks than the queue holds, so it can't be exhausted after waiting
+      if (unpaced)
+        m_queue.wait_for_space([&]() -> bool { return m_stop.test(true); });
+
+      // If the proper amount of data was returned by the callback, convert it into
+      // the floating-point I/Q sample data for the demodulator to process.  If the
+      // pool has been exhausted the block will be empty and a resync will be queued
+      if (count == readsize)
+        samples = m_samplepool->acquire();
+
+      if (samples)
       {
 
         // The demodulator expects the I/Q samples in the range of -32767.0 through +32767.0
-        // (32767.0 / 127.5) = 256.9960784313725
-        samples[index] = {
-
-#ifdef FMDSP_USE_DOUBLE_PRECISION
-            (static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5) * 256.9960784313725, // I
-            (static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5) * 256.9960784313725, // Q
-#else
-            (static_cast<TYPEREAL>(buffer[(index * 2)]) - 127.5f) * 256.9960784313725f, // I
-            (static_cast<TYPEREAL>(buffer[(index * 2) + 1]) - 127.5f) * 256.9960784313725f, // Q
-#endif
-        };
+        if (m_decimator)
+          m_decimator->decimate(&buffer[index * blocksize],
+                                reinterpret_cast<TYPEREAL*>(samples.get()),
+                                m_demodulator->GetInputBufferLimit() * factor, 256.9960784313725f);
+        else
+          m_converter.convert(&buffer[index * blocksize],
+                              reinterpret_cast<TYPEREAL*>(samples.get()),
+                              m_demodulator->GetInputBufferLimit());
       }
-    }
 
-    // Push the converted samples into the queue<> for processing.  If there is insufficient space
-    // left in the queue<>, the samples aren't being processed quickly enough to keep up with the rate
-    std::unique_lock<std::mutex> lock(m_queuelock);
-    if (m_queue.size() < MAX_SAMPLE_QUEUE)
-      m_queue.emplace(std::move(samples));
-    else
-    {
+      // If samples were previously dropped, a resync packet (empty) has to be queued ahead
+      // of any new samples so the demodulator knows that the input is discontinuous
+      if (resync)
+        resync = !m_queue.push(sample_queue_item_t());
 
-      m_queue = sample_queue_t(); // Replace the queue<>
-      m_queue.push(nullptr); // Push a resync packet (null)
-      if (samples)
-        m_queue.emplace(std::move(samples)); // Push samples
+      // Push the converted samples into the queue for processing.  If there is insufficient
+      // space left in the queue, the samples aren't being processed quickly enough to keep up;
+      // the samples are dropped, counted as an overrun, and a resync will be queued next time
+      if ((resync) || (!m_queue.push(std::move(samples))))
+        resync = true;
     }
-
-    // Notify any threads waiting on the lock that the queue<> has been updated
-    m_cv.notify_all();
   };
 
   // Begin streaming from the device and inform the caller that the thread is running
@@ -548,7 +691,7 @@ void wxstream::transfer(scalar_condition<bool>& started)
   // Continuously read data from the device until cancel_async() has been called
   try
   {
-    m_device->read_async(read_callback_func, static_cast<uint32_t>(readsize));
+    m_device->read_async(read_callback_func, static_cast<uint32_t>(readsize), m_buffercount);
   }
   catch (...)
   {
@@ -556,7 +699,7 @@ void wxstream::transfer(scalar_condition<bool>& started)
   }
 
   m_stopped.store(true); // Thread is stopped
-  m_cv.notify_all(); // Unblock any waiters
+  m_queue.notify(); // Unblock any waiters
 }
 
 //---------------------------------------------------------------------------
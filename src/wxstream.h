@@ -29,13 +29,16 @@
 #include "props.h"
 #include "pvrstream.h"
 #include "rtldevice.h"
+#include "utils/clockrecovery.h"
+#include "utils/iqconverter.h"
+#include "utils/iqdecimator.h"
+#include "utils/latencycontrol.h"
+#include "utils/samplepool.h"
 #include "utils/scalar_condition.h"
+#include "utils/spsc_queue.h"
 
 #include <atomic>
-#include <condition_variable>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <thread>
 
 #pragma warning(push, 4)
@@ -55,6 +58,11 @@ public:
   //-----------------------------------------------------------------------
   // Member Functions
 
+  // canpause
+  //
+  // Flag indicating if the stream allows pause operations
+  bool canpause(void) const override;
+
   // canseek
   //
   // Flag indicating if the stream allows seek operations
@@ -98,6 +106,11 @@ public:
   // Gets the device name associated with the stream
   std::string devicename(void) const override;
 
+  // devicestatistics
+  //
+  // Gets the data transfer statistics for the device associated with the stream
+  void devicestatistics(struct rtldevice::device_statistics& stats) const override;
+
   // enumproperties
   //
   // Enumerates the stream properties
@@ -114,6 +127,11 @@ public:
   // Gets the mux name associated with the stream
   std::string muxname(void) const override;
 
+  // overruns
+  //
+  // Gets the number of times that data was dropped because the stream fell behind
+  uint64_t overruns(void) const override;
+
   // position
   //
   // Gets the current position of the stream
@@ -134,6 +152,11 @@ public:
   // Sets the stream pointer to a specific position
   long long seek(long long position, int whence) override;
 
+  // seektime
+  //
+  // Sets the stream pointer to a specific time
+  bool seektime(double time, bool backwards, double& startpts) override;
+
   // servicename
   //
   // Gets the service name associated with the stream
@@ -144,14 +167,24 @@ public:
   // Gets the signal quality as percentages
   void signalquality(int& quality, int& snr) const override;
 
+  // streamtimes
+  //
+  // Gets the time shift boundaries of the stream
+  bool streamtimes(struct streamtimes& times) const override;
+
 private:
   wxstream(wxstream const&) = delete;
   wxstream& operator=(wxstream const&) = delete;
 
-  // MAX_SAMPLE_QUEUE
+  // MIN_DECIMATED_RATE
+  //
+  // Minimum effective sample rate after front-end decimation
+  static uint32_t const MIN_DECIMATED_RATE;
+
+  // SAMPLE_BLOCK_DURATION
   //
-  // Maximum number of queued sample sets from device
-  static size_t const MAX_SAMPLE_QUEUE;
+  // Approximate duration of a block of samples, in milliseconds
+  static uint32_t const SAMPLE_BLOCK_DURATION;
 
   // STREAM_ID_AUDIO
   //
@@ -171,12 +204,12 @@ private:
   // sample_queue_item_t
   //
   // Defines the type of a single sample_queue_t entry
-  using sample_queue_item_t = std::unique_ptr<TYPECPX[]>;
+  using sample_queue_item_t = samplepool<TYPECPX>::block;
 
   // sample_queue_t
   //
   // Defines the type of the input sample queue
-  using sample_queue_t = std::queue<sample_queue_item_t>;
+  using sample_queue_t = spsc_queue<sample_queue_item_t>;
 
   //-----------------------------------------------------------------------
   // Private Member Functions
@@ -195,19 +228,26 @@ private:
   // Member Variables
 
   std::unique_ptr<rtldevice> m_device; // RTL-SDR device instance
-  std::unique_ptr<CDemodulator> m_demodulator; // CuteSDR demodulator instance
-  std::unique_ptr<CFractResampler> m_resampler; // CuteSDR resampler instance
+  uint32_t const m_buffercount; // Device transfer buffer count
+  uint32_t const m_bufferlength; // Device transfer buffer length
+  std::unique_ptr<CDemodulator<>> m_demodulator; // CuteSDR demodulator instance
+  std::unique_ptr<CFractResampler<>> m_resampler; // CuteSDR resampler instance
+  std::unique_ptr<TYPEREAL[]> m_outsamples; // Demodulator output buffer
 
   std::string const m_muxname; // Generated mux name
   uint32_t const m_pcmsamplerate; // Output sample rate
   TYPEREAL const m_pcmgain; // Output gain
   double m_dts{STREAM_TIME_BASE}; // Current decode time stamp
+  bool const m_freerun; // Flag if the output is not paced by the player
+  latencycontrol m_latency; // Output latency control
+  clockrecovery m_clock; // Output clock recovery
 
   // STREAM CONTROL
   //
-  sample_queue_t m_queue; // queue<> of prepared samples
-  mutable std::mutex m_queuelock; // Synchronization object
-  std::condition_variable m_cv; // Transfer event condvar
+  iqconverter m_converter{127.5f, 256.9960784313725f}; // I/Q sample converter
+  std::unique_ptr<iqdecimator> m_decimator; // Front-end I/Q sample decimator
+  std::unique_ptr<samplepool<TYPECPX>> m_samplepool; // Pool of sample blocks
+  sample_queue_t m_queue; // Queue of prepared samples
   std::thread m_worker; // Data transfer thread
   std::exception_ptr m_worker_exception; // Exception on worker thread
   scalar_condition<bool> m_stop{false}; // Condition to stop data transfer